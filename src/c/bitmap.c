@@ -180,3 +180,43 @@ int bitmap_get(bitmap_t *bmp, int idx)
     
     return ( (bmp->map[I_ULONG(idx)]) & (1UL << I_BIT(idx)) ) > 0;
 }
+
+/* find first set bit starting from idx; returns -1 if didn't find anything */
+int bitmap_next_set(bitmap_t *bmp, int idx)
+{
+    if (!bmp || !bmp->map || idx < 0) return -1;
+
+    int i = (int)I_ULONG(idx), ulongs = (int)NUM_ULONGS((size_t)bmp->elements);
+    if (idx >= bmp->elements)
+        return -1;
+
+    /* skip bits below idx in the first word */
+    _ulong word = bmp->map[i] & (~0UL << I_BIT(idx));
+    while (!word && ++i < ulongs)
+        word = bmp->map[i];
+    if (!word)
+        return -1;
+
+    int res = i*8*(int)sizeof(_ulong) + __builtin_ctzl(word);
+    return res < bmp->elements ? res : -1;
+}
+
+/* find first cleared bit starting from idx; returns -1 if didn't find anything */
+int bitmap_next_clear(bitmap_t *bmp, int idx)
+{
+    if (!bmp || !bmp->map || idx < 0) return -1;
+
+    int i = (int)I_ULONG(idx), ulongs = (int)NUM_ULONGS((size_t)bmp->elements);
+    if (idx >= bmp->elements)
+        return -1;
+
+    /* skip bits below idx in the first word */
+    _ulong word = ~bmp->map[i] & (~0UL << I_BIT(idx));
+    while (!word && ++i < ulongs)
+        word = ~bmp->map[i];
+    if (!word)
+        return -1;
+
+    int res = i*8*(int)sizeof(_ulong) + __builtin_ctzl(word);
+    return res < bmp->elements ? res : -1;
+}
@@ -118,4 +118,10 @@ int bitmap_clear(bitmap_t *bmp, int idx);
 /* get bit status; returns -1 if index exceeds upper limit */
 int bitmap_get(bitmap_t *bmp, int idx);
 
+/* find first set bit starting from idx; returns -1 if didn't find anything */
+int bitmap_next_set(bitmap_t *bmp, int idx);
+
+/* find first cleared bit starting from idx; returns -1 if didn't find anything */
+int bitmap_next_clear(bitmap_t *bmp, int idx);
+
 #endif /* BITMAP_H_ */
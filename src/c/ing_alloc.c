@@ -0,0 +1,360 @@
+/* ing_alloc.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Inango allocators implementation
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ing_alloc.h"
+
+#define ALIGN_UP(x, a)  (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+/*
+ * Threads are assigned magazines round-robin on first use. With more than
+ * ING_POOL_MAGAZINES threads a magazine is shared, so it has its own mutex
+ */
+static __thread int thread_mag = -1;
+static int next_mag;
+
+static ing_pool_magazine_t *pool_magazine(ing_pool_t *pool)
+{
+    if (thread_mag < 0)
+        thread_mag = __atomic_fetch_add(&next_mag, 1, __ATOMIC_RELAXED) % ING_POOL_MAGAZINES;
+    return &pool->mags[thread_mag];
+}
+
+ing_stat_t ing_pool_init(ing_pool_t *pool, size_t obj_size, int capacity)
+{
+    int i;
+
+    if (!pool || !obj_size || capacity <= 0)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    memset(pool, 0, sizeof(*pool));
+    pool->obj_size = ALIGN_UP(obj_size, sizeof(void *));
+    pool->capacity = capacity;
+    pool->objs = (char *)malloc(pool->obj_size * (size_t)capacity);
+    if (!pool->objs)
+        return ING_STAT_OUTOFMEMORY;
+
+    if (bitmap_init(&pool->map_free, capacity, 1) < 0)
+    {
+        free(pool->objs);
+        pool->objs = NULL;
+        return ING_STAT_OUTOFMEMORY;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    for (i = 0; i < ING_POOL_MAGAZINES; i++)
+        pthread_mutex_init(&pool->mags[i].lock, NULL);
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_pool_destroy(ing_pool_t *pool)
+{
+    int i;
+
+    if (!pool)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (pool->objs)
+    {
+        pthread_mutex_destroy(&pool->lock);
+        for (i = 0; i < ING_POOL_MAGAZINES; i++)
+            pthread_mutex_destroy(&pool->mags[i].lock);
+    }
+    bitmap_destroy(&pool->map_free);
+    free(pool->objs);
+    memset(pool, 0, sizeof(*pool));
+    return ING_STAT_OK;
+}
+
+/* moves up to ING_POOL_BATCH free objects from bitmap to magazine */
+static void pool_refill(ing_pool_t *pool, ing_pool_magazine_t *mag)
+{
+    int idx;
+
+    pthread_mutex_lock(&pool->lock);
+    idx = bitmap_next_set(&pool->map_free, pool->hint);
+    if (idx < 0)
+        idx = bitmap_next_set(&pool->map_free, 0);
+    while (idx >= 0 && mag->count < ING_POOL_BATCH)
+    {
+        bitmap_clear(&pool->map_free, idx);
+        mag->objs[mag->count++] = pool->objs + (size_t)idx * pool->obj_size;
+        pool->hint = idx + 1;
+        idx = bitmap_next_set(&pool->map_free, idx + 1);
+    }
+    if (pool->hint >= pool->capacity)
+        pool->hint = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/* moves ING_POOL_BATCH objects from magazine back to bitmap */
+static void pool_flush(ing_pool_t *pool, ing_pool_magazine_t *mag)
+{
+    int i, idx;
+
+    pthread_mutex_lock(&pool->lock);
+    for (i = 0; i < ING_POOL_BATCH; i++)
+    {
+        idx = (int)(((char *)mag->objs[--mag->count] - pool->objs) / pool->obj_size);
+        bitmap_set(&pool->map_free, idx);
+        if (idx < pool->hint)
+            pool->hint = idx;
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void *ing_pool_alloc(ing_pool_t *pool)
+{
+    ing_pool_magazine_t *mag;
+    void *obj = NULL;
+    int i;
+
+    if (!pool || !pool->objs)
+        return NULL;
+
+    mag = pool_magazine(pool);
+    pthread_mutex_lock(&mag->lock);
+    if (!mag->count)
+        pool_refill(pool, mag);
+    if (mag->count)
+        obj = mag->objs[--mag->count];
+    pthread_mutex_unlock(&mag->lock);
+    if (obj)
+        return obj;
+
+    /* the pool is exhausted or free objects wait in other magazines */
+    for (i = 0; i < ING_POOL_MAGAZINES && !obj; i++)
+    {
+        mag = &pool->mags[i];
+        pthread_mutex_lock(&mag->lock);
+        if (mag->count)
+            obj = mag->objs[--mag->count];
+        pthread_mutex_unlock(&mag->lock);
+    }
+    return obj;
+}
+
+void *ing_pool_calloc(ing_pool_t *pool)
+{
+    void *obj = ing_pool_alloc(pool);
+    if (obj)
+        memset(obj, 0, pool->obj_size);
+    return obj;
+}
+
+void ing_pool_free(ing_pool_t *pool, void *obj)
+{
+    ing_pool_magazine_t *mag;
+
+    if (!pool || !obj)
+        return;
+
+    mag = pool_magazine(pool);
+    pthread_mutex_lock(&mag->lock);
+    if (mag->count == ING_POOL_MAGAZINE_SIZE)
+        pool_flush(pool, mag);
+    mag->objs[mag->count++] = obj;
+    pthread_mutex_unlock(&mag->lock);
+}
+
+int ing_pool_owns(const ing_pool_t *pool, const void *obj)
+{
+    const char *p = (const char *)obj;
+
+    if (!pool || !pool->objs || p < pool->objs ||
+        p >= pool->objs + pool->obj_size * (size_t)pool->capacity)
+        return FALSE;
+    return ((size_t)(p - pool->objs) % pool->obj_size) == 0;
+}
+
+/*
+ * Arena
+ */
+ing_stat_t ing_arena_init(ing_arena_t *arena, size_t chunk_size)
+{
+    if (!arena)
+        return ING_STAT_INVALID_ARGUMENT;
+    memset(arena, 0, sizeof(*arena));
+    arena->chunk_size = chunk_size ? chunk_size : ING_ARENA_CHUNK_SIZE;
+    return ING_STAT_OK;
+}
+
+void ing_arena_destroy(ing_arena_t *arena)
+{
+    ing_arena_chunk_t *c, *next;
+
+    if (!arena)
+        return;
+    for (c = arena->first; c; c = next)
+    {
+        next = c->next;
+        free(c);
+    }
+    arena->first = arena->cur = NULL;
+    arena->allocated = 0;
+}
+
+static ing_arena_chunk_t *arena_new_chunk(size_t size)
+{
+    size_t hdr = ALIGN_UP(sizeof(ing_arena_chunk_t), ING_ARENA_ALIGN);
+    ing_arena_chunk_t *c = (ing_arena_chunk_t *)malloc(hdr + size);
+
+    if (!c)
+        return NULL;
+    c->next = NULL;
+    c->size = size;
+    c->used = 0;
+    c->data = (char *)c + hdr;
+    return c;
+}
+
+void *ing_arena_alloc(ing_arena_t *arena, size_t size)
+{
+    ing_arena_chunk_t *c;
+    void *p;
+
+    if (!arena)
+        return NULL;
+    size = ALIGN_UP(size ? size : 1, ING_ARENA_ALIGN);
+
+    c = arena->cur;
+    if (!c || c->size - c->used < size)
+    {
+        /* reuse chunks kept by ing_arena_reset() if they fit */
+        while (c && c->next && c->next->size < size)
+        {
+            c = c->next;
+            c->used = c->size;  /* skipped: too small */
+        }
+        if (c && c->next)
+        {
+            c = c->next;
+            c->used = 0;
+        }
+        else
+        {
+            ing_arena_chunk_t *n = arena_new_chunk(size > arena->chunk_size ? size : arena->chunk_size);
+            if (!n)
+                return NULL;
+            if (c)
+                c->next = n;
+            else
+                arena->first = n;
+            c = n;
+        }
+        arena->cur = c;
+    }
+
+    p = c->data + c->used;
+    c->used += size;
+    arena->allocated += size;
+    return p;
+}
+
+void *ing_arena_calloc(ing_arena_t *arena, size_t size)
+{
+    void *p = ing_arena_alloc(arena, size);
+    if (p)
+        memset(p, 0, size);
+    return p;
+}
+
+char *ing_arena_strndup(ing_arena_t *arena, const char *str, size_t len)
+{
+    char *p;
+
+    if (!str)
+        return NULL;
+    p = (char *)ing_arena_alloc(arena, len + 1);
+    if (p)
+    {
+        memcpy(p, str, len);
+        p[len] = '\0';
+    }
+    return p;
+}
+
+char *ing_arena_strdup(ing_arena_t *arena, const char *str)
+{
+    return str ? ing_arena_strndup(arena, str, strlen(str)) : NULL;
+}
+
+void ing_arena_reset(ing_arena_t *arena)
+{
+    if (!arena)
+        return;
+    arena->cur = arena->first;
+    if (arena->cur)
+        arena->cur->used = 0;
+    arena->allocated = 0;
+}
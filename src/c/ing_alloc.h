@@ -0,0 +1,176 @@
+/* ing_alloc.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Inango allocators
+ *
+ * ing_pool_t  - pool of fixed-size objects preallocated in one block. Free
+ *               objects are tracked by a bitmap and cached in sharded
+ *               magazines: ING_POOL_MAGAZINES small caches of free objects,
+ *               each guarded by a mutex, over which threads are spread
+ *               round-robin. Threads rarely contend on a magazine and the
+ *               shared bitmap is locked only once per ING_POOL_BATCH
+ *               operations.
+ *
+ * ing_arena_t - bump allocator for short-living data (e.g. one request):
+ *               objects are never freed one by one, the whole arena is reset
+ *               at once and keeps its memory for the next use. Not thread-safe.
+ */
+
+#ifndef ING_ALLOC_H_
+#define ING_ALLOC_H_
+
+#include <stddef.h>
+#include <pthread.h>
+
+#include "ing_gen_utils.h"
+#include "bitmap.h"
+
+/*
+ * Object pool
+ */
+#define ING_POOL_MAGAZINES      16  /* shards threads are spread over */
+#define ING_POOL_MAGAZINE_SIZE  32  /* objects per cache */
+#define ING_POOL_BATCH          (ING_POOL_MAGAZINE_SIZE/2)
+
+typedef struct ing_pool_magazine_s {
+    pthread_mutex_t lock;           /* threads may share a magazine */
+    int count;
+    void *objs[ING_POOL_MAGAZINE_SIZE];
+} __attribute__((aligned(64))) ing_pool_magazine_t;
+
+typedef struct ing_pool_s {
+    char *objs;                     /* objects block */
+    size_t obj_size;                /* object size rounded up to alignment */
+    int capacity;                   /* number of objects */
+    pthread_mutex_t lock;           /* protects map_free and hint */
+    bitmap_t map_free;              /* free objects not cached in magazines */
+    int hint;                       /* where to start looking for free objects */
+    ing_pool_magazine_t mags[ING_POOL_MAGAZINES];
+} ing_pool_t;
+
+/* initialize pool of capacity objects of obj_size bytes */
+ing_stat_t ing_pool_init(ing_pool_t *pool, size_t obj_size, int capacity);
+
+/* destroy pool; all objects become invalid */
+ing_stat_t ing_pool_destroy(ing_pool_t *pool);
+
+/* returns NULL if all objects are in use */
+void *ing_pool_alloc(ing_pool_t *pool);
+
+/* same as ing_pool_alloc(), object is zeroed */
+void *ing_pool_calloc(ing_pool_t *pool);
+
+/* return object to the pool; obj must be allocated from this pool */
+void ing_pool_free(ing_pool_t *pool, void *obj);
+
+/* returns TRUE if obj points to an object of this pool */
+int ing_pool_owns(const ing_pool_t *pool, const void *obj);
+
+/*
+ * Arena
+ */
+#define ING_ARENA_ALIGN         16
+#define ING_ARENA_CHUNK_SIZE    4096
+
+typedef struct ing_arena_chunk_s {
+    struct ing_arena_chunk_s *next;
+    size_t size;                    /* bytes in data */
+    size_t used;
+    char *data;
+} ing_arena_chunk_t;
+
+typedef struct ing_arena_s {
+    ing_arena_chunk_t *first;
+    ing_arena_chunk_t *cur;         /* chunk allocations are taken from */
+    size_t chunk_size;              /* default size of a new chunk */
+    size_t allocated;               /* bytes handed out since last reset */
+} ing_arena_t;
+
+/* initialize arena; chunk_size == 0 selects ING_ARENA_CHUNK_SIZE;
+ * no memory is allocated until first use
+ */
+ing_stat_t ing_arena_init(ing_arena_t *arena, size_t chunk_size);
+
+/* free all memory of the arena */
+void ing_arena_destroy(ing_arena_t *arena);
+
+/* returns ING_ARENA_ALIGN aligned block or NULL if out of memory */
+void *ing_arena_alloc(ing_arena_t *arena, size_t size);
+
+void *ing_arena_calloc(ing_arena_t *arena, size_t size);
+
+char *ing_arena_strdup(ing_arena_t *arena, const char *str);
+
+/* copies len bytes of str and terminates the copy with '\0' */
+char *ing_arena_strndup(ing_arena_t *arena, const char *str, size_t len);
+
+/* forget all allocations; memory is kept for reuse */
+void ing_arena_reset(ing_arena_t *arena);
+
+#endif /* ING_ALLOC_H_ */
@@ -0,0 +1,189 @@
+/* ing_bloom.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Inango counting blocked Bloom filter implementation
+ */
+
+#define _POSIX_C_SOURCE 200112L   /* posix_memalign */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ing_bloom.h"
+
+#define LN2     0.69314718055994530942
+
+/* initialize filter for max_keys keys with the given false-positive rate
+ * (0 < fp_rate < 1); returns -1 on wrong arguments or memory allocation failure
+ */
+int ing_bloom_init(ing_bloom_t *bf, int max_keys, double fp_rate)
+{
+    double bits_per_key;
+    unsigned long counters;
+
+    if (!bf || max_keys <= 0 || !(fp_rate > 0.0 && fp_rate < 1.0))
+        return -1;
+    memset(bf, 0, sizeof(*bf));
+
+    /* optimal m/n and k of a classic filter; blocking costs a bit of accuracy
+     * which is compensated by rounding the number of blocks up */
+    bits_per_key = -log(fp_rate) / (LN2 * LN2);
+    bf->num_hashes = (uint32_t)(bits_per_key * LN2 + 0.5);
+    if (bf->num_hashes < 1)
+        bf->num_hashes = 1;
+    if (bf->num_hashes > ING_BLOOM_MAX_HASHES)
+        bf->num_hashes = ING_BLOOM_MAX_HASHES;
+
+    counters = (unsigned long)ceil(bits_per_key * max_keys);
+    bf->num_blocks = (uint32_t)((counters + ING_BLOOM_BLOCK_COUNTERS - 1) / ING_BLOOM_BLOCK_COUNTERS);
+    if (!bf->num_blocks)
+        bf->num_blocks = 1;
+
+    if (posix_memalign((void **)&bf->blocks, ING_BLOOM_BLOCK_SIZE,
+                       (size_t)bf->num_blocks * ING_BLOOM_BLOCK_SIZE) != 0)
+    {
+        bf->blocks = NULL;
+        return -1;
+    }
+    memset(bf->blocks, 0, (size_t)bf->num_blocks * ING_BLOOM_BLOCK_SIZE);
+    return 0;
+}
+
+/* destroy filter */
+int ing_bloom_destroy(ing_bloom_t *bf)
+{
+    if (!bf) return -1;
+    if (bf->blocks)
+        free(bf->blocks);
+    memset(bf, 0, sizeof(*bf));
+    return 0;
+}
+
+void ing_bloom_add(ing_bloom_t *bf, uint32_t hashv)
+{
+    uint64_t bits;
+    uint8_t *block;
+    uint32_t i, idx, shift;
+
+    if (!bf->blocks)
+        return;
+
+    block = ing_bloom_block(bf, hashv, &bits);
+    for (i = 0; i < bf->num_hashes; i++, bits >>= 7)
+    {
+        idx = bits & (ING_BLOOM_BLOCK_COUNTERS - 1);
+        shift = (idx & 1) << 2;
+        if (ING_BLOOM_COUNTER(block, idx) < ING_BLOOM_COUNTER_MAX)
+            block[idx >> 1] += 1 << shift;
+    }
+}
+
+void ing_bloom_del(ing_bloom_t *bf, uint32_t hashv)
+{
+    uint64_t bits;
+    uint8_t *block;
+    uint32_t i, idx, shift, cnt;
+
+    if (!bf->blocks)
+        return;
+
+    block = ing_bloom_block(bf, hashv, &bits);
+    for (i = 0; i < bf->num_hashes; i++, bits >>= 7)
+    {
+        idx = bits & (ING_BLOOM_BLOCK_COUNTERS - 1);
+        shift = (idx & 1) << 2;
+        cnt = ING_BLOOM_COUNTER(block, idx);
+        /* saturated counters are sticky: we don't know how many keys hit them */
+        if (cnt > 0 && cnt < ING_BLOOM_COUNTER_MAX)
+            block[idx >> 1] -= 1 << shift;
+    }
+}
+
+void ing_bloom_clear(ing_bloom_t *bf)
+{
+    if (bf && bf->blocks)
+        memset(bf->blocks, 0, (size_t)bf->num_blocks * ING_BLOOM_BLOCK_SIZE);
+}
+
+unsigned long ing_bloom_size(const ing_bloom_t *bf)
+{
+    return (bf && bf->blocks) ? (unsigned long)bf->num_blocks * ING_BLOOM_BLOCK_SIZE : 0;
+}
+
+double ing_bloom_fp_rate(const ing_bloom_t *bf)
+{
+    unsigned long long absent, fp;
+
+    if (!bf)
+        return 0.0;
+    fp = __atomic_load_n(&bf->false_positives, __ATOMIC_RELAXED);
+    absent = __atomic_load_n(&bf->negatives, __ATOMIC_RELAXED) + fp;
+    return absent ? (double)fp / (double)absent : 0.0;
+}
@@ -0,0 +1,184 @@
+/* ing_bloom.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Inango counting blocked Bloom filter
+ *
+ * Every key touches a single ING_BLOOM_BLOCK_SIZE byte block (one cache line)
+ * which holds 4-bit counters, so a negative answer costs one cache miss and
+ * keys can be removed again. Counters saturate at 15 and are never decremented
+ * after that, which keeps the filter free of false negatives.
+ */
+
+#ifndef ING_BLOOM_H_
+#define ING_BLOOM_H_
+
+#include <stdint.h>
+
+#define ING_BLOOM_BLOCK_SIZE        64      /* bytes per block */
+#define ING_BLOOM_BLOCK_COUNTERS    (ING_BLOOM_BLOCK_SIZE*2)
+#define ING_BLOOM_MAX_HASHES        8
+#define ING_BLOOM_COUNTER_MAX       0xF
+
+typedef struct ing_bloom_s
+{
+    uint8_t *blocks;            /* counters, two per byte */
+    uint32_t num_blocks;
+    uint32_t num_hashes;        /* counters set per key */
+    /* statistics, updated with relaxed atomics: readers may look up in parallel */
+    unsigned long long lookups;         /* number of ing_bloom_check() calls */
+    unsigned long long negatives;       /* lookups answered by the filter alone */
+    unsigned long long false_positives; /* lookups passed to the table but not found */
+} ing_bloom_t;
+
+/* initialize filter for max_keys keys with the given false-positive rate
+ * (0 < fp_rate < 1); returns -1 on wrong arguments or memory allocation failure
+ */
+int ing_bloom_init(ing_bloom_t *bf, int max_keys, double fp_rate);
+
+/* destroy filter */
+int ing_bloom_destroy(ing_bloom_t *bf);
+
+/* add/remove key by its 32-bit hash value */
+void ing_bloom_add(ing_bloom_t *bf, uint32_t hashv);
+void ing_bloom_del(ing_bloom_t *bf, uint32_t hashv);
+
+/* clear all counters, keeps statistics */
+void ing_bloom_clear(ing_bloom_t *bf);
+
+/* memory used by the counters in bytes */
+unsigned long ing_bloom_size(const ing_bloom_t *bf);
+
+/* false positives / lookups of absent keys, 0 if there were no such lookups */
+double ing_bloom_fp_rate(const ing_bloom_t *bf);
+
+#define ing_bloom_enabled(bf)   ((bf)->blocks != NULL)
+
+/* Mixes 32-bit table hash into two independent 64-bit values:
+ * the first selects the block, the second supplies 7-bit counter indexes
+ */
+static inline uint64_t ing_bloom_mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint8_t *ing_bloom_block(const ing_bloom_t *bf, uint32_t hashv, uint64_t *bits)
+{
+    uint64_t h = ing_bloom_mix(hashv);
+    *bits = ing_bloom_mix(h);
+    return bf->blocks + ((((h >> 32) * bf->num_blocks) >> 32) * ING_BLOOM_BLOCK_SIZE);
+}
+
+#define ING_BLOOM_COUNTER(block, idx) \
+    (((block)[(idx) >> 1] >> (((idx) & 1) << 2)) & ING_BLOOM_COUNTER_MAX)
+
+/* returns 0 if the key is definitely absent, 1 if it may be present;
+ * a disabled filter always returns 1
+ */
+static inline int ing_bloom_test(const ing_bloom_t *bf, uint32_t hashv)
+{
+    uint64_t bits;
+    uint8_t *block;
+    uint32_t i;
+
+    if (!bf->blocks)
+        return 1;
+
+    block = ing_bloom_block(bf, hashv, &bits);
+    for (i = 0; i < bf->num_hashes; i++, bits >>= 7)
+    {
+        if (!ING_BLOOM_COUNTER(block, bits & (ING_BLOOM_BLOCK_COUNTERS - 1)))
+            return 0;
+    }
+    return 1;
+}
+
+/* same as ing_bloom_test() but also updates lookup statistics;
+ * call ing_bloom_false_positive() if the table then misses the key
+ */
+static inline int ing_bloom_check(ing_bloom_t *bf, uint32_t hashv)
+{
+    if (!bf->blocks)
+        return 1;
+
+    __atomic_fetch_add(&bf->lookups, 1, __ATOMIC_RELAXED);
+    if (ing_bloom_test(bf, hashv))
+        return 1;
+    __atomic_fetch_add(&bf->negatives, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+#define ing_bloom_false_positive(bf) \
+    do { if ((bf)->blocks) __atomic_fetch_add(&(bf)->false_positives, 1, __ATOMIC_RELAXED); } while (0)
+
+#endif /* ING_BLOOM_H_ */
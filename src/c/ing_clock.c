@@ -0,0 +1,157 @@
+/* ing_clock.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Fast clocks implementation
+ */
+
+#define _GNU_SOURCE
+
+#include <string.h>
+
+#include "ing_clock.h"
+
+#define TIMESTR_LEN     14      /* "dd.MM hh:mm:ss" */
+
+static __thread time_t cached_sec = (time_t)-1;
+static __thread char cached_str[TIMESTR_LEN + 1];
+
+static inline uint64_t clock_ms(clockid_t id)
+{
+    struct timespec ts;
+
+    clock_gettime(id, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+uint64_t ing_clock_mono_ms(void)
+{
+    return clock_ms(CLOCK_MONOTONIC_COARSE);
+}
+
+uint64_t ing_clock_real_ms(void)
+{
+    return clock_ms(CLOCK_REALTIME_COARSE);
+}
+
+uint64_t ing_clock_real_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+long ing_clock_uptime(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    /* rounded up as sysinfo() does */
+    return ts.tv_sec + (ts.tv_nsec ? 1 : 0);
+}
+
+static inline char *put2(char *p, int v, char sep)
+{
+    p[0] = '0' + v / 10 % 10;
+    p[1] = '0' + v % 10;
+    p[2] = sep;
+    return p + 3;
+}
+
+size_t ing_clock_timestr(char *buf, time_t t)
+{
+    struct tm tm;
+    char *p;
+
+    if (t != cached_sec)
+    {
+        localtime_r(&t, &tm);
+        p = put2(cached_str, tm.tm_mday, '.');
+        p = put2(p, tm.tm_mon + 1, ' ');
+        p = put2(p, tm.tm_hour, ':');
+        p = put2(p, tm.tm_min, ':');
+        p = put2(p, tm.tm_sec, '\0');
+        cached_sec = t;
+    }
+    memcpy(buf, cached_str, TIMESTR_LEN + 1);
+    return TIMESTR_LEN;
+}
+
+size_t ing_clock_timestr_ms(char *buf, uint64_t real_ms)
+{
+    unsigned ms = real_ms % 1000;
+    size_t n = ing_clock_timestr(buf, (time_t)(real_ms / 1000));
+
+    buf[n++] = '.';
+    buf[n++] = '0' + ms / 100;
+    buf[n++] = '0' + ms / 10 % 10;
+    buf[n++] = '0' + ms % 10;
+    buf[n] = '\0';
+    return n;
+}
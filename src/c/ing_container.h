@@ -68,6 +68,10 @@
 
 /*
  * Inango hash container implementation
+ *
+ * Define HASH_BKT_TAGS before including this file to keep 8-bit fingerprints
+ * in hash buckets (see uthash_ing.h); it speeds up lookups in tables with
+ * long chains at the cost of 9 bytes per record on 64-bit platforms.
  */
 
 #ifndef ING_CONTAINTER_H_
@@ -77,6 +81,22 @@
 
 #include "ing_gen_utils.h"
 #include "bitmap.h"
+#include "ing_bloom.h"
+#include "ing_sort.h"
+#include "ing_parallel.h"
+
+/* Container statistics filled by IC_STATS */
+typedef struct ing_container_stats_s {
+    int max_rec_num;            /* max number of records */
+    int rec_num;                /* current number of records */
+    unsigned num_buckets;       /* number of hash table buckets */
+    unsigned nonideal_items;    /* items placed beyond ideal chain length */
+    unsigned long bloom_size;   /* bloom filter size in bytes, 0 if disabled */
+    unsigned long long bloom_lookups;           /* lookups checked by the filter */
+    unsigned long long bloom_negatives;         /* lookups answered by the filter */
+    unsigned long long bloom_false_positives;   /* passed by the filter, missed in table */
+    double bloom_fp_rate;       /* false positives / lookups of absent keys */
+} ing_container_stats_t;
 
 
 #define _GENERATE_DB_TYPE(RECORD_TYPE, _DB_TYPE_SUFFIX) \
@@ -87,22 +107,47 @@ typedef struct RECORD_TYPE##_DB_TYPE_SUFFIX { \
     bitmap_t map_free;          /* bit map of free blocks */ \
     RECORD_TYPE *head;          /* hash table pointer */ \
     void *hash_buf;             /* TODO buffer for hash table */ \
+    ing_bloom_t bloom;          /* optional filter for negative lookups */ \
 } RECORD_TYPE##_DB_TYPE_SUFFIX;
 
 #define GENERATE_DB_TYPE(RECORD_TYPE)   _GENERATE_DB_TYPE(RECORD_TYPE, _db_t)
 
 #define _GENERATE_DB_DECLARATIONS(RECORD_TYPE, _DB_TYPE_SUFFIX, KEYFIELD_NAME) \
 ing_stat_t init_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, int max_rec_num); \
+ing_stat_t init_bloom_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, int max_rec_num, double fp_rate); \
 ing_stat_t destroy_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db); \
 ing_stat_t add_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, const RECORD_TYPE *xi_val); \
 ing_stat_t del_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, const void *xi_key); \
 ing_stat_t get_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, const void *xi_key, RECORD_TYPE **xo_val); \
-int size_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db);
+int size_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db); \
+ing_stat_t stats_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, ing_container_stats_t *xo_stats); \
+ing_stat_t sorted_view_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, ing_view_t *xo_view, \
+    ing_cmp_fn cmp, int nthreads); \
+ing_stat_t sorted_view_by_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, ing_view_t *xo_view, \
+    size_t key_off, size_t key_size, ing_sort_key_t key_type); \
+ing_stat_t sorted_view_by_key_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, ing_view_t *xo_view, \
+    ing_sort_key_t key_type);
 
 #define GENERATE_DB_DECLARATIONS(RECORD_TYPE, KEYFIELD_NAME) \
     _GENERATE_DB_DECLARATIONS(RECORD_TYPE, _db_t, KEYFIELD_NAME)
 
 #define _GENERATE_DB_FUNCTIONS(RECORD_TYPE, _DB_TYPE_SUFFIX, KEYFIELD_NAME) \
+/* Hash the key once, ask the bloom filter (if any) and only then walk the bucket */ \
+static RECORD_TYPE *find_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, const void *xi_key) \
+{ \
+    RECORD_TYPE *tmp = NULL; \
+    unsigned hashv; \
+    if (!db->head) return NULL; \
+    HASH_VALUE(xi_key, FIELD_SIZE(RECORD_TYPE, KEYFIELD_NAME), hashv); \
+    if (!ing_bloom_check(&db->bloom, hashv)) \
+        return NULL; \
+    HASH_FIND_BYHASHVALUE(hh, db->head, xi_key, \
+        FIELD_SIZE(RECORD_TYPE, KEYFIELD_NAME), hashv, tmp); \
+    if (!tmp) \
+        ing_bloom_false_positive(&db->bloom); \
+    return tmp; \
+} \
+ \
 ing_stat_t init_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, int max_rec_num) \
 { \
     if (!db) return ING_STAT_INVALID_ARGUMENT; \
@@ -117,10 +162,28 @@ ing_stat_t init_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, int max_rec_num)
     return ING_STAT_OK; \
 } \
  \
+/* Same as init, but also creates a counting bloom filter sized for max_rec_num */ \
+/* keys with false-positive rate fp_rate (e.g. 0.01), so most lookups of absent */ \
+/* keys are answered without touching the hash table */ \
+ing_stat_t init_bloom_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, int max_rec_num, double fp_rate) \
+{ \
+    ing_stat_t res = init_##RECORD_TYPE(db, max_rec_num); \
+    if (res != ING_STAT_OK) \
+        return res; \
+    if (ing_bloom_init(&db->bloom, max_rec_num, fp_rate) < 0) \
+    { \
+        bitmap_destroy(&db->map_free); \
+        free(db->records); db->records = NULL; \
+        return (fp_rate > 0.0 && fp_rate < 1.0) ? ING_STAT_OUTOFMEMORY : ING_STAT_INVALID_ARGUMENT; \
+    } \
+    return ING_STAT_OK; \
+} \
+ \
 ing_stat_t destroy_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db) \
 { \
     if (!db) return ING_STAT_INVALID_ARGUMENT; \
     bitmap_destroy(&db->map_free); \
+    ing_bloom_destroy(&db->bloom); \
     if (db->head) \
         HASH_CLEAR(hh, db->head); \
         db->rec_num = 0; \
@@ -134,10 +197,7 @@ ing_stat_t add_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, const RECORD_TYPE
     if (!db || !xi_val) return ING_STAT_INVALID_ARGUMENT; \
      \
     /* check if already exists */ \
-    RECORD_TYPE *tmp; \
-    HASH_FIND(hh, db->head, &(xi_val->KEYFIELD_NAME), \
-        FIELD_SIZE(RECORD_TYPE, KEYFIELD_NAME), tmp); \
-    if (tmp) \
+    if (find_##RECORD_TYPE(db, &(xi_val->KEYFIELD_NAME))) \
         return ING_STAT_ALREADY_EXISTS; \
      \
     /* check if we have space */ \
@@ -153,6 +213,7 @@ ing_stat_t add_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, const RECORD_TYPE
     /* add to hash table */ \
     HASH_ADD(hh, db->head, KEYFIELD_NAME, \
         FIELD_SIZE(RECORD_TYPE, KEYFIELD_NAME), (&db->records[ifree])); \
+    ing_bloom_add(&db->bloom, db->records[ifree].hh.hashv); \
      \
     return ING_STAT_OK; \
 } \
@@ -162,13 +223,12 @@ ing_stat_t del_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, const void *xi_ke
     if (!db || !xi_key) return ING_STAT_INVALID_ARGUMENT; \
      \
     /* check if exists */ \
-    RECORD_TYPE *tmp; \
-    HASH_FIND(hh, db->head, xi_key, \
-        FIELD_SIZE(RECORD_TYPE, KEYFIELD_NAME), tmp); \
+    RECORD_TYPE *tmp = find_##RECORD_TYPE(db, xi_key); \
     if (!tmp) \
         return ING_STAT_NOT_FOUND; \
      \
     /* delete from hash table */ \
+    ing_bloom_del(&db->bloom, tmp->hh.hashv); \
     HASH_DELETE(hh, db->head, tmp); \
      \
     /* set its place free */ \
@@ -184,6 +244,7 @@ ing_stat_t del_val_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, RECORD_TYPE *
     if (!db || !xi_val) return ING_STAT_INVALID_ARGUMENT; \
      \
     /* delete from hash table */ \
+    ing_bloom_del(&db->bloom, xi_val->hh.hashv); \
     HASH_DELETE(hh, db->head, xi_val); \
      \
     /* set its place free */ \
@@ -200,9 +261,7 @@ ing_stat_t get_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, const void *xi_ke
     if (!db || !xi_key) return ING_STAT_INVALID_ARGUMENT; \
      \
     /* check if exists */ \
-    RECORD_TYPE *tmp; \
-    HASH_FIND(hh, db->head, xi_key, \
-        FIELD_SIZE(RECORD_TYPE, KEYFIELD_NAME), tmp); \
+    RECORD_TYPE *tmp = find_##RECORD_TYPE(db, xi_key); \
     if (!tmp) \
         return ING_STAT_NOT_FOUND; \
     else \
@@ -216,6 +275,69 @@ int size_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db) \
         return 0; \
     else \
         return db->rec_num; \
+} \
+ \
+ing_stat_t stats_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, ing_container_stats_t *xo_stats) \
+{ \
+    if (!db || !xo_stats) return ING_STAT_INVALID_ARGUMENT; \
+    memset(xo_stats, 0, sizeof(ing_container_stats_t)); \
+    xo_stats->max_rec_num = db->max_rec_num; \
+    xo_stats->rec_num = db->rec_num; \
+    if (db->head) \
+    { \
+        xo_stats->num_buckets = db->head->hh.tbl->num_buckets; \
+        xo_stats->nonideal_items = db->head->hh.tbl->nonideal_items; \
+    } \
+    xo_stats->bloom_size = ing_bloom_size(&db->bloom); \
+    xo_stats->bloom_lookups = __atomic_load_n(&db->bloom.lookups, __ATOMIC_RELAXED); \
+    xo_stats->bloom_negatives = __atomic_load_n(&db->bloom.negatives, __ATOMIC_RELAXED); \
+    xo_stats->bloom_false_positives = __atomic_load_n(&db->bloom.false_positives, __ATOMIC_RELAXED); \
+    xo_stats->bloom_fp_rate = ing_bloom_fp_rate(&db->bloom); \
+    return ING_STAT_OK; \
+} \
+ \
+/* Collect pointers to all records in slot order, container is not modified */ \
+static ing_stat_t view_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, ing_view_t *xo_view) \
+{ \
+    int i; \
+    if (!db || !xo_view) return ING_STAT_INVALID_ARGUMENT; \
+    if (ing_view_init(xo_view, db->rec_num) != ING_STAT_OK) \
+        return ING_STAT_OUTOFMEMORY; \
+    for (i = bitmap_next_clear(&db->map_free, 0); \
+         i >= 0 && xo_view->count < db->rec_num; \
+         i = bitmap_next_clear(&db->map_free, i + 1)) \
+        xo_view->items[xo_view->count++] = &db->records[i]; \
+    return ING_STAT_OK; \
+} \
+ \
+ing_stat_t sorted_view_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, ing_view_t *xo_view, \
+    ing_cmp_fn cmp, int nthreads) \
+{ \
+    ing_stat_t res = view_##RECORD_TYPE(db, xo_view); \
+    if (res == ING_STAT_OK) \
+        res = ing_sort_ptrs(xo_view->items, xo_view->count, cmp, nthreads); \
+    if (res != ING_STAT_OK) \
+        ing_view_free(xo_view); \
+    return res; \
+} \
+ \
+ing_stat_t sorted_view_by_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, ing_view_t *xo_view, \
+    size_t key_off, size_t key_size, ing_sort_key_t key_type) \
+{ \
+    ing_stat_t res = view_##RECORD_TYPE(db, xo_view); \
+    if (res == ING_STAT_OK) \
+        res = ing_sort_ptrs_by_key(xo_view->items, xo_view->count, \
+            key_off, key_size, key_type, 0); \
+    if (res != ING_STAT_OK) \
+        ing_view_free(xo_view); \
+    return res; \
+} \
+ \
+ing_stat_t sorted_view_by_key_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db, ing_view_t *xo_view, \
+    ing_sort_key_t key_type) \
+{ \
+    return sorted_view_by_##RECORD_TYPE(db, xo_view, offsetof(RECORD_TYPE, KEYFIELD_NAME), \
+        FIELD_SIZE(RECORD_TYPE, KEYFIELD_NAME), key_type); \
 }
 
 #define GENERATE_DB_FUNCTIONS(RECORD_TYPE, KEYFIELD_NAME) \
@@ -224,6 +346,10 @@ int size_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db) \
 #define IC_INIT(RECORD_TYPE, DB_PTR, MAX_SIZE) \
     init_##RECORD_TYPE(DB_PTR, MAX_SIZE)
 
+/* Init container with a bloom filter; FP_RATE is the target false-positive rate */
+#define IC_INIT_BLOOM(RECORD_TYPE, DB_PTR, MAX_SIZE, FP_RATE) \
+    init_bloom_##RECORD_TYPE(DB_PTR, MAX_SIZE, FP_RATE)
+
 #define IC_DESTROY(RECORD_TYPE, DB_PTR) \
     destroy_##RECORD_TYPE(DB_PTR)
 
@@ -241,9 +367,57 @@ int size_##RECORD_TYPE(RECORD_TYPE##_DB_TYPE_SUFFIX *db) \
 
 #define IC_SIZE(RECORD_TYPE, DB_PTR) \
     size_##RECORD_TYPE(DB_PTR)
+
+#define IC_STATS(RECORD_TYPE, DB_PTR, STATS_PTR) \
+    stats_##RECORD_TYPE(DB_PTR, STATS_PTR)
     
 #define IC_DB_TYPE(RECORD_TYPE) RECORD_TYPE##_db_t
 
+/* Sorted snapshots of the container: VIEW_PTR (ing_view_t *) receives an */
+/* array of record pointers, the container itself is not modified.        */
+/* The view must be released by IC_VIEW_FREE and becomes invalid when     */
+/* viewed records are deleted.                                            */
+
+/* Sort by comparator of two records; NTHREADS == 0 selects CPU count */
+#define IC_SORTED_VIEW(RECORD_TYPE, DB_PTR, VIEW_PTR, CMP_FN, NTHREADS) \
+    sorted_view_##RECORD_TYPE(DB_PTR, VIEW_PTR, CMP_FN, NTHREADS)
+
+/* Sort by container key; KEY_TYPE is ing_sort_key_t */
+#define IC_SORTED_VIEW_BY_KEY(RECORD_TYPE, DB_PTR, VIEW_PTR, KEY_TYPE) \
+    sorted_view_by_key_##RECORD_TYPE(DB_PTR, VIEW_PTR, KEY_TYPE)
+
+/* Sort by fixed-width record field */
+#define IC_SORTED_VIEW_BY_FIELD(RECORD_TYPE, DB_PTR, VIEW_PTR, FIELD, KEY_TYPE) \
+    sorted_view_by_##RECORD_TYPE(DB_PTR, VIEW_PTR, offsetof(RECORD_TYPE, FIELD), \
+        FIELD_SIZE(RECORD_TYPE, FIELD), KEY_TYPE)
+
+#define IC_VIEW_AT(RECORD_TYPE, VIEW_PTR, IDX) \
+    ((RECORD_TYPE *)(VIEW_PTR)->items[IDX])
+
+#define IC_VIEW_FREE(VIEW_PTR) \
+    ing_view_free(VIEW_PTR)
+
+/* Parallel scans of the records array: slots are split between worker     */
+/* pool threads (NTHREADS == 0 selects CPU count), free slots are skipped   */
+/* by map_free words. Callbacks get (RECORD_TYPE *) as void pointers and    */
+/* run concurrently; the container must not be modified meanwhile.          */
+
+/* Call FN(rec, ARG) for every record */
+#define IC_PARALLEL_FOREACH(RECORD_TYPE, DB_PTR, FN, ARG, NTHREADS) \
+    ing_parallel_foreach(&(DB_PTR)->map_free, (DB_PTR)->records, sizeof(RECORD_TYPE), \
+        FN, ARG, NTHREADS)
+
+/* Collect records with PRED(rec, ARG) != 0 into VIEW_PTR (ing_view_t *) */
+#define IC_SELECT_INTO_ARRAY(RECORD_TYPE, DB_PTR, PRED, ARG, VIEW_PTR, NTHREADS) \
+    ing_parallel_select(&(DB_PTR)->map_free, (DB_PTR)->records, sizeof(RECORD_TYPE), \
+        PRED, ARG, VIEW_PTR, NTHREADS)
+
+/* Fold records into *ACC_PTR: MAP(acc, rec, ARG) per record on per-thread */
+/* copies of *ACC_PTR, then MERGE(acc, thread_acc, ARG) per thread          */
+#define IC_REDUCE(RECORD_TYPE, DB_PTR, MAP, MERGE, ACC_PTR, ARG, NTHREADS) \
+    ing_parallel_reduce(&(DB_PTR)->map_free, (DB_PTR)->records, sizeof(RECORD_TYPE), \
+        MAP, MERGE, ACC_PTR, sizeof(*(ACC_PTR)), ARG, NTHREADS)
+
 /* Macros implementing "for" loop over database specified by */
 /* its record type and pointer to the DB itself              */
 
@@ -0,0 +1,652 @@
+/* ing_evloop.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Event loop implementation
+ */
+
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+#include "ing_evloop.h"
+
+typedef enum ev_type_e {
+    EV_NONE,
+    EV_FD,
+    EV_TIMER,
+    EV_WAKE
+} ev_type_t;
+
+typedef struct ev_handler_s {
+    ev_type_t type;
+    uint32_t gen;                   /* tells a reused fd from the old one */
+    int oneshot;                    /* timer */
+    ing_ev_fn fd_fn;
+    ing_timer_fn timer_fn;
+    void *arg;
+} ev_handler_t;
+
+typedef struct ev_post_s {
+    ing_post_fn fn;
+    void *arg;
+    struct ev_post_s *next;
+} ev_post_t;
+
+struct ing_evloop_s {
+    int epfd;
+    int wakefd;
+    ev_handler_t *handlers;         /* indexed by fd */
+    int nhandlers;
+    uint32_t gen;
+    int stop;
+    pthread_mutex_t post_lock;
+    ev_post_t *posts;
+    ev_post_t **posts_tail;
+    pthread_t thread;
+    cpu_set_t cpus;                 /* affinity of the thread */
+    int pinned;                     /* cpus is set */
+    int has_thread;
+};
+
+static uint32_t ev2epoll(unsigned events)
+{
+    return (events & ING_EV_READ ? EPOLLIN : 0) | (events & ING_EV_WRITE ? EPOLLOUT : 0);
+}
+
+static unsigned epoll2ev(uint32_t events)
+{
+    return (events & (EPOLLIN | EPOLLPRI) ? ING_EV_READ : 0) |
+           (events & EPOLLOUT ? ING_EV_WRITE : 0) |
+           (events & (EPOLLERR | EPOLLHUP) ? ING_EV_ERROR : 0);
+}
+
+static ev_handler_t *handler_get(ing_evloop_t *loop, int fd)
+{
+    ev_handler_t *h;
+    int n;
+
+    if (fd < loop->nhandlers)
+        return &loop->handlers[fd];
+
+    n = loop->nhandlers ? loop->nhandlers : 64;
+    while (n <= fd)
+        n *= 2;
+    h = (ev_handler_t *)realloc(loop->handlers, n * sizeof(*h));
+    if (!h)
+        return NULL;
+    memset(h + loop->nhandlers, 0, (n - loop->nhandlers) * sizeof(*h));
+    loop->handlers = h;
+    loop->nhandlers = n;
+    return &h[fd];
+}
+
+static ing_stat_t handler_add(ing_evloop_t *loop, int fd, ev_type_t type, uint32_t events)
+{
+    struct epoll_event ev;
+    ev_handler_t *h;
+
+    if (fd < 0)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!(h = handler_get(loop, fd)))
+        return ING_STAT_OUTOFMEMORY;
+    if (h->type != EV_NONE)
+        return ING_STAT_ALREADY_EXISTS;
+
+    memset(h, 0, sizeof(*h));
+    h->type = type;
+    h->gen = ++loop->gen;
+    ev.events = events;
+    ev.data.u64 = (uint64_t)h->gen << 32 | (uint32_t)fd;
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): epoll_ctl(%d) failed: %s\n", __func__, __LINE__, fd, strerror(errno));
+        h->type = EV_NONE;
+        return ING_STAT_SYSTEM_ERROR;
+    }
+    return ING_STAT_OK;
+}
+
+static ev_handler_t *handler_find(ing_evloop_t *loop, int fd, ev_type_t type)
+{
+    if (!loop || fd < 0 || fd >= loop->nhandlers || loop->handlers[fd].type != type)
+        return NULL;
+    return &loop->handlers[fd];
+}
+
+ing_stat_t ing_evloop_create(ing_evloop_t **loop)
+{
+    ing_evloop_t *l;
+
+    if (!loop)
+        return ING_STAT_INVALID_ARGUMENT;
+    l = (ing_evloop_t *)calloc(1, sizeof(*l));
+    if (!l)
+        return ING_STAT_OUTOFMEMORY;
+
+    l->wakefd = -1;
+    l->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (l->epfd < 0 ||
+        (l->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): Cannot create loop: %s\n", __func__, __LINE__, strerror(errno));
+        goto fail;
+    }
+    if (handler_add(l, l->wakefd, EV_WAKE, EPOLLIN) != ING_STAT_OK)
+        goto fail;
+
+    pthread_mutex_init(&l->post_lock, NULL);
+    l->posts_tail = &l->posts;
+    l->pinned = FALSE;
+    *loop = l;
+    return ING_STAT_OK;
+
+fail:
+    if (l->wakefd >= 0)
+        close(l->wakefd);
+    if (l->epfd >= 0)
+        close(l->epfd);
+    free(l->handlers);
+    free(l);
+    return ING_STAT_SYSTEM_ERROR;
+}
+
+void ing_evloop_destroy(ing_evloop_t *loop)
+{
+    ev_post_t *p, *next;
+    int fd;
+
+    if (!loop)
+        return;
+    if (loop->has_thread)
+        ing_evloop_thread_join(loop);
+
+    for (fd = 0; fd < loop->nhandlers; fd++)
+    {
+        if (loop->handlers[fd].type == EV_TIMER)
+            close(fd);
+    }
+    for (p = loop->posts; p; p = next)
+    {
+        next = p->next;
+        free(p);
+    }
+    close(loop->wakefd);
+    close(loop->epfd);
+    pthread_mutex_destroy(&loop->post_lock);
+    free(loop->handlers);
+    free(loop);
+}
+
+ing_stat_t ing_evloop_add(ing_evloop_t *loop, int fd, unsigned events, ing_ev_fn fn, void *arg)
+{
+    ing_stat_t res;
+
+    if (!loop || !fn)
+        return ING_STAT_INVALID_ARGUMENT;
+    res = handler_add(loop, fd, EV_FD, ev2epoll(events));
+    if (res == ING_STAT_OK)
+    {
+        loop->handlers[fd].fd_fn = fn;
+        loop->handlers[fd].arg = arg;
+    }
+    return res;
+}
+
+ing_stat_t ing_evloop_mod(ing_evloop_t *loop, int fd, unsigned events)
+{
+    ev_handler_t *h = handler_find(loop, fd, EV_FD);
+    struct epoll_event ev;
+
+    if (!h)
+        return ING_STAT_NOT_FOUND;
+    ev.events = ev2epoll(events);
+    ev.data.u64 = (uint64_t)h->gen << 32 | (uint32_t)fd;
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_MOD, fd, &ev) < 0)
+        return ING_STAT_SYSTEM_ERROR;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_evloop_del(ing_evloop_t *loop, int fd)
+{
+    ev_handler_t *h = handler_find(loop, fd, EV_FD);
+
+    if (!h)
+        return ING_STAT_NOT_FOUND;
+    epoll_ctl(loop->epfd, EPOLL_CTL_DEL, fd, NULL);
+    h->type = EV_NONE;
+    return ING_STAT_OK;
+}
+
+int ing_evloop_timer_add(ing_evloop_t *loop, unsigned long ms, unsigned long interval_ms,
+    ing_timer_fn fn, void *arg)
+{
+    struct itimerspec its;
+    int fd;
+
+    if (!loop || !fn)
+        return -1;
+    fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): Cannot create timer: %s\n", __func__, __LINE__, strerror(errno));
+        return -1;
+    }
+
+    its.it_value.tv_sec = ms / 1000;
+    its.it_value.tv_nsec = (ms % 1000) * 1000000;
+    if (!ms)
+        its.it_value.tv_nsec = 1;   /* zero would disarm the timer */
+    its.it_interval.tv_sec = interval_ms / 1000;
+    its.it_interval.tv_nsec = (interval_ms % 1000) * 1000000;
+    if (timerfd_settime(fd, 0, &its, NULL) < 0 ||
+        handler_add(loop, fd, EV_TIMER, EPOLLIN) != ING_STAT_OK)
+    {
+        close(fd);
+        return -1;
+    }
+    loop->handlers[fd].timer_fn = fn;
+    loop->handlers[fd].arg = arg;
+    loop->handlers[fd].oneshot = !interval_ms;
+    return fd;
+}
+
+ing_stat_t ing_evloop_timer_del(ing_evloop_t *loop, int timer)
+{
+    ev_handler_t *h = handler_find(loop, timer, EV_TIMER);
+
+    if (!h)
+        return ING_STAT_NOT_FOUND;
+    epoll_ctl(loop->epfd, EPOLL_CTL_DEL, timer, NULL);
+    close(timer);
+    h->type = EV_NONE;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_evloop_post(ing_evloop_t *loop, ing_post_fn fn, void *arg)
+{
+    ev_post_t *p;
+    uint64_t one = 1;
+
+    if (!loop || !fn)
+        return ING_STAT_INVALID_ARGUMENT;
+    p = (ev_post_t *)malloc(sizeof(*p));
+    if (!p)
+        return ING_STAT_OUTOFMEMORY;
+    p->fn = fn;
+    p->arg = arg;
+    p->next = NULL;
+
+    pthread_mutex_lock(&loop->post_lock);
+    *loop->posts_tail = p;
+    loop->posts_tail = &p->next;
+    pthread_mutex_unlock(&loop->post_lock);
+
+    if (write(loop->wakefd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        return ING_STAT_SYSTEM_ERROR;
+    return ING_STAT_OK;
+}
+
+static void run_posts(ing_evloop_t *loop)
+{
+    ev_post_t *p, *next;
+    uint64_t cnt;
+
+    if (read(loop->wakefd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN)
+        ing_log(LOG_ERR, " %s (%d): read failed: %s\n", __func__, __LINE__, strerror(errno));
+
+    pthread_mutex_lock(&loop->post_lock);
+    p = loop->posts;
+    loop->posts = NULL;
+    loop->posts_tail = &loop->posts;
+    pthread_mutex_unlock(&loop->post_lock);
+
+    for (; p; p = next)
+    {
+        next = p->next;
+        p->fn(loop, p->arg);
+        free(p);
+    }
+}
+
+int ing_evloop_run_once(ing_evloop_t *loop, int timeout_ms)
+{
+    struct epoll_event evs[ING_EVLOOP_MAX_EVENTS];
+    ev_handler_t *h;
+    uint64_t expirations;
+    int i, n, fd;
+
+    if (!loop)
+        return -1;
+    n = epoll_wait(loop->epfd, evs, ING_EVLOOP_MAX_EVENTS, timeout_ms);
+    if (n < 0)
+    {
+        if (errno == EINTR)
+            return 0;
+        ing_log(LOG_ERR, " %s (%d): epoll_wait failed: %s\n", __func__, __LINE__, strerror(errno));
+        return -1;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        fd = (int)(uint32_t)evs[i].data.u64;
+        if (fd >= loop->nhandlers)
+            continue;
+        h = &loop->handlers[fd];
+        /* the fd could be removed (and reused) by a previous callback */
+        if (h->type == EV_NONE || h->gen != (uint32_t)(evs[i].data.u64 >> 32))
+            continue;
+
+        switch (h->type)
+        {
+        case EV_FD:
+            h->fd_fn(loop, fd, epoll2ev(evs[i].events), h->arg);
+            break;
+        case EV_TIMER:
+            if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+                break;
+            if (h->oneshot)
+            {
+                ing_timer_fn fn = h->timer_fn;
+                void *arg = h->arg;
+
+                ing_evloop_timer_del(loop, fd);
+                fn(loop, fd, arg);
+            }
+            else
+                h->timer_fn(loop, fd, h->arg);
+            break;
+        case EV_WAKE:
+            run_posts(loop);
+            break;
+        default:
+            break;
+        }
+    }
+    return n;
+}
+
+ing_stat_t ing_evloop_run(ing_evloop_t *loop)
+{
+    if (!loop)
+        return ING_STAT_INVALID_ARGUMENT;
+    while (!__atomic_load_n(&loop->stop, __ATOMIC_ACQUIRE))
+    {
+        if (ing_evloop_run_once(loop, -1) < 0)
+            return ING_STAT_SYSTEM_ERROR;
+    }
+    __atomic_store_n(&loop->stop, 0, __ATOMIC_RELAXED);
+    return ING_STAT_OK;
+}
+
+void ing_evloop_stop(ing_evloop_t *loop)
+{
+    uint64_t one = 1;
+
+    if (!loop)
+        return;
+    __atomic_store_n(&loop->stop, 1, __ATOMIC_RELEASE);
+    if (write(loop->wakefd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        ing_log(LOG_ERR, " %s (%d): write failed: %s\n", __func__, __LINE__, strerror(errno));
+}
+
+static int loop_first_cpu(const ing_evloop_t *loop)
+{
+    int cpu;
+
+    for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, &loop->cpus))
+            return cpu;
+    }
+    return -1;
+}
+
+static void *loop_thread(void *arg)
+{
+    ing_evloop_t *loop = (ing_evloop_t *)arg;
+
+    if (loop->pinned &&
+        (errno = pthread_setaffinity_np(pthread_self(), sizeof(loop->cpus), &loop->cpus)) != 0)
+        ing_log(LOG_ERR, " %s (%d): Cannot pin to cpu %d: %s\n", __func__, __LINE__,
+                loop_first_cpu(loop), strerror(errno));
+    ing_evloop_run(loop);
+    return NULL;
+}
+
+/* pins to cpus (NULL - not pinned) */
+static ing_stat_t loop_thread_start(ing_evloop_t *loop, const cpu_set_t *cpus)
+{
+    if (!loop || loop->has_thread)
+        return ING_STAT_INVALID_ARGUMENT;
+    loop->pinned = cpus != NULL;
+    if (cpus)
+        loop->cpus = *cpus;
+    if ((errno = pthread_create(&loop->thread, NULL, loop_thread, loop)) != 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): Cannot create thread: %s\n", __func__, __LINE__, strerror(errno));
+        return ING_STAT_SYSTEM_ERROR;
+    }
+    loop->has_thread = TRUE;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_evloop_thread_start(ing_evloop_t *loop, int cpu)
+{
+    cpu_set_t set;
+
+    if (cpu >= CPU_SETSIZE)
+        return ING_STAT_INVALID_ARGUMENT;
+    CPU_ZERO(&set);
+    if (cpu >= 0)
+        CPU_SET(cpu, &set);
+    return loop_thread_start(loop, cpu >= 0 ? &set : NULL);
+}
+
+void ing_evloop_thread_join(ing_evloop_t *loop)
+{
+    if (!loop || !loop->has_thread)
+        return;
+    ing_evloop_stop(loop);
+    pthread_join(loop->thread, NULL);
+    loop->has_thread = FALSE;
+}
+
+ing_stat_t ing_evloop_unix_socket(ing_evloop_t *loop, int *sock, const char *sun_name,
+    ing_ev_fn fn, void *arg)
+{
+    ing_stat_t res;
+
+    if (!loop || !sock || !fn)
+        return ING_STAT_INVALID_ARGUMENT;
+    *sock = -1;
+    res = unix_socket_init_ex(sock, sun_name, NULL, NULL, SOCK_NONBLOCK);
+    if (res == ING_STAT_OK)
+        res = ing_evloop_add(loop, *sock, ING_EV_READ, fn, arg);
+    if (res != ING_STAT_OK && *sock >= 0)
+    {
+        close(*sock);
+        *sock = -1;
+    }
+    return res;
+}
+
+ing_stat_t ing_evloop_udp_socket(ing_evloop_t *loop, int *sock, in_addr_t addr, in_port_t port,
+    ing_ev_fn fn, void *arg)
+{
+    ing_stat_t res;
+
+    if (!loop || !sock || !fn)
+        return ING_STAT_INVALID_ARGUMENT;
+    *sock = -1;
+    res = udp_socket_init_ex(sock, addr, port, SOCK_NONBLOCK);
+    if (res == ING_STAT_OK)
+        res = ing_evloop_add(loop, *sock, ING_EV_READ, fn, arg);
+    if (res != ING_STAT_OK && *sock >= 0)
+    {
+        close(*sock);
+        *sock = -1;
+    }
+    return res;
+}
+
+/* cpus c with c % n == i; with more threads than cpus, thread i gets
+ * the (i % ncpu)-th allowed cpu. NULL if no cpus are allowed at all
+ */
+static const cpu_set_t *group_cpus(const cpu_set_t *allowed, int ncpu, int i, int n, cpu_set_t *set)
+{
+    int cpu, k = 0;
+
+    if (!ncpu)
+        return NULL;
+    CPU_ZERO(set);
+    for (cpu = i; cpu < CPU_SETSIZE; cpu += n)
+    {
+        if (CPU_ISSET(cpu, allowed))
+            CPU_SET(cpu, set);
+    }
+    if (CPU_COUNT(set))
+        return set;
+
+    for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, allowed) && k++ == i % ncpu)
+        {
+            CPU_SET(cpu, set);
+            break;
+        }
+    }
+    return set;
+}
+
+ing_stat_t ing_evloop_udp_group_start(ing_evloop_t **loops, int *socks, int n,
+    in_addr_t addr, in_port_t port, const udp_group_opts_t *opts, ing_ev_fn fn, void *arg)
+{
+    udp_group_opts_t o = {0};
+    ing_stat_t res;
+    cpu_set_t allowed, set;
+    int i, cpu, ncpu;
+
+    if (!loops || !socks || n <= 0 || !fn)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (opts)
+        o = *opts;
+    o.flags |= SOCK_NONBLOCK;
+
+    /* the steering program selects socket (cpu % n) by the number of the
+     * receiving cpu, so thread i runs on exactly these cpus
+     */
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) < 0)
+    {
+        CPU_ZERO(&allowed);
+        for (cpu = 0; cpu < sysconf(_SC_NPROCESSORS_ONLN) && cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, &allowed);
+    }
+    ncpu = CPU_COUNT(&allowed);
+
+    for (i = 0; i < n; i++)
+        loops[i] = NULL;
+    if ((res = udp_socket_group_init(socks, n, addr, port, &o)) != ING_STAT_OK)
+        return res;
+
+    for (i = 0; i < n; i++)
+    {
+        if ((res = ing_evloop_create(&loops[i])) != ING_STAT_OK ||
+            (res = ing_evloop_add(loops[i], socks[i], ING_EV_READ, fn, arg)) != ING_STAT_OK ||
+            (res = loop_thread_start(loops[i], group_cpus(&allowed, ncpu, i, n, &set))) != ING_STAT_OK)
+        {
+            ing_evloop_udp_group_stop(loops, socks, n);
+            return res;
+        }
+    }
+    return ING_STAT_OK;
+}
+
+void ing_evloop_udp_group_stop(ing_evloop_t **loops, int *socks, int n)
+{
+    int i;
+
+    if (!loops || !socks)
+        return;
+    for (i = 0; i < n; i++)
+    {
+        if (!loops[i])
+            continue;
+        ing_evloop_thread_join(loops[i]);
+        ing_evloop_destroy(loops[i]);
+        loops[i] = NULL;
+    }
+    udp_socket_group_close(socks, n);
+}
@@ -0,0 +1,170 @@
+/* ing_evloop.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Event loop
+ *
+ * epoll reactor with per-fd callbacks, timerfd timers and eventfd based
+ * cross-thread wakeup. A loop is driven by one thread; run one loop per
+ * core (see ing_evloop_thread_start()) to use several cores.
+ *
+ * Only ing_evloop_post() and ing_evloop_stop() may be called from other
+ * threads; all other functions must be called from the loop thread (or
+ * before the loop is started).
+ */
+
+#ifndef ING_EVLOOP_H_
+#define ING_EVLOOP_H_
+
+#include "ing_gen_utils.h"
+
+#define ING_EV_READ     0x1
+#define ING_EV_WRITE    0x2
+#define ING_EV_ERROR    0x4     /* reported only: error or hang-up */
+
+#define ING_EVLOOP_MAX_EVENTS   64  /* events handled per epoll_wait() */
+
+typedef struct ing_evloop_s ing_evloop_t;
+
+/* events - ING_EV_* that occurred */
+typedef void (*ing_ev_fn)(ing_evloop_t *loop, int fd, unsigned events, void *arg);
+
+/* timer - id returned by ing_evloop_timer_add() */
+typedef void (*ing_timer_fn)(ing_evloop_t *loop, int timer, void *arg);
+
+typedef void (*ing_post_fn)(ing_evloop_t *loop, void *arg);
+
+ing_stat_t ing_evloop_create(ing_evloop_t **loop);
+
+/* closes loop descriptors; registered fds are not closed */
+void ing_evloop_destroy(ing_evloop_t *loop);
+
+/* register fd for events; fd should be non-blocking */
+ing_stat_t ing_evloop_add(ing_evloop_t *loop, int fd, unsigned events, ing_ev_fn fn, void *arg);
+
+ing_stat_t ing_evloop_mod(ing_evloop_t *loop, int fd, unsigned events);
+
+/* unregister fd; safe to call from any callback */
+ing_stat_t ing_evloop_del(ing_evloop_t *loop, int fd);
+
+/*
+ * Timers: fires after ms milliseconds, then every interval_ms
+ * (0 - one-shot timer, removed after it fires).
+ * Returns timer id or -1 on error
+ */
+int ing_evloop_timer_add(ing_evloop_t *loop, unsigned long ms, unsigned long interval_ms,
+    ing_timer_fn fn, void *arg);
+
+ing_stat_t ing_evloop_timer_del(ing_evloop_t *loop, int timer);
+
+/* calls fn(loop, arg) in the loop thread; thread-safe */
+ing_stat_t ing_evloop_post(ing_evloop_t *loop, ing_post_fn fn, void *arg);
+
+/* runs until ing_evloop_stop() */
+ing_stat_t ing_evloop_run(ing_evloop_t *loop);
+
+/* waits up to timeout_ms (-1 - infinitely) and handles events once;
+ * returns number of handled events or -1 on error
+ */
+int ing_evloop_run_once(ing_evloop_t *loop, int timeout_ms);
+
+/* makes ing_evloop_run() return; thread-safe */
+void ing_evloop_stop(ing_evloop_t *loop);
+
+/* runs the loop in a new thread pinned to cpu (-1 - not pinned) */
+ing_stat_t ing_evloop_thread_start(ing_evloop_t *loop, int cpu);
+
+/* stops the loop and waits for its thread */
+void ing_evloop_thread_join(ing_evloop_t *loop);
+
+/*
+ * Non-blocking variants of socket helpers registered in the loop for
+ * ING_EV_READ. On error the socket is closed
+ */
+ing_stat_t ing_evloop_unix_socket(ing_evloop_t *loop, int *sock, const char *sun_name,
+    ing_ev_fn fn, void *arg);
+
+ing_stat_t ing_evloop_udp_socket(ing_evloop_t *loop, int *sock, in_addr_t addr, in_port_t port,
+    ing_ev_fn fn, void *arg);
+
+/*
+ * Sharded UDP receivers: creates udp_socket_group_init() group of n
+ * non-blocking sockets and n loops, registers socket i in loop i and runs
+ * it in a thread pinned to the allowed cpus c with c % n == i, the cpus
+ * whose datagrams opts->cpu_steer delivers to socket i. Threads without
+ * such cpus (n is larger than the number of cpus) are spread over all
+ * allowed cpus; with cpu_steer their sockets get nothing, so keep n at most
+ * the number of cpus then. fn gets arg of its loop
+ */
+ing_stat_t ing_evloop_udp_group_start(ing_evloop_t **loops, int *socks, int n,
+    in_addr_t addr, in_port_t port, const udp_group_opts_t *opts, ing_ev_fn fn, void *arg);
+
+/* joins the loop threads, destroys the loops and closes the sockets */
+void ing_evloop_udp_group_stop(ing_evloop_t **loops, int *socks, int n);
+
+#endif /* ING_EVLOOP_H_ */
@@ -66,10 +66,15 @@
  *
  */
 
+#define _GNU_SOURCE
+
 #include <string.h>
 #include <errno.h>
-#include <sys/sysinfo.h>
+#include <linux/filter.h>
 #include "ing_gen_utils.h"
+#include "ing_clock.h"
+#include "ing_strkern.h"
+#include "ing_strbuf.h"
 
 
 ing_stat_t unix_socket_init(int *sock, const char *sun_name)
@@ -79,12 +84,18 @@ ing_stat_t unix_socket_init(int *sock, const char *sun_name)
 
 ing_stat_t unix_socket_init_full(int *sock, const char *sun_name,
     struct sockaddr_un *saddr, int *saddr_size)
+{
+    return unix_socket_init_ex(sock, sun_name, saddr, saddr_size, 0);
+}
+
+ing_stat_t unix_socket_init_ex(int *sock, const char *sun_name,
+    struct sockaddr_un *saddr, int *saddr_size, int flags)
 {
     int res;
     struct sockaddr_un addr = {0};
 
     /* create socket */
-    int s = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    int s = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC | flags, 0);
     if (s < 0)
     {
         ing_log(LOG_ERR," %s (%d):  Cannot create socket: %s\n", __func__, __LINE__, strerror(errno));
@@ -127,11 +138,16 @@ ing_stat_t unix_socket_init_full(int *sock, const char *sun_name,
 }
 
 ing_stat_t udp_socket_init(int *sock, in_addr_t addr, in_port_t port)
+{
+    return udp_socket_init_ex(sock, addr, port, 0);
+}
+
+ing_stat_t udp_socket_init_ex(int *sock, in_addr_t addr, in_port_t port, int flags)
 {
     struct sockaddr_in sock_addr = {0};
 
     /* create socket */
-    int s = socket(PF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+    int s = socket(PF_INET, SOCK_DGRAM | SOCK_CLOEXEC | flags, IPPROTO_UDP);
     if (s < 0)
     {
         ing_log(LOG_ERR," %s (%d): Cannot create socket: %s\n", __func__, __LINE__, strerror(errno));
@@ -157,116 +173,116 @@ ing_stat_t udp_socket_init(int *sock, in_addr_t addr, in_port_t port)
     return ING_STAT_OK;
 }
 
-/*
- * Writes current time to buf in the following format:
- *  dd.MM hh:mm:ss
- */
-static char *time2str(char *buf)
+static void sock_set_buf(int s, int opt, int size)
 {
-    time_t t = time(0);
-    struct tm *lt = localtime(&t);
-    sprintf(buf, "%02d.%02d %02d:%02d:%02d", (lt)->tm_mday,
-                 (lt)->tm_mon+1, (lt)->tm_hour, (lt)->tm_min, (lt)->tm_sec);
-    return buf;
+    if (size > 0 && setsockopt(s, SOL_SOCKET, opt, &size, sizeof(size)) < 0)
+        ing_log(LOG_WARNING," %s (%d): Cannot set %s: %s\n", __func__, __LINE__,
+            opt == SO_RCVBUF ? "SO_RCVBUF" : "SO_SNDBUF", strerror(errno));
 }
 
-static const char *priority2str(int priority)
+/* selects socket (cpu % n) of the reuseport group */
+static ing_stat_t udp_group_attach_cpu_steer(int s, int n)
 {
-    switch(priority)
-    {
-    case LOG_DEBUG: return "DEBUG";
-    case LOG_INFO:  return "INFO ";
-    case LOG_ERR:   return "ERROR";
-    case LOG_CRIT:  return "CRIT ";
+    struct sock_filter code[] = {
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF + SKF_AD_CPU },
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t)n },
+        { BPF_RET | BPF_A, 0, 0, 0 },
     };
-    return "UNKNW";
-}
+    struct sock_fprog prog = { sizeof(code) / sizeof(code[0]), code };
 
-static void vflog(FILE *file, int priority, char *msg, va_list arglist)
-{
-    char buf[64];
-    time2str(buf);
-    strcat(buf, " |");
-    fputs(buf, file);
-    sprintf(buf, "%s| ", priority2str(priority));
-    fputs(buf, file);
-    vfprintf(file, msg, arglist);
-    fflush(file);
+    if (setsockopt(s, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0)
+    {
+        ing_log(LOG_ERR," %s (%d): Cannot attach steering program: %s\n", __func__, __LINE__, strerror(errno));
+        return ING_STAT_SYSTEM_ERROR;
+    }
+    return ING_STAT_OK;
 }
 
-void ing_openlog(void)
+ing_stat_t udp_socket_group_init(int *socks, int n, in_addr_t addr, in_port_t port,
+    const udp_group_opts_t *opts)
 {
-#if USE_SYSLOG
-    openlog("EP", LOG_CONS | LOG_PID | LOG_NDELAY, LOG_DAEMON);
-#endif
-}
+    struct sockaddr_in sock_addr = {0};
+    udp_group_opts_t def = {0};
+    int i, s, one = 1;
 
-void ing_closelog(void)
-{
-#if USE_SYSLOG
-    closelog();
-#endif
-}
+    if (!socks || n <= 0 || !port)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!opts)
+        opts = &def;
 
-void ing_log(int priority, char *msg, ...)
-{
-    va_list arg;
-    va_start(arg, msg);
-#if USE_SYSLOG
-    extern char *program_invocation_name;
-    openlog(program_invocation_name, LOG_PID|LOG_NDELAY, LOG_DAEMON);
-    vsyslog(priority, msg, arg);
-#else
-    vflog(stdout, priority, msg, arg);
-#endif
-    va_end(arg);
+    for (i = 0; i < n; i++)
+        socks[i] = -1;
+
+    sock_addr.sin_family = AF_INET;
+    sock_addr.sin_addr.s_addr = htonl(addr);
+    sock_addr.sin_port = htons(port);
+
+    /* sockets join the group in bind order, which is the steering index */
+    for (i = 0; i < n; i++)
+    {
+        s = socket(PF_INET, SOCK_DGRAM | SOCK_CLOEXEC | opts->flags, IPPROTO_UDP);
+        if (s < 0)
+        {
+            ing_log(LOG_ERR," %s (%d): Cannot create socket: %s\n", __func__, __LINE__, strerror(errno));
+            udp_socket_group_close(socks, n);
+            return ING_STAT_SYSTEM_ERROR;
+        }
+        socks[i] = s;
+
+        if (setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0 ||
+            bind(s, (struct sockaddr *)&sock_addr, sizeof(sock_addr)) < 0)
+        {
+            ing_log(LOG_ERR," %s (%d): Cannot bind socket: %s\n", __func__, __LINE__, strerror(errno));
+            udp_socket_group_close(socks, n);
+            return ING_STAT_SYSTEM_ERROR;
+        }
+        sock_set_buf(s, SO_RCVBUF, opts->rcvbuf);
+        sock_set_buf(s, SO_SNDBUF, opts->sndbuf);
+    }
+
+    if (opts->cpu_steer && n > 1 && udp_group_attach_cpu_steer(socks[0], n) != ING_STAT_OK)
+    {
+        udp_socket_group_close(socks, n);
+        return ING_STAT_SYSTEM_ERROR;
+    }
+    return ING_STAT_OK;
 }
 
-/* This message is written to cg_critical_err.log file regardless of log level
- * Only one message is stored, old ones will be rewritten
- */
-void ing_log_critical(char *msg, ...)
+void udp_socket_group_close(int *socks, int n)
 {
-    char buf[128];
-    strcpy(buf, getenv("INANGOLOGPATH"));
-    strcat(buf, "/cg_critical_err.log");
-    FILE *f = fopen(buf, "w");
-    if (f)
+    int i;
+
+    if (!socks)
+        return;
+    for (i = 0; i < n; i++)
     {
-        va_list arg;
-
-        va_start(arg, msg);
-        vflog(f, LOG_CRIT, msg, arg);
-        va_end(arg);
-
-#if USE_SYSLOG
-        va_start(arg, msg);
-        vsyslog(LOG_CRIT, msg, arg);
-        va_end(arg);
-#else
-        va_start(arg, msg);
-        vflog(stderr, LOG_CRIT, msg, arg);
-        va_end(arg);
-#endif
-        fclose(f);
+        if (socks[i] >= 0)
+            close(socks[i]);
+        socks[i] = -1;
     }
 }
 
 inline char *strcat_safe(char *to, const char *from, size_t to_len)
 {
-	if ((to == NULL) || (from == NULL))
-	    return NULL;
-	 
-    if (to_len - strlen(to) > strlen(from))
-        return strcat(to, from);
+    ing_strbuf_t sb;
+
+    if ((to == NULL) || (from == NULL))
+        return NULL;
+
+    if (ing_strbuf_init_fixed(&sb, to, to_len, strlen(to)) == ING_STAT_OK &&
+        ing_strbuf_append(&sb, from, strlen(from)) == ING_STAT_OK)
+        return to;
     else
         return NULL;
 }
 
 inline char *strcpy_safe(char *to, const char *from, size_t to_len)
 {
-    if (to && from && to_len > strlen(from))
-        return strcpy(to, from);
+    ing_strbuf_t sb;
+
+    if (to && from && ing_strbuf_init_fixed(&sb, to, to_len, 0) == ING_STAT_OK &&
+        ing_strbuf_set(&sb, from, strlen(from)) == ING_STAT_OK)
+        return to;
     else
         return NULL;
 }
@@ -275,14 +291,28 @@ char *rstrstr(const char *s1, const char *s2)
 {
     size_t s1len = strlen(s1);
     size_t s2len = strlen(s2);
-    char *s;
+    const char *s;
+    size_t n;
 
     if (s2len > s1len)
         return NULL;
-
-    for (s = (char *)s1 + s1len - s2len; s >= s1; s--)
-        if (strncmp(s, s2, s2len) == 0)
-            return s;
+    if (!s2len)
+        return (char *)s1 + s1len;
+
+    /*
+     * candidates are the occurrences of the first character, last first;
+     * the position next to the previous one is checked inline, which keeps
+     * text where the character is frequent from calling memrchr() per byte
+     */
+    for (n = s1len - s2len + 1; n > 0; n = s - s1)
+    {
+        if (s1[n - 1] == s2[0])
+            s = s1 + n - 1;
+        else if (!(s = memrchr(s1, s2[0], n - 1)))
+            break;
+        if (memcmp(s + 1, s2 + 1, s2len - 1) == 0)
+            return (char *)s;
+    }
 
     return NULL;
 }
@@ -290,14 +320,14 @@ char *rstrstr(const char *s1, const char *s2)
 char *trim(char *str)
 {
     if (!str) return NULL;
-    char *p;
-    for (p = str; *p == ' ' || *p == '\t' || *p == '\n' ||  *p == '\r'; p++)
-        ;
-    memmove(str, p, strlen(p)+1);
-    for (p = p + strlen(p) - 1; 
-         p >= str && (*p == ' ' || *p == '\t' || *p == '\n' ||  *p == '\r' || *p == '\0');
-         p--)
-        *p = '\0';
+    size_t len = strlen(str);
+    size_t lead = ing_str_span_space(str, len);
+
+    len -= lead;
+    len -= ing_str_rspan_space(str + lead, len);
+    if (lead)
+        memmove(str, str + lead, len);
+    str[len] = '\0';
     return str;
 }
 
@@ -315,42 +345,45 @@ char *trim_quotes(char *str)
 
 int str_replace(char *str, size_t str_size, const char *placeholder, const char *replacement)
 {
+    ing_strbuf_t sb;
+    size_t count;
+
     if (!str || !placeholder || !replacement)
         return 1;
-    char *p_ph = strstr(str, placeholder);
-    if (!p_ph)
-        return 2;
-    size_t sv_len = strlen(replacement);
-    if (strlen(str) - strlen(placeholder) + sv_len >= str_size)
+    if (ing_strbuf_init_fixed(&sb, str, str_size, strlen(str)) != ING_STAT_OK)
         return 3;
-    memmove(p_ph+sv_len, p_ph+strlen(placeholder), strlen(p_ph)-1);
-    memmove(p_ph, replacement, sv_len);
-    return 0;
+    /* an empty placeholder is found at the start, as strstr() finds it */
+    if (!*placeholder)
+    {
+        count = strlen(replacement);
+        if (sb.len + count >= str_size)
+            return 3;
+        memmove(str + count, str, sb.len + 1);
+        memcpy(str, replacement, count);
+        return 0;
+    }
+    switch (ing_strbuf_replace(&sb, placeholder, replacement, 1, &count))
+    {
+    case ING_STAT_OK:
+        return count ? 0 : 2;
+    case ING_STAT_INVALID_ARGUMENT:
+        return 1;
+    default:
+        return 3;
+    }
 }
 
 char *str_toupper(char *str)
 {
     if (!str) return NULL;
-    char *p = str;
-    while (*p != '\0')
-    {
-        *p = (char) toupper((unsigned char) *p);
-        ++p;
-    }
-
+    ing_str_ascii_upper(str, strlen(str));
     return str;
 }
 
 char *str_tolower(char *str)
 {
     if (!str) return NULL;
-    char *p = str;
-    while (*p != '\0')
-    {
-        *p = (char) tolower((unsigned char) *p);
-        ++p;
-    }
-
+    ing_str_ascii_lower(str, strlen(str));
     return str;
 }
 
@@ -360,12 +393,5 @@ char *str_tolower(char *str)
  */
 long get_uptime()
 {
-    struct sysinfo s_info;
-    
-    if(sysinfo(&s_info) != 0)
-    {
-		ing_log(LOG_ERR," %s (%d): Couldn't get uptime: %s\n", __func__, __LINE__, strerror(errno));
-        return 0;
-    }
-    return s_info.uptime;
+    return ing_clock_uptime();
 }
@@ -90,7 +90,8 @@ typedef enum ing_stat_e {
     ING_STAT_OUTOFMEMORY,
     ING_STAT_ALREADY_EXISTS,
     ING_STAT_NOT_FOUND,
-    ING_STAT_FULL
+    ING_STAT_FULL,
+    ING_STAT_TIMEOUT
 
 } ing_stat_t;
 
@@ -108,6 +109,12 @@ typedef struct nvpair_s {
     char *pValue;
 } nvpair_t;
 
+/* not owned, not necessarily '\0'-terminated string */
+typedef struct ing_strview_s {
+    const char *ptr;
+    size_t len;
+} ing_strview_t;
+
 
 //typedef char    BOOL;
 #define TRUE    1
@@ -145,8 +152,10 @@ void ing_closelog(void);
  */
 void ing_log(int priority, char *msg, ...);
 
-/* This message is written to cg_critical_err.log file regardless of log level
- * Only one message is stored, old ones will be rewritten
+/* This message is written to the critical log regardless of log level.
+ * After ing_openlog() the last ING_LOG_CRIT_SLOTS messages are kept in
+ * mmaped cg_critical_err.ring (see ing_log.h); otherwise only one message
+ * is stored in cg_critical_err.log, old ones will be rewritten
  */
 void ing_log_critical(char *msg, ...);
 
@@ -174,6 +183,34 @@ ing_stat_t unix_socket_init_full(int *sock, const char *sun_name,
  */
 ing_stat_t udp_socket_init(int *sock, in_addr_t addr, in_port_t port);
 
+/*
+ * Same as unix_socket_init_full()/udp_socket_init() with extra socket type
+ * flags, e.g. SOCK_NONBLOCK
+ */
+ing_stat_t unix_socket_init_ex(int *sock, const char *sun_name,
+    struct sockaddr_un *saddr, int *saddr_size, int flags);
+
+ing_stat_t udp_socket_init_ex(int *sock, in_addr_t addr, in_port_t port, int flags);
+
+typedef struct udp_group_opts_s {
+    int flags;          /* socket type flags, e.g. SOCK_NONBLOCK */
+    int rcvbuf;         /* SO_RCVBUF, 0 - system default */
+    int sndbuf;         /* SO_SNDBUF, 0 - system default */
+    int cpu_steer;      /* deliver datagrams to socket (receiving cpu % n) */
+} udp_group_opts_t;
+
+/*
+ * Creates n UDP sockets bound to the same addr and port with SO_REUSEPORT,
+ * so the kernel spreads incoming datagrams over them (by flow hash, or by
+ * receiving CPU with cpu_steer). Each socket is meant for its own worker,
+ * socket i on cpu i. opts may be NULL. Arguments addr and port must be
+ * provided in a host byte order
+ */
+ing_stat_t udp_socket_group_init(int *socks, int n, in_addr_t addr, in_port_t port,
+    const udp_group_opts_t *opts);
+
+void udp_socket_group_close(int *socks, int n);
+
 char *rstrstr(const char *s1, const char *s2);
 
 char *trim(char *str);
@@ -186,7 +223,9 @@ char *str_tolower(char *str);
 
 /*
  * Replaces the first occurrence of `placeholder' in `str' of size `str_size'
- * by `replacement'
+ * by `replacement'; an empty `placeholder' matches at the start of `str'.
+ * Returns 0 on success, 1 on invalid arguments, 2 if `placeholder' is not
+ * found and 3 if the result does not fit
  */
 int str_replace(char *str, size_t str_size, const char *placeholder, const char *replacement);
 
@@ -0,0 +1,965 @@
+/* ing_io.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * I/O engine implementation
+ *
+ * io_uring is used through raw system calls, so there is no liburing
+ * dependency. Completions are signalled to the event loop through an
+ * eventfd registered with the ring. Receive buffers are a provided buffer
+ * ring: the kernel picks a buffer per datagram and the buffer is given back
+ * after the callback returns. A socket whose multishot receive is rejected
+ * by an older kernel is moved to epoll.
+ */
+
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#if USE_IO_URING
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/io_uring.h>
+#endif
+
+#include "ing_io.h"
+
+#define IO_RECV_BUDGET  64      /* datagrams received per epoll event */
+#define IO_BGID         0       /* provided buffer group */
+
+enum {
+    IO_OP_RECV = 1,
+    IO_OP_WRITE
+};
+
+typedef struct io_op_s {
+    int type;
+    int fd;
+    int uring;                  /* submitted to io_uring */
+    int stopping;               /* cancelled, waiting for the last completion */
+    struct io_op_s *next;
+    struct io_op_s *all_prev;   /* all allocated ops, for ing_io_destroy() */
+    struct io_op_s *all_next;
+    /* receive */
+    ing_io_recv_fn recv_fn;
+    struct msghdr msg;          /* multishot recvmsg template */
+    /* write */
+    ing_io_done_fn done_fn;
+    const void *buf;
+    size_t len;
+    int64_t off;
+    unsigned batch;             /* ing_io_submit() count when queued */
+    void *arg;
+} io_op_t;
+
+/* write state of an fd */
+typedef struct {
+    io_op_t *held;              /* io_uring: writes waiting for the ones in flight */
+    io_op_t *held_last;
+    unsigned inflight;          /* io_uring: writes in the ring */
+    int failed;                 /* a write of failed_batch failed */
+    unsigned failed_batch;
+} io_wfd_t;
+
+struct ing_io_s {
+    ing_evloop_t *loop;
+    io_op_t *recvs;             /* active receive ops */
+    io_op_t *free_ops;
+    io_op_t *all_ops;
+    io_op_t *wq;                /* epoll: queued writes */
+    io_op_t **wq_tail;
+    io_wfd_t *wfds;             /* indexed by fd */
+    int nwfds;
+    unsigned batch;
+    size_t buf_size;
+    char *rbuf;                 /* epoll receive buffer */
+    size_t ubuf_size;           /* io_uring buffer: header, address, payload */
+#if USE_IO_URING
+    int ring_fd;
+    int efd;
+    unsigned sq_entries;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_flags;
+    unsigned *sq_array;
+    struct io_uring_sqe *sqes;
+    unsigned sqe_tail;          /* local tail, published by submit */
+    unsigned sqe_submitted;
+    struct io_uring_sqe *last_write;    /* write in the last unsubmitted entry */
+    int held_issued;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_cqe *cqes;
+    void *sq_map;
+    size_t sq_map_size;
+    void *cq_map;
+    size_t cq_map_size;
+    size_t sqes_size;
+    struct io_uring_buf_ring *br;
+    size_t br_size;
+    unsigned nbufs;
+    char *bufs;
+#endif
+};
+
+static io_op_t *op_get(ing_io_t *io, int type, int fd)
+{
+    io_op_t *op = io->free_ops;
+
+    if (op)
+        io->free_ops = op->next;
+    else if (!(op = (io_op_t *)malloc(sizeof(*op))))
+        return NULL;
+    memset(op, 0, sizeof(*op));
+    op->type = type;
+    op->fd = fd;
+    op->all_next = io->all_ops;
+    if (io->all_ops)
+        io->all_ops->all_prev = op;
+    io->all_ops = op;
+    return op;
+}
+
+static void op_put(ing_io_t *io, io_op_t *op)
+{
+    if (op->all_prev)
+        op->all_prev->all_next = op->all_next;
+    else
+        io->all_ops = op->all_next;
+    if (op->all_next)
+        op->all_next->all_prev = op->all_prev;
+    op->next = io->free_ops;
+    io->free_ops = op;
+}
+
+static io_wfd_t *wfd_get(ing_io_t *io, int fd)
+{
+    io_wfd_t *w;
+    int n;
+
+    if (fd < io->nwfds)
+        return &io->wfds[fd];
+    n = io->nwfds ? io->nwfds : 64;
+    while (n <= fd)
+        n <<= 1;
+    w = (io_wfd_t *)realloc(io->wfds, n * sizeof(*w));
+    if (!w)
+        return NULL;
+    memset(w + io->nwfds, 0, (n - io->nwfds) * sizeof(*w));
+    io->wfds = w;
+    io->nwfds = n;
+    return &w[fd];
+}
+
+/* records result of a write, the following writes of its batch are cancelled on failure */
+static void wfd_result(ing_io_t *io, io_op_t *op, ssize_t res)
+{
+    io_wfd_t *w = &io->wfds[op->fd];
+
+    if (res < 0 || (size_t)res != op->len)
+    {
+        w->failed = TRUE;
+        w->failed_batch = op->batch;
+    }
+}
+
+static int wfd_cancelled(ing_io_t *io, io_op_t *op)
+{
+    io_wfd_t *w = &io->wfds[op->fd];
+
+    return w->failed && w->failed_batch == op->batch;
+}
+
+static void recv_unlink(ing_io_t *io, io_op_t *op)
+{
+    io_op_t **p;
+
+    for (p = &io->recvs; *p; p = &(*p)->next)
+    {
+        if (*p == op)
+        {
+            *p = op->next;
+            return;
+        }
+    }
+}
+
+static io_op_t *recv_find(ing_io_t *io, int fd)
+{
+    io_op_t *op;
+
+    for (op = io->recvs; op; op = op->next)
+    {
+        if (op->fd == fd && !op->stopping)
+            return op;
+    }
+    return NULL;
+}
+
+/* epoll receive path */
+static void epoll_recv(ing_evloop_t *loop, int fd, unsigned events, void *arg)
+{
+    ing_io_t *io = (ing_io_t *)arg;
+    struct sockaddr_storage addr;
+    struct msghdr msg;
+    struct iovec iov;
+    io_op_t *op;
+    ssize_t n;
+    int i;
+
+    (void)loop;
+    (void)events;
+
+    for (i = 0; i < IO_RECV_BUDGET; i++)
+    {
+        /* the callback may stop receiving */
+        if (!(op = recv_find(io, fd)))
+            return;
+
+        iov.iov_base = io->rbuf;
+        iov.iov_len = io->buf_size;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &addr;
+        msg.msg_namelen = sizeof(addr);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        n = recvmsg(fd, &msg, MSG_DONTWAIT);
+        if (n < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                ing_log(LOG_ERR, " %s (%d): recvmsg failed: %s\n", __func__, __LINE__, strerror(errno));
+            return;
+        }
+        op->recv_fn(io, fd, io->rbuf, (size_t)n, msg.msg_namelen ? (struct sockaddr *)&addr : NULL,
+            msg.msg_namelen, op->arg);
+    }
+}
+
+static ing_stat_t epoll_recv_start(ing_io_t *io, io_op_t *op)
+{
+    op->uring = FALSE;
+    return ing_evloop_add(io->loop, op->fd, ING_EV_READ, epoll_recv, io);
+}
+
+/* epoll write path: performs queued writes in order */
+static void epoll_submit(ing_io_t *io)
+{
+    io_op_t *op, *next;
+    ssize_t n;
+
+    op = io->wq;
+    io->wq = NULL;
+    io->wq_tail = &io->wq;
+
+    for (; op; op = next)
+    {
+        next = op->next;
+        if (wfd_cancelled(io, op))
+            n = -ECANCELED;
+        else
+        {
+            do
+            {
+                n = op->off >= 0 ? pwrite(op->fd, op->buf, op->len, (off_t)op->off) :
+                    write(op->fd, op->buf, op->len);
+            } while (n < 0 && errno == EINTR);
+            if (n < 0)
+                n = -errno;
+            wfd_result(io, op, n);
+        }
+        if (op->done_fn)
+            op->done_fn(io, op->fd, n, op->arg);
+        op_put(io, op);
+    }
+}
+
+#if USE_IO_URING
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *p)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static void uring_cqe_ready(ing_evloop_t *loop, int fd, unsigned events, void *arg);
+
+static void buf_put(ing_io_t *io, unsigned bid, unsigned offset)
+{
+    unsigned mask = io->nbufs - 1;
+    struct io_uring_buf *b = &io->br->bufs[(io->br->tail + offset) & mask];
+
+    b->addr = (uint64_t)(uintptr_t)(io->bufs + (size_t)bid * io->ubuf_size);
+    b->len = (uint32_t)io->ubuf_size;
+    b->bid = (uint16_t)bid;
+}
+
+static void buf_commit(ing_io_t *io, unsigned count)
+{
+    __atomic_store_n(&io->br->tail, (uint16_t)(io->br->tail + count), __ATOMIC_RELEASE);
+}
+
+static void uring_free(ing_io_t *io)
+{
+    if (io->ring_fd >= 0)
+        close(io->ring_fd);
+    if (io->efd >= 0)
+        close(io->efd);
+    if (io->sqes)
+        munmap(io->sqes, io->sqes_size);
+    if (io->cq_map && io->cq_map != io->sq_map)
+        munmap(io->cq_map, io->cq_map_size);
+    if (io->sq_map)
+        munmap(io->sq_map, io->sq_map_size);
+    if (io->br)
+        munmap(io->br, io->br_size);
+    free(io->bufs);
+    io->ring_fd = io->efd = -1;
+    io->sqes = NULL;
+    io->sq_map = io->cq_map = NULL;
+    io->br = NULL;
+    io->bufs = NULL;
+}
+
+static ing_stat_t uring_init(ing_io_t *io, unsigned nbufs)
+{
+    struct io_uring_params p;
+    struct io_uring_buf_reg reg;
+    char *sq, *cq;
+    unsigned i;
+
+    io->ring_fd = io->efd = -1;
+
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = ING_IO_ENTRIES * 4;   /* room for multishot completions */
+    io->ring_fd = sys_io_uring_setup(ING_IO_ENTRIES, &p);
+    if (io->ring_fd < 0)
+        return ING_STAT_NOT_FOUND;
+    if (!(p.features & IORING_FEAT_NODROP))
+        goto unsupported;
+
+    io->sq_map_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    io->cq_map_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (io->cq_map_size > io->sq_map_size)
+            io->sq_map_size = io->cq_map_size;
+        io->cq_map_size = io->sq_map_size;
+    }
+    io->sq_map = mmap(NULL, io->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        io->ring_fd, IORING_OFF_SQ_RING);
+    if (io->sq_map == MAP_FAILED)
+    {
+        io->sq_map = NULL;
+        goto unsupported;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        io->cq_map = io->sq_map;
+    else
+    {
+        io->cq_map = mmap(NULL, io->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            io->ring_fd, IORING_OFF_CQ_RING);
+        if (io->cq_map == MAP_FAILED)
+        {
+            io->cq_map = NULL;
+            goto unsupported;
+        }
+    }
+    io->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    io->sqes = (struct io_uring_sqe *)mmap(NULL, io->sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, io->ring_fd, IORING_OFF_SQES);
+    if (io->sqes == MAP_FAILED)
+    {
+        io->sqes = NULL;
+        goto unsupported;
+    }
+
+    sq = (char *)io->sq_map;
+    cq = (char *)io->cq_map;
+    io->sq_entries = p.sq_entries;
+    io->sq_head = (unsigned *)(sq + p.sq_off.head);
+    io->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+    io->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+    io->sq_flags = (unsigned *)(sq + p.sq_off.flags);
+    io->sq_array = (unsigned *)(sq + p.sq_off.array);
+    io->cq_head = (unsigned *)(cq + p.cq_off.head);
+    io->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+    io->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+    io->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    io->sqe_tail = io->sqe_submitted = *io->sq_tail;
+
+    /* provided buffer ring for multishot receive */
+    io->nbufs = nbufs;
+    io->br_size = nbufs * sizeof(struct io_uring_buf);
+    io->br = (struct io_uring_buf_ring *)mmap(NULL, io->br_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    io->ubuf_size = sizeof(struct io_uring_recvmsg_out) + sizeof(struct sockaddr_storage) +
+        io->buf_size;
+    io->bufs = (char *)malloc((size_t)nbufs * io->ubuf_size);
+    if (io->br == MAP_FAILED || !io->bufs)
+    {
+        if (io->br == MAP_FAILED)
+            io->br = NULL;
+        goto unsupported;
+    }
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)io->br;
+    reg.ring_entries = nbufs;
+    reg.bgid = IO_BGID;
+    if (sys_io_uring_register(io->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+        goto unsupported;
+    io->br->tail = 0;
+    for (i = 0; i < nbufs; i++)
+        buf_put(io, i, i);
+    buf_commit(io, nbufs);
+
+    io->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (io->efd < 0 ||
+        sys_io_uring_register(io->ring_fd, IORING_REGISTER_EVENTFD, &io->efd, 1) < 0 ||
+        ing_evloop_add(io->loop, io->efd, ING_EV_READ, uring_cqe_ready, io) != ING_STAT_OK)
+        goto unsupported;
+    return ING_STAT_OK;
+
+unsupported:
+    uring_free(io);
+    return ING_STAT_NOT_FOUND;
+}
+
+static struct io_uring_sqe *sqe_get(ing_io_t *io)
+{
+    struct io_uring_sqe *sqe;
+    unsigned head, idx;
+
+    head = __atomic_load_n(io->sq_head, __ATOMIC_ACQUIRE);
+    if (io->sqe_tail - head >= io->sq_entries)
+    {
+        if (ing_io_submit(io) != ING_STAT_OK)
+            return NULL;
+        head = __atomic_load_n(io->sq_head, __ATOMIC_ACQUIRE);
+        if (io->sqe_tail - head >= io->sq_entries)
+            return NULL;
+    }
+    /* last_write is only valid while it is the last entry */
+    io->last_write = NULL;
+    idx = io->sqe_tail & *io->sq_mask;
+    sqe = &io->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    io->sq_array[idx] = idx;
+    io->sqe_tail++;
+    return sqe;
+}
+
+static ing_stat_t uring_recv_arm(ing_io_t *io, io_op_t *op)
+{
+    struct io_uring_sqe *sqe;
+
+    if (!(sqe = sqe_get(io)))
+        return ING_STAT_FULL;
+
+    memset(&op->msg, 0, sizeof(op->msg));
+    op->msg.msg_namelen = sizeof(struct sockaddr_storage);
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = op->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&op->msg;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = IO_BGID;
+    sqe->user_data = (uint64_t)(uintptr_t)op;
+    op->uring = TRUE;
+    return ing_io_submit(io);
+}
+
+static void uring_recv_done(ing_io_t *io, io_op_t *op, struct io_uring_cqe *cqe)
+{
+    struct io_uring_recvmsg_out *out;
+    unsigned bid;
+    size_t off, len, namelen;
+    char *buf;
+
+    if (cqe->flags & IORING_CQE_F_BUFFER)
+    {
+        bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        buf = io->bufs + (size_t)bid * io->ubuf_size;
+        out = (struct io_uring_recvmsg_out *)buf;
+        if (cqe->res >= (int)sizeof(*out) && !op->stopping)
+        {
+            namelen = out->namelen < op->msg.msg_namelen ? out->namelen : op->msg.msg_namelen;
+            off = sizeof(*out) + op->msg.msg_namelen + op->msg.msg_controllen;
+            len = (size_t)cqe->res > off ? (size_t)cqe->res - off : 0;
+            if (len > out->payloadlen)
+                len = out->payloadlen;
+            op->recv_fn(io, op->fd, buf + off, len,
+                namelen ? (struct sockaddr *)(buf + sizeof(*out)) : NULL,
+                (socklen_t)namelen, op->arg);
+        }
+        buf_put(io, bid, 0);
+        buf_commit(io, 1);
+    }
+
+    if (cqe->flags & IORING_CQE_F_MORE)
+        return;
+
+    /* multishot request has ended */
+    if (op->stopping)
+    {
+        op_put(io, op);
+        return;
+    }
+    if (cqe->res == -EINVAL || cqe->res == -EOPNOTSUPP)
+    {
+        ing_log(LOG_INFO, " %s (%d): multishot receive is not supported, using epoll\n",
+            __func__, __LINE__);
+        if (epoll_recv_start(io, op) != ING_STAT_OK)
+        {
+            recv_unlink(io, op);
+            op_put(io, op);
+        }
+        return;
+    }
+    if (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -EINTR && cqe->res != -EAGAIN)
+    {
+        ing_log(LOG_ERR, " %s (%d): receive on %d failed: %s\n", __func__, __LINE__,
+            op->fd, strerror(-cqe->res));
+        recv_unlink(io, op);
+        op_put(io, op);
+        return;
+    }
+    /* out of buffers or a transient error: buffers are back, re-arm */
+    if (uring_recv_arm(io, op) != ING_STAT_OK)
+    {
+        recv_unlink(io, op);
+        op_put(io, op);
+    }
+}
+
+/*
+ * A write is ordered after a write of the same fd in the ring only by linking
+ * it to the entry just before it, in the same submission (a chain ends at
+ * io_uring_enter()) and batch. Other writes are held until the fd has no
+ * writes in flight.
+ */
+static int uring_write_ready(ing_io_t *io, io_wfd_t *w, io_op_t *op)
+{
+    io_op_t *last;
+
+    if (!w->inflight)
+        return TRUE;
+    if (!io->last_write || io->last_write->fd != op->fd)
+        return FALSE;
+    last = (io_op_t *)(uintptr_t)io->last_write->user_data;
+    return last->batch == op->batch &&
+        io->sqe_tail - __atomic_load_n(io->sq_head, __ATOMIC_ACQUIRE) < io->sq_entries;
+}
+
+static ing_stat_t uring_write_issue(ing_io_t *io, io_wfd_t *w, io_op_t *op)
+{
+    struct io_uring_sqe *sqe;
+
+    /* the ring has room for the linked entry, see uring_write_ready() */
+    if (w->inflight)
+        io->last_write->flags |= IOSQE_IO_LINK;
+    if (!(sqe = sqe_get(io)))
+        return ING_STAT_FULL;
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = op->fd;
+    sqe->addr = (uint64_t)(uintptr_t)op->buf;
+    sqe->len = (uint32_t)op->len;
+    sqe->off = op->off >= 0 ? (uint64_t)op->off : (uint64_t)-1;
+    sqe->user_data = (uint64_t)(uintptr_t)op;
+    op->uring = TRUE;
+    io->last_write = sqe;
+    w->inflight++;
+    return ING_STAT_OK;
+}
+
+/* issues held writes of fd, returns TRUE if any was queued to the ring */
+static int uring_write_held(ing_io_t *io, int fd)
+{
+    io_wfd_t *w = &io->wfds[fd];
+    int issued = FALSE;
+    io_op_t *op;
+
+    while ((op = w->held) && (wfd_cancelled(io, op) || uring_write_ready(io, w, op)))
+    {
+        w->held = op->next;
+        if (!w->held)
+            w->held_last = NULL;
+        op->next = NULL;
+        if (!wfd_cancelled(io, op) && uring_write_issue(io, w, op) == ING_STAT_OK)
+        {
+            issued = TRUE;
+            continue;
+        }
+        if (op->done_fn)
+            op->done_fn(io, fd, wfd_cancelled(io, op) ? -ECANCELED : -EAGAIN, op->arg);
+        op_put(io, op);
+        /* the callback may queue writes */
+        w = &io->wfds[fd];
+    }
+    return issued;
+}
+
+static void uring_write_done(ing_io_t *io, io_op_t *op, struct io_uring_cqe *cqe)
+{
+    int fd = op->fd;
+
+    wfd_result(io, op, cqe->res);
+    io->wfds[fd].inflight--;
+    if (op->done_fn)
+        op->done_fn(io, fd, cqe->res, op->arg);
+    op_put(io, op);
+    if (!io->wfds[fd].inflight && uring_write_held(io, fd))
+        io->held_issued = TRUE;
+}
+
+static void uring_reap(ing_io_t *io)
+{
+    struct io_uring_cqe cqe;
+    unsigned head, tail;
+    io_op_t *op;
+
+    head = *io->cq_head;
+    for (;;)
+    {
+        tail = __atomic_load_n(io->cq_tail, __ATOMIC_ACQUIRE);
+        if (head == tail)
+            break;
+        cqe = io->cqes[head & *io->cq_mask];
+        head++;
+        /* free the entry before the callback, which may submit more */
+        __atomic_store_n(io->cq_head, head, __ATOMIC_RELEASE);
+
+        op = (io_op_t *)(uintptr_t)cqe.user_data;
+        if (!op)
+            continue;   /* cancel request */
+        if (op->type == IO_OP_RECV)
+            uring_recv_done(io, op, &cqe);
+        else
+            uring_write_done(io, op, &cqe);
+    }
+    if (io->held_issued)
+    {
+        io->held_issued = FALSE;
+        ing_io_submit(io);
+    }
+}
+
+static void uring_cqe_ready(ing_evloop_t *loop, int fd, unsigned events, void *arg)
+{
+    ing_io_t *io = (ing_io_t *)arg;
+    uint64_t cnt;
+
+    (void)loop;
+    (void)events;
+
+    if (read(fd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN)
+        ing_log(LOG_ERR, " %s (%d): read failed: %s\n", __func__, __LINE__, strerror(errno));
+    uring_reap(io);
+
+    /* completions that did not fit in the CQ ring are flushed by the kernel on enter */
+    if (__atomic_load_n(io->sq_flags, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW)
+    {
+        sys_io_uring_enter(io->ring_fd, 0, 0, IORING_ENTER_GETEVENTS);
+        uring_reap(io);
+    }
+}
+
+#endif /* USE_IO_URING */
+
+ing_stat_t ing_io_create(ing_io_t **io, ing_evloop_t *loop, int nbufs, size_t buf_size,
+    unsigned flags)
+{
+    ing_io_t *r;
+    unsigned n = 1;
+
+    if (!io || !loop || nbufs < 0 || nbufs > 32768)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    r = (ing_io_t *)calloc(1, sizeof(*r));
+    if (!r)
+        return ING_STAT_OUTOFMEMORY;
+    r->loop = loop;
+    r->wq_tail = &r->wq;
+    r->buf_size = buf_size ? buf_size : ING_IO_BUF_SIZE;
+    r->rbuf = (char *)malloc(r->buf_size);
+    if (!r->rbuf)
+    {
+        free(r);
+        return ING_STAT_OUTOFMEMORY;
+    }
+
+    while (n < (unsigned)(nbufs ? nbufs : ING_IO_BUFS))
+        n <<= 1;
+#if USE_IO_URING
+    if (flags & ING_IO_EPOLL || uring_init(r, n) != ING_STAT_OK)
+        r->ring_fd = r->efd = -1;
+#else
+    (void)flags;
+    (void)n;
+#endif
+    *io = r;
+    return ING_STAT_OK;
+}
+
+void ing_io_destroy(ing_io_t *io)
+{
+    io_op_t *op, *next;
+
+    if (!io)
+        return;
+
+    for (op = io->recvs; op; op = op->next)
+    {
+        if (!op->uring)
+            ing_evloop_del(io->loop, op->fd);
+    }
+#if USE_IO_URING
+    if (io->efd >= 0)
+        ing_evloop_del(io->loop, io->efd);
+    /* closing the ring cancels requests in flight */
+    uring_free(io);
+#endif
+    for (op = io->all_ops; op; op = next)
+    {
+        next = op->all_next;
+        free(op);
+    }
+    for (op = io->free_ops; op; op = next)
+    {
+        next = op->next;
+        free(op);
+    }
+    free(io->wfds);
+    free(io->rbuf);
+    free(io);
+}
+
+int ing_io_uring_enabled(const ing_io_t *io)
+{
+#if USE_IO_URING
+    return io && io->ring_fd >= 0;
+#else
+    (void)io;
+    return FALSE;
+#endif
+}
+
+ing_stat_t ing_io_recv_start(ing_io_t *io, int fd, ing_io_recv_fn fn, void *arg)
+{
+    ing_stat_t rc;
+    io_op_t *op;
+
+    if (!io || fd < 0 || !fn)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (recv_find(io, fd))
+        return ING_STAT_ALREADY_EXISTS;
+    if (!(op = op_get(io, IO_OP_RECV, fd)))
+        return ING_STAT_OUTOFMEMORY;
+    op->recv_fn = fn;
+    op->arg = arg;
+
+#if USE_IO_URING
+    if (ing_io_uring_enabled(io))
+        rc = uring_recv_arm(io, op);
+    else
+#endif
+        rc = epoll_recv_start(io, op);
+    if (rc != ING_STAT_OK)
+    {
+        op_put(io, op);
+        return rc;
+    }
+    op->next = io->recvs;
+    io->recvs = op;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_io_recv_stop(ing_io_t *io, int fd)
+{
+    io_op_t *op;
+
+    if (!io)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!(op = recv_find(io, fd)))
+        return ING_STAT_NOT_FOUND;
+
+#if USE_IO_URING
+    if (op->uring)
+    {
+        struct io_uring_sqe *sqe = sqe_get(io);
+
+        if (!sqe)
+            return ING_STAT_FULL;
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = (uint64_t)(uintptr_t)op;
+        sqe->user_data = 0;
+        /* the op is freed by its last completion */
+        op->stopping = TRUE;
+        recv_unlink(io, op);
+        return ing_io_submit(io);
+    }
+#endif
+    ing_evloop_del(io->loop, fd);
+    recv_unlink(io, op);
+    op_put(io, op);
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_io_write(ing_io_t *io, int fd, const void *buf, size_t len, int64_t off,
+    ing_io_done_fn fn, void *arg)
+{
+    io_op_t *op;
+
+    if (!io || fd < 0 || (len && !buf) || len > UINT32_MAX)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!wfd_get(io, fd) || !(op = op_get(io, IO_OP_WRITE, fd)))
+        return ING_STAT_OUTOFMEMORY;
+    op->buf = buf;
+    op->len = len;
+    op->off = off;
+    op->batch = io->batch;
+    op->done_fn = fn;
+    op->arg = arg;
+
+#if USE_IO_URING
+    if (ing_io_uring_enabled(io))
+    {
+        io_wfd_t *w = &io->wfds[fd];
+
+        if (!w->held && uring_write_ready(io, w, op))
+        {
+            if (uring_write_issue(io, w, op) != ING_STAT_OK)
+            {
+                op_put(io, op);
+                return ING_STAT_FULL;
+            }
+            return ING_STAT_OK;
+        }
+        /* issued when the writes of fd in flight complete */
+        if (w->held_last)
+            w->held_last->next = op;
+        else
+            w->held = op;
+        w->held_last = op;
+        return ING_STAT_OK;
+    }
+#endif
+    *io->wq_tail = op;
+    io->wq_tail = &op->next;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_io_submit(ing_io_t *io)
+{
+    if (!io)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    io->batch++;
+#if USE_IO_URING
+    if (ing_io_uring_enabled(io))
+    {
+        int n;
+
+        io->last_write = NULL;
+        __atomic_store_n(io->sq_tail, io->sqe_tail, __ATOMIC_RELEASE);
+        while (io->sqe_submitted != io->sqe_tail)
+        {
+            n = sys_io_uring_enter(io->ring_fd, io->sqe_tail - io->sqe_submitted, 0, 0);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                ing_log(LOG_ERR, " %s (%d): io_uring_enter failed: %s\n", __func__, __LINE__,
+                    strerror(errno));
+                return ING_STAT_SYSTEM_ERROR;
+            }
+            io->sqe_submitted += n;
+        }
+        return ING_STAT_OK;
+    }
+#endif
+    epoll_submit(io);
+    return ING_STAT_OK;
+}
@@ -0,0 +1,146 @@
+/* ing_io.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * I/O engine
+ *
+ * Datagram receive and batched writes driven by an ing_evloop_t. When built
+ * with USE_IO_URING and supported by the kernel, receives are multishot
+ * io_uring recvmsg requests into a registered (provided) buffer ring and
+ * writes are queued as submission entries and sent to the kernel in one
+ * io_uring_enter() by ing_io_submit(). Otherwise the same API runs on epoll
+ * with recvmsg() and write()/pwrite().
+ *
+ * All functions must be called from the loop thread.
+ */
+
+#ifndef ING_IO_H_
+#define ING_IO_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "ing_gen_utils.h"
+#include "ing_evloop.h"
+
+#define ING_IO_EPOLL        0x1     /* do not use io_uring */
+
+#define ING_IO_ENTRIES      256     /* submission queue size */
+#define ING_IO_BUFS         64      /* default number of receive buffers */
+#define ING_IO_BUF_SIZE     16384   /* default receive buffer size */
+
+typedef struct ing_io_s ing_io_t;
+
+/* received datagram; data is valid only during the call */
+typedef void (*ing_io_recv_fn)(ing_io_t *io, int fd, const void *data, size_t len,
+    const struct sockaddr *addr, socklen_t addrlen, void *arg);
+
+/* write completion: res is number of bytes written or -errno */
+typedef void (*ing_io_done_fn)(ing_io_t *io, int fd, ssize_t res, void *arg);
+
+/*
+ * Creates engine in loop. nbufs (rounded up to power of 2) and buf_size
+ * size the receive buffers, 0 - defaults. Falls back to epoll if io_uring
+ * is not built in, not supported or flags has ING_IO_EPOLL
+ */
+ing_stat_t ing_io_create(ing_io_t **io, ing_evloop_t *loop, int nbufs, size_t buf_size,
+    unsigned flags);
+
+/* releases engine; write completions still pending are not called */
+void ing_io_destroy(ing_io_t *io);
+
+/* TRUE if io_uring is used */
+int ing_io_uring_enabled(const ing_io_t *io);
+
+/*
+ * Starts receiving datagrams on fd (e.g. from unix_socket_init() or
+ * udp_socket_init()); fn is called for each datagram. Datagrams longer
+ * than buf_size are truncated
+ */
+ing_stat_t ing_io_recv_start(ing_io_t *io, int fd, ing_io_recv_fn fn, void *arg);
+
+ing_stat_t ing_io_recv_stop(ing_io_t *io, int fd);
+
+/*
+ * Queues write of len bytes at file offset off (-1 - current position).
+ * buf must stay valid until fn is called. Writes are performed by
+ * ing_io_submit() (or when the queue is full). Writes to one fd are done
+ * in the order they are queued, also when writes to other fds are queued
+ * between them: with io_uring a write that cannot be linked to the entry
+ * just before it is held until the earlier writes of the fd complete and
+ * then submitted from the completion handler. A failed or short write
+ * completes the following writes to the fd queued in the same batch
+ * (before the same ing_io_submit()) with -ECANCELED
+ */
+ing_stat_t ing_io_write(ing_io_t *io, int fd, const void *buf, size_t len, int64_t off,
+    ing_io_done_fn fn, void *arg);
+
+ing_stat_t ing_io_submit(ing_io_t *io);
+
+#endif /* ING_IO_H_ */
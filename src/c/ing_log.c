@@ -0,0 +1,2033 @@
+/* ing_log.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Logging
+ */
+
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ing_log.h"
+#include "ing_clock.h"
+
+#define ASYNC_BATCH     64          /* messages per writev() */
+#define ASYNC_WAIT_MS   100         /* bounds a missed wakeup of the writer */
+
+typedef struct log_slot_s {
+    unsigned long seq;              /* ring position the slot is ready for */
+    int priority;
+    int len;
+    char data[ING_LOG_ASYNC_MSG_SIZE];
+} log_slot_t;
+
+/*
+ * Bounded MPSC ring: producers claim positions by CAS on head; a slot
+ * holds a message of position pos when its seq == pos + 1 and is free for
+ * position pos when seq == pos.
+ */
+static struct {
+    int enabled;
+    int writers;                    /* producers inside async_vlog() */
+    int stop;
+    int sleeping;                   /* writer thread waits for messages */
+    int atexit_set;
+    log_slot_t *slots;
+    unsigned long mask;
+    unsigned long head;             /* next position to claim */
+    unsigned long tail;             /* next position to write */
+    unsigned long dropped;
+    unsigned long dropped_reported;
+    pthread_t thread;
+    pthread_mutex_t lock;           /* protects start/stop and waits */
+    pthread_cond_t wake;
+    pthread_cond_t flushed;
+} async = { .lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER,
+            .flushed = PTHREAD_COND_INITIALIZER };
+
+/*
+ * Writes current time to buf in the following format:
+ *  dd.MM hh:mm:ss
+ */
+static char *time2str_at(char *buf, time_t t)
+{
+    ing_clock_timestr(buf, t);
+    return buf;
+}
+
+static char *time2str(char *buf)
+{
+    return time2str_at(buf, (time_t)(ing_clock_real_ms() / 1000));
+}
+
+static const char *priority2str(int priority)
+{
+    switch(priority)
+    {
+    case LOG_DEBUG: return "DEBUG";
+    case LOG_INFO:  return "INFO ";
+    case LOG_ERR:   return "ERROR";
+    case LOG_CRIT:  return "CRIT ";
+    };
+    return "UNKNW";
+}
+
+static void vflog(FILE *file, int priority, char *msg, va_list arglist)
+{
+    char buf[64];
+    time2str(buf);
+    strcat(buf, " |");
+    fputs(buf, file);
+    sprintf(buf, "%s| ", priority2str(priority));
+    fputs(buf, file);
+    vfprintf(file, msg, arglist);
+    fflush(file);
+}
+
+/***************************\
+*        Syslog sink        *
+\***************************/
+
+#define SYSLOG_BATCH        64
+#define SYSLOG_HDR_SIZE     160
+#define SYSLOG_IDENT_SIZE   48
+
+static struct {
+    int fd;
+    int format;
+    int facility;
+    int pid;
+    char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    char ident[SYSLOG_IDENT_SIZE];
+    char hostname[64];
+    int senders;                    /* threads that may be using fd */
+    unsigned gen;                   /* incremented on every (re)connect */
+    pthread_mutex_t lock;           /* open/close/reconnect */
+} sink = { .fd = -1, .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static __thread time_t sink_hdr_sec = (time_t)-1;
+static __thread int sink_hdr_format;
+static __thread char sink_hdr_time[40];
+
+/*
+ * Must be called with sink.lock held. Other threads may be sending on
+ * sink.fd meanwhile, so a connected fd is never closed here: the new
+ * socket is dup'ed over it and the fd number stays valid all the time.
+ */
+static int sink_connect(void)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, sink.path, sizeof(addr.sun_path));
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    if (sink.fd >= 0)
+    {
+        if (dup3(fd, sink.fd, O_CLOEXEC) < 0)
+        {
+            close(fd);
+            return -1;
+        }
+        close(fd);
+        fd = sink.fd;
+    }
+    else
+        __atomic_store_n(&sink.fd, fd, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&sink.gen, 1, __ATOMIC_RELEASE);
+    return fd;
+}
+
+ing_stat_t ing_syslog_open(const char *path, const char *ident, int facility, int format)
+{
+    extern char *program_invocation_short_name;
+    ing_stat_t res = ING_STAT_OK;
+
+    if (!path)
+        path = ING_SYSLOG_PATH;
+    if (strlen(path) >= sizeof(sink.path) ||
+        (format != ING_SYSLOG_RFC3164 && format != ING_SYSLOG_RFC5424))
+        return ING_STAT_INVALID_ARGUMENT;
+
+    pthread_mutex_lock(&sink.lock);
+    strcpy(sink.path, path);
+    snprintf(sink.ident, sizeof(sink.ident), "%s", ident ? ident : program_invocation_short_name);
+    sink.facility = facility & LOG_FACMASK;
+    sink.format = format;
+    sink.pid = getpid();
+    if (gethostname(sink.hostname, sizeof(sink.hostname)) < 0 || !sink.hostname[0])
+        strcpy(sink.hostname, "-");
+    sink.hostname[sizeof(sink.hostname) - 1] = '\0';
+    if (sink_connect() < 0)
+        res = ING_STAT_SYSTEM_ERROR;
+    pthread_mutex_unlock(&sink.lock);
+    return res;
+}
+
+void ing_syslog_close(void)
+{
+    int fd;
+
+    pthread_mutex_lock(&sink.lock);
+    fd = __atomic_exchange_n(&sink.fd, -1, __ATOMIC_SEQ_CST);
+    sink.path[0] = '\0';
+
+    /* threads that loaded fd before the exchange may still send on it */
+    while (__atomic_load_n(&sink.senders, __ATOMIC_ACQUIRE))
+        sched_yield();
+    if (fd >= 0)
+        close(fd);
+    pthread_mutex_unlock(&sink.lock);
+}
+
+/* time part of the header, cached per second */
+static const char *sink_time(int format)
+{
+    struct timespec ts;
+    struct tm tm;
+    static const char *mon[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                 "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    if (ts.tv_sec != sink_hdr_sec || format != sink_hdr_format)
+    {
+        if (format == ING_SYSLOG_RFC5424)
+        {
+            gmtime_r(&ts.tv_sec, &tm);
+            strftime(sink_hdr_time, sizeof(sink_hdr_time), "%Y-%m-%dT%H:%M:%S", &tm);
+        }
+        else
+        {
+            localtime_r(&ts.tv_sec, &tm);
+            snprintf(sink_hdr_time, sizeof(sink_hdr_time), "%s %2d %02d:%02d:%02d",
+                     mon[tm.tm_mon], tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+        }
+        sink_hdr_sec = ts.tv_sec;
+        sink_hdr_format = format;
+    }
+    return sink_hdr_time;
+}
+
+static int sink_header(char *buf, int priority)
+{
+    struct timespec ts;
+    int pri = (priority & LOG_PRIMASK) | (priority & LOG_FACMASK ? priority & LOG_FACMASK : sink.facility);
+
+    if (sink.format == ING_SYSLOG_RFC5424)
+    {
+        clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+        return snprintf(buf, SYSLOG_HDR_SIZE, "<%d>1 %s.%03ldZ %s %s %d - - ", pri,
+                        sink_time(sink.format), ts.tv_nsec / 1000000, sink.hostname,
+                        sink.ident, sink.pid);
+    }
+    return snprintf(buf, SYSLOG_HDR_SIZE, "<%d>%s %s[%d]: ", pri, sink_time(sink.format),
+                    sink.ident, sink.pid);
+}
+
+ing_stat_t ing_syslog_sendv(const int *priorities, const ing_strview_t *msgs, int n)
+{
+    struct mmsghdr mh[SYSLOG_BATCH];
+    struct iovec iov[SYSLOG_BATCH][2];
+    char hdr[SYSLOG_BATCH][SYSLOG_HDR_SIZE];
+    int i, cnt, sent, fd, retried = FALSE;
+    unsigned gen;
+    size_t len;
+
+    if ((!priorities || !msgs) && n)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (__atomic_load_n(&sink.fd, __ATOMIC_ACQUIRE) < 0 && !sink.path[0])
+        return ING_STAT_GENERAL_ERROR;
+
+    while (n > 0)
+    {
+        cnt = n < SYSLOG_BATCH ? n : SYSLOG_BATCH;
+        memset(mh, 0, cnt * sizeof(mh[0]));
+        for (i = 0; i < cnt; i++)
+        {
+            /* lines come with '\n', syslog does not need it */
+            len = msgs[i].len;
+            while (len && msgs[i].ptr[len - 1] == '\n')
+                len--;
+            iov[i][0].iov_base = hdr[i];
+            iov[i][0].iov_len = sink_header(hdr[i], priorities[i]);
+            iov[i][1].iov_base = (void *)msgs[i].ptr;
+            iov[i][1].iov_len = len;
+            mh[i].msg_hdr.msg_iov = iov[i];
+            mh[i].msg_hdr.msg_iovlen = 2;
+        }
+
+        for (i = 0; i < cnt; )
+        {
+            __atomic_fetch_add(&sink.senders, 1, __ATOMIC_SEQ_CST);
+            gen = __atomic_load_n(&sink.gen, __ATOMIC_ACQUIRE);
+            fd = __atomic_load_n(&sink.fd, __ATOMIC_SEQ_CST);
+            sent = fd >= 0 ? sendmmsg(fd, mh + i, cnt - i, MSG_NOSIGNAL) : -1;
+            __atomic_fetch_sub(&sink.senders, 1, __ATOMIC_RELEASE);
+            if (sent > 0)
+            {
+                i += sent;
+                continue;
+            }
+            if (sent < 0 && errno == EINTR)
+                continue;
+            if (retried)
+                return ING_STAT_SYSTEM_ERROR;
+
+            /* syslogd restarted: its socket is a new one. Reconnect unless
+             * another thread has done it since our send
+             */
+            retried = TRUE;
+            pthread_mutex_lock(&sink.lock);
+            if (sink.path[0] && (sink.fd < 0 || sink.gen == gen))
+                sink_connect();
+            pthread_mutex_unlock(&sink.lock);
+        }
+        priorities += cnt;
+        msgs += cnt;
+        n -= cnt;
+    }
+    return ING_STAT_OK;
+}
+
+#if USE_SYSLOG
+/* logs formatted message; libc syslog is used if the sink is unavailable */
+static void sink_msg(int priority, const char *msg, size_t len)
+{
+    ing_strview_t sv;
+
+    if (__atomic_load_n(&sink.fd, __ATOMIC_ACQUIRE) < 0 && !sink.path[0])
+    {
+        extern char *program_invocation_name;
+        ing_syslog_open(NULL, program_invocation_name, LOG_DAEMON, ING_SYSLOG_FORMAT);
+    }
+    sv.ptr = msg;
+    sv.len = len;
+    if (ing_syslog_sendv(&priority, &sv, 1) != ING_STAT_OK)
+        syslog(priority, "%.*s", (int)len, msg);
+}
+
+static void sink_vmsg(int priority, const char *msg, va_list arg)
+{
+    char buf[ING_LOG_ASYNC_MSG_SIZE * 2];
+    int n = vsnprintf(buf, sizeof(buf), msg, arg);
+
+    if (n >= (int)sizeof(buf))
+        n = sizeof(buf) - 1;
+    sink_msg(priority, buf, n > 0 ? n : 0);
+}
+#endif
+
+/***************************\
+*      Asynchronous mode    *
+\***************************/
+
+static void async_write(struct iovec *iov, int cnt)
+{
+#if USE_SYSLOG
+    int prio[ASYNC_BATCH], i;
+    ing_strview_t msgs[ASYNC_BATCH];
+    log_slot_t *slot;
+
+    for (i = 0; i < cnt; i++)
+    {
+        slot = (log_slot_t *)((char *)iov[i].iov_base - offsetof(log_slot_t, data));
+        prio[i] = slot->priority;
+        msgs[i].ptr = slot->data;
+        msgs[i].len = slot->len;
+    }
+    if (ing_syslog_sendv(prio, msgs, cnt) != ING_STAT_OK)
+    {
+        for (i = 0; i < cnt; i++)
+            syslog(prio[i], "%.*s", (int)msgs[i].len, msgs[i].ptr);
+    }
+#else
+    ssize_t n;
+
+    while (cnt > 0)
+    {
+        n = writev(STDOUT_FILENO, iov, cnt);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;     /* nowhere to report it */
+        }
+        while (cnt > 0 && (size_t)n >= iov->iov_len)
+        {
+            n -= iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+#endif
+}
+
+static void async_report_dropped(void)
+{
+    unsigned long dropped = __atomic_load_n(&async.dropped, __ATOMIC_RELAXED);
+    char buf[128];
+    struct iovec iov;
+
+    if (dropped == async.dropped_reported)
+        return;
+#if USE_SYSLOG
+    sink_msg(LOG_ERR, buf, sprintf(buf, "%lu log messages dropped", dropped - async.dropped_reported));
+    (void)iov;
+#else
+    time2str(buf);
+    iov.iov_base = buf;
+    iov.iov_len = strlen(buf);
+    iov.iov_len += sprintf(buf + iov.iov_len, " |%s| %lu log messages dropped\n",
+                           priority2str(LOG_ERR), dropped - async.dropped_reported);
+    async_write(&iov, 1);
+#endif
+    async.dropped_reported = dropped;
+}
+
+/* returns number of ready messages at tail, up to max */
+static int async_ready(struct iovec *iov, int max)
+{
+    log_slot_t *slot;
+    int n;
+
+    for (n = 0; n < max; n++)
+    {
+        slot = &async.slots[(async.tail + n) & async.mask];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != async.tail + n + 1)
+            break;
+        if (iov)
+        {
+            iov[n].iov_base = slot->data;
+            iov[n].iov_len = slot->len;
+        }
+    }
+    return n;
+}
+
+static void *async_thread(void *arg)
+{
+    struct iovec iov[ASYNC_BATCH];
+    struct timespec ts;
+    int i, n;
+
+    (void)arg;
+    for (;;)
+    {
+        n = async_ready(iov, ASYNC_BATCH);
+        if (n)
+        {
+            async_write(iov, n);
+            for (i = 0; i < n; i++)
+            {
+                __atomic_store_n(&async.slots[(async.tail + i) & async.mask].seq,
+                                 async.tail + i + async.mask + 1, __ATOMIC_RELEASE);
+            }
+            __atomic_store_n(&async.tail, async.tail + n, __ATOMIC_RELEASE);
+            async_report_dropped();
+
+            pthread_mutex_lock(&async.lock);
+            pthread_cond_broadcast(&async.flushed);
+            pthread_mutex_unlock(&async.lock);
+            continue;
+        }
+
+        pthread_mutex_lock(&async.lock);
+        __atomic_store_n(&async.sleeping, 1, __ATOMIC_SEQ_CST);
+        if (!async_ready(NULL, 1))
+        {
+            if (async.stop)
+            {
+                pthread_mutex_unlock(&async.lock);
+                break;
+            }
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += ASYNC_WAIT_MS * 1000000L;
+            if (ts.tv_nsec >= 1000000000L)
+            {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&async.wake, &async.lock, &ts);
+        }
+        __atomic_store_n(&async.sleeping, 0, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&async.lock);
+    }
+    async_report_dropped();
+    return NULL;
+}
+
+/* returns FALSE if asynchronous mode is off and the message must be logged
+ * synchronously
+ */
+static int async_vlog(int priority, const char *msg, va_list arg)
+{
+    unsigned long pos;
+    log_slot_t *slot;
+    int len = 0, n;
+
+    __atomic_fetch_add(&async.writers, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&async.enabled, __ATOMIC_SEQ_CST))
+    {
+        __atomic_fetch_sub(&async.writers, 1, __ATOMIC_RELEASE);
+        return FALSE;
+    }
+
+    pos = __atomic_load_n(&async.head, __ATOMIC_RELAXED);
+    for (;;)
+    {
+        slot = &async.slots[pos & async.mask];
+        long diff = (long)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&async.head, &pos, pos + 1, TRUE,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (diff < 0)
+        {
+            /* full */
+            __atomic_fetch_add(&async.dropped, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_sub(&async.writers, 1, __ATOMIC_RELEASE);
+            return TRUE;
+        }
+        else
+            pos = __atomic_load_n(&async.head, __ATOMIC_RELAXED);
+    }
+
+#if !USE_SYSLOG
+    time2str(slot->data);
+    len = strlen(slot->data);
+    len += sprintf(slot->data + len, " |%s| ", priority2str(priority));
+#endif
+    n = vsnprintf(slot->data + len, sizeof(slot->data) - len, msg, arg);
+    if (n < 0)
+        n = 0;
+    if (n >= (int)sizeof(slot->data) - len)
+    {
+        n = sizeof(slot->data) - len - 1;
+        slot->data[len + n - 1] = '\n';
+    }
+    slot->len = len + n;
+    slot->priority = priority;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&async.sleeping, __ATOMIC_RELAXED))
+    {
+        pthread_mutex_lock(&async.lock);
+        pthread_cond_signal(&async.wake);
+        pthread_mutex_unlock(&async.lock);
+    }
+    __atomic_fetch_sub(&async.writers, 1, __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+static void async_atexit(void)
+{
+    ing_log_async_stop();
+}
+
+ing_stat_t ing_log_async_start(int slots)
+{
+    unsigned long size = 1, i;
+    ing_stat_t res = ING_STAT_OK;
+
+    if (slots < 0)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!slots)
+        slots = ING_LOG_ASYNC_SLOTS;
+    while (size < (unsigned long)slots)
+        size <<= 1;
+
+    pthread_mutex_lock(&async.lock);
+    if (async.slots)
+    {
+        res = ING_STAT_ALREADY_EXISTS;
+        goto out;
+    }
+
+    async.slots = (log_slot_t *)malloc(size * sizeof(log_slot_t));
+    if (!async.slots)
+    {
+        res = ING_STAT_OUTOFMEMORY;
+        goto out;
+    }
+    for (i = 0; i < size; i++)
+        async.slots[i].seq = i;
+    async.mask = size - 1;
+    async.head = async.tail = 0;
+    async.stop = 0;
+    async.dropped = async.dropped_reported = 0;
+
+    /* messages already buffered by stdio go first */
+    fflush(stdout);
+#if USE_SYSLOG
+    if (sink.fd < 0)
+    {
+        extern char *program_invocation_name;
+        ing_syslog_open(NULL, program_invocation_name, LOG_DAEMON, ING_SYSLOG_FORMAT);
+    }
+#endif
+
+    if ((errno = pthread_create(&async.thread, NULL, async_thread, NULL)) != 0)
+    {
+        free(async.slots);
+        async.slots = NULL;
+        res = ING_STAT_SYSTEM_ERROR;
+        goto out;
+    }
+    if (!async.atexit_set)
+        async.atexit_set = !atexit(async_atexit);
+    __atomic_store_n(&async.enabled, 1, __ATOMIC_SEQ_CST);
+
+out:
+    pthread_mutex_unlock(&async.lock);
+    if (res == ING_STAT_SYSTEM_ERROR)
+        ing_log(LOG_ERR, " %s (%d): Cannot create thread: %s\n", __func__, __LINE__, strerror(errno));
+    return res;
+}
+
+void ing_log_async_stop(void)
+{
+    pthread_mutex_lock(&async.lock);
+    if (!async.slots)
+    {
+        pthread_mutex_unlock(&async.lock);
+        return;
+    }
+    __atomic_store_n(&async.enabled, 0, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&async.writers, __ATOMIC_ACQUIRE))
+    {
+        pthread_mutex_unlock(&async.lock);
+        sched_yield();
+        pthread_mutex_lock(&async.lock);
+    }
+    async.stop = 1;
+    pthread_cond_signal(&async.wake);
+    pthread_mutex_unlock(&async.lock);
+
+    pthread_join(async.thread, NULL);
+
+    pthread_mutex_lock(&async.lock);
+    free(async.slots);
+    async.slots = NULL;
+    pthread_cond_broadcast(&async.flushed);
+    pthread_mutex_unlock(&async.lock);
+}
+
+void ing_log_flush(void)
+{
+    unsigned long target = __atomic_load_n(&async.head, __ATOMIC_ACQUIRE);
+    int active;
+
+    pthread_mutex_lock(&async.lock);
+    while (async.slots && (long)(__atomic_load_n(&async.tail, __ATOMIC_ACQUIRE) - target) < 0)
+    {
+        pthread_cond_signal(&async.wake);
+        pthread_cond_wait(&async.flushed, &async.lock);
+    }
+    active = async.slots != NULL;
+    pthread_mutex_unlock(&async.lock);
+    if (!active)
+        fflush(stdout);
+}
+
+unsigned long ing_log_dropped(void)
+{
+    return __atomic_load_n(&async.dropped, __ATOMIC_RELAXED);
+}
+
+/***************************\
+*     Levels and modules    *
+\***************************/
+
+int ing_log_level = LOG_DEBUG;
+
+static ing_log_module_t *log_modules;
+static pthread_mutex_t log_modules_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void ing_log_set_level(int level)
+{
+    __atomic_store_n(&ing_log_level, level, __ATOMIC_RELAXED);
+}
+
+void ing_log_module_register(ing_log_module_t *mod)
+{
+    pthread_mutex_lock(&log_modules_lock);
+    mod->next = log_modules;
+    log_modules = mod;
+    pthread_mutex_unlock(&log_modules_lock);
+}
+
+ing_stat_t ing_log_set_module_level(const char *name, int level)
+{
+    ing_log_module_t *mod;
+    ing_stat_t res = ING_STAT_NOT_FOUND;
+
+    if (!name)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    pthread_mutex_lock(&log_modules_lock);
+    for (mod = log_modules; mod; mod = mod->next)
+    {
+        if (!strcmp(mod->name, name))
+        {
+            __atomic_store_n(&mod->level, level, __ATOMIC_RELAXED);
+            res = ING_STAT_OK;
+        }
+    }
+    pthread_mutex_unlock(&log_modules_lock);
+    return res;
+}
+
+/***************************\
+*       Rate limiting       *
+\***************************/
+
+int ing_log_ratelimit(ing_log_ratelimit_t *rl, int rate, int burst, unsigned long *suppressed)
+{
+    unsigned long now = ing_clock_mono_ms(), add;
+    int allowed = FALSE;
+
+    *suppressed = 0;
+    if (rate <= 0 || burst <= 0)
+        return TRUE;
+
+    while (__atomic_exchange_n(&rl->lock, 1, __ATOMIC_ACQUIRE))
+        sched_yield();
+
+    if (!rl->last_ms)
+    {
+        rl->last_ms = now;
+        rl->tokens = burst;
+    }
+    add = (now - rl->last_ms) * rate / 1000;
+    if (add)
+    {
+        rl->tokens = add >= (unsigned long)burst - rl->tokens ? burst : rl->tokens + (int)add;
+        /* keep the fraction of a token for the next call */
+        rl->last_ms += add * 1000 / rate;
+        if (rl->tokens == burst)
+            rl->last_ms = now;
+    }
+
+    if (rl->tokens > 0)
+    {
+        rl->tokens--;
+        *suppressed = rl->suppressed;
+        rl->suppressed = 0;
+        allowed = TRUE;
+    }
+    else
+        rl->suppressed++;
+
+    __atomic_store_n(&rl->lock, 0, __ATOMIC_RELEASE);
+    return allowed;
+}
+
+/***************************\
+*        Binary mode        *
+\***************************/
+
+#define LOGB_MAGIC          "INGLOGB1"
+#define LOGB_TBUF_SIZE      (64 * 1024)     /* per thread, power of 2 */
+#define LOGB_OUT_SIZE       (64 * 1024)
+#define LOGB_STR_MAX        1024            /* longer strings are truncated */
+#define LOGB_IDLE_US        1000
+
+#define LOGB_ID_FORMAT      0               /* record defines a format */
+#define LOGB_ID_DROPPED     0xfffffffeu
+#define LOGB_ID_PAD         0xffffffffu     /* skip to the buffer start */
+
+#define LOGB_ALIGN(x)       (((x) + 7) & ~(size_t)7)
+
+typedef enum logb_arg_e {
+    A_NONE, A_INT, A_LONG, A_LLONG, A_SIZE, A_INTMAX, A_PTRDIFF,
+    A_DOUBLE, A_LDOUBLE, A_PTR, A_STR
+} logb_arg_t;
+
+/* piece of format with at most one conversion */
+typedef struct logb_seg_s {
+    char *fmt;
+    logb_arg_t type;
+} logb_seg_t;
+
+typedef struct logb_fmt_s {
+    uint32_t id;
+    int line;
+    char *file;
+    char *fmt;
+    int nsegs;
+    logb_seg_t *segs;
+} logb_fmt_t;
+
+/* record in thread buffers and in log file; arguments follow 8-aligned */
+typedef struct logb_rec_s {
+    uint32_t size;                  /* whole record */
+    uint32_t id;
+    int32_t priority;
+    uint32_t reserved;
+    uint64_t ts;                    /* CLOCK_REALTIME, ns */
+} logb_rec_t;
+
+/* payload of LOGB_ID_FORMAT record, followed by file and format strings */
+typedef struct logb_fmt_rec_s {
+    uint32_t id;
+    int32_t line;
+    uint32_t file_len;
+    uint32_t fmt_len;
+} logb_fmt_rec_t;
+
+/* SPSC ring: the owner thread writes, the writer thread reads */
+typedef struct logb_tbuf_s {
+    uint64_t head;
+    uint64_t tail;
+    int dead;                       /* owner thread exited */
+    struct logb_tbuf_s *next;
+    unsigned char data[LOGB_TBUF_SIZE];
+} logb_tbuf_t;
+
+static struct {
+    int enabled;
+    int writers;                    /* producers inside ing_logb() */
+    int stop;
+    int fd;                         /* binary log file, -1 - text to stdout */
+    pthread_t thread;
+    pthread_mutex_t lock;           /* formats, buffers list, start/stop */
+    logb_fmt_t **fmts;              /* format id - 1 is its index */
+    uint32_t nfmts;
+    uint32_t fmts_cap;
+    uint32_t fmts_written;
+    logb_tbuf_t *bufs;
+    pthread_key_t key;
+    unsigned long dropped;
+    unsigned long dropped_reported;
+    size_t out_len;
+    char out[LOGB_OUT_SIZE];
+} logb = { .fd = -1, .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static pthread_once_t logb_key_once = PTHREAD_ONCE_INIT;
+static __thread logb_tbuf_t *logb_tbuf;
+
+static void logb_fmt_free(logb_fmt_t *f)
+{
+    int i;
+
+    if (!f)
+        return;
+    for (i = 0; i < f->nsegs; i++)
+        free(f->segs[i].fmt);
+    free(f->segs);
+    free(f->file);
+    free(f->fmt);
+    free(f);
+}
+
+/*
+ * Splits printf format into segments with one conversion each.
+ * Returns NULL if the format can not be deferred ('*' width, %n, ...)
+ */
+static logb_fmt_t *logb_fmt_parse(const char *fmt, const char *file, int line)
+{
+    logb_fmt_t *f = (logb_fmt_t *)calloc(1, sizeof(*f));
+    const char *p = fmt, *start = fmt;
+    logb_arg_t type;
+    char *seg;
+    int lmod;
+
+    if (!f)
+        return NULL;
+    f->line = line;
+    f->fmt = strdup(fmt);
+    f->file = strdup(file ? file : "");
+    f->segs = (logb_seg_t *)calloc(strlen(fmt) / 2 + 2, sizeof(logb_seg_t));
+    if (!f->fmt || !f->file || !f->segs)
+        goto fail;
+
+    while (*p)
+    {
+        if (*p++ != '%')
+            continue;
+        if (*p == '%')
+        {
+            p++;
+            continue;
+        }
+        p += strspn(p, "-+ #0'");
+        p += strspn(p, "0123456789");
+        if (*p == '.')
+        {
+            p++;
+            p += strspn(p, "0123456789");
+        }
+
+        /* length modifier: 0 - none, 1 - l, 2 - ll, others - the char */
+        lmod = 0;
+        if (*p == 'h')
+            p += (p[1] == 'h') ? 2 : 1;
+        else if (*p == 'l')
+        {
+            lmod = (p[1] == 'l') ? 2 : 1;
+            p += lmod;
+        }
+        else if (*p == 'z' || *p == 'j' || *p == 't' || *p == 'L')
+            lmod = *p++;
+
+        switch (*p)
+        {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            type = lmod == 1 ? A_LONG : lmod == 2 ? A_LLONG : lmod == 'z' ? A_SIZE :
+                   lmod == 'j' ? A_INTMAX : lmod == 't' ? A_PTRDIFF : A_INT;
+            break;
+        case 'c':
+            type = A_INT;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            type = lmod == 'L' ? A_LDOUBLE : A_DOUBLE;
+            break;
+        case 'p':
+            type = A_PTR;
+            break;
+        case 's':
+            if (lmod)
+                goto fail;
+            type = A_STR;
+            break;
+        default:
+            /* '*', %n, wide chars */
+            goto fail;
+        }
+        p++;
+
+        seg = strndup(start, p - start);
+        if (!seg)
+            goto fail;
+        f->segs[f->nsegs].fmt = seg;
+        f->segs[f->nsegs++].type = type;
+        start = p;
+    }
+
+    if (*start)
+    {
+        /* trailing text is printed with "%s", so unescape "%%" */
+        char *d;
+        const char *s;
+
+        seg = (char *)malloc(strlen(start) + 1);
+        if (!seg)
+            goto fail;
+        for (s = start, d = seg; *s; *d++ = *s++)
+        {
+            if (s[0] == '%' && s[1] == '%')
+                s++;
+        }
+        *d = '\0';
+        f->segs[f->nsegs].fmt = seg;
+        f->segs[f->nsegs++].type = A_NONE;
+    }
+    return f;
+
+fail:
+    logb_fmt_free(f);
+    return NULL;
+}
+
+/* formats record arguments into out; returns string length */
+static size_t logb_fmt_print(const logb_fmt_t *f, const unsigned char *args, size_t len,
+    char *out, size_t size)
+{
+    const unsigned char *end = args + len;
+    size_t n = 0;
+    int i, r = 0;
+    int64_t iv;
+    double dv;
+    long double ldv;
+    void *pv;
+    uint32_t slen;
+
+    out[0] = '\0';
+    for (i = 0; i < f->nsegs && n < size; i++)
+    {
+        const char *seg = f->segs[i].fmt;
+
+        if (f->segs[i].type == A_NONE)
+        {
+            r = snprintf(out + n, size - n, "%s", seg);
+        }
+        else if (f->segs[i].type == A_STR)
+        {
+            if (end - args < 4)
+                break;
+            memcpy(&slen, args, 4);
+            if (slen == UINT32_MAX)
+            {
+                r = snprintf(out + n, size - n, seg, "(null)");
+                args += 8;
+            }
+            else
+            {
+                if ((size_t)(end - args) < LOGB_ALIGN(4 + slen + 1))
+                    break;
+                r = snprintf(out + n, size - n, seg, (const char *)args + 4);
+                args += LOGB_ALIGN(4 + slen + 1);
+            }
+        }
+        else if (f->segs[i].type == A_LDOUBLE)
+        {
+            if ((size_t)(end - args) < LOGB_ALIGN(sizeof(long double)))
+                break;
+            memcpy(&ldv, args, sizeof(ldv));
+            r = snprintf(out + n, size - n, seg, ldv);
+            args += LOGB_ALIGN(sizeof(long double));
+        }
+        else
+        {
+            if (end - args < 8)
+                break;
+            memcpy(&iv, args, 8);
+            switch (f->segs[i].type)
+            {
+            case A_INT:     r = snprintf(out + n, size - n, seg, (int)iv); break;
+            case A_LONG:    r = snprintf(out + n, size - n, seg, (long)iv); break;
+            case A_LLONG:   r = snprintf(out + n, size - n, seg, (long long)iv); break;
+            case A_SIZE:    r = snprintf(out + n, size - n, seg, (size_t)iv); break;
+            case A_INTMAX:  r = snprintf(out + n, size - n, seg, (intmax_t)iv); break;
+            case A_PTRDIFF: r = snprintf(out + n, size - n, seg, (ptrdiff_t)iv); break;
+            case A_DOUBLE:
+                memcpy(&dv, args, 8);
+                r = snprintf(out + n, size - n, seg, dv);
+                break;
+            case A_PTR:
+                memcpy(&pv, args, sizeof(pv));
+                r = snprintf(out + n, size - n, seg, pv);
+                break;
+            default:
+                break;
+            }
+            args += 8;
+        }
+        if (r < 0)
+            break;
+        n += r;
+    }
+    return n < size ? n : size - 1;
+}
+
+/* log line prefix as in vflog() */
+static size_t logb_prefix(char *buf, uint64_t ts, int priority)
+{
+    size_t n;
+
+    time2str_at(buf, (time_t)(ts / 1000000000ull));
+    n = strlen(buf);
+    return n + sprintf(buf + n, " |%s| ", priority2str(priority));
+}
+
+static int logb_register(ing_logb_site_t *site, const char *fmt, const char *file, int line)
+{
+    logb_fmt_t *f, **fmts;
+    int id;
+
+    pthread_mutex_lock(&logb.lock);
+    id = site->id;
+    if (id)
+        goto out;
+
+    id = -1;
+    f = logb_fmt_parse(fmt, file, line);
+    if (!f)
+        goto out;
+    if (logb.nfmts == logb.fmts_cap)
+    {
+        uint32_t cap = logb.fmts_cap ? logb.fmts_cap * 2 : 64;
+        fmts = (logb_fmt_t **)realloc(logb.fmts, cap * sizeof(*fmts));
+        if (!fmts)
+        {
+            logb_fmt_free(f);
+            goto out;
+        }
+        logb.fmts = fmts;
+        logb.fmts_cap = cap;
+    }
+    logb.fmts[logb.nfmts++] = f;
+    f->id = logb.nfmts;
+    id = f->id;
+    site->fmt = f;
+
+out:
+    __atomic_store_n(&site->id, id, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&logb.lock);
+    return id;
+}
+
+static void logb_tbuf_destructor(void *arg)
+{
+    __atomic_store_n(&((logb_tbuf_t *)arg)->dead, 1, __ATOMIC_RELEASE);
+}
+
+static void logb_key_create(void)
+{
+    pthread_key_create(&logb.key, logb_tbuf_destructor);
+}
+
+static logb_tbuf_t *logb_tbuf_get(void)
+{
+    logb_tbuf_t *b = (logb_tbuf_t *)malloc(sizeof(*b));
+
+    if (!b)
+        return NULL;
+    b->head = b->tail = 0;
+    b->dead = 0;
+    pthread_once(&logb_key_once, logb_key_create);
+    pthread_setspecific(logb.key, b);
+
+    pthread_mutex_lock(&logb.lock);
+    b->next = logb.bufs;
+    logb.bufs = b;
+    pthread_mutex_unlock(&logb.lock);
+    return b;
+}
+
+/* computes size of arguments as stored in a record */
+static size_t logb_args_size(const logb_fmt_t *f, va_list arg)
+{
+    size_t size = 0, len;
+    const char *s;
+    int i;
+
+    for (i = 0; i < f->nsegs; i++)
+    {
+        switch (f->segs[i].type)
+        {
+        case A_NONE:    break;
+        case A_INT:     (void)va_arg(arg, int); size += 8; break;
+        case A_LONG:    (void)va_arg(arg, long); size += 8; break;
+        case A_LLONG:   (void)va_arg(arg, long long); size += 8; break;
+        case A_SIZE:    (void)va_arg(arg, size_t); size += 8; break;
+        case A_INTMAX:  (void)va_arg(arg, intmax_t); size += 8; break;
+        case A_PTRDIFF: (void)va_arg(arg, ptrdiff_t); size += 8; break;
+        case A_DOUBLE:  (void)va_arg(arg, double); size += 8; break;
+        case A_LDOUBLE: (void)va_arg(arg, long double); size += LOGB_ALIGN(sizeof(long double)); break;
+        case A_PTR:     (void)va_arg(arg, void *); size += 8; break;
+        case A_STR:
+            s = va_arg(arg, const char *);
+            len = s ? strnlen(s, LOGB_STR_MAX) : 0;
+            size += s ? LOGB_ALIGN(4 + len + 1) : 8;
+            break;
+        }
+    }
+    return size;
+}
+
+static void logb_args_copy(const logb_fmt_t *f, unsigned char *p, va_list arg)
+{
+    int64_t iv = 0;
+    double dv;
+    long double ldv;
+    void *pv;
+    const char *s;
+    uint32_t len;
+    int i;
+
+    for (i = 0; i < f->nsegs; i++)
+    {
+        switch (f->segs[i].type)
+        {
+        case A_NONE:    continue;
+        case A_INT:     iv = va_arg(arg, int); break;
+        case A_LONG:    iv = va_arg(arg, long); break;
+        case A_LLONG:   iv = va_arg(arg, long long); break;
+        case A_SIZE:    iv = (int64_t)va_arg(arg, size_t); break;
+        case A_INTMAX:  iv = va_arg(arg, intmax_t); break;
+        case A_PTRDIFF: iv = va_arg(arg, ptrdiff_t); break;
+        case A_DOUBLE:
+            dv = va_arg(arg, double);
+            memcpy(p, &dv, 8);
+            p += 8;
+            continue;
+        case A_LDOUBLE:
+            ldv = va_arg(arg, long double);
+            memcpy(p, &ldv, sizeof(ldv));
+            p += LOGB_ALIGN(sizeof(long double));
+            continue;
+        case A_PTR:
+            pv = va_arg(arg, void *);
+            memset(p, 0, 8);
+            memcpy(p, &pv, sizeof(pv));
+            p += 8;
+            continue;
+        case A_STR:
+            s = va_arg(arg, const char *);
+            if (!s)
+            {
+                len = UINT32_MAX;
+                memcpy(p, &len, 4);
+                p += 8;
+                continue;
+            }
+            len = strnlen(s, LOGB_STR_MAX);
+            memcpy(p, &len, 4);
+            memcpy(p + 4, s, len);
+            p[4 + len] = '\0';
+            p += LOGB_ALIGN(4 + len + 1);
+            continue;
+        }
+        memcpy(p, &iv, 8);
+        p += 8;
+    }
+}
+
+void ing_logb(ing_logb_site_t *site, int priority, const char *file, int line, const char *fmt, ...)
+{
+    const logb_fmt_t *f;
+    logb_tbuf_t *b;
+    logb_rec_t *rec;
+    va_list arg;
+    uint64_t head, tail;
+    size_t size, off, contig;
+    int id;
+
+    id = __atomic_load_n(&site->id, __ATOMIC_ACQUIRE);
+    if (!id)
+        id = logb_register(site, fmt, file, line);
+
+    __atomic_fetch_add(&logb.writers, 1, __ATOMIC_SEQ_CST);
+    if (id < 0 || !__atomic_load_n(&logb.enabled, __ATOMIC_SEQ_CST) ||
+        (!(b = logb_tbuf) && !(b = logb_tbuf = logb_tbuf_get())))
+    {
+        __atomic_fetch_sub(&logb.writers, 1, __ATOMIC_RELEASE);
+        va_start(arg, fmt);
+        ing_log_vmsg(priority, (char *)fmt, arg);
+        va_end(arg);
+        return;
+    }
+    f = (const logb_fmt_t *)site->fmt;
+
+    va_start(arg, fmt);
+    size = sizeof(logb_rec_t) + logb_args_size(f, arg);
+    va_end(arg);
+
+    head = b->head;
+    tail = __atomic_load_n(&b->tail, __ATOMIC_ACQUIRE);
+    off = head & (LOGB_TBUF_SIZE - 1);
+    contig = LOGB_TBUF_SIZE - off;
+    if (contig < size)
+    {
+        /* the record must be contiguous: skip the buffer end */
+        if (head + contig + size - tail > LOGB_TBUF_SIZE)
+            goto drop;
+        if (contig >= sizeof(logb_rec_t))
+        {
+            rec = (logb_rec_t *)(b->data + off);
+            rec->size = contig;
+            rec->id = LOGB_ID_PAD;
+        }
+        head += contig;
+        off = 0;
+    }
+    else if (head + size - tail > LOGB_TBUF_SIZE)
+        goto drop;
+
+    rec = (logb_rec_t *)(b->data + off);
+    rec->size = size;
+    rec->id = id;
+    rec->priority = priority;
+    rec->reserved = 0;
+    rec->ts = ing_clock_real_ns();
+    va_start(arg, fmt);
+    logb_args_copy(f, (unsigned char *)(rec + 1), arg);
+    va_end(arg);
+
+    __atomic_store_n(&b->head, head + size, __ATOMIC_RELEASE);
+    __atomic_fetch_sub(&logb.writers, 1, __ATOMIC_RELEASE);
+    return;
+
+drop:
+    __atomic_fetch_add(&logb.dropped, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&logb.writers, 1, __ATOMIC_RELEASE);
+}
+
+static void logb_out_flush(void)
+{
+    size_t done = 0;
+    ssize_t n;
+    int fd = logb.fd >= 0 ? logb.fd : STDOUT_FILENO;
+
+    while (done < logb.out_len)
+    {
+        n = write(fd, logb.out + done, logb.out_len - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        done += n;
+    }
+    logb.out_len = 0;
+}
+
+static void logb_out(const void *data, size_t len)
+{
+    if (logb.out_len + len > sizeof(logb.out))
+        logb_out_flush();
+    if (len > sizeof(logb.out))
+        len = sizeof(logb.out);
+    memcpy(logb.out + logb.out_len, data, len);
+    logb.out_len += len;
+}
+
+static void logb_out_format(const logb_fmt_t *f)
+{
+    unsigned char buf[sizeof(logb_rec_t) + sizeof(logb_fmt_rec_t)];
+    logb_rec_t *rec = (logb_rec_t *)buf;
+    logb_fmt_rec_t *fr = (logb_fmt_rec_t *)(rec + 1);
+    static const char pad[8];
+    size_t len;
+
+    fr->id = f->id;
+    fr->line = f->line;
+    fr->file_len = strlen(f->file);
+    fr->fmt_len = strlen(f->fmt);
+    len = sizeof(buf) + fr->file_len + fr->fmt_len;
+
+    memset(rec, 0, sizeof(*rec));
+    rec->size = LOGB_ALIGN(len);
+    rec->id = LOGB_ID_FORMAT;
+    logb_out(buf, sizeof(buf));
+    logb_out(f->file, fr->file_len);
+    logb_out(f->fmt, fr->fmt_len);
+    logb_out(pad, rec->size - len);
+}
+
+static void logb_out_text(const logb_rec_t *rec, const logb_fmt_t *f)
+{
+    char line[ING_LOG_ASYNC_MSG_SIZE * 2];
+    size_t n = 0;
+
+#if !USE_SYSLOG
+    n = logb_prefix(line, rec->ts, rec->priority);
+#endif
+    n += logb_fmt_print(f, (const unsigned char *)(rec + 1), rec->size - sizeof(*rec),
+                        line + n, sizeof(line) - n);
+#if USE_SYSLOG
+    sink_msg(rec->priority, line, n);
+#else
+    logb_out(line, n);
+#endif
+}
+
+static void logb_out_dropped(void)
+{
+    unsigned long dropped = __atomic_load_n(&logb.dropped, __ATOMIC_RELAXED);
+    logb_rec_t rec[2];
+    uint64_t cnt;
+    char line[128];
+    size_t n;
+
+    if (dropped == logb.dropped_reported)
+        return;
+    cnt = dropped - logb.dropped_reported;
+    logb.dropped_reported = dropped;
+
+    if (logb.fd >= 0)
+    {
+        memset(rec, 0, sizeof(rec));
+        rec[0].size = sizeof(rec[0]) + 8;
+        rec[0].id = LOGB_ID_DROPPED;
+        memcpy(&rec[1], &cnt, 8);
+        logb_out(rec, rec[0].size);
+        return;
+    }
+#if USE_SYSLOG
+    n = sprintf(line, "%lu log messages dropped", (unsigned long)cnt);
+    sink_msg(LOG_ERR, line, n);
+#else
+    time2str(line);
+    n = strlen(line);
+    n += sprintf(line + n, " |%s| %lu log messages dropped\n", priority2str(LOG_ERR),
+                 (unsigned long)cnt);
+    logb_out(line, n);
+#endif
+}
+
+/* processes records of one thread buffer; returns number of records */
+static int logb_drain(logb_tbuf_t *b)
+{
+    uint64_t head = __atomic_load_n(&b->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = b->tail;
+    const logb_rec_t *rec;
+    size_t off;
+    int n = 0;
+
+    while (tail != head)
+    {
+        off = tail & (LOGB_TBUF_SIZE - 1);
+        if (LOGB_TBUF_SIZE - off < sizeof(logb_rec_t))
+        {
+            tail += LOGB_TBUF_SIZE - off;
+            continue;
+        }
+        rec = (const logb_rec_t *)(b->data + off);
+        if (rec->id != LOGB_ID_PAD)
+        {
+            if (logb.fd >= 0)
+                logb_out(rec, rec->size);
+            else
+                logb_out_text(rec, logb.fmts[rec->id - 1]);
+            n++;
+        }
+        tail += rec->size;
+    }
+    __atomic_store_n(&b->tail, tail, __ATOMIC_RELEASE);
+    return n;
+}
+
+static void *logb_thread(void *arg)
+{
+    logb_tbuf_t **pb, *b;
+    int stop, n;
+
+    (void)arg;
+    for (;;)
+    {
+        stop = __atomic_load_n(&logb.stop, __ATOMIC_ACQUIRE);
+        n = 0;
+
+        /* new formats can not be registered while the lock is held, so every
+         * record seen below uses an already written format
+         */
+        pthread_mutex_lock(&logb.lock);
+        if (logb.fd >= 0)
+        {
+            for (; logb.fmts_written < logb.nfmts; logb.fmts_written++)
+                logb_out_format(logb.fmts[logb.fmts_written]);
+        }
+        for (pb = &logb.bufs; (b = *pb) != NULL; )
+        {
+            n += logb_drain(b);
+            if (__atomic_load_n(&b->dead, __ATOMIC_ACQUIRE) &&
+                __atomic_load_n(&b->head, __ATOMIC_ACQUIRE) == b->tail)
+            {
+                *pb = b->next;
+                free(b);
+                continue;
+            }
+            pb = &b->next;
+        }
+        logb_out_dropped();
+        logb_out_flush();
+        pthread_mutex_unlock(&logb.lock);
+
+        if (!n)
+        {
+            struct timespec ts = { 0, LOGB_IDLE_US * 1000L };
+
+            if (stop)
+                break;
+            nanosleep(&ts, NULL);
+        }
+    }
+    return NULL;
+}
+
+static void logb_atexit(void)
+{
+    ing_logb_stop();
+}
+
+ing_stat_t ing_logb_start(const char *path)
+{
+    static int atexit_set;
+    ing_stat_t res = ING_STAT_OK;
+    int fd = -1;
+
+    if (path)
+    {
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            ing_log(LOG_ERR, " %s (%d): Cannot open %s: %s\n", __func__, __LINE__, path, strerror(errno));
+            return ING_STAT_SYSTEM_ERROR;
+        }
+        if (write(fd, LOGB_MAGIC, 8) != 8)
+        {
+            ing_log(LOG_ERR, " %s (%d): Cannot write %s: %s\n", __func__, __LINE__, path, strerror(errno));
+            close(fd);
+            return ING_STAT_SYSTEM_ERROR;
+        }
+    }
+
+    pthread_mutex_lock(&logb.lock);
+    if (__atomic_load_n(&logb.enabled, __ATOMIC_RELAXED))
+    {
+        res = ING_STAT_ALREADY_EXISTS;
+        goto out;
+    }
+    logb.fd = fd;
+    logb.fmts_written = 0;
+    logb.stop = 0;
+    logb.out_len = 0;
+    logb.dropped_reported = __atomic_load_n(&logb.dropped, __ATOMIC_RELAXED);
+    fflush(stdout);
+
+    if ((errno = pthread_create(&logb.thread, NULL, logb_thread, NULL)) != 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): Cannot create thread: %s\n", __func__, __LINE__, strerror(errno));
+        logb.fd = -1;
+        res = ING_STAT_SYSTEM_ERROR;
+        goto out;
+    }
+    if (!atexit_set)
+        atexit_set = !atexit(logb_atexit);
+    __atomic_store_n(&logb.enabled, 1, __ATOMIC_SEQ_CST);
+
+out:
+    pthread_mutex_unlock(&logb.lock);
+    if (res != ING_STAT_OK && fd >= 0)
+        close(fd);
+    return res;
+}
+
+void ing_logb_stop(void)
+{
+    pthread_mutex_lock(&logb.lock);
+    if (!__atomic_load_n(&logb.enabled, __ATOMIC_RELAXED))
+    {
+        pthread_mutex_unlock(&logb.lock);
+        return;
+    }
+    __atomic_store_n(&logb.enabled, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&logb.lock);
+
+    while (__atomic_load_n(&logb.writers, __ATOMIC_ACQUIRE))
+        sched_yield();
+    __atomic_store_n(&logb.stop, 1, __ATOMIC_RELEASE);
+    pthread_join(logb.thread, NULL);
+
+    if (logb.fd >= 0)
+    {
+        close(logb.fd);
+        logb.fd = -1;
+    }
+}
+
+void ing_logb_flush(void)
+{
+    struct timespec ts = { 0, LOGB_IDLE_US * 1000L };
+    logb_tbuf_t *b;
+    int pending;
+
+    do
+    {
+        pending = FALSE;
+        pthread_mutex_lock(&logb.lock);
+        if (__atomic_load_n(&logb.enabled, __ATOMIC_RELAXED))
+        {
+            for (b = logb.bufs; b && !pending; b = b->next)
+                pending = __atomic_load_n(&b->head, __ATOMIC_ACQUIRE) != b->tail;
+        }
+        pthread_mutex_unlock(&logb.lock);
+        if (pending)
+            nanosleep(&ts, NULL);
+    } while (pending);
+}
+
+unsigned long ing_logb_dropped(void)
+{
+    return __atomic_load_n(&logb.dropped, __ATOMIC_RELAXED);
+}
+
+/*
+ * Decoder
+ */
+ing_stat_t ing_logb_decode(FILE *in, FILE *out)
+{
+    logb_fmt_t **fmts = NULL, *f;
+    uint32_t nfmts = 0, i;
+    ing_stat_t res = ING_STAT_INVALID_ARGUMENT;
+    unsigned char *payload = NULL, *p;
+    size_t cap = 0, len;
+    logb_rec_t rec;
+    logb_fmt_rec_t fr;
+    char magic[8];
+    char line[ING_LOG_ASYNC_MSG_SIZE * 2];
+    uint64_t cnt;
+
+    if (!in || !out)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (fread(magic, 1, 8, in) != 8 || memcmp(magic, LOGB_MAGIC, 8))
+        return ING_STAT_INVALID_ARGUMENT;
+
+    while (fread(&rec, sizeof(rec), 1, in) == 1)
+    {
+        if (rec.size < sizeof(rec))
+            goto out;
+        len = rec.size - sizeof(rec);
+        if (len > cap)
+        {
+            p = (unsigned char *)realloc(payload, len);
+            if (!p)
+            {
+                res = ING_STAT_OUTOFMEMORY;
+                goto out;
+            }
+            payload = p;
+            cap = len;
+        }
+        if (len && fread(payload, len, 1, in) != 1)
+            goto out;
+
+        if (rec.id == LOGB_ID_FORMAT)
+        {
+            char *file, *fmt;
+
+            if (len < sizeof(fr))
+                goto out;
+            memcpy(&fr, payload, sizeof(fr));
+            if ((size_t)fr.file_len + fr.fmt_len > len - sizeof(fr) || fr.id != nfmts + 1)
+                goto out;
+            file = strndup((char *)payload + sizeof(fr), fr.file_len);
+            fmt = strndup((char *)payload + sizeof(fr) + fr.file_len, fr.fmt_len);
+            f = (file && fmt) ? logb_fmt_parse(fmt, file, fr.line) : NULL;
+            free(file);
+            free(fmt);
+            p = (unsigned char *)realloc(fmts, (nfmts + 1) * sizeof(*fmts));
+            if (!f || !p)
+            {
+                logb_fmt_free(f);
+                res = ING_STAT_OUTOFMEMORY;
+                goto out;
+            }
+            fmts = (logb_fmt_t **)p;
+            f->id = fr.id;
+            fmts[nfmts++] = f;
+        }
+        else if (rec.id == LOGB_ID_DROPPED)
+        {
+            if (len < 8)
+                goto out;
+            memcpy(&cnt, payload, 8);
+            fprintf(out, "*** %llu log messages dropped\n", (unsigned long long)cnt);
+        }
+        else
+        {
+            if (rec.id == 0 || rec.id > nfmts)
+                goto out;
+            len = logb_prefix(line, rec.ts, rec.priority);
+            len += logb_fmt_print(fmts[rec.id - 1], payload, rec.size - sizeof(rec),
+                                  line + len, sizeof(line) - len);
+            fwrite(line, 1, len, out);
+        }
+    }
+    res = feof(in) ? ING_STAT_OK : ING_STAT_SYSTEM_ERROR;
+
+out:
+    for (i = 0; i < nfmts; i++)
+        logb_fmt_free(fmts[i]);
+    free(fmts);
+    free(payload);
+    return res;
+}
+
+/***************************\
+*       Critical log        *
+\***************************/
+
+#define CRIT_MAGIC          "INGCRIT1"
+#define CRIT_FILE           "cg_critical_err.ring"
+
+typedef struct crit_hdr_s {
+    char magic[8];
+    uint32_t slots;
+    uint32_t slot_size;
+    uint64_t seq;                   /* last used sequence number */
+    char reserved[40];
+} crit_hdr_t;
+
+typedef struct crit_slot_s {
+    uint64_t seq;                   /* 0 - empty or being written */
+    uint64_t ts_ms;                 /* CLOCK_REALTIME */
+    uint32_t len;
+    char data[ING_LOG_CRIT_MSG_MAX + 1];
+} crit_slot_t;
+
+static crit_hdr_t *crit_map;
+static size_t crit_map_size = sizeof(crit_hdr_t) + ING_LOG_CRIT_SLOTS * sizeof(crit_slot_t);
+
+static int crit_path(char *buf, size_t size)
+{
+    const char *dir = getenv("INANGOLOGPATH");
+
+    if (!dir)
+        return -1;
+    return snprintf(buf, size, "%s/%s", dir, CRIT_FILE) < (int)size ? 0 : -1;
+}
+
+static void crit_open(void)
+{
+    char path[PATH_MAX];
+    crit_hdr_t *map;
+    struct stat st;
+    int fd;
+
+    if (__atomic_load_n(&crit_map, __ATOMIC_ACQUIRE) || crit_path(path, sizeof(path)) < 0)
+        return;
+
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): Cannot open %s: %s\n", __func__, __LINE__, path, strerror(errno));
+        return;
+    }
+    if (fstat(fd, &st) < 0 || ((size_t)st.st_size != crit_map_size && ftruncate(fd, 0) < 0) ||
+        ftruncate(fd, crit_map_size) < 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): Cannot resize %s: %s\n", __func__, __LINE__, path, strerror(errno));
+        close(fd);
+        return;
+    }
+    map = (crit_hdr_t *)mmap(NULL, crit_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        ing_log(LOG_ERR, " %s (%d): Cannot map %s: %s\n", __func__, __LINE__, path, strerror(errno));
+        return;
+    }
+
+    /* messages of the previous run are kept if the layout matches */
+    if (memcmp(map->magic, CRIT_MAGIC, 8) || map->slots != ING_LOG_CRIT_SLOTS ||
+        map->slot_size != sizeof(crit_slot_t))
+    {
+        memset(map, 0, crit_map_size);
+        map->slots = ING_LOG_CRIT_SLOTS;
+        map->slot_size = sizeof(crit_slot_t);
+        memcpy(map->magic, CRIT_MAGIC, 8);
+    }
+    __atomic_store_n(&crit_map, map, __ATOMIC_RELEASE);
+}
+
+static void crit_close(void)
+{
+    crit_hdr_t *map = __atomic_exchange_n(&crit_map, NULL, __ATOMIC_ACQ_REL);
+
+    if (map)
+        munmap(map, crit_map_size);
+}
+
+/* returns slot to write or NULL if the critical log is not open */
+static crit_slot_t *crit_slot_get(uint64_t *seq)
+{
+    crit_hdr_t *map = __atomic_load_n(&crit_map, __ATOMIC_ACQUIRE);
+    crit_slot_t *slot;
+
+    if (!map)
+        return NULL;
+    *seq = __atomic_add_fetch(&map->seq, 1, __ATOMIC_RELAXED);
+    slot = (crit_slot_t *)(map + 1) + (*seq - 1) % ING_LOG_CRIT_SLOTS;
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    return slot;
+}
+
+static void crit_slot_put(crit_slot_t *slot, uint64_t seq, size_t len)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    slot->ts_ms = (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    slot->len = len < sizeof(slot->data) ? len : sizeof(slot->data) - 1;
+    slot->data[slot->len] = '\0';
+    __atomic_store_n(&slot->seq, seq, __ATOMIC_RELEASE);
+}
+
+void ing_log_critical_str(const char *msg)
+{
+    crit_slot_t *slot;
+    uint64_t seq;
+    size_t len;
+
+    if (!msg)
+        return;
+    for (len = 0; msg[len]; len++)
+        ;
+
+    slot = crit_slot_get(&seq);
+    if (slot)
+    {
+        memcpy(slot->data, msg, len < sizeof(slot->data) ? len : sizeof(slot->data) - 1);
+        crit_slot_put(slot, seq, len);
+    }
+    while (len && write(STDERR_FILENO, msg, len) < 0 && errno == EINTR)
+        ;
+}
+
+static int crit_slot_cmp(const void *a, const void *b)
+{
+    uint64_t sa = (*(const crit_slot_t * const *)a)->seq;
+    uint64_t sb = (*(const crit_slot_t * const *)b)->seq;
+
+    return sa < sb ? -1 : sa > sb;
+}
+
+ing_stat_t ing_log_critical_dump(const char *path, FILE *out)
+{
+    char buf[PATH_MAX], ts[ING_CLOCK_TIMESTR_SIZE];
+    crit_slot_t *slots[ING_LOG_CRIT_SLOTS];
+    ing_stat_t res = ING_STAT_INVALID_ARGUMENT;
+    unsigned char *data;
+    crit_hdr_t *hdr;
+    crit_slot_t *slot;
+    FILE *in;
+    int i, n = 0;
+
+    if (!out)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!path)
+    {
+        if (crit_path(buf, sizeof(buf)) < 0)
+            return ING_STAT_INVALID_ARGUMENT;
+        path = buf;
+    }
+    if (!(in = fopen(path, "rb")))
+        return ING_STAT_NOT_FOUND;
+    data = (unsigned char *)malloc(crit_map_size);
+    if (!data)
+    {
+        fclose(in);
+        return ING_STAT_OUTOFMEMORY;
+    }
+
+    hdr = (crit_hdr_t *)data;
+    if (fread(data, 1, crit_map_size, in) == crit_map_size && !memcmp(hdr->magic, CRIT_MAGIC, 8) &&
+        hdr->slots == ING_LOG_CRIT_SLOTS && hdr->slot_size == sizeof(crit_slot_t))
+    {
+        for (i = 0; i < ING_LOG_CRIT_SLOTS; i++)
+        {
+            slot = (crit_slot_t *)(hdr + 1) + i;
+            if (slot->seq && slot->len < sizeof(slot->data))
+                slots[n++] = slot;
+        }
+        qsort(slots, n, sizeof(slots[0]), crit_slot_cmp);
+        for (i = 0; i < n; i++)
+        {
+            ing_clock_timestr_ms(ts, slots[i]->ts_ms);
+            fprintf(out, "%s |%s| %.*s", ts, priority2str(LOG_CRIT),
+                    (int)slots[i]->len, slots[i]->data);
+            if (!slots[i]->len || slots[i]->data[slots[i]->len - 1] != '\n')
+                fputc('\n', out);
+        }
+        res = ING_STAT_OK;
+    }
+    free(data);
+    fclose(in);
+    return res;
+}
+
+/***************************\
+*       Common logging      *
+\***************************/
+
+void ing_openlog(void)
+{
+    crit_open();
+#if USE_SYSLOG
+    openlog("EP", LOG_CONS | LOG_PID | LOG_NDELAY, LOG_DAEMON);
+    {
+        extern char *program_invocation_name;
+        ing_syslog_open(NULL, program_invocation_name, LOG_DAEMON, ING_SYSLOG_FORMAT);
+    }
+#endif
+}
+
+void ing_closelog(void)
+{
+    ing_logb_stop();
+    ing_log_async_stop();
+    crit_close();
+#if USE_SYSLOG
+    ing_syslog_close();
+    closelog();
+#endif
+}
+
+static void vlog(int priority, char *msg, va_list arg)
+{
+    va_list arg2;
+
+    if (__atomic_load_n(&async.enabled, __ATOMIC_ACQUIRE))
+    {
+        va_copy(arg2, arg);
+        if (async_vlog(priority, msg, arg2))
+        {
+            va_end(arg2);
+            return;
+        }
+        va_end(arg2);
+    }
+
+#if USE_SYSLOG
+    sink_vmsg(priority, msg, arg);
+#else
+    vflog(stdout, priority, msg, arg);
+#endif
+}
+
+void ing_log(int priority, char *msg, ...)
+{
+    va_list arg;
+
+    if (priority > __atomic_load_n(&ing_log_level, __ATOMIC_RELAXED))
+        return;
+
+    va_start(arg, msg);
+    vlog(priority, msg, arg);
+    va_end(arg);
+}
+
+void ing_log_vmsg(int priority, char *msg, va_list arg)
+{
+    vlog(priority, msg, arg);
+}
+
+void ing_log_msg(int priority, char *msg, ...)
+{
+    va_list arg;
+
+    va_start(arg, msg);
+    vlog(priority, msg, arg);
+    va_end(arg);
+}
+
+/* This message is written to the critical log regardless of log level.
+ * Without the critical log (see ing_openlog()) it goes to
+ * cg_critical_err.log file, which keeps only one message
+ */
+void ing_log_critical(char *msg, ...)
+{
+    crit_slot_t *slot;
+    uint64_t seq;
+    va_list arg;
+    int len;
+
+    slot = crit_slot_get(&seq);
+    if (slot)
+    {
+        va_start(arg, msg);
+        len = vsnprintf(slot->data, sizeof(slot->data), msg, arg);
+        va_end(arg);
+        crit_slot_put(slot, seq, len > 0 ? len : 0);
+    }
+    else
+    {
+        char buf[PATH_MAX];
+        const char *dir = getenv("INANGOLOGPATH");
+        FILE *f;
+
+        if (dir && snprintf(buf, sizeof(buf), "%s/cg_critical_err.log", dir) < (int)sizeof(buf) &&
+            (f = fopen(buf, "w")) != NULL)
+        {
+            va_start(arg, msg);
+            vflog(f, LOG_CRIT, msg, arg);
+            va_end(arg);
+            fclose(f);
+        }
+    }
+
+#if USE_SYSLOG
+    va_start(arg, msg);
+    sink_vmsg(LOG_CRIT, msg, arg);
+    va_end(arg);
+#else
+    va_start(arg, msg);
+    vflog(stderr, LOG_CRIT, msg, arg);
+    va_end(arg);
+#endif
+}
@@ -0,0 +1,321 @@
+/* ing_log.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Logging extensions
+ *
+ * Basic logging API (ing_openlog(), ing_log(), ...) is declared in
+ * ing_gen_utils.h.
+ */
+
+#ifndef ING_LOG_H_
+#define ING_LOG_H_
+
+#include "ing_gen_utils.h"
+
+/***************************\
+*     Levels and modules    *
+\***************************/
+
+/*
+ * Messages with priority above the level (less severe) are not logged.
+ * Use ING_LOG()/ING_LOGM() instead of calling ing_log() directly: they check
+ * the level before arguments are evaluated, and calls above
+ * ING_LOG_BUILD_LEVEL are removed by the compiler.
+ */
+#ifndef ING_LOG_BUILD_LEVEL
+#define ING_LOG_BUILD_LEVEL     LOG_DEBUG
+#endif
+
+#define ING_LOG_LEVEL_INHERIT   (-1)    /* module uses global level */
+
+typedef struct ing_log_module_s {
+    const char *name;
+    int level;
+    struct ing_log_module_s *next;
+} ing_log_module_t;
+
+/* global runtime level, LOG_DEBUG by default; use ing_log_set_level() */
+extern int ing_log_level;
+
+void ing_log_set_level(int level);
+
+/* same as ing_log() but does not check the level; used by ING_LOG() macros */
+void ing_log_msg(int priority, char *msg, ...);
+
+void ing_log_vmsg(int priority, char *msg, va_list arg);
+
+/*
+ * Defines log module var named name; the module is registered on startup.
+ * In other files of the same component declare it by
+ *   extern ing_log_module_t var;
+ */
+#define ING_LOG_MODULE(var, name)                                           \
+    ing_log_module_t var = { name, ING_LOG_LEVEL_INHERIT, NULL };            \
+    static void __attribute__((constructor)) var##_ing_log_register(void)   \
+    {                                                                       \
+        ing_log_module_register(&var);                                      \
+    }
+
+void ing_log_module_register(ing_log_module_t *mod);
+
+/* sets level of the registered module with this name;
+ * level ING_LOG_LEVEL_INHERIT returns the module to the global level
+ */
+ing_stat_t ing_log_set_module_level(const char *name, int level);
+
+#define ing_log_module_level(mod) \
+    ((mod).level != ING_LOG_LEVEL_INHERIT ? (mod).level : ing_log_level)
+
+#define ING_LOG_ENABLED(prio) \
+    ((prio) <= ING_LOG_BUILD_LEVEL && (prio) <= ing_log_level)
+
+#define ING_LOGM_ENABLED(mod, prio) \
+    ((prio) <= ING_LOG_BUILD_LEVEL && (prio) <= ing_log_module_level(mod))
+
+#define ING_LOG(prio, ...)                                                  \
+do {                                                                        \
+    if (ING_LOG_ENABLED(prio))                                              \
+        ing_log_msg(prio, __VA_ARGS__);                                     \
+} while (0)
+
+#define ING_LOGM(mod, prio, ...)                                            \
+do {                                                                        \
+    if (ING_LOGM_ENABLED(mod, prio))                                        \
+        ing_log_msg(prio, __VA_ARGS__);                                     \
+} while (0)
+
+/***************************\
+*       Rate limiting       *
+\***************************/
+
+typedef struct ing_log_ratelimit_s {
+    int lock;
+    int tokens;
+    unsigned long last_ms;          /* time tokens were refilled at */
+    unsigned long suppressed;
+} ing_log_ratelimit_t;
+
+/*
+ * Token bucket: allows burst messages at once and rate messages per second
+ * on average. Returns TRUE if a message may be logged; suppressed gets the
+ * number of messages suppressed since the previous allowed one.
+ */
+int ing_log_ratelimit(ing_log_ratelimit_t *rl, int rate, int burst, unsigned long *suppressed);
+
+/* rate limited ING_LOG(), one bucket per call site */
+#define ING_LOG_RATELIMITED(prio, rate, burst, ...)                          \
+do {                                                                        \
+    static ing_log_ratelimit_t _ing_rl;                                     \
+    unsigned long _ing_suppressed;                                          \
+    if (ING_LOG_ENABLED(prio) &&                                            \
+        ing_log_ratelimit(&_ing_rl, rate, burst, &_ing_suppressed))         \
+    {                                                                       \
+        if (_ing_suppressed)                                                \
+            ing_log_msg(prio, " %s (%d): suppressed %lu messages\n",        \
+                        __func__, __LINE__, _ing_suppressed);               \
+        ing_log_msg(prio, __VA_ARGS__);                                     \
+    }                                                                       \
+} while (0)
+
+/***************************\
+*        Syslog sink        *
+\***************************/
+
+/*
+ * With USE_SYSLOG ing_log() sends messages to syslogd itself instead of
+ * libc syslog(): the socket stays connected, headers are formatted here
+ * and the asynchronous mode sends a batch of messages in one sendmmsg().
+ * The socket is reconnected when syslogd restarts.
+ */
+#define ING_SYSLOG_RFC3164      0   /* <PRI>Mmm dd hh:mm:ss ident[pid]: msg */
+#define ING_SYSLOG_RFC5424      1   /* <PRI>1 timestamp host ident pid - - msg */
+
+#ifndef ING_SYSLOG_PATH
+#define ING_SYSLOG_PATH         "/dev/log"
+#endif
+
+#ifndef ING_SYSLOG_FORMAT
+#define ING_SYSLOG_FORMAT       ING_SYSLOG_RFC3164
+#endif
+
+/* path NULL - ING_SYSLOG_PATH; ident NULL - program name.
+ * ing_openlog() calls it with defaults when built with USE_SYSLOG
+ */
+ing_stat_t ing_syslog_open(const char *path, const char *ident, int facility, int format);
+
+/* waits for sends already in progress in other threads before closing */
+void ing_syslog_close(void);
+
+/* sends n messages with given priorities */
+ing_stat_t ing_syslog_sendv(const int *priorities, const ing_strview_t *msgs, int n);
+
+/***************************\
+*      Asynchronous mode    *
+\***************************/
+
+/*
+ * In asynchronous mode ing_log() formats the message into a slot of a
+ * lock-free ring buffer and returns. A background thread writes ready
+ * messages to the log in batches (one writev() per batch).
+ * Messages longer than ING_LOG_ASYNC_MSG_SIZE are truncated; messages that
+ * do not fit the ring are dropped and counted.
+ * Pending messages are flushed by ing_log_async_stop(), ing_closelog()
+ * and on exit.
+ */
+#define ING_LOG_ASYNC_MSG_SIZE  512
+#define ING_LOG_ASYNC_SLOTS     1024
+
+/* slots - ring capacity in messages, rounded up to a power of 2;
+ * 0 selects ING_LOG_ASYNC_SLOTS
+ */
+ing_stat_t ing_log_async_start(int slots);
+
+/* flush pending messages and return to synchronous mode */
+void ing_log_async_stop(void);
+
+/* wait until all messages logged so far are written */
+void ing_log_flush(void);
+
+/* number of messages dropped because the ring was full */
+unsigned long ing_log_dropped(void);
+
+/***************************\
+*       Critical log        *
+\***************************/
+
+/*
+ * ing_openlog() maps $INANGOLOGPATH/cg_critical_err.ring holding the last
+ * ING_LOG_CRIT_SLOTS critical messages; the file survives crashes and
+ * restarts. ing_log_critical() formats into the mapping directly, without
+ * allocations or file operations. A slot of ING_LOG_CRIT_MSG_SIZE bytes
+ * keeps up to ING_LOG_CRIT_MSG_MAX characters of a message.
+ */
+#define ING_LOG_CRIT_SLOTS      64
+#define ING_LOG_CRIT_MSG_SIZE   256
+#define ING_LOG_CRIT_MSG_MAX    (ING_LOG_CRIT_MSG_SIZE - 21)    /* 20 bytes of slot header */
+
+/* async-signal-safe: stores msg as is and writes it to stderr */
+void ing_log_critical_str(const char *msg);
+
+/* prints critical log file to out, oldest message first;
+ * path NULL - the file of $INANGOLOGPATH
+ */
+ing_stat_t ing_log_critical_dump(const char *path, FILE *out);
+
+/***************************\
+*        Binary mode        *
+\***************************/
+
+/*
+ * ING_LOGB() call sites do not format messages: the format is registered
+ * once per call site, then every call copies the raw arguments (strings
+ * included) with a timestamp into a buffer of the calling thread.
+ * A background thread either formats the records as text (same output as
+ * ing_log()) or writes them unformatted to a binary file, which is decoded
+ * later by ing_logdecode tool or ing_logb_decode().
+ *
+ * Formats using '*' width/precision, %n or wide characters can not be
+ * deferred; such call sites are logged by ing_log_msg(). So are all
+ * ING_LOGB() calls while the binary mode is not started.
+ *
+ * Messages of one thread keep their order; messages of different threads
+ * may be interleaved out of time order. The binary file is read on a
+ * machine of the same architecture only.
+ */
+typedef struct ing_logb_site_s {
+    int id;                         /* 0 - not registered, -1 - not deferrable */
+    const void *fmt;
+} ing_logb_site_t;
+
+#define ING_LOGB(prio, ...)                                                 \
+do {                                                                        \
+    static ing_logb_site_t _ing_site;                                       \
+    if (ING_LOG_ENABLED(prio))                                              \
+        ing_logb(&_ing_site, prio, __FILE__, __LINE__, __VA_ARGS__);        \
+} while (0)
+
+void ing_logb(ing_logb_site_t *site, int priority, const char *file, int line,
+    const char *fmt, ...);
+
+/* path - binary log file; NULL - format in background and log as text */
+ing_stat_t ing_logb_start(const char *path);
+
+/* write all pending records and stop the background thread */
+void ing_logb_stop(void);
+
+/* wait until all records logged so far are written */
+void ing_logb_flush(void);
+
+/* number of records dropped because a thread buffer was full */
+unsigned long ing_logb_dropped(void);
+
+/* decode binary log in to text out */
+ing_stat_t ing_logb_decode(FILE *in, FILE *out);
+
+#endif /* ING_LOG_H_ */
@@ -0,0 +1,505 @@
+/* ing_nvset.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Compact name/value pair set implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "ing_nvset.h"
+#include "ing_log.h"
+
+#define SYM_TABLE_MIN   256
+
+/*
+ * Symbol table: open addressing, linear probing, symbols are never removed;
+ * the number of symbols is bounded by limit
+ */
+static struct {
+    pthread_rwlock_t lock;
+    struct ing_sym_s **slots;
+    size_t size;                    /* power of 2 */
+    size_t count;
+    size_t limit;
+    ing_arena_t arena;
+} sym_table = { PTHREAD_RWLOCK_INITIALIZER, NULL, 0, 0, ING_SYM_MAX, { NULL, NULL, 0, 0 } };
+
+/* FNV-1a */
+static uint32_t sym_hash(const char *name, size_t len)
+{
+    uint32_t hashv = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        hashv ^= (unsigned char)name[i];
+        hashv *= 16777619u;
+    }
+    return hashv;
+}
+
+static struct ing_sym_s *sym_find(const char *name, size_t len, uint32_t hash)
+{
+    size_t i, mask = sym_table.size - 1;
+    struct ing_sym_s *sym;
+
+    if (!sym_table.size)
+        return NULL;
+    for (i = hash & mask; (sym = sym_table.slots[i]) != NULL; i = (i + 1) & mask)
+    {
+        if (sym->hash == hash && sym->len == len && !memcmp(sym->name, name, len))
+            return sym;
+    }
+    return NULL;
+}
+
+static ing_stat_t sym_grow(void)
+{
+    size_t i, j, size = sym_table.size ? sym_table.size * 2 : SYM_TABLE_MIN;
+    struct ing_sym_s **slots = (struct ing_sym_s **)calloc(size, sizeof(*slots));
+
+    if (!slots)
+        return ING_STAT_OUTOFMEMORY;
+    for (i = 0; i < sym_table.size; i++)
+    {
+        if (!sym_table.slots[i])
+            continue;
+        for (j = sym_table.slots[i]->hash & (size - 1); slots[j]; j = (j + 1) & (size - 1))
+            ;
+        slots[j] = sym_table.slots[i];
+    }
+    free(sym_table.slots);
+    sym_table.slots = slots;
+    sym_table.size = size;
+    return ING_STAT_OK;
+}
+
+/* res is ING_STAT_FULL if the table holds limit symbols */
+static ing_sym_t sym_intern(const char *name, size_t len, ing_stat_t *res)
+{
+    uint32_t hash;
+    struct ing_sym_s *sym;
+    size_t i;
+
+    *res = ING_STAT_INVALID_ARGUMENT;
+    if (!name || len > UINT32_MAX)
+        return NULL;
+    *res = ING_STAT_OK;
+
+    hash = sym_hash(name, len);
+    pthread_rwlock_rdlock(&sym_table.lock);
+    sym = sym_find(name, len, hash);
+    pthread_rwlock_unlock(&sym_table.lock);
+    if (sym)
+        return sym;
+
+    pthread_rwlock_wrlock(&sym_table.lock);
+    /* could be added while the lock was released */
+    sym = sym_find(name, len, hash);
+    if (sym)
+        goto out;
+
+    if (sym_table.limit && sym_table.count >= sym_table.limit)
+    {
+        *res = ING_STAT_FULL;
+        goto out;
+    }
+    if (!sym_table.arena.chunk_size)
+        ing_arena_init(&sym_table.arena, 0);
+    if ((sym_table.count + 1) * 2 > sym_table.size && sym_grow() != ING_STAT_OK)
+        goto out;
+
+    sym = (struct ing_sym_s *)ing_arena_alloc(&sym_table.arena, sizeof(*sym) + len + 1);
+    if (!sym)
+        goto out;
+    sym->hash = hash;
+    sym->len = (uint32_t)len;
+    memcpy(sym->name, name, len);
+    sym->name[len] = '\0';
+
+    for (i = hash & (sym_table.size - 1); sym_table.slots[i]; i = (i + 1) & (sym_table.size - 1))
+        ;
+    sym_table.slots[i] = sym;
+    sym_table.count++;
+
+out:
+    pthread_rwlock_unlock(&sym_table.lock);
+    if (sym)
+        return sym;
+    if (*res == ING_STAT_FULL)
+        ING_LOG_RATELIMITED(LOG_ERR, 1, 1, " %s (%d): symbol table is full (%zu names)\n",
+            __func__, __LINE__, sym_table.limit);
+    else
+    {
+        *res = ING_STAT_OUTOFMEMORY;
+        ing_log(LOG_ERR, " %s (%d): Out of memory\n", __func__, __LINE__);
+    }
+    return NULL;
+}
+
+ing_sym_t ing_sym_internn(const char *name, size_t len)
+{
+    ing_stat_t res;
+
+    return sym_intern(name, len, &res);
+}
+
+ing_sym_t ing_sym_intern(const char *name)
+{
+    return name ? ing_sym_internn(name, strlen(name)) : NULL;
+}
+
+ing_sym_t ing_sym_lookup(const char *name)
+{
+    struct ing_sym_s *sym;
+    size_t len;
+
+    if (!name)
+        return NULL;
+    len = strlen(name);
+
+    pthread_rwlock_rdlock(&sym_table.lock);
+    sym = sym_find(name, len, sym_hash(name, len));
+    pthread_rwlock_unlock(&sym_table.lock);
+    return sym;
+}
+
+void ing_sym_set_limit(size_t max)
+{
+    pthread_rwlock_wrlock(&sym_table.lock);
+    sym_table.limit = max;
+    pthread_rwlock_unlock(&sym_table.lock);
+}
+
+size_t ing_sym_count(void)
+{
+    size_t count;
+
+    pthread_rwlock_rdlock(&sym_table.lock);
+    count = sym_table.count;
+    pthread_rwlock_unlock(&sym_table.lock);
+    return count;
+}
+
+void ing_sym_cleanup(void)
+{
+    pthread_rwlock_wrlock(&sym_table.lock);
+    free(sym_table.slots);
+    sym_table.slots = NULL;
+    sym_table.size = sym_table.count = 0;
+    ing_arena_destroy(&sym_table.arena);
+    pthread_rwlock_unlock(&sym_table.lock);
+}
+
+/*
+ * Set
+ */
+static int nvset_slot(const ing_nvset_t *set, ing_sym_t name)
+{
+    int i, mask = set->index_size - 1;
+
+    for (i = name->hash & mask; set->index[i]; i = (i + 1) & mask)
+    {
+        if (set->pairs[set->index[i] - 1].name == name)
+            break;
+    }
+    return i;
+}
+
+/* the set is changed only when both allocations succeed */
+static ing_stat_t nvset_grow(ing_nvset_t *set)
+{
+    int i, j, capacity = set->capacity ? set->capacity * 2 : 16;
+    int size = set->index_size;
+    ing_nvp_t *pairs;
+    int *index = NULL;
+
+    if (size < capacity * 2)
+    {
+        while (size < capacity * 2)
+            size = size ? size * 2 : 32;
+        index = (int *)calloc(size, sizeof(*index));
+        if (!index)
+            return ING_STAT_OUTOFMEMORY;
+        for (i = 0; i < set->count; i++)
+        {
+            for (j = set->pairs[i].name->hash & (size - 1); index[j]; j = (j + 1) & (size - 1))
+                ;
+            index[j] = i + 1;
+        }
+    }
+
+    pairs = (ing_nvp_t *)realloc(set->pairs, capacity * sizeof(*pairs));
+    if (!pairs)
+    {
+        free(index);
+        return ING_STAT_OUTOFMEMORY;
+    }
+    set->pairs = pairs;
+    set->capacity = capacity;
+    if (index)
+    {
+        free(set->index);
+        set->index = index;
+        set->index_size = size;
+    }
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_nvset_init(ing_nvset_t *set, int capacity)
+{
+    if (!set || capacity < 0)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    memset(set, 0, sizeof(*set));
+    ing_arena_init(&set->arena, 0);
+    if (capacity)
+    {
+        set->capacity = capacity / 2;
+        return nvset_grow(set);
+    }
+    return ING_STAT_OK;
+}
+
+void ing_nvset_destroy(ing_nvset_t *set)
+{
+    if (!set)
+        return;
+    ing_arena_destroy(&set->arena);
+    free(set->pairs);
+    free(set->index);
+    memset(set, 0, sizeof(*set));
+}
+
+void ing_nvset_clear(ing_nvset_t *set)
+{
+    if (!set)
+        return;
+    ing_arena_reset(&set->arena);
+    if (set->index)
+        memset(set->index, 0, set->index_size * sizeof(*set->index));
+    set->count = 0;
+}
+
+ing_stat_t ing_nvset_set_sym(ing_nvset_t *set, ing_sym_t name, const char *value, size_t len)
+{
+    ing_nvval_t *val;
+    ing_stat_t res;
+    int slot;
+
+    if (!set || !name || (!value && len) || len > UINT32_MAX)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    if (set->count == set->capacity && (res = nvset_grow(set)) != ING_STAT_OK)
+        return res;
+
+    val = (ing_nvval_t *)ing_arena_alloc(&set->arena, sizeof(*val) + len + 1);
+    if (!val)
+        return ING_STAT_OUTOFMEMORY;
+    val->len = (uint32_t)len;
+    if (len)
+        memcpy(val->data, value, len);
+    val->data[len] = '\0';
+
+    slot = nvset_slot(set, name);
+    if (set->index[slot])
+    {
+        set->pairs[set->index[slot] - 1].value = val;
+        return ING_STAT_OK;
+    }
+    set->pairs[set->count].name = name;
+    set->pairs[set->count].value = val;
+    set->index[slot] = ++set->count;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_nvset_set(ing_nvset_t *set, const char *name, const char *value)
+{
+    ing_stat_t res;
+    ing_sym_t sym;
+
+    if (!set || !name || !value)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!(sym = sym_intern(name, strlen(name), &res)))
+        return res;
+    return ing_nvset_set_sym(set, sym, value, strlen(value));
+}
+
+const char *ing_nvset_get_sym(const ing_nvset_t *set, ing_sym_t name, size_t *len)
+{
+    ing_nvval_t *val;
+    int slot;
+
+    if (!set || !name || !set->count)
+        return NULL;
+    slot = nvset_slot(set, name);
+    if (!set->index[slot])
+        return NULL;
+
+    val = set->pairs[set->index[slot] - 1].value;
+    if (len)
+        *len = val->len;
+    return val->data;
+}
+
+const char *ing_nvset_get(const ing_nvset_t *set, const char *name, size_t *len)
+{
+    /* a name that was never interned can not be in any set */
+    return ing_nvset_get_sym(set, ing_sym_lookup(name), len);
+}
+
+ing_stat_t ing_nvset_del(ing_nvset_t *set, const char *name)
+{
+    ing_sym_t sym;
+    int slot, i, j, home, pos, mask;
+
+    if (!set || !name)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!(sym = ing_sym_lookup(name)) || !set->count)
+        return ING_STAT_NOT_FOUND;
+    slot = nvset_slot(set, sym);
+    if (!set->index[slot])
+        return ING_STAT_NOT_FOUND;
+
+    /* backward shift deletion keeps probe sequences unbroken; pairs are
+     * not touched yet, so homes of the shifted entries are still right
+     */
+    pos = set->index[slot] - 1;
+    mask = set->index_size - 1;
+    i = slot;
+    for (j = (i + 1) & mask; set->index[j]; j = (j + 1) & mask)
+    {
+        home = set->pairs[set->index[j] - 1].name->hash & mask;
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            set->index[i] = set->index[j];
+            i = j;
+        }
+    }
+    set->index[i] = 0;
+
+    /* move the last pair into the hole; its index entry still holds count */
+    if (pos != set->count - 1)
+    {
+        set->index[nvset_slot(set, set->pairs[set->count - 1].name)] = pos + 1;
+        set->pairs[pos] = set->pairs[set->count - 1];
+    }
+    set->count--;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_nvset_from_nvp(ing_nvset_t *set, const namevaluepair_t *nvps, int n)
+{
+    ing_stat_t res;
+    int i;
+
+    if (!set || (!nvps && n) || n < 0)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    for (i = 0; i < n; i++)
+    {
+        res = ing_nvset_set(set, nvps[i].name, nvps[i].value);
+        if (res != ING_STAT_OK)
+            return res;
+    }
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_nvset_to_nvp(const ing_nvset_t *set, namevaluepair_t *nvps, int n, int *count)
+{
+    ing_stat_t res = ING_STAT_OK;
+    const ing_nvp_t *nvp;
+    int i;
+
+    if (!set || (!nvps && n) || n < 0 || !count)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    for (i = 0; i < set->count; i++)
+    {
+        if (i == n)
+        {
+            res = ING_STAT_FULL;
+            break;
+        }
+        nvp = &set->pairs[i];
+        if (nvp->name->len >= NVP_MAX_NAME_LEN || nvp->value->len >= NVP_MAX_VALUE_LEN)
+        {
+            res = ING_STAT_INVALID_ARGUMENT;
+            break;
+        }
+        memcpy(nvps[i].name, nvp->name->name, nvp->name->len + 1);
+        memcpy(nvps[i].value, nvp->value->data, nvp->value->len + 1);
+    }
+    *count = i;
+    return res;
+}
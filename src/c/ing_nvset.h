@@ -0,0 +1,192 @@
+/* ing_nvset.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Compact name/value pair set
+ *
+ * Names are interned into a process-wide symbol table, so a name is
+ * represented by a pointer (ing_sym_t) and names are compared by pointer.
+ * Values are stored length-prefixed in the set's arena: memory used by
+ * a pair is close to the sizes of its name and value, unlike 384 bytes
+ * of a namevaluepair_t.
+ *
+ * A set is not thread-safe; the symbol table is.
+ */
+
+#ifndef ING_NVSET_H_
+#define ING_NVSET_H_
+
+#include <stdint.h>
+
+#include "ing_gen_utils.h"
+#include "ing_alloc.h"
+
+/*
+ * Interned names
+ */
+struct ing_sym_s {
+    uint32_t hash;
+    uint32_t len;
+    char name[];
+};
+
+typedef const struct ing_sym_s *ing_sym_t;
+
+/*
+ * Names come from messages too, so the table holds at most ING_SYM_MAX
+ * symbols (ing_sym_set_limit() changes it). A name is not interned when
+ * the table is full
+ */
+#ifndef ING_SYM_MAX
+#define ING_SYM_MAX     65536
+#endif
+
+/* returns the symbol of name, creating it if needed; NULL if out of memory
+ * or the table is full
+ */
+ing_sym_t ing_sym_intern(const char *name);
+
+ing_sym_t ing_sym_internn(const char *name, size_t len);
+
+/* returns the symbol of name or NULL if name was never interned */
+ing_sym_t ing_sym_lookup(const char *name);
+
+#define ing_sym_name(sym)   ((sym)->name)
+#define ing_sym_len(sym)    ((sym)->len)
+
+/* max - number of symbols, 0 - unlimited; symbols already interned are kept */
+void ing_sym_set_limit(size_t max);
+
+size_t ing_sym_count(void);
+
+/* frees the symbol table; all symbols become invalid. Call when no symbol
+ * is in use, e.g. on exit or after all sets are destroyed
+ */
+void ing_sym_cleanup(void);
+
+/*
+ * Name/value set
+ */
+typedef struct ing_nvval_s {
+    uint32_t len;
+    char data[];                    /* '\0'-terminated */
+} ing_nvval_t;
+
+typedef struct ing_nvp_s {
+    ing_sym_t name;
+    ing_nvval_t *value;
+} ing_nvp_t;
+
+typedef struct ing_nvset_s {
+    ing_arena_t arena;              /* values */
+    ing_nvp_t *pairs;
+    int count;
+    int capacity;
+    int *index;                     /* open addressing: pair index + 1, 0 - empty */
+    int index_size;                 /* power of 2 */
+} ing_nvset_t;
+
+/* initialize set; capacity is a hint of expected number of pairs */
+ing_stat_t ing_nvset_init(ing_nvset_t *set, int capacity);
+
+void ing_nvset_destroy(ing_nvset_t *set);
+
+/* remove all pairs, memory is kept for reuse */
+void ing_nvset_clear(ing_nvset_t *set);
+
+/* add pair or replace the value of existing one. The memory of a replaced
+ * value is reclaimed by ing_nvset_clear() only. Returns ING_STAT_FULL if
+ * name is new and the symbol table is full
+ */
+ing_stat_t ing_nvset_set(ing_nvset_t *set, const char *name, const char *value);
+
+ing_stat_t ing_nvset_set_sym(ing_nvset_t *set, ing_sym_t name, const char *value, size_t len);
+
+/* returns value of name or NULL if not found; len is optional */
+const char *ing_nvset_get(const ing_nvset_t *set, const char *name, size_t *len);
+
+const char *ing_nvset_get_sym(const ing_nvset_t *set, ing_sym_t name, size_t *len);
+
+/* remove pair; the last pair takes place of the removed one */
+ing_stat_t ing_nvset_del(ing_nvset_t *set, const char *name);
+
+#define ing_nvset_count(set)    ((set)->count)
+
+/* i-th pair, 0 <= i < ing_nvset_count(set) */
+#define ing_nvset_at(set, i)    (&(set)->pairs[i])
+
+/* add pairs of array nvps of n elements */
+ing_stat_t ing_nvset_from_nvp(ing_nvset_t *set, const namevaluepair_t *nvps, int n);
+
+/* copy pairs to array nvps of n elements; number of copied pairs is
+ * returned in count. Returns ING_STAT_FULL if the array is too small and
+ * ING_STAT_INVALID_ARGUMENT if a name or value does not fit namevaluepair_t
+ */
+ing_stat_t ing_nvset_to_nvp(const ing_nvset_t *set, namevaluepair_t *nvps, int n, int *count);
+
+#endif /* ING_NVSET_H_ */
@@ -0,0 +1,291 @@
+/* ing_nvwire.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Compact wire encoding of name/value pair lists implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+
+#include "ing_nvwire.h"
+
+static size_t varint_put(unsigned char *p, uint64_t v)
+{
+    size_t n = 0;
+
+    while (v >= 0x80)
+    {
+        p[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (unsigned char)v;
+    return n;
+}
+
+static size_t varint_size(uint64_t v)
+{
+    size_t n = 1;
+
+    while (v >= 0x80)
+    {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+/* returns 0 if varint is truncated, too long or does not fit 64 bits */
+static size_t varint_get(const unsigned char *p, size_t avail, uint64_t *v)
+{
+    size_t n;
+    int shift = 0;
+
+    *v = 0;
+    for (n = 0; n < avail && n < ING_NVWIRE_VARINT_MAX; n++, shift += 7)
+    {
+        /* the last byte holds the 64th bit only */
+        if (n == ING_NVWIRE_VARINT_MAX - 1 && p[n] > 1)
+            return 0;
+        *v |= (uint64_t)(p[n] & 0x7f) << shift;
+        if (!(p[n] & 0x80))
+            return n + 1;
+    }
+    return 0;
+}
+
+static void put_le32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static uint32_t get_le32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+ing_stat_t ing_nvwire_enc_init(ing_nvwire_enc_t *enc, void *buf, size_t size)
+{
+    if (!enc || !buf)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (size < ING_NVWIRE_HDR_SIZE)
+        return ING_STAT_FULL;
+
+    enc->buf = (unsigned char *)buf;
+    enc->size = size;
+    enc->count = 0;
+    enc->buf[0] = 'N';
+    enc->buf[1] = 'V';
+    enc->buf[2] = ING_NVWIRE_VERSION;
+    enc->buf[3] = 0;
+    put_le32(enc->buf + 4, 0);
+    enc->len = ING_NVWIRE_HDR_SIZE;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_nvwire_enc_add(ing_nvwire_enc_t *enc, const char *name, size_t name_len,
+    const char *value, size_t value_len)
+{
+    unsigned char *p;
+
+    if (!enc || !enc->buf || (!name && name_len) || (!value && value_len))
+        return ING_STAT_INVALID_ARGUMENT;
+    if (enc->count == UINT32_MAX ||
+        enc->size - enc->len < varint_size(name_len) + name_len + varint_size(value_len) + value_len)
+        return ING_STAT_FULL;
+
+    p = enc->buf + enc->len;
+    p += varint_put(p, name_len);
+    if (name_len)
+        memcpy(p, name, name_len);
+    p += name_len;
+    p += varint_put(p, value_len);
+    if (value_len)
+        memcpy(p, value, value_len);
+    p += value_len;
+
+    enc->len = p - enc->buf;
+    enc->count++;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_nvwire_enc_add_nvp(ing_nvwire_enc_t *enc, const namevaluepair_t *nvps, int n)
+{
+    ing_stat_t res;
+    int i;
+
+    if (!nvps && n)
+        return ING_STAT_INVALID_ARGUMENT;
+    for (i = 0; i < n; i++)
+    {
+        res = ing_nvwire_enc_add(enc, nvps[i].name, strnlen(nvps[i].name, NVP_MAX_NAME_LEN),
+                                 nvps[i].value, strnlen(nvps[i].value, NVP_MAX_VALUE_LEN));
+        if (res != ING_STAT_OK)
+            return res;
+    }
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_nvwire_enc_add_nvpair(ing_nvwire_enc_t *enc, const nvpair_t *nvps, int n)
+{
+    ing_stat_t res;
+    int i;
+
+    if (!nvps && n)
+        return ING_STAT_INVALID_ARGUMENT;
+    for (i = 0; i < n; i++)
+    {
+        res = ing_nvwire_enc_add(enc, nvps[i].name, strnlen(nvps[i].name, NVP_MAX_NAME_LEN),
+                                 nvps[i].pValue, nvps[i].pValue ? strlen(nvps[i].pValue) : 0);
+        if (res != ING_STAT_OK)
+            return res;
+    }
+    return ING_STAT_OK;
+}
+
+size_t ing_nvwire_enc_finish(ing_nvwire_enc_t *enc)
+{
+    if (!enc || !enc->buf)
+        return 0;
+    put_le32(enc->buf + 4, enc->count);
+    return enc->len;
+}
+
+ing_stat_t ing_nvwire_dec_init(ing_nvwire_dec_t *dec, const void *buf, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)buf;
+
+    if (!dec || !p || len < ING_NVWIRE_HDR_SIZE ||
+        p[0] != 'N' || p[1] != 'V' || p[2] != ING_NVWIRE_VERSION)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    dec->buf = p;
+    dec->len = len;
+    dec->pos = ING_NVWIRE_HDR_SIZE;
+    dec->count = get_le32(p + 4);
+    dec->index = 0;
+    return ING_STAT_OK;
+}
+
+static ing_stat_t dec_str(ing_nvwire_dec_t *dec, ing_strview_t *str)
+{
+    uint64_t len;
+    size_t n = varint_get(dec->buf + dec->pos, dec->len - dec->pos, &len);
+
+    if (!n || len > dec->len - dec->pos - n)
+        return ING_STAT_INVALID_ARGUMENT;
+    str->ptr = (const char *)dec->buf + dec->pos + n;
+    str->len = (size_t)len;
+    dec->pos += n + (size_t)len;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_nvwire_dec_next(ing_nvwire_dec_t *dec, ing_nvwire_pair_t *pair)
+{
+    if (!dec || !dec->buf || !pair)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (dec->index == dec->count)
+        return ING_STAT_NOT_FOUND;
+
+    if (dec_str(dec, &pair->name) != ING_STAT_OK || dec_str(dec, &pair->value) != ING_STAT_OK)
+    {
+        ing_log(LOG_ERR, " %s (%d): Malformed message: pair %u of %u\n",
+                __func__, __LINE__, dec->index, dec->count);
+        return ING_STAT_INVALID_ARGUMENT;
+    }
+    dec->index++;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_nvwire_decode(const void *buf, size_t len, ing_nvwire_pair_t *pairs,
+    int max, int *count)
+{
+    ing_nvwire_dec_t dec;
+    ing_stat_t res;
+    int n = 0;
+
+    if (!count || (!pairs && max) || max < 0)
+        return ING_STAT_INVALID_ARGUMENT;
+    *count = 0;
+    if ((res = ing_nvwire_dec_init(&dec, buf, len)) != ING_STAT_OK)
+        return res;
+
+    while (n < max && (res = ing_nvwire_dec_next(&dec, &pairs[n])) == ING_STAT_OK)
+        n++;
+    *count = n;
+
+    if (res == ING_STAT_NOT_FOUND)
+        return ING_STAT_OK;
+    if (res == ING_STAT_OK)
+        return dec.index == dec.count ? ING_STAT_OK : ING_STAT_FULL;
+    return res;
+}
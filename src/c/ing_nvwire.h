@@ -0,0 +1,160 @@
+/* ing_nvwire.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Compact wire encoding of name/value pair lists
+ *
+ * Message layout (integers are little endian):
+ *
+ *   'N' 'V' <version:1> <flags:1> <count:4>
+ *   count times: <name len:varint> <name> <value len:varint> <value>
+ *
+ * varint is LEB128: 7 bits per byte, high bit set on all bytes but the last.
+ * Strings are not '\0'-terminated on the wire.
+ *
+ * The encoder writes directly into a caller buffer (e.g. the one passed to
+ * send()). The decoder does not copy: names and values are returned as
+ * views into the received buffer, which must outlive them.
+ */
+
+#ifndef ING_NVWIRE_H_
+#define ING_NVWIRE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ing_gen_utils.h"
+
+#define ING_NVWIRE_VERSION      1
+#define ING_NVWIRE_HDR_SIZE     8
+#define ING_NVWIRE_VARINT_MAX   10  /* bytes of the largest varint */
+
+/* upper bound of encoded size of one pair */
+#define ING_NVWIRE_PAIR_SIZE(name_len, value_len) \
+    (2 * ING_NVWIRE_VARINT_MAX + (name_len) + (value_len))
+
+typedef struct ing_nvwire_enc_s {
+    unsigned char *buf;
+    size_t size;
+    size_t len;                     /* bytes written */
+    uint32_t count;                 /* pairs written */
+} ing_nvwire_enc_t;
+
+typedef struct ing_nvwire_pair_s {
+    ing_strview_t name;
+    ing_strview_t value;
+} ing_nvwire_pair_t;
+
+typedef struct ing_nvwire_dec_s {
+    const unsigned char *buf;
+    size_t len;
+    size_t pos;
+    uint32_t count;                 /* pairs in the message */
+    uint32_t index;                 /* pairs returned so far */
+} ing_nvwire_dec_t;
+
+/*
+ * Encoder
+ */
+
+/* start message in buf of size bytes */
+ing_stat_t ing_nvwire_enc_init(ing_nvwire_enc_t *enc, void *buf, size_t size);
+
+/* returns ING_STAT_FULL if the pair does not fit; the encoder is unchanged then */
+ing_stat_t ing_nvwire_enc_add(ing_nvwire_enc_t *enc, const char *name, size_t name_len,
+    const char *value, size_t value_len);
+
+#define ing_nvwire_enc_add_str(enc, name, value) \
+    ing_nvwire_enc_add(enc, name, strlen(name), value, strlen(value))
+
+ing_stat_t ing_nvwire_enc_add_nvp(ing_nvwire_enc_t *enc, const namevaluepair_t *nvps, int n);
+
+ing_stat_t ing_nvwire_enc_add_nvpair(ing_nvwire_enc_t *enc, const nvpair_t *nvps, int n);
+
+/* completes the header; returns the message length */
+size_t ing_nvwire_enc_finish(ing_nvwire_enc_t *enc);
+
+/*
+ * Decoder
+ */
+
+/* returns ING_STAT_INVALID_ARGUMENT if buf does not hold a valid header */
+ing_stat_t ing_nvwire_dec_init(ing_nvwire_dec_t *dec, const void *buf, size_t len);
+
+/* returns ING_STAT_NOT_FOUND after the last pair and
+ * ING_STAT_INVALID_ARGUMENT if the message is malformed
+ */
+ing_stat_t ing_nvwire_dec_next(ing_nvwire_dec_t *dec, ing_nvwire_pair_t *pair);
+
+/* decode up to max pairs of the message; number of decoded pairs is returned
+ * in count. Returns ING_STAT_FULL if the message holds more than max pairs
+ */
+ing_stat_t ing_nvwire_decode(const void *buf, size_t len, ing_nvwire_pair_t *pairs,
+    int max, int *count);
+
+#endif /* ING_NVWIRE_H_ */
@@ -0,0 +1,417 @@
+/* ing_parallel.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Inango worker pool and parallel scans implementation
+ */
+
+#define _GNU_SOURCE     /* sysconf(_SC_NPROCESSORS_ONLN) */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "ing_parallel.h"
+
+static struct {
+    pthread_mutex_t job_lock;   /* serializes jobs */
+    pthread_mutex_t lock;       /* protects fields below */
+    pthread_cond_t start;
+    pthread_cond_t done;
+    pthread_t tids[ING_PARALLEL_MAX_THREADS];
+    int nworkers;
+    int shutdown;
+    unsigned long generation;   /* incremented for every job */
+
+    /* current job */
+    ing_parallel_fn fn;
+    void *arg;
+    int nparts;
+    int next_part;
+    int pending;
+} pool = {
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    {0}, 0, 0, 0, NULL, NULL, 0, 0, 0
+};
+
+static __thread int in_pool_job;
+
+/* grabs and runs parts of the current job; called with pool.lock held */
+static void run_parts(void)
+{
+    int part;
+
+    while (pool.next_part < pool.nparts)
+    {
+        part = pool.next_part++;
+        pthread_mutex_unlock(&pool.lock);
+        in_pool_job = 1;
+        pool.fn(pool.arg, part, pool.nparts);
+        in_pool_job = 0;
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.pending == 0)
+            pthread_cond_broadcast(&pool.done);
+    }
+}
+
+/* arg is the job generation at thread creation: the job about to start
+ * must be seen as a new one */
+static void *worker_thread(void *arg)
+{
+    unsigned long seen = (unsigned long)(uintptr_t)arg;
+
+    pthread_mutex_lock(&pool.lock);
+    while (!pool.shutdown)
+    {
+        if (seen == pool.generation)
+        {
+            pthread_cond_wait(&pool.start, &pool.lock);
+            continue;
+        }
+        seen = pool.generation;
+        run_parts();
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+int ing_parallel_threads(int nthreads)
+{
+    if (nthreads <= 0)
+        nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads < 1)
+        nthreads = 1;
+    if (nthreads > ING_PARALLEL_MAX_THREADS)
+        nthreads = ING_PARALLEL_MAX_THREADS;
+    return nthreads;
+}
+
+ing_stat_t ing_parallel_run(int nparts, ing_parallel_fn fn, void *arg)
+{
+    int i;
+
+    if (!fn || nparts < 1 || nparts > ING_PARALLEL_MAX_THREADS)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    /* nested job or nothing to share: do it here */
+    if (nparts == 1 || in_pool_job)
+    {
+        for (i = 0; i < nparts; i++)
+            fn(arg, i, nparts);
+        return ING_STAT_OK;
+    }
+
+    pthread_mutex_lock(&pool.job_lock);
+    pthread_mutex_lock(&pool.lock);
+
+    /* the caller runs parts too, so nparts-1 workers are enough */
+    while (pool.nworkers < nparts - 1 && !pool.shutdown)
+    {
+        if (pthread_create(&pool.tids[pool.nworkers], NULL, worker_thread,
+                           (void *)(uintptr_t)pool.generation) != 0)
+            break;
+        pool.nworkers++;
+    }
+
+    pool.fn = fn;
+    pool.arg = arg;
+    pool.nparts = nparts;
+    pool.next_part = 0;
+    pool.pending = nparts;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.start);
+
+    run_parts();
+    while (pool.pending)
+        pthread_cond_wait(&pool.done, &pool.lock);
+
+    pool.fn = NULL;
+    pool.arg = NULL;
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.job_lock);
+    return ING_STAT_OK;
+}
+
+void ing_parallel_shutdown(void)
+{
+    int i, n;
+
+    pthread_mutex_lock(&pool.job_lock);
+    pthread_mutex_lock(&pool.lock);
+    pool.shutdown = 1;
+    pthread_cond_broadcast(&pool.start);
+    n = pool.nworkers;
+    pthread_mutex_unlock(&pool.lock);
+
+    for (i = 0; i < n; i++)
+        pthread_join(pool.tids[i], NULL);
+
+    pthread_mutex_lock(&pool.lock);
+    pool.nworkers = 0;
+    pool.shutdown = 0;
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.job_lock);
+}
+
+/*
+ * Container scans. Parts are ranges of whole bitmap words, so every part
+ * checks 8*sizeof(long) slots with a single load of map_free.
+ */
+typedef struct scan_job_s {
+    bitmap_t *map;
+    char *records;
+    size_t rec_size;
+    void (*fn)(void *rec, void *arg);
+    int (*pred)(const void *rec, void *arg);
+    void (*map_fn)(void *acc, const void *rec, void *arg);
+    void *arg;
+    ing_view_t parts[ING_PARALLEL_MAX_THREADS];    /* select results */
+    char *accs;                                     /* reduce accumulators */
+    size_t acc_size;
+    size_t acc_stride;                              /* acc_size rounded to cache lines */
+    int failed;
+} scan_job_t;
+
+#define SCAN_BEGIN(job, part, nparts, slot)                                     \
+    {                                                                           \
+        int _words = (int)NUM_ULONGS((size_t)(job)->map->elements);             \
+        int _w = _words * (part) / (nparts);                                    \
+        int _wend = _words * ((part) + 1) / (nparts);                           \
+        for (; _w < _wend; _w++)                                                \
+        {                                                                       \
+            _ulong _bits = ~(job)->map->map[_w];                                \
+            while (_bits)                                                       \
+            {                                                                   \
+                int slot = _w*8*(int)sizeof(_ulong) + __builtin_ctzl(_bits);    \
+                _bits &= _bits - 1;                                             \
+                if (slot >= (job)->map->elements)                               \
+                    break;
+
+#define SCAN_END                                                                \
+            }                                                                   \
+        }                                                                       \
+    }
+
+#define SCAN_REC(job, slot)     ((job)->records + (size_t)(slot) * (job)->rec_size)
+
+static void foreach_part(void *arg, int part, int nparts)
+{
+    scan_job_t *job = (scan_job_t *)arg;
+
+    SCAN_BEGIN(job, part, nparts, slot)
+        job->fn(SCAN_REC(job, slot), job->arg);
+    SCAN_END
+}
+
+static void select_part(void *arg, int part, int nparts)
+{
+    scan_job_t *job = (scan_job_t *)arg;
+    ing_view_t *v = &job->parts[part];
+    int cap = 0;
+
+    SCAN_BEGIN(job, part, nparts, slot)
+        void *rec = SCAN_REC(job, slot);
+        if (!job->pred(rec, job->arg))
+            continue;
+        if (v->count == cap)
+        {
+            void **items = (void **)realloc(v->items, (cap ? 2*cap : 64) * sizeof(void *));
+            if (!items)
+            {
+                job->failed = 1;
+                return;
+            }
+            v->items = items;
+            cap = cap ? 2*cap : 64;
+        }
+        v->items[v->count++] = rec;
+    SCAN_END
+}
+
+static void reduce_part(void *arg, int part, int nparts)
+{
+    scan_job_t *job = (scan_job_t *)arg;
+    void *acc = job->accs + (size_t)part * job->acc_stride;
+
+    SCAN_BEGIN(job, part, nparts, slot)
+        job->map_fn(acc, SCAN_REC(job, slot), job->arg);
+    SCAN_END
+}
+
+static int scan_parts(bitmap_t *map_free, int nthreads)
+{
+    if (map_free->elements < ING_PARALLEL_SCAN_MIN)
+        return 1;
+    return ing_parallel_threads(nthreads);
+}
+
+ing_stat_t ing_parallel_foreach(bitmap_t *map_free, void *records, size_t rec_size,
+    void (*fn)(void *rec, void *arg), void *arg, int nthreads)
+{
+    scan_job_t job;
+
+    if (!map_free || !map_free->map || !records || !rec_size || !fn)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    memset(&job, 0, sizeof(job));
+    job.map = map_free;
+    job.records = (char *)records;
+    job.rec_size = rec_size;
+    job.fn = fn;
+    job.arg = arg;
+    return ing_parallel_run(scan_parts(map_free, nthreads), foreach_part, &job);
+}
+
+ing_stat_t ing_parallel_select(bitmap_t *map_free, void *records, size_t rec_size,
+    int (*pred)(const void *rec, void *arg), void *arg, ing_view_t *xo_view, int nthreads)
+{
+    scan_job_t job;
+    ing_stat_t res;
+    int i, nparts, total = 0;
+
+    if (!map_free || !map_free->map || !records || !rec_size || !pred || !xo_view)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    memset(&job, 0, sizeof(job));
+    job.map = map_free;
+    job.records = (char *)records;
+    job.rec_size = rec_size;
+    job.pred = pred;
+    job.arg = arg;
+    nparts = scan_parts(map_free, nthreads);
+
+    res = ing_parallel_run(nparts, select_part, &job);
+    if (res == ING_STAT_OK && job.failed)
+        res = ING_STAT_OUTOFMEMORY;
+
+    /* concatenate parts: they are ordered by slot */
+    for (i = 0; i < nparts; i++)
+        total += job.parts[i].count;
+    if (res == ING_STAT_OK)
+        res = ing_view_init(xo_view, total);
+    if (res == ING_STAT_OK)
+    {
+        for (i = 0; i < nparts; i++)
+        {
+            if (job.parts[i].count)
+                memcpy(xo_view->items + xo_view->count, job.parts[i].items,
+                       job.parts[i].count * sizeof(void *));
+            xo_view->count += job.parts[i].count;
+        }
+    }
+
+    for (i = 0; i < nparts; i++)
+        free(job.parts[i].items);
+    return res;
+}
+
+ing_stat_t ing_parallel_reduce(bitmap_t *map_free, void *records, size_t rec_size,
+    void (*map)(void *acc, const void *rec, void *arg),
+    void (*merge)(void *acc, const void *part_acc, void *arg),
+    void *acc, size_t acc_size, void *arg, int nthreads)
+{
+    scan_job_t job;
+    ing_stat_t res;
+    int i, nparts;
+
+    if (!map_free || !map_free->map || !records || !rec_size || !map || !merge ||
+        !acc || !acc_size)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    memset(&job, 0, sizeof(job));
+    job.map = map_free;
+    job.records = (char *)records;
+    job.rec_size = rec_size;
+    job.map_fn = map;
+    job.arg = arg;
+    job.acc_size = acc_size;
+    nparts = scan_parts(map_free, nthreads);
+
+    /* every accumulator gets its own cache lines, so threads updating
+     * neighbouring accumulators do not invalidate each other's lines
+     */
+    job.acc_stride = (acc_size + ING_PARALLEL_CACHE_LINE - 1) & ~(size_t)(ING_PARALLEL_CACHE_LINE - 1);
+    if (posix_memalign((void **)&job.accs, ING_PARALLEL_CACHE_LINE, (size_t)nparts * job.acc_stride))
+        return ING_STAT_OUTOFMEMORY;
+    for (i = 0; i < nparts; i++)
+        memcpy(job.accs + (size_t)i * job.acc_stride, acc, acc_size);
+
+    res = ing_parallel_run(nparts, reduce_part, &job);
+    if (res == ING_STAT_OK)
+    {
+        for (i = 0; i < nparts; i++)
+            merge(acc, job.accs + (size_t)i * job.acc_stride, arg);
+    }
+
+    free(job.accs);
+    return res;
+}
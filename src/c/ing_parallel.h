@@ -0,0 +1,142 @@
+/* ing_parallel.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Inango worker pool and parallel scans over IC containers
+ *
+ * A single process-wide pool of worker threads is created on first use.
+ * Work is split into parts; the calling thread processes parts too, so a
+ * pool of N-1 workers keeps N CPUs busy. Only one parallel job runs at a
+ * time, other callers wait; a job started from inside a worker callback is
+ * run by that worker alone.
+ */
+
+#ifndef ING_PARALLEL_H_
+#define ING_PARALLEL_H_
+
+#include <stddef.h>
+
+#include "ing_gen_utils.h"
+#include "bitmap.h"
+#include "ing_sort.h"
+
+/* max number of parts (and threads) of a single job */
+#define ING_PARALLEL_MAX_THREADS    ING_SORT_MAX_THREADS
+
+/* alignment and padding of per-thread data written concurrently */
+#define ING_PARALLEL_CACHE_LINE     64
+
+/* containers with less slots are scanned by the calling thread only */
+#define ING_PARALLEL_SCAN_MIN       4096
+
+/* Processes part number `part' of `nparts' */
+typedef void (*ing_parallel_fn)(void *arg, int part, int nparts);
+
+/*
+ * Runs fn for parts 0..nparts-1 on the worker pool and waits for completion.
+ * nparts is limited by ING_PARALLEL_MAX_THREADS
+ */
+ing_stat_t ing_parallel_run(int nparts, ing_parallel_fn fn, void *arg);
+
+/*
+ * Returns number of threads to use: nthreads == 0 selects number of online
+ * CPUs, result is within 1..ING_PARALLEL_MAX_THREADS
+ */
+int ing_parallel_threads(int nthreads);
+
+/*
+ * Stops and joins pool threads; the pool is created again on next use
+ */
+void ing_parallel_shutdown(void);
+
+/*
+ * Parallel scans over records array with occupied slots marked by cleared
+ * bits of map_free (IC container layout). Callbacks are called concurrently
+ * from several threads; the container must not be modified meanwhile.
+ */
+
+/* calls fn for every record */
+ing_stat_t ing_parallel_foreach(bitmap_t *map_free, void *records, size_t rec_size,
+    void (*fn)(void *rec, void *arg), void *arg, int nthreads);
+
+/* collects pointers to records matching pred into view, in slot order;
+ * release the view with ing_view_free()
+ */
+ing_stat_t ing_parallel_select(bitmap_t *map_free, void *records, size_t rec_size,
+    int (*pred)(const void *rec, void *arg), void *arg, ing_view_t *xo_view, int nthreads);
+
+/* folds records into acc of acc_size bytes: every thread starts from a copy
+ * of acc (must hold the identity value, e.g. zero for sums), map() adds one
+ * record to thread's accumulator, merge() adds thread's accumulator to acc
+ */
+ing_stat_t ing_parallel_reduce(bitmap_t *map_free, void *records, size_t rec_size,
+    void (*map)(void *acc, const void *rec, void *arg),
+    void (*merge)(void *acc, const void *part_acc, void *arg),
+    void *acc, size_t acc_size, void *arg, int nthreads);
+
+#endif /* ING_PARALLEL_H_ */
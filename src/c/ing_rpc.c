@@ -0,0 +1,615 @@
+/* ing_rpc.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Request/response RPC implementation
+ *
+ * Frame: rpc_hdr_t followed by the payload. Request id is
+ * generation << 16 | slot, so a response is matched to its pending slot
+ * in O(1) and stale responses (e.g. to a retried request) are dropped.
+ * Pending calls are kept in a binary heap ordered by deadline, which a
+ * periodic timer checks while requests are outstanding, so a tick only
+ * looks at expired calls. Requests that did not fit in the socket buffer
+ * (unix datagram queues are short) wait in a FIFO and are sent in order on
+ * the next tick or received message. Waiting does not use up retries: the
+ * attempt deadline starts when a request is actually sent, and a request
+ * that cannot be sent for timeout_ms * (retries + 1) completes with
+ * ING_STAT_TIMEOUT.
+ */
+
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <fcntl.h>
+
+#include "ing_rpc.h"
+#include "ing_sock.h"
+#include "ing_clock.h"
+
+#define RPC_MAGIC0      'I'
+#define RPC_MAGIC1      'R'
+#define RPC_VERSION     1
+#define RPC_REQUEST     1
+#define RPC_RESPONSE    2
+
+#define RPC_SLOT_BITS   16
+#define RPC_SLOT_MASK   ((1u << RPC_SLOT_BITS) - 1)
+#define RPC_RECV_BUDGET 64      /* messages received per loop event */
+
+typedef struct rpc_hdr_s {
+    uint8_t magic[2];
+    uint8_t version;
+    uint8_t type;
+    uint32_t id;
+} rpc_hdr_t;
+
+typedef struct rpc_call_s {
+    uint32_t id;                /* 0 - free slot */
+    uint16_t gen;
+    unsigned retries;
+    unsigned timeout_ms;
+    int unsent;                 /* socket buffer was full */
+    int unsent_prev;            /* links in the unsent FIFO, -1 - none */
+    int unsent_next;
+    int heap_pos;               /* index in ing_rpc_s.heap */
+    uint64_t deadline;          /* of the attempt, or for sending if unsent */
+    ing_rpc_resp_fn fn;
+    void *arg;
+    char *frame;                /* kept for resending */
+    size_t frame_len;
+    socklen_t addrlen;
+    struct sockaddr_storage addr;
+} rpc_call_t;
+
+struct ing_rpc_s {
+    ing_evloop_t *loop;
+    int sock;
+    int timer;                  /* -1 while nothing is pending */
+    int max_pending;
+    int npending;               /* also the number of heap entries */
+    int nunsent;
+    int unsent_head;            /* oldest unsent call, -1 - none */
+    int unsent_tail;
+    rpc_call_t *calls;
+    int *heap;                  /* pending slots, earliest deadline first */
+    int *free_slots;
+    int nfree;
+    ing_rpc_req_fn req_fn;
+    void *req_arg;
+    char buf[ING_SOCK_INLINE_MAX];
+};
+
+static void rpc_tick(ing_evloop_t *loop, int timer, void *arg);
+
+static ing_stat_t rpc_send(ing_rpc_t *rpc, const struct sockaddr *addr, socklen_t addrlen,
+    const char *frame, size_t len)
+{
+    return ing_sock_send_msg(rpc->sock, addrlen ? addr : NULL, addrlen, frame, len);
+}
+
+static char *frame_build(uint8_t type, uint32_t id, const void *data, size_t len, size_t *frame_len)
+{
+    rpc_hdr_t hdr;
+    char *frame;
+
+    frame = (char *)malloc(sizeof(hdr) + len);
+    if (!frame)
+        return NULL;
+    hdr.magic[0] = RPC_MAGIC0;
+    hdr.magic[1] = RPC_MAGIC1;
+    hdr.version = RPC_VERSION;
+    hdr.type = type;
+    hdr.id = id;
+    memcpy(frame, &hdr, sizeof(hdr));
+    if (len)
+        memcpy(frame + sizeof(hdr), data, len);
+    *frame_len = sizeof(hdr) + len;
+    return frame;
+}
+
+static void heap_set(ing_rpc_t *rpc, int pos, int slot)
+{
+    rpc->heap[pos] = slot;
+    rpc->calls[slot].heap_pos = pos;
+}
+
+static void heap_up(ing_rpc_t *rpc, int pos)
+{
+    int slot = rpc->heap[pos];
+    uint64_t deadline = rpc->calls[slot].deadline;
+    int parent;
+
+    while (pos > 0)
+    {
+        parent = (pos - 1) / 2;
+        if (rpc->calls[rpc->heap[parent]].deadline <= deadline)
+            break;
+        heap_set(rpc, pos, rpc->heap[parent]);
+        pos = parent;
+    }
+    heap_set(rpc, pos, slot);
+}
+
+static void heap_down(ing_rpc_t *rpc, int pos)
+{
+    int slot = rpc->heap[pos];
+    uint64_t deadline = rpc->calls[slot].deadline;
+    int child;
+
+    while ((child = 2 * pos + 1) < rpc->npending)
+    {
+        if (child + 1 < rpc->npending &&
+            rpc->calls[rpc->heap[child + 1]].deadline < rpc->calls[rpc->heap[child]].deadline)
+            child++;
+        if (deadline <= rpc->calls[rpc->heap[child]].deadline)
+            break;
+        heap_set(rpc, pos, rpc->heap[child]);
+        pos = child;
+    }
+    heap_set(rpc, pos, slot);
+}
+
+static void heap_push(ing_rpc_t *rpc, rpc_call_t *call)
+{
+    heap_set(rpc, rpc->npending++, (int)(call - rpc->calls));
+    heap_up(rpc, call->heap_pos);
+}
+
+static void heap_remove(ing_rpc_t *rpc, rpc_call_t *call)
+{
+    int pos = call->heap_pos;
+    int moved;
+
+    if (pos == --rpc->npending)
+        return;
+    /* the last entry fills the hole and may have to move either way */
+    moved = rpc->heap[rpc->npending];
+    heap_set(rpc, pos, moved);
+    heap_up(rpc, pos);
+    heap_down(rpc, rpc->calls[moved].heap_pos);
+}
+
+static void call_set_deadline(ing_rpc_t *rpc, rpc_call_t *call, uint64_t deadline)
+{
+    uint64_t old = call->deadline;
+
+    call->deadline = deadline;
+    if (deadline < old)
+        heap_up(rpc, call->heap_pos);
+    else
+        heap_down(rpc, call->heap_pos);
+}
+
+/* appends call to the unsent FIFO; its deadline bounds the wait for buffer space */
+static void unsent_push(ing_rpc_t *rpc, rpc_call_t *call, uint64_t now)
+{
+    int slot = (int)(call - rpc->calls);
+
+    call->unsent = TRUE;
+    call->unsent_prev = rpc->unsent_tail;
+    call->unsent_next = -1;
+    if (rpc->unsent_tail >= 0)
+        rpc->calls[rpc->unsent_tail].unsent_next = slot;
+    else
+        rpc->unsent_head = slot;
+    rpc->unsent_tail = slot;
+    rpc->nunsent++;
+    call_set_deadline(rpc, call, now + (uint64_t)call->timeout_ms * (call->retries + 1));
+}
+
+static void unsent_remove(ing_rpc_t *rpc, rpc_call_t *call)
+{
+    if (call->unsent_prev >= 0)
+        rpc->calls[call->unsent_prev].unsent_next = call->unsent_next;
+    else
+        rpc->unsent_head = call->unsent_next;
+    if (call->unsent_next >= 0)
+        rpc->calls[call->unsent_next].unsent_prev = call->unsent_prev;
+    else
+        rpc->unsent_tail = call->unsent_prev;
+    call->unsent = FALSE;
+    rpc->nunsent--;
+}
+
+static void call_free(ing_rpc_t *rpc, rpc_call_t *call)
+{
+    if (call->unsent)
+        unsent_remove(rpc, call);
+    heap_remove(rpc, call);
+    free(call->frame);
+    call->frame = NULL;
+    call->id = 0;
+    call->fn = NULL;
+    rpc->free_slots[rpc->nfree++] = (int)(call - rpc->calls);
+    if (!rpc->npending && rpc->timer >= 0)
+    {
+        ing_evloop_timer_del(rpc->loop, rpc->timer);
+        rpc->timer = -1;
+    }
+}
+
+/* frees the slot first, so the callback may issue new calls */
+static void call_complete(ing_rpc_t *rpc, rpc_call_t *call, ing_stat_t status,
+    const void *data, size_t len)
+{
+    ing_rpc_resp_fn fn = call->fn;
+    void *arg = call->arg;
+
+    call_free(rpc, call);
+    if (fn)
+        fn(rpc, status, data, len, arg);
+}
+
+static rpc_call_t *call_find(ing_rpc_t *rpc, uint32_t id)
+{
+    uint32_t slot = id & RPC_SLOT_MASK;
+
+    if (!id || slot >= (uint32_t)rpc->max_pending || rpc->calls[slot].id != id)
+        return NULL;
+    return &rpc->calls[slot];
+}
+
+/*
+ * Sends call and starts its attempt deadline; returns FALSE if the socket
+ * buffer is full, the call is then queued (or stays queued) as unsent
+ */
+static int call_send(ing_rpc_t *rpc, rpc_call_t *call, uint64_t now)
+{
+    ing_stat_t rc;
+
+    rc = rpc_send(rpc, (struct sockaddr *)&call->addr, call->addrlen, call->frame, call->frame_len);
+    if (rc == ING_STAT_FULL)
+    {
+        if (!call->unsent)
+            unsent_push(rpc, call, now);
+        return FALSE;
+    }
+    /* other errors are handled like a lost datagram */
+    if (call->unsent)
+        unsent_remove(rpc, call);
+    call_set_deadline(rpc, call, now + call->timeout_ms);
+    return TRUE;
+}
+
+static void rpc_flush(ing_rpc_t *rpc)
+{
+    uint64_t now;
+
+    if (rpc->unsent_head < 0)
+        return;
+    now = ing_clock_mono_ms();
+    while (rpc->unsent_head >= 0 && call_send(rpc, &rpc->calls[rpc->unsent_head], now))
+        ;
+}
+
+static void rpc_tick(ing_evloop_t *loop, int timer, void *arg)
+{
+    ing_rpc_t *rpc = (ing_rpc_t *)arg;
+    rpc_call_t *call;
+    uint64_t now;
+
+    (void)loop;
+    (void)timer;
+
+    rpc_flush(rpc);
+    now = ing_clock_mono_ms();
+    while (rpc->npending && rpc->calls[rpc->heap[0]].deadline <= now)
+    {
+        call = &rpc->calls[rpc->heap[0]];
+        /* unsent calls expire only after waiting out all their attempts */
+        if (call->unsent || !call->retries)
+        {
+            call_complete(rpc, call, ING_STAT_TIMEOUT, NULL, 0);
+            continue;
+        }
+        call->retries--;
+        /* do not overtake requests waiting for socket buffer space */
+        if (rpc->nunsent)
+            unsent_push(rpc, call, now);
+        else
+            call_send(rpc, call, now);
+    }
+}
+
+static void rpc_handle(ing_rpc_t *rpc, const char *msg, size_t len,
+    const struct sockaddr_storage *addr, socklen_t addrlen)
+{
+    ing_rpc_req_t req;
+    rpc_call_t *call;
+    rpc_hdr_t hdr;
+
+    if (len < sizeof(hdr))
+        return;
+    memcpy(&hdr, msg, sizeof(hdr));
+    if (hdr.magic[0] != RPC_MAGIC0 || hdr.magic[1] != RPC_MAGIC1 || hdr.version != RPC_VERSION)
+        return;
+
+    if (hdr.type == RPC_RESPONSE)
+    {
+        /* late responses to completed or retried requests are dropped */
+        if ((call = call_find(rpc, hdr.id)) != NULL)
+            call_complete(rpc, call, ING_STAT_OK, msg + sizeof(hdr), len - sizeof(hdr));
+    }
+    else if (hdr.type == RPC_REQUEST && rpc->req_fn)
+    {
+        req.id = hdr.id;
+        req.addrlen = addrlen;
+        memcpy(&req.addr, addr, addrlen);
+        rpc->req_fn(rpc, &req, msg + sizeof(hdr), len - sizeof(hdr), rpc->req_arg);
+    }
+}
+
+static void rpc_read(ing_evloop_t *loop, int fd, unsigned events, void *arg)
+{
+    ing_rpc_t *rpc = (ing_rpc_t *)arg;
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+    ing_sock_msg_t msg;
+    ing_stat_t rc;
+    int i;
+
+    (void)loop;
+    (void)events;
+
+    for (i = 0; i < RPC_RECV_BUDGET; i++)
+    {
+        addrlen = sizeof(addr);
+        rc = ing_sock_recv_msg(fd, rpc->buf, sizeof(rpc->buf), &msg,
+                (struct sockaddr *)&addr, &addrlen, MSG_DONTWAIT);
+        if (rc == ING_STAT_GENERAL_ERROR)
+            continue;       /* truncated or malformed message was dropped */
+        if (rc != ING_STAT_OK)
+            break;
+        if (addrlen > sizeof(addr))
+            addrlen = sizeof(addr);
+        rpc_handle(rpc, (const char *)msg.data, msg.len, &addr, addrlen);
+        ing_sock_msg_release(&msg);
+    }
+    /* a response means the peer has drained some of its queue */
+    rpc_flush(rpc);
+}
+
+ing_stat_t ing_rpc_create(ing_rpc_t **rpc, ing_evloop_t *loop, int sock, int max_pending)
+{
+    ing_rpc_t *r;
+    ing_stat_t rc;
+    int i, fl;
+
+    if (!rpc || !loop || sock < 0 || max_pending <= 0 || max_pending > ING_RPC_MAX_PENDING)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    fl = fcntl(sock, F_GETFL);
+    if (fl < 0 || fcntl(sock, F_SETFL, fl | O_NONBLOCK) < 0)
+        return ING_STAT_SYSTEM_ERROR;
+
+    r = (ing_rpc_t *)calloc(1, sizeof(*r));
+    if (!r)
+        return ING_STAT_OUTOFMEMORY;
+    r->calls = (rpc_call_t *)calloc(max_pending, sizeof(*r->calls));
+    r->free_slots = (int *)malloc(max_pending * sizeof(*r->free_slots));
+    r->heap = (int *)malloc(max_pending * sizeof(*r->heap));
+    if (!r->calls || !r->free_slots || !r->heap)
+    {
+        free(r->calls);
+        free(r->free_slots);
+        free(r->heap);
+        free(r);
+        return ING_STAT_OUTOFMEMORY;
+    }
+    r->loop = loop;
+    r->sock = sock;
+    r->timer = -1;
+    r->max_pending = max_pending;
+    r->unsent_head = -1;
+    r->unsent_tail = -1;
+    /* lowest slots are used first */
+    for (i = 0; i < max_pending; i++)
+        r->free_slots[i] = max_pending - 1 - i;
+    r->nfree = max_pending;
+
+    if ((rc = ing_evloop_add(loop, sock, ING_EV_READ, rpc_read, r)) != ING_STAT_OK)
+    {
+        free(r->calls);
+        free(r->free_slots);
+        free(r->heap);
+        free(r);
+        return rc;
+    }
+    *rpc = r;
+    return ING_STAT_OK;
+}
+
+void ing_rpc_destroy(ing_rpc_t *rpc)
+{
+    int i;
+
+    if (!rpc)
+        return;
+
+    ing_evloop_del(rpc->loop, rpc->sock);
+    for (i = 0; i < rpc->max_pending; i++)
+    {
+        if (rpc->calls[i].id)
+            call_complete(rpc, &rpc->calls[i], ING_STAT_GENERAL_ERROR, NULL, 0);
+    }
+    if (rpc->timer >= 0)
+        ing_evloop_timer_del(rpc->loop, rpc->timer);
+    free(rpc->calls);
+    free(rpc->free_slots);
+    free(rpc->heap);
+    free(rpc);
+}
+
+void ing_rpc_set_handler(ing_rpc_t *rpc, ing_rpc_req_fn fn, void *arg)
+{
+    if (!rpc)
+        return;
+    rpc->req_fn = fn;
+    rpc->req_arg = arg;
+}
+
+ing_stat_t ing_rpc_call(ing_rpc_t *rpc, const struct sockaddr *addr, socklen_t addrlen,
+    const void *data, size_t len, const ing_rpc_opts_t *opts,
+    ing_rpc_resp_fn fn, void *arg, uint32_t *id)
+{
+    rpc_call_t *call;
+    ing_stat_t rc;
+    uint64_t now;
+    int slot;
+
+    if (!rpc || (len && !data) || (addr && addrlen > sizeof(call->addr)))
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!rpc->nfree)
+        return ING_STAT_FULL;
+
+    if (rpc->timer < 0)
+    {
+        rpc->timer = ing_evloop_timer_add(rpc->loop, ING_RPC_TICK_MS, ING_RPC_TICK_MS, rpc_tick, rpc);
+        if (rpc->timer < 0)
+            return ING_STAT_SYSTEM_ERROR;
+    }
+
+    slot = rpc->free_slots[--rpc->nfree];
+    call = &rpc->calls[slot];
+    /* generation 0 is skipped so that id 0 is never used */
+    if (!++call->gen)
+        call->gen = 1;
+    call->id = (uint32_t)call->gen << RPC_SLOT_BITS | (uint32_t)slot;
+    call->fn = fn;
+    call->arg = arg;
+    call->retries = opts ? opts->retries : 0;
+    call->timeout_ms = (opts && opts->timeout_ms) ? opts->timeout_ms : ING_RPC_TIMEOUT_MS;
+    now = ing_clock_mono_ms();
+    call->deadline = now + call->timeout_ms;
+    call->unsent = FALSE;
+    call->addrlen = addr ? addrlen : 0;
+    if (addr)
+        memcpy(&call->addr, addr, addrlen);
+    heap_push(rpc, call);
+
+    call->frame = frame_build(RPC_REQUEST, call->id, data, len, &call->frame_len);
+    if (!call->frame)
+    {
+        call_free(rpc, call);
+        return ING_STAT_OUTOFMEMORY;
+    }
+
+    /* do not overtake requests waiting for socket buffer space */
+    if (rpc->nunsent)
+        rpc_flush(rpc);
+    if (rpc->nunsent)
+        unsent_push(rpc, call, now);
+    else
+    {
+        rc = rpc_send(rpc, addr, call->addrlen, call->frame, call->frame_len);
+        if (rc == ING_STAT_FULL)
+            unsent_push(rpc, call, now);
+        else if (rc != ING_STAT_OK)
+        {
+            call_free(rpc, call);
+            return rc;
+        }
+    }
+    if (id)
+        *id = call->id;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_rpc_cancel(ing_rpc_t *rpc, uint32_t id)
+{
+    rpc_call_t *call;
+
+    if (!rpc)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!(call = call_find(rpc, id)))
+        return ING_STAT_NOT_FOUND;
+    call_free(rpc, call);
+    return ING_STAT_OK;
+}
+
+int ing_rpc_pending(const ing_rpc_t *rpc)
+{
+    return rpc ? rpc->npending : 0;
+}
+
+ing_stat_t ing_rpc_reply(ing_rpc_t *rpc, const ing_rpc_req_t *req, const void *data, size_t len)
+{
+    ing_stat_t rc;
+    size_t frame_len;
+    char *frame;
+
+    if (!rpc || !req || (len && !data))
+        return ING_STAT_INVALID_ARGUMENT;
+
+    frame = frame_build(RPC_RESPONSE, req->id, data, len, &frame_len);
+    if (!frame)
+        return ING_STAT_OUTOFMEMORY;
+    rc = rpc_send(rpc, (const struct sockaddr *)&req->addr, req->addrlen, frame, frame_len);
+    free(frame);
+    return rc;
+}
@@ -0,0 +1,152 @@
+/* ing_rpc.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Request/response RPC over datagram sockets
+ *
+ * Requests carry a correlation id, so many requests may be outstanding on
+ * one socket and their latencies overlap. Each request has a deadline per
+ * attempt and is resent on timeout up to the given number of retries (the
+ * server should handle repeated requests idempotently); the completion
+ * callback is called exactly once with the response, ING_STAT_TIMEOUT or
+ * ING_STAT_GENERAL_ERROR if the RPC is destroyed. Requests that do not fit
+ * in the socket buffer are queued and sent in order; the attempt deadline
+ * starts when a request is sent, and a request still queued after
+ * timeout_ms * (retries + 1) completes with ING_STAT_TIMEOUT.
+ *
+ * An ing_rpc_t runs in an ing_evloop_t and can both send requests and serve
+ * them. Messages larger than ING_SOCK_INLINE_MAX are passed as memfds (see
+ * ing_sock_send_msg()). All functions must be called from the loop thread.
+ */
+
+#ifndef ING_RPC_H_
+#define ING_RPC_H_
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include "ing_gen_utils.h"
+#include "ing_evloop.h"
+
+#define ING_RPC_TIMEOUT_MS      1000
+#define ING_RPC_TICK_MS         10      /* deadline check period */
+#define ING_RPC_MAX_PENDING     65536
+
+typedef struct ing_rpc_s ing_rpc_t;
+
+typedef struct ing_rpc_opts_s {
+    unsigned timeout_ms;        /* per attempt, 0 - ING_RPC_TIMEOUT_MS */
+    unsigned retries;           /* resends after timeout */
+} ing_rpc_opts_t;
+
+/* request being served; may be copied to reply later */
+typedef struct ing_rpc_req_s {
+    uint32_t id;
+    socklen_t addrlen;
+    struct sockaddr_storage addr;
+} ing_rpc_req_t;
+
+/* completion: data/len is the response if status is ING_STAT_OK */
+typedef void (*ing_rpc_resp_fn)(ing_rpc_t *rpc, ing_stat_t status, const void *data, size_t len,
+    void *arg);
+
+/* request handler; replies now or later with ing_rpc_reply() */
+typedef void (*ing_rpc_req_fn)(ing_rpc_t *rpc, const ing_rpc_req_t *req, const void *data,
+    size_t len, void *arg);
+
+/*
+ * Creates RPC on datagram socket sock (e.g. from unix_socket_init()) and
+ * registers it in loop. The socket is made non-blocking; it is not closed
+ * by ing_rpc_destroy(). max_pending limits outstanding requests
+ */
+ing_stat_t ing_rpc_create(ing_rpc_t **rpc, ing_evloop_t *loop, int sock, int max_pending);
+
+/* completes outstanding requests with ING_STAT_GENERAL_ERROR; not from callbacks */
+void ing_rpc_destroy(ing_rpc_t *rpc);
+
+/* serve requests with fn (NULL - ignore requests) */
+void ing_rpc_set_handler(ing_rpc_t *rpc, ing_rpc_req_fn fn, void *arg);
+
+/*
+ * Sends request to addr (NULL for connected socket); opts may be NULL.
+ * fn is called on completion. The request id is returned in *id if id is
+ * not NULL. Returns ING_STAT_FULL if max_pending requests are outstanding
+ */
+ing_stat_t ing_rpc_call(ing_rpc_t *rpc, const struct sockaddr *addr, socklen_t addrlen,
+    const void *data, size_t len, const ing_rpc_opts_t *opts,
+    ing_rpc_resp_fn fn, void *arg, uint32_t *id);
+
+/* drops outstanding request without calling its callback */
+ing_stat_t ing_rpc_cancel(ing_rpc_t *rpc, uint32_t id);
+
+/* number of outstanding requests */
+int ing_rpc_pending(const ing_rpc_t *rpc);
+
+ing_stat_t ing_rpc_reply(ing_rpc_t *rpc, const ing_rpc_req_t *req, const void *data, size_t len);
+
+#endif /* ING_RPC_H_ */
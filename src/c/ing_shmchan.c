@@ -0,0 +1,466 @@
+/* ing_shmchan.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Shared-memory channel implementation
+ *
+ * Ring layout: a record is an 8-byte header (message length) followed by
+ * the message padded to 8 bytes. A record never wraps: if it does not fit
+ * at the end of the ring, a SHMCHAN_WRAP header is written and the record
+ * starts at offset 0. head and tail are free-running byte counters. Limiting
+ * messages to half of the ring guarantees that an empty ring always has
+ * room for the wrap and the record.
+ */
+
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+
+#include "ing_shmchan.h"
+#include "ing_sock.h"
+#include "ing_clock.h"
+
+#define SHMCHAN_MAGIC       "INGSHMC1"
+#define SHMCHAN_DATA_OFF    256
+#define SHMCHAN_REC_HDR     8
+#define SHMCHAN_WRAP        0xffffffffu
+#define SHMCHAN_MAX_SIZE    (1u << 30)
+
+#define REC_SIZE(len)       (SHMCHAN_REC_HDR + (((uint64_t)(len) + 7) & ~(uint64_t)7))
+
+struct ing_shmchan_hdr_s {
+    char magic[8];
+    uint32_t capacity;
+    uint32_t closed;
+    char pad0[48];
+    /* producer cache line */
+    uint64_t head;
+    uint32_t cons_waiting;
+    char pad1[52];
+    /* consumer cache line */
+    uint64_t tail;
+    uint32_t prod_waiting;
+    char pad2[52];
+};
+
+static void chan_reset(ing_shmchan_t *ch)
+{
+    memset(ch, 0, sizeof(*ch));
+    ch->memfd = ch->datafd = ch->spacefd = -1;
+}
+
+static void signal_fd(int fd)
+{
+    uint64_t one = 1;
+
+    if (write(fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        ing_log(LOG_ERR, " %s (%d): eventfd write failed: %s\n", __func__, __LINE__, strerror(errno));
+}
+
+/*
+ * Waits for fd to be signalled till deadline (0 means forever). Returns
+ * FALSE on timeout
+ */
+static int wait_fd(int fd, uint64_t deadline)
+{
+    struct pollfd pfd;
+    uint64_t now, cnt;
+    int timeout = -1, n;
+
+    if (deadline)
+    {
+        now = ing_clock_mono_ms();
+        if (now >= deadline)
+            return FALSE;
+        timeout = (int)(deadline - now);
+    }
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    n = poll(&pfd, 1, timeout);
+    if (n > 0 && read(fd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN)
+        ing_log(LOG_ERR, " %s (%d): eventfd read failed: %s\n", __func__, __LINE__, strerror(errno));
+    /* interrupts and timeouts are sorted out by the caller's loop */
+    return n != 0 || !deadline || ing_clock_mono_ms() < deadline;
+}
+
+static ing_stat_t chan_map(ing_shmchan_t *ch, size_t map_size)
+{
+    void *p;
+
+    p = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, ch->memfd, 0);
+    if (p == MAP_FAILED)
+    {
+        ing_log(LOG_ERR, " %s (%d): mmap failed: %s\n", __func__, __LINE__, strerror(errno));
+        return ING_STAT_SYSTEM_ERROR;
+    }
+    ch->hdr = (struct ing_shmchan_hdr_s *)p;
+    ch->data = (char *)p + SHMCHAN_DATA_OFF;
+    ch->map_size = map_size;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_shmchan_create(ing_shmchan_t *ch, const char *name, size_t capacity)
+{
+    uint32_t cap = ING_SHMCHAN_MIN_SIZE;
+    size_t map_size;
+    ing_stat_t rc;
+
+    if (!ch || capacity > SHMCHAN_MAX_SIZE)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    chan_reset(ch);
+    while (cap < capacity)
+        cap <<= 1;
+    map_size = SHMCHAN_DATA_OFF + cap;
+
+    ch->memfd = memfd_create(name ? name : "ing_shmchan", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    ch->datafd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    ch->spacefd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (ch->memfd < 0 || ch->datafd < 0 || ch->spacefd < 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): %s\n", __func__, __LINE__, strerror(errno));
+        ing_shmchan_close(ch);
+        return ING_STAT_SYSTEM_ERROR;
+    }
+
+    /* the peer must not be able to shrink the segment under us */
+    if (ftruncate(ch->memfd, map_size) < 0 ||
+        fcntl(ch->memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): %s\n", __func__, __LINE__, strerror(errno));
+        ing_shmchan_close(ch);
+        return ING_STAT_SYSTEM_ERROR;
+    }
+
+    if ((rc = chan_map(ch, map_size)) != ING_STAT_OK)
+    {
+        ing_shmchan_close(ch);
+        return rc;
+    }
+    ch->capacity = cap;
+    ch->hdr->capacity = cap;
+    memcpy(ch->hdr->magic, SHMCHAN_MAGIC, sizeof(ch->hdr->magic));
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_shmchan_share(ing_shmchan_t *ch, int sock, const struct sockaddr *addr,
+    socklen_t addrlen, const void *data, size_t len)
+{
+    int fds[ING_SHMCHAN_NFDS];
+
+    if (!ch || !ch->hdr)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    fds[0] = ch->memfd;
+    fds[1] = ch->datafd;
+    fds[2] = ch->spacefd;
+    return ing_sock_send_fds(sock, addr, addrlen, data, len, fds, ING_SHMCHAN_NFDS);
+}
+
+ing_stat_t ing_shmchan_attach(ing_shmchan_t *ch, const int fds[ING_SHMCHAN_NFDS])
+{
+    struct stat st;
+    int seals;
+    uint32_t cap;
+    ing_stat_t rc;
+
+    if (!ch || !fds)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    chan_reset(ch);
+    seals = fcntl(fds[0], F_GET_SEALS);
+    if (fstat(fds[0], &st) < 0 || seals < 0 || !(seals & F_SEAL_SHRINK) ||
+        st.st_size < SHMCHAN_DATA_OFF + ING_SHMCHAN_MIN_SIZE)
+    {
+        ing_log(LOG_ERR, " %s (%d): not a channel segment\n", __func__, __LINE__);
+        return ING_STAT_INVALID_ARGUMENT;
+    }
+
+    ch->memfd = fds[0];
+    if ((rc = chan_map(ch, st.st_size)) != ING_STAT_OK)
+    {
+        chan_reset(ch);
+        return rc;
+    }
+
+    cap = ch->hdr->capacity;
+    if (memcmp(ch->hdr->magic, SHMCHAN_MAGIC, sizeof(ch->hdr->magic)) ||
+        cap < ING_SHMCHAN_MIN_SIZE || (cap & (cap - 1)) ||
+        (size_t)st.st_size != SHMCHAN_DATA_OFF + (size_t)cap)
+    {
+        ing_log(LOG_ERR, " %s (%d): bad channel header\n", __func__, __LINE__);
+        munmap(ch->hdr, ch->map_size);
+        chan_reset(ch);
+        return ING_STAT_INVALID_ARGUMENT;
+    }
+
+    ch->capacity = cap;
+    ch->datafd = fds[1];
+    ch->spacefd = fds[2];
+    return ING_STAT_OK;
+}
+
+void ing_shmchan_close(ing_shmchan_t *ch)
+{
+    if (!ch)
+        return;
+
+    if (ch->hdr)
+    {
+        __atomic_store_n(&ch->hdr->closed, 1, __ATOMIC_SEQ_CST);
+        signal_fd(ch->datafd);
+        signal_fd(ch->spacefd);
+        munmap(ch->hdr, ch->map_size);
+    }
+    if (ch->memfd >= 0)
+        close(ch->memfd);
+    if (ch->datafd >= 0)
+        close(ch->datafd);
+    if (ch->spacefd >= 0)
+        close(ch->spacefd);
+    chan_reset(ch);
+}
+
+ing_stat_t ing_shmchan_reserve(ing_shmchan_t *ch, size_t len, void **ptr, int timeout_ms)
+{
+    struct ing_shmchan_hdr_s *hdr;
+    uint64_t head, tail, need, pos, deadline = 0;
+
+    if (!ch || !ch->hdr || !ptr || len > ing_shmchan_max_msg(ch))
+        return ING_STAT_INVALID_ARGUMENT;
+
+    hdr = ch->hdr;
+    head = hdr->head;
+    pos = head & (ch->capacity - 1);
+    need = REC_SIZE(len);
+    if (pos + need > ch->capacity)
+        need += ch->capacity - pos;
+    if (timeout_ms > 0)
+        deadline = ing_clock_mono_ms() + timeout_ms;
+
+    for (;;)
+    {
+        if (__atomic_load_n(&hdr->closed, __ATOMIC_ACQUIRE))
+            return ING_STAT_GENERAL_ERROR;
+        tail = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+        if (ch->capacity - (head - tail) >= need)
+            break;
+
+        /* arm the wakeup, then check again to not miss a release */
+        __atomic_store_n(&hdr->prod_waiting, 1, __ATOMIC_SEQ_CST);
+        tail = __atomic_load_n(&hdr->tail, __ATOMIC_SEQ_CST);
+        if (ch->capacity - (head - tail) >= need)
+            break;
+        if (!timeout_ms || !wait_fd(ch->spacefd, deadline))
+            return ING_STAT_FULL;
+    }
+
+    if (pos + REC_SIZE(len) > ch->capacity)
+    {
+        *(uint32_t *)(ch->data + pos) = SHMCHAN_WRAP;
+        head += ch->capacity - pos;
+        pos = 0;
+    }
+    ch->res_head = head;
+    ch->res_len = (uint32_t)len;
+    *ptr = ch->data + pos + SHMCHAN_REC_HDR;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_shmchan_commit(ing_shmchan_t *ch, size_t len)
+{
+    struct ing_shmchan_hdr_s *hdr;
+    uint64_t head;
+
+    if (!ch || !ch->hdr || len > ch->res_len)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    hdr = ch->hdr;
+    head = ch->res_head;
+    *(uint32_t *)(ch->data + (head & (ch->capacity - 1))) = (uint32_t)len;
+    __atomic_store_n(&hdr->head, head + REC_SIZE(len), __ATOMIC_SEQ_CST);
+    ch->res_len = 0;
+
+    if (__atomic_load_n(&hdr->cons_waiting, __ATOMIC_SEQ_CST) &&
+        __atomic_exchange_n(&hdr->cons_waiting, 0, __ATOMIC_SEQ_CST))
+        signal_fd(ch->datafd);
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_shmchan_send(ing_shmchan_t *ch, const void *data, size_t len, int timeout_ms)
+{
+    ing_stat_t rc;
+    void *ptr;
+
+    if ((rc = ing_shmchan_reserve(ch, len, &ptr, timeout_ms)) != ING_STAT_OK)
+        return rc;
+    if (len)
+        memcpy(ptr, data, len);
+    return ing_shmchan_commit(ch, len);
+}
+
+ing_stat_t ing_shmchan_peek(ing_shmchan_t *ch, const void **ptr, size_t *len, int timeout_ms)
+{
+    struct ing_shmchan_hdr_s *hdr;
+    uint64_t head, tail, pos, deadline = 0;
+    uint32_t rlen;
+
+    if (!ch || !ch->hdr || !ptr || !len)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    hdr = ch->hdr;
+    tail = hdr->tail;
+    if (timeout_ms > 0)
+        deadline = ing_clock_mono_ms() + timeout_ms;
+
+    for (;;)
+    {
+        head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+        if (head != tail)
+            break;
+        if (__atomic_load_n(&hdr->closed, __ATOMIC_ACQUIRE))
+            return ING_STAT_GENERAL_ERROR;
+
+        __atomic_store_n(&hdr->cons_waiting, 1, __ATOMIC_SEQ_CST);
+        head = __atomic_load_n(&hdr->head, __ATOMIC_SEQ_CST);
+        if (head != tail)
+            break;
+        if (!timeout_ms || !wait_fd(ch->datafd, deadline))
+            return ING_STAT_NOT_FOUND;
+    }
+
+    /* the peer's memory is not trusted: a record must lie within the ring
+     * and between tail and head, also after the jump over a wrap header
+     */
+    if ((tail & 7) || head - tail > ch->capacity)
+        goto corrupted;
+    pos = tail & (ch->capacity - 1);
+    rlen = *(volatile uint32_t *)(ch->data + pos);
+    if (rlen == SHMCHAN_WRAP)
+    {
+        tail += ch->capacity - pos;
+        pos = 0;
+        if (head - tail > ch->capacity)
+            goto corrupted;
+        rlen = *(volatile uint32_t *)ch->data;
+    }
+    if (rlen > ing_shmchan_max_msg(ch) || pos + REC_SIZE(rlen) > ch->capacity ||
+        REC_SIZE(rlen) > head - tail)
+        goto corrupted;
+
+    ch->peek_tail = tail;
+    ch->peek_len = rlen;
+    ch->peeked = TRUE;
+    *ptr = ch->data + pos + SHMCHAN_REC_HDR;
+    *len = rlen;
+    return ING_STAT_OK;
+
+corrupted:
+    ing_log(LOG_ERR, " %s (%d): corrupted channel\n", __func__, __LINE__);
+    return ING_STAT_GENERAL_ERROR;
+}
+
+ing_stat_t ing_shmchan_release(ing_shmchan_t *ch)
+{
+    struct ing_shmchan_hdr_s *hdr;
+
+    if (!ch || !ch->hdr || !ch->peeked)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    hdr = ch->hdr;
+    ch->peeked = FALSE;
+    __atomic_store_n(&hdr->tail, ch->peek_tail + REC_SIZE(ch->peek_len), __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&hdr->prod_waiting, __ATOMIC_SEQ_CST) &&
+        __atomic_exchange_n(&hdr->prod_waiting, 0, __ATOMIC_SEQ_CST))
+        signal_fd(ch->spacefd);
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_shmchan_recv(ing_shmchan_t *ch, void *buf, size_t size, size_t *len, int timeout_ms)
+{
+    const void *ptr;
+    ing_stat_t rc;
+
+    if (!len || (size && !buf))
+        return ING_STAT_INVALID_ARGUMENT;
+    if ((rc = ing_shmchan_peek(ch, &ptr, len, timeout_ms)) != ING_STAT_OK)
+        return rc;
+    if (*len > size)
+        return ING_STAT_FULL;
+    if (*len)
+        memcpy(buf, ptr, *len);
+    return ing_shmchan_release(ch);
+}
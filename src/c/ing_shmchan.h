@@ -0,0 +1,173 @@
+/* ing_shmchan.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Shared-memory channel
+ *
+ * One-directional single-producer/single-consumer ring of messages in a
+ * sealed memfd segment shared between two processes. Messages are written
+ * and read in place (ing_shmchan_reserve()/ing_shmchan_commit() and
+ * ing_shmchan_peek()/ing_shmchan_release()), so bulk transfers are not
+ * copied through the kernel and are not limited by datagram size.
+ *
+ * Wakeups use two eventfds and are only signalled when the peer is
+ * actually waiting. The memfd and the eventfds are passed to the peer over
+ * a unix socket (ing_shmchan_share() and ing_shmchan_attach()).
+ */
+
+#ifndef ING_SHMCHAN_H_
+#define ING_SHMCHAN_H_
+
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include "ing_gen_utils.h"
+
+/* number of descriptors passed by ing_shmchan_share() */
+#define ING_SHMCHAN_NFDS        3
+
+#define ING_SHMCHAN_MIN_SIZE    4096
+
+typedef struct ing_shmchan_s {
+    struct ing_shmchan_hdr_s *hdr;
+    char *data;
+    size_t map_size;
+    uint32_t capacity;          /* ring size, power of 2 */
+    int memfd;
+    int datafd;                 /* signalled by producer */
+    int spacefd;                /* signalled by consumer */
+    uint64_t res_head;          /* pending reservation */
+    uint32_t res_len;
+    uint64_t peek_tail;         /* pending peeked message */
+    uint32_t peek_len;
+    int peeked;
+} ing_shmchan_t;
+
+/* creates channel with ring of at least capacity bytes */
+ing_stat_t ing_shmchan_create(ing_shmchan_t *ch, const char *name, size_t capacity);
+
+/*
+ * Sends channel descriptors with data to a peer over a unix datagram
+ * socket (addr may be NULL for connected socket)
+ */
+ing_stat_t ing_shmchan_share(ing_shmchan_t *ch, int sock, const struct sockaddr *addr,
+    socklen_t addrlen, const void *data, size_t len);
+
+/*
+ * Attaches to a channel by descriptors received with ing_sock_recv_fds().
+ * On success the channel owns the descriptors
+ */
+ing_stat_t ing_shmchan_attach(ing_shmchan_t *ch, const int fds[ING_SHMCHAN_NFDS]);
+
+/* unmaps and closes channel; the peer sees it as closed */
+void ing_shmchan_close(ing_shmchan_t *ch);
+
+/* largest message the channel accepts */
+#define ing_shmchan_max_msg(ch) ((ch)->capacity / 2 - 8)
+
+/*
+ * Descriptors to poll (ING_EV_READ) in an event loop: the consumer waits
+ * for data on ing_shmchan_data_fd(), the producer for space on
+ * ing_shmchan_space_fd(). A call with timeout 0 that fails for lack of
+ * data/space arms the wakeup
+ */
+#define ing_shmchan_data_fd(ch)  ((ch)->datafd)
+#define ing_shmchan_space_fd(ch) ((ch)->spacefd)
+
+/*
+ * Producer side. Reserves len bytes for a message and returns pointer to
+ * them in *ptr. timeout_ms is -1 to wait for space, 0 to not wait.
+ * Returns ING_STAT_FULL if there is no space, ING_STAT_GENERAL_ERROR if
+ * the consumer closed the channel
+ */
+ing_stat_t ing_shmchan_reserve(ing_shmchan_t *ch, size_t len, void **ptr, int timeout_ms);
+
+/* publishes reserved message of len bytes (at most the reserved length) */
+ing_stat_t ing_shmchan_commit(ing_shmchan_t *ch, size_t len);
+
+/* reserves, copies and commits message */
+ing_stat_t ing_shmchan_send(ing_shmchan_t *ch, const void *data, size_t len, int timeout_ms);
+
+/*
+ * Consumer side. Returns pointer to the next message and its length; it
+ * stays valid till ing_shmchan_release(). Returns ING_STAT_NOT_FOUND if
+ * there is no message, ING_STAT_GENERAL_ERROR if the channel is empty and
+ * the producer closed it or if the ring content is corrupted
+ */
+ing_stat_t ing_shmchan_peek(ing_shmchan_t *ch, const void **ptr, size_t *len, int timeout_ms);
+
+/* frees peeked message */
+ing_stat_t ing_shmchan_release(ing_shmchan_t *ch);
+
+/*
+ * Copies next message to buf of size bytes. *len is message length;
+ * ING_STAT_FULL is returned (and the message kept) if it does not fit
+ */
+ing_stat_t ing_shmchan_recv(ing_shmchan_t *ch, void *buf, size_t size, size_t *len, int timeout_ms);
+
+#endif /* ING_SHMCHAN_H_ */
@@ -0,0 +1,489 @@
+/* ing_sock.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Batched datagram I/O implementation
+ */
+
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ing_sock.h"
+
+/* datagram sent along with a memfd */
+typedef struct memfd_hdr_s {
+    char magic[4];
+    uint32_t reserved;
+    uint64_t len;
+} memfd_hdr_t;
+
+#define MEMFD_MAGIC     "INGM"
+#define MEMFD_SEALS     (F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE)
+
+ing_stat_t ing_sock_batch_init(ing_sock_batch_t *batch, int max, size_t buf_size)
+{
+    int i;
+
+    if (!batch || max <= 0 || !buf_size)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    memset(batch, 0, sizeof(*batch));
+    batch->max = max;
+    batch->buf_size = buf_size;
+    batch->bufs = (char *)malloc((size_t)max * buf_size);
+    batch->msgs = (struct mmsghdr *)calloc(max, sizeof(*batch->msgs));
+    batch->iovs = (struct iovec *)calloc(max, sizeof(*batch->iovs));
+    batch->addrs = (struct sockaddr_storage *)calloc(max, sizeof(*batch->addrs));
+    if (!batch->bufs || !batch->msgs || !batch->iovs || !batch->addrs)
+    {
+        ing_sock_batch_destroy(batch);
+        return ING_STAT_OUTOFMEMORY;
+    }
+
+    for (i = 0; i < max; i++)
+    {
+        batch->iovs[i].iov_base = ing_sock_batch_data(batch, i);
+        batch->msgs[i].msg_hdr.msg_iov = &batch->iovs[i];
+        batch->msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    return ING_STAT_OK;
+}
+
+void ing_sock_batch_destroy(ing_sock_batch_t *batch)
+{
+    if (!batch)
+        return;
+    free(batch->bufs);
+    free(batch->msgs);
+    free(batch->iovs);
+    free(batch->addrs);
+    memset(batch, 0, sizeof(*batch));
+}
+
+int ing_sock_recv_batch(int sock, ing_sock_batch_t *batch, int flags)
+{
+    struct msghdr *hdr;
+    int i, n;
+
+    if (!batch || !batch->msgs)
+        return -1;
+
+    for (i = 0; i < batch->max; i++)
+    {
+        hdr = &batch->msgs[i].msg_hdr;
+        batch->iovs[i].iov_len = batch->buf_size;
+        hdr->msg_name = &batch->addrs[i];
+        hdr->msg_namelen = sizeof(batch->addrs[i]);
+        hdr->msg_control = NULL;
+        hdr->msg_controllen = 0;
+        hdr->msg_flags = 0;
+    }
+
+    do
+    {
+        n = recvmmsg(sock, batch->msgs, batch->max, flags, NULL);
+    } while (n < 0 && errno == EINTR);
+
+    batch->sent = 0;
+    if (n < 0)
+    {
+        batch->count = 0;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return 0;
+        ing_log(LOG_ERR, " %s (%d): recvmmsg failed: %s\n", __func__, __LINE__, strerror(errno));
+        return -1;
+    }
+    batch->count = n;
+    return n;
+}
+
+ing_stat_t ing_sock_batch_add(ing_sock_batch_t *batch, const void *data, size_t len,
+    const struct sockaddr *addr, socklen_t addrlen)
+{
+    struct msghdr *hdr;
+    int i;
+
+    if (!batch || !batch->msgs || (!data && len) || len > batch->buf_size ||
+        (addr && addrlen > sizeof(batch->addrs[0])))
+        return ING_STAT_INVALID_ARGUMENT;
+    if (batch->count == batch->max)
+        return ING_STAT_FULL;
+
+    i = batch->count++;
+    hdr = &batch->msgs[i].msg_hdr;
+    if (len)
+        memcpy(ing_sock_batch_data(batch, i), data, len);
+    batch->iovs[i].iov_len = len;
+    if (addr)
+    {
+        memcpy(&batch->addrs[i], addr, addrlen);
+        hdr->msg_name = &batch->addrs[i];
+        hdr->msg_namelen = addrlen;
+    }
+    else
+    {
+        hdr->msg_name = NULL;
+        hdr->msg_namelen = 0;
+    }
+    hdr->msg_control = NULL;
+    hdr->msg_controllen = 0;
+    hdr->msg_flags = 0;
+    return ING_STAT_OK;
+}
+
+int ing_sock_send_batch(int sock, ing_sock_batch_t *batch, int flags)
+{
+    int n, total = 0;
+
+    if (!batch || !batch->msgs)
+        return -1;
+
+    while (batch->sent < batch->count)
+    {
+        n = sendmmsg(sock, batch->msgs + batch->sent, batch->count - batch->sent, flags);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return total;
+            ing_log(LOG_ERR, " %s (%d): sendmmsg failed: %s\n", __func__, __LINE__, strerror(errno));
+            return total ? total : -1;
+        }
+        batch->sent += n;
+        total += n;
+    }
+    ing_sock_batch_reset(batch);
+    return total;
+}
+
+ing_stat_t ing_sock_send_fds(int sock, const struct sockaddr *addr, socklen_t addrlen,
+    const void *data, size_t len, const int *fds, int nfds)
+{
+    union {
+        char buf[CMSG_SPACE(ING_SOCK_MAX_FDS * sizeof(int))];
+        struct cmsghdr align;
+    } ctrl;
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    char dummy = 0;
+    ssize_t n;
+
+    if (nfds < 0 || nfds > ING_SOCK_MAX_FDS || (nfds && !fds) || (len && !data))
+        return ING_STAT_INVALID_ARGUMENT;
+
+    /* at least one byte has to be sent with the descriptors */
+    iov.iov_base = len ? (void *)data : &dummy;
+    iov.iov_len = len ? len : 1;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = (void *)addr;
+    msg.msg_namelen = addr ? addrlen : 0;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (nfds)
+    {
+        memset(&ctrl, 0, sizeof(ctrl));
+        msg.msg_control = ctrl.buf;
+        msg.msg_controllen = CMSG_SPACE(nfds * sizeof(int));
+        cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(nfds * sizeof(int));
+        memcpy(CMSG_DATA(cmsg), fds, nfds * sizeof(int));
+    }
+
+    do
+    {
+        n = sendmsg(sock, &msg, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+
+    if (n < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return ING_STAT_FULL;
+        ing_log(LOG_ERR, " %s (%d): sendmsg failed: %s\n", __func__, __LINE__, strerror(errno));
+        return ING_STAT_SYSTEM_ERROR;
+    }
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_sock_recv_fds(int sock, void *buf, size_t *len, int *fds, int *nfds,
+    struct sockaddr *addr, socklen_t *addrlen, int flags)
+{
+    union {
+        char buf[CMSG_SPACE(ING_SOCK_MAX_FDS * sizeof(int))];
+        struct cmsghdr align;
+    } ctrl;
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    int i, max, got = 0, fd;
+    char dummy;
+    ssize_t n;
+
+    if (!len || (*len && !buf) || !nfds || (*nfds && !fds))
+        return ING_STAT_INVALID_ARGUMENT;
+
+    max = *nfds;
+    iov.iov_base = *len ? buf : &dummy;
+    iov.iov_len = *len ? *len : 1;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = addr;
+    msg.msg_namelen = (addr && addrlen) ? *addrlen : 0;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+
+    do
+    {
+        n = recvmsg(sock, &msg, flags | MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+
+    if (n < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return ING_STAT_NOT_FOUND;
+        ing_log(LOG_ERR, " %s (%d): recvmsg failed: %s\n", __func__, __LINE__, strerror(errno));
+        return ING_STAT_SYSTEM_ERROR;
+    }
+
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+            continue;
+        for (i = 0; i < (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int)); i++)
+        {
+            memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+            if (got < max)
+                fds[got++] = fd;
+            else
+                close(fd);
+        }
+    }
+    /* a part of the datagram or of its descriptors is lost */
+    if (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC))
+    {
+        ing_log(LOG_ERR, " %s (%d): %s truncated\n", __func__, __LINE__,
+                (msg.msg_flags & MSG_TRUNC) ? "datagram" : "descriptors");
+        for (i = 0; i < got; i++)
+            close(fds[i]);
+        *nfds = 0;
+        return ING_STAT_GENERAL_ERROR;
+    }
+
+    *nfds = got;
+    *len = *len ? (size_t)n : 0;
+    if (addr && addrlen)
+        *addrlen = msg.msg_namelen;
+    return ING_STAT_OK;
+}
+
+static int memfd_from(const void *data, size_t len)
+{
+    const char *p = (const char *)data;
+    ssize_t n;
+    int fd;
+
+    fd = memfd_create("ing_sock_msg", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+        return -1;
+
+    while (len)
+    {
+        n = write(fd, p, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+
+    if (fcntl(fd, F_ADD_SEALS, MEMFD_SEALS | F_SEAL_SEAL) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+ing_stat_t ing_sock_send_msg(int sock, const struct sockaddr *addr, socklen_t addrlen,
+    const void *data, size_t len)
+{
+    memfd_hdr_t hdr;
+    ing_stat_t rc;
+    ssize_t n;
+    int fd;
+
+    if (len && !data)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    if (len <= ING_SOCK_INLINE_MAX)
+    {
+        do
+        {
+            n = sendto(sock, data, len, MSG_NOSIGNAL, addr, addr ? addrlen : 0);
+        } while (n < 0 && errno == EINTR);
+
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return ING_STAT_FULL;
+            ing_log(LOG_ERR, " %s (%d): sendto failed: %s\n", __func__, __LINE__, strerror(errno));
+            return ING_STAT_SYSTEM_ERROR;
+        }
+        return ING_STAT_OK;
+    }
+
+    if ((fd = memfd_from(data, len)) < 0)
+    {
+        ing_log(LOG_ERR, " %s (%d): memfd failed: %s\n", __func__, __LINE__, strerror(errno));
+        return ING_STAT_SYSTEM_ERROR;
+    }
+
+    memcpy(hdr.magic, MEMFD_MAGIC, sizeof(hdr.magic));
+    hdr.reserved = 0;
+    hdr.len = len;
+    rc = ing_sock_send_fds(sock, addr, addrlen, &hdr, sizeof(hdr), &fd, 1);
+    close(fd);
+    return rc;
+}
+
+ing_stat_t ing_sock_recv_msg(int sock, void *buf, size_t size, ing_sock_msg_t *msg,
+    struct sockaddr *addr, socklen_t *addrlen, int flags)
+{
+    memfd_hdr_t hdr;
+    struct stat st;
+    ing_stat_t rc;
+    size_t len = size;
+    int fd = -1, nfds = 1, seals;
+    void *map;
+
+    if (!msg || !buf || size < sizeof(hdr))
+        return ING_STAT_INVALID_ARGUMENT;
+
+    memset(msg, 0, sizeof(*msg));
+    rc = ing_sock_recv_fds(sock, buf, &len, &fd, &nfds, addr, addrlen, flags);
+    if (rc != ING_STAT_OK)
+        return rc;
+
+    if (!nfds)
+    {
+        msg->data = buf;
+        msg->len = len;
+        return ING_STAT_OK;
+    }
+
+    /* the sender is not trusted: the memfd must be sealed against changes */
+    rc = ING_STAT_GENERAL_ERROR;
+    if (len == sizeof(hdr))
+    {
+        memcpy(&hdr, buf, sizeof(hdr));
+        seals = fcntl(fd, F_GET_SEALS);
+        if (!memcmp(hdr.magic, MEMFD_MAGIC, sizeof(hdr.magic)) &&
+            seals >= 0 && (seals & MEMFD_SEALS) == MEMFD_SEALS &&
+            !fstat(fd, &st) && (uint64_t)st.st_size >= hdr.len && hdr.len <= SIZE_MAX)
+        {
+            map = hdr.len ? mmap(NULL, hdr.len, PROT_READ, MAP_SHARED, fd, 0) : NULL;
+            if (map != MAP_FAILED)
+            {
+                msg->map = map;
+                msg->map_len = hdr.len;
+                msg->data = map;
+                msg->len = hdr.len;
+                rc = ING_STAT_OK;
+            }
+        }
+    }
+    if (rc != ING_STAT_OK)
+        ing_log(LOG_ERR, " %s (%d): bad memfd message\n", __func__, __LINE__);
+    close(fd);
+    return rc;
+}
+
+void ing_sock_msg_release(ing_sock_msg_t *msg)
+{
+    if (!msg)
+        return;
+    if (msg->map)
+        munmap(msg->map, msg->map_len);
+    memset(msg, 0, sizeof(*msg));
+}
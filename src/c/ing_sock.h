@@ -0,0 +1,195 @@
+/* ing_sock.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Batched datagram I/O
+ *
+ * A batch holds preallocated buffers, iovecs, message headers and source
+ * addresses for up to max datagrams, so receiving or sending a batch is
+ * one recvmmsg()/sendmmsg() call and no allocation.
+ */
+
+#ifndef ING_SOCK_H_
+#define ING_SOCK_H_
+
+#include <sys/socket.h>
+
+#include "ing_gen_utils.h"
+
+typedef struct ing_sock_batch_s {
+    int max;                        /* capacity in messages */
+    size_t buf_size;                /* per message */
+    int count;                      /* messages in the batch */
+    int sent;                       /* messages already sent by ing_sock_send_batch() */
+    char *bufs;
+    struct mmsghdr *msgs;
+    struct iovec *iovs;
+    struct sockaddr_storage *addrs;
+} ing_sock_batch_t;
+
+ing_stat_t ing_sock_batch_init(ing_sock_batch_t *batch, int max, size_t buf_size);
+
+void ing_sock_batch_destroy(ing_sock_batch_t *batch);
+
+/* forget all messages */
+#define ing_sock_batch_reset(batch)     ((batch)->count = (batch)->sent = 0)
+
+/* i-th message */
+#define ing_sock_batch_data(batch, i)   ((batch)->bufs + (size_t)(i) * (batch)->buf_size)
+#define ing_sock_batch_len(batch, i)    ((batch)->msgs[i].msg_len)
+#define ing_sock_batch_addr(batch, i)   ((struct sockaddr *)&(batch)->addrs[i])
+#define ing_sock_batch_addrlen(batch, i) ((batch)->msgs[i].msg_hdr.msg_namelen)
+
+/* TRUE if i-th received message was longer than buf_size and truncated */
+#define ing_sock_batch_truncated(batch, i) \
+    (((batch)->msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0)
+
+/*
+ * Receives up to max datagrams into the batch (previous content is lost).
+ * flags are recvmmsg() flags; with MSG_WAITFORONE it blocks for the first
+ * datagram only. Returns number of received datagrams, 0 if the
+ * non-blocking socket has none, -1 on error
+ */
+int ing_sock_recv_batch(int sock, ing_sock_batch_t *batch, int flags);
+
+/*
+ * Copies a datagram to the batch for sending to addr (NULL for a connected
+ * socket). Returns ING_STAT_FULL if the batch is full and
+ * ING_STAT_INVALID_ARGUMENT if len > buf_size
+ */
+ing_stat_t ing_sock_batch_add(ing_sock_batch_t *batch, const void *data, size_t len,
+    const struct sockaddr *addr, socklen_t addrlen);
+
+/*
+ * Sends queued datagrams. Returns number of datagrams sent by this call,
+ * -1 on error. Datagrams not sent (the non-blocking socket is full) stay
+ * queued for the next call; the batch is reset when all are sent
+ */
+int ing_sock_send_batch(int sock, ing_sock_batch_t *batch, int flags);
+
+/* max number of descriptors passed in one message */
+#define ING_SOCK_MAX_FDS 16
+
+/*
+ * Sends a datagram with nfds descriptors attached (SCM_RIGHTS) over a unix
+ * socket; addr may be NULL for a connected socket. Returns ING_STAT_FULL if
+ * the non-blocking socket buffer is full
+ */
+ing_stat_t ing_sock_send_fds(int sock, const struct sockaddr *addr, socklen_t addrlen,
+    const void *data, size_t len, const int *fds, int nfds);
+
+/*
+ * Receives a datagram into buf (*len is its size on input and the received
+ * length on output) and up to *nfds descriptors (*nfds is updated, extra
+ * descriptors are closed). Received descriptors are close-on-exec. addr and
+ * addrlen may be NULL. flags are recvmsg() flags. Returns ING_STAT_NOT_FOUND
+ * if the non-blocking socket has no data. *len must be at least the size of
+ * the largest datagram expected (1 byte with *len == 0, for descriptors
+ * only): a truncated datagram, or one with more than ING_SOCK_MAX_FDS
+ * descriptors, is dropped with its descriptors and ING_STAT_GENERAL_ERROR
+ * is returned
+ */
+ing_stat_t ing_sock_recv_fds(int sock, void *buf, size_t *len, int *fds, int *nfds,
+    struct sockaddr *addr, socklen_t *addrlen, int flags);
+
+/*
+ * Size-aware unix socket messages
+ *
+ * Messages up to ING_SOCK_INLINE_MAX bytes are sent as plain datagrams.
+ * Larger ones are written to a sealed memfd and only the descriptor is
+ * sent; the receiver maps it read-only instead of reassembling fragments.
+ */
+
+#define ING_SOCK_INLINE_MAX     (16 * 1024)
+
+typedef struct ing_sock_msg_s {
+    const void *data;
+    size_t len;
+    void *map;                  /* mapped memfd, NULL for inline message */
+    size_t map_len;
+} ing_sock_msg_t;
+
+/* returns ING_STAT_FULL if the non-blocking socket buffer is full */
+ing_stat_t ing_sock_send_msg(int sock, const struct sockaddr *addr, socklen_t addrlen,
+    const void *data, size_t len);
+
+/*
+ * Receives a message. Inline messages are received into buf of size bytes;
+ * large ones are mapped. msg->data and msg->len describe the message till
+ * ing_sock_msg_release(). size must be at least ING_SOCK_INLINE_MAX to
+ * receive any message (16 bytes is the absolute minimum, for memfd messages
+ * only); a longer inline message is dropped and ING_STAT_GENERAL_ERROR is
+ * returned, as for a malformed one. Returns ING_STAT_NOT_FOUND if the
+ * non-blocking socket has no data
+ */
+ing_stat_t ing_sock_recv_msg(int sock, void *buf, size_t size, ing_sock_msg_t *msg,
+    struct sockaddr *addr, socklen_t *addrlen, int flags);
+
+void ing_sock_msg_release(ing_sock_msg_t *msg);
+
+#endif /* ING_SOCK_H_ */
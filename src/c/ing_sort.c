@@ -0,0 +1,403 @@
+/* ing_sort.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Inango sorting of record pointer arrays implementation
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ing_sort.h"
+#include "ing_parallel.h"
+
+/* runs shorter than this are sorted by insertion */
+#define INSERTION_RUN   16
+
+typedef struct sort_cmp_s {
+    int (*fn)(const void *a, const void *b, const struct sort_cmp_s *c);
+    ing_cmp_fn user_cmp;
+    size_t key_off;
+    size_t key_size;
+} sort_cmp_t;
+
+static int cmp_user(const void *a, const void *b, const sort_cmp_t *c)
+{
+    return c->user_cmp(a, b);
+}
+
+static int cmp_key_bytes(const void *a, const void *b, const sort_cmp_t *c)
+{
+    return memcmp((const char *)a + c->key_off, (const char *)b + c->key_off, c->key_size);
+}
+
+/*
+ * Merge sort
+ */
+static void merge(void **dst, void **l, size_t nl, void **r, size_t nr, const sort_cmp_t *c)
+{
+    while (nl && nr)
+    {
+        /* take from the right run only if strictly less: keeps sort stable */
+        if (c->fn(*r, *l, c) < 0) { *dst++ = *r++; nr--; }
+        else                      { *dst++ = *l++; nl--; }
+    }
+    memcpy(dst, l, nl * sizeof(void *));
+    memcpy(dst + nl, r, nr * sizeof(void *));
+}
+
+/* bottom-up merge sort of a[0..n) using tmp[0..n); result is left in a */
+static void merge_sort(void **a, void **tmp, size_t n, const sort_cmp_t *c)
+{
+    size_t i, j, w;
+    void **src = a, **dst = tmp, **swp;
+
+    for (i = 0; i < n; i += INSERTION_RUN)
+    {
+        size_t end = (i + INSERTION_RUN < n) ? i + INSERTION_RUN : n;
+        for (j = i + 1; j < end; j++)
+        {
+            void *p = a[j];
+            size_t k = j;
+            for (; k > i && c->fn(p, a[k-1], c) < 0; k--)
+                a[k] = a[k-1];
+            a[k] = p;
+        }
+    }
+
+    for (w = INSERTION_RUN; w < n; w *= 2)
+    {
+        for (i = 0; i < n; i += 2*w)
+        {
+            size_t nl = (i + w < n) ? w : n - i;
+            size_t nr = (i + nl + w < n) ? w : n - i - nl;
+            merge(dst + i, src + i, nl, src + i + nl, nr, c);
+        }
+        swp = src; src = dst; dst = swp;
+    }
+
+    if (src != a)
+        memcpy(a, src, n * sizeof(void *));
+}
+
+/*
+ * Parallel merge sort: every pool thread sorts its own chunk, then chunks
+ * are merged pairwise, each pair by its own thread
+ */
+typedef struct sort_task_s {
+    void **a, **tmp, **dst;
+    size_t nl, nr;
+    const sort_cmp_t *c;
+} sort_task_t;
+
+static void sort_chunk(sort_task_t *t)
+{
+    merge_sort(t->a, t->tmp, t->nl, t->c);
+}
+
+static void merge_chunks(sort_task_t *t)
+{
+    merge(t->dst, t->a, t->nl, t->a + t->nl, t->nr, t->c);
+}
+
+typedef struct sort_job_s {
+    void (*fn)(sort_task_t *t);
+    sort_task_t *tasks;
+} sort_job_t;
+
+static void sort_job_part(void *arg, int part, int nparts)
+{
+    sort_job_t *job = (sort_job_t *)arg;
+    (void)nparts;
+    job->fn(&job->tasks[part]);
+}
+
+/* runs fn for every task on the worker pool */
+static void run_tasks(void (*fn)(sort_task_t *t), sort_task_t *tasks, int ntasks)
+{
+    sort_job_t job = {fn, tasks};
+    int i;
+
+    if (ing_parallel_run(ntasks, sort_job_part, &job) != ING_STAT_OK)
+        for (i = 0; i < ntasks; i++)
+            fn(&tasks[i]);
+}
+
+static int sort_threads(size_t n, int nthreads)
+{
+    int t = 1;
+
+    if (n < ING_SORT_PARALLEL_MIN)
+        return 1;
+    nthreads = ing_parallel_threads(nthreads);
+
+    /* power of two keeps the merge tree balanced */
+    while (t * 2 <= nthreads && n / (size_t)(t * 2) >= ING_SORT_PARALLEL_MIN / 4)
+        t *= 2;
+    return t;
+}
+
+static ing_stat_t sort_ptrs(void **ptrs, size_t n, const sort_cmp_t *c, int nthreads)
+{
+    sort_task_t tasks[ING_SORT_MAX_THREADS];
+    size_t bounds[ING_SORT_MAX_THREADS + 1];
+    void **tmp, **src, **dst, **swp;
+    int t, i, w, ntasks;
+
+    if (n < 2)
+        return ING_STAT_OK;
+
+    tmp = (void **)malloc(n * sizeof(void *));
+    if (!tmp)
+        return ING_STAT_OUTOFMEMORY;
+
+    t = sort_threads(n, nthreads);
+    if (t == 1)
+    {
+        merge_sort(ptrs, tmp, n, c);
+        free(tmp);
+        return ING_STAT_OK;
+    }
+
+    for (i = 0; i <= t; i++)
+        bounds[i] = n * (size_t)i / (size_t)t;
+
+    for (i = 0; i < t; i++)
+    {
+        tasks[i].a = ptrs + bounds[i];
+        tasks[i].tmp = tmp + bounds[i];
+        tasks[i].nl = bounds[i+1] - bounds[i];
+        tasks[i].c = c;
+    }
+    run_tasks(sort_chunk, tasks, t);
+
+    src = ptrs; dst = tmp;
+    for (w = 1; w < t; w *= 2)
+    {
+        ntasks = 0;
+        for (i = 0; i < t; i += 2*w)
+        {
+            tasks[ntasks].a = src + bounds[i];
+            tasks[ntasks].dst = dst + bounds[i];
+            tasks[ntasks].nl = bounds[i+w] - bounds[i];
+            tasks[ntasks].nr = bounds[i+2*w] - bounds[i+w];
+            tasks[ntasks].c = c;
+            ntasks++;
+        }
+        run_tasks(merge_chunks, tasks, ntasks);
+        swp = src; src = dst; dst = swp;
+    }
+
+    if (src != ptrs)
+        memcpy(ptrs, src, n * sizeof(void *));
+    free(tmp);
+    return ING_STAT_OK;
+}
+
+/*
+ * LSD radix sort of (key, pointer) pairs; keys are normalized to uint64_t
+ * so that unsigned integer order matches the requested key order
+ */
+typedef struct radix_item_s {
+    uint64_t key;
+    void *ptr;
+} radix_item_t;
+
+static uint64_t radix_key(const void *rec, size_t key_off, size_t key_size, ing_sort_key_t key_type)
+{
+    const unsigned char *p = (const unsigned char *)rec + key_off;
+    uint64_t k = 0;
+    size_t i;
+
+    switch (key_type)
+    {
+    case ING_SORT_KEY_UINT:
+        switch (key_size)
+        {
+        case 1: { uint8_t v;  memcpy(&v, p, 1); k = v; } break;
+        case 2: { uint16_t v; memcpy(&v, p, 2); k = v; } break;
+        case 4: { uint32_t v; memcpy(&v, p, 4); k = v; } break;
+        default: memcpy(&k, p, 8); break;
+        }
+        break;
+
+    case ING_SORT_KEY_INT:
+        switch (key_size)
+        {
+        case 1: { int8_t v;  memcpy(&v, p, 1); k = (uint64_t)(int64_t)v; } break;
+        case 2: { int16_t v; memcpy(&v, p, 2); k = (uint64_t)(int64_t)v; } break;
+        case 4: { int32_t v; memcpy(&v, p, 4); k = (uint64_t)(int64_t)v; } break;
+        default: memcpy(&k, p, 8); break;
+        }
+        k ^= 1ULL << 63;    /* negative values go first */
+        break;
+
+    default:
+        /* big-endian packing: numeric order == memcmp() order */
+        for (i = 0; i < key_size; i++)
+            k |= (uint64_t)p[i] << (56 - 8*i);
+        break;
+    }
+    return k;
+}
+
+static ing_stat_t radix_sort_ptrs(void **ptrs, size_t n, size_t key_off, size_t key_size,
+    ing_sort_key_t key_type)
+{
+    size_t (*count)[256];
+    radix_item_t *a, *b, *swp;
+    size_t i, d, sum, tmp;
+
+    a = (radix_item_t *)malloc(2 * n * sizeof(radix_item_t));
+    count = (size_t (*)[256])calloc(8, sizeof(*count));
+    if (!a || !count)
+    {
+        free(a);
+        free(count);
+        return ING_STAT_OUTOFMEMORY;
+    }
+    b = a + n;
+
+    /* build keys and all eight digit histograms in one pass */
+    for (i = 0; i < n; i++)
+    {
+        a[i].key = radix_key(ptrs[i], key_off, key_size, key_type);
+        a[i].ptr = ptrs[i];
+        for (d = 0; d < 8; d++)
+            count[d][(a[i].key >> (8*d)) & 0xFF]++;
+    }
+
+    for (d = 0; d < 8; d++)
+    {
+        /* digit is the same for all keys: nothing to reorder */
+        if (count[d][(a[0].key >> (8*d)) & 0xFF] == n)
+            continue;
+
+        for (i = 0, sum = 0; i < 256; i++)
+        {
+            tmp = count[d][i];
+            count[d][i] = sum;
+            sum += tmp;
+        }
+        for (i = 0; i < n; i++)
+            b[count[d][(a[i].key >> (8*d)) & 0xFF]++] = a[i];
+        swp = a; a = b; b = swp;
+    }
+
+    for (i = 0; i < n; i++)
+        ptrs[i] = a[i].ptr;
+
+    free(a < b ? a : b);
+    free(count);
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_sort_ptrs(void **ptrs, size_t n, ing_cmp_fn cmp, int nthreads)
+{
+    sort_cmp_t c = {cmp_user, cmp, 0, 0};
+
+    if ((!ptrs && n) || !cmp || nthreads < 0)
+        return ING_STAT_INVALID_ARGUMENT;
+    return sort_ptrs(ptrs, n, &c, nthreads);
+}
+
+ing_stat_t ing_sort_ptrs_by_key(void **ptrs, size_t n, size_t key_off, size_t key_size,
+    ing_sort_key_t key_type, int nthreads)
+{
+    sort_cmp_t c = {cmp_key_bytes, NULL, key_off, key_size};
+
+    if ((!ptrs && n) || !key_size || nthreads < 0)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (key_type != ING_SORT_KEY_BYTES &&
+        key_size != 1 && key_size != 2 && key_size != 4 && key_size != 8)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    if (n < 2)
+        return ING_STAT_OK;
+    if (key_size <= 8)
+        return radix_sort_ptrs(ptrs, n, key_off, key_size, key_type);
+    return sort_ptrs(ptrs, n, &c, nthreads);
+}
+
+ing_stat_t ing_view_init(ing_view_t *view, int max_count)
+{
+    if (!view || max_count < 0)
+        return ING_STAT_INVALID_ARGUMENT;
+    view->count = 0;
+    view->items = (void **)malloc((max_count ? max_count : 1) * sizeof(void *));
+    return view->items ? ING_STAT_OK : ING_STAT_OUTOFMEMORY;
+}
+
+void ing_view_free(ing_view_t *view)
+{
+    if (!view)
+        return;
+    free(view->items);
+    view->items = NULL;
+    view->count = 0;
+}
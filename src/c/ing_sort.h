@@ -0,0 +1,129 @@
+/* ing_sort.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Inango sorting of record pointer arrays
+ *
+ * Records are never moved: the functions reorder an array of pointers to
+ * them, so a sorted view of a container can be built while the container
+ * stays untouched. Fixed-width keys up to 8 bytes are sorted with LSD radix
+ * sort, everything else with a stable merge sort which is spread over
+ * several threads for large arrays.
+ */
+
+#ifndef ING_SORT_H_
+#define ING_SORT_H_
+
+#include <stddef.h>
+
+#include "ing_gen_utils.h"
+
+/* arrays shorter than this are always sorted by the calling thread */
+#define ING_SORT_PARALLEL_MIN   65536
+
+/* max number of threads used for a single sort */
+#define ING_SORT_MAX_THREADS    16
+
+/* Compares two records (not pointers to them);
+ * returns <0, 0 or >0 like strcmp()
+ */
+typedef int (*ing_cmp_fn)(const void *a, const void *b);
+
+typedef enum ing_sort_key_e {
+    ING_SORT_KEY_BYTES,     /* memcmp() order, any key size */
+    ING_SORT_KEY_UINT,      /* unsigned integer in host byte order: 1, 2, 4 or 8 bytes */
+    ING_SORT_KEY_INT        /* signed integer in host byte order: 1, 2, 4 or 8 bytes */
+} ing_sort_key_t;
+
+/* Array of record pointers, e.g. a sorted snapshot of a container */
+typedef struct ing_view_s {
+    void **items;
+    int count;
+} ing_view_t;
+
+/*
+ * Stable sort of n record pointers with cmp.
+ * nthreads == 0 selects number of online CPUs, 1 disables threading
+ */
+ing_stat_t ing_sort_ptrs(void **ptrs, size_t n, ing_cmp_fn cmp, int nthreads);
+
+/*
+ * Stable sort of n record pointers by the key of key_size bytes located
+ * key_off bytes from the record start
+ */
+ing_stat_t ing_sort_ptrs_by_key(void **ptrs, size_t n, size_t key_off, size_t key_size,
+    ing_sort_key_t key_type, int nthreads);
+
+/*
+ * Allocates view->items for max_count pointers, sets view->count to 0
+ */
+ing_stat_t ing_view_init(ing_view_t *view, int max_count);
+
+void ing_view_free(ing_view_t *view);
+
+#endif /* ING_SORT_H_ */
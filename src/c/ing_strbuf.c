@@ -0,0 +1,368 @@
+/* ing_strbuf.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * String buffer implementation
+ */
+
+#define _GNU_SOURCE
+
+#include <string.h>
+#include <stdio.h>
+
+#include "ing_strbuf.h"
+#include "ing_strkern.h"
+
+#define STRBUF_MIN_CAP  64
+
+ing_stat_t ing_strbuf_init(ing_strbuf_t *sb, size_t cap)
+{
+    if (!sb)
+        return ING_STAT_INVALID_ARGUMENT;
+    memset(sb, 0, sizeof(*sb));
+    return cap ? ing_strbuf_reserve(sb, cap) : ING_STAT_OK;
+}
+
+ing_stat_t ing_strbuf_init_fixed(ing_strbuf_t *sb, char *buf, size_t size, size_t len)
+{
+    if (!sb || !buf || (size && len >= size) || (!size && len))
+        return ING_STAT_INVALID_ARGUMENT;
+    sb->ptr = buf;
+    sb->len = len;
+    sb->cap = size;
+    sb->fixed = TRUE;
+    return ING_STAT_OK;
+}
+
+void ing_strbuf_destroy(ing_strbuf_t *sb)
+{
+    if (!sb)
+        return;
+    if (!sb->fixed)
+        free(sb->ptr);
+    memset(sb, 0, sizeof(*sb));
+}
+
+char *ing_strbuf_detach(ing_strbuf_t *sb)
+{
+    char *s;
+
+    if (!sb)
+        return NULL;
+    if (sb->fixed || !sb->ptr)
+        s = strdup(ing_strbuf_str(sb));
+    else
+        s = sb->ptr;
+    if (!sb->fixed)
+        memset(sb, 0, sizeof(*sb));
+    return s;
+}
+
+void ing_strbuf_clear(ing_strbuf_t *sb)
+{
+    if (!sb)
+        return;
+    sb->len = 0;
+    if (sb->ptr && sb->cap)
+        sb->ptr[0] = '\0';
+}
+
+ing_stat_t ing_strbuf_reserve(ing_strbuf_t *sb, size_t extra)
+{
+    size_t need, cap;
+    char *p;
+
+    if (!sb)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (extra > (size_t)-1 - sb->len - 1)
+        return ING_STAT_OUTOFMEMORY;
+    need = sb->len + extra + 1;
+    if (need <= sb->cap)
+        return ING_STAT_OK;
+    if (sb->fixed)
+        return ING_STAT_FULL;
+
+    cap = sb->cap < STRBUF_MIN_CAP ? STRBUF_MIN_CAP : sb->cap;
+    while (cap < need)
+        cap = cap > (size_t)-1 / 2 ? need : cap * 2;
+    p = (char *)realloc(sb->ptr, cap);
+    if (!p)
+        return ING_STAT_OUTOFMEMORY;
+    if (!sb->ptr)
+        p[0] = '\0';
+    sb->ptr = p;
+    sb->cap = cap;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_strbuf_set(ing_strbuf_t *sb, const char *s, size_t len)
+{
+    size_t old;
+    ing_stat_t rc;
+
+    if (!sb || (len && !s))
+        return ING_STAT_INVALID_ARGUMENT;
+    old = sb->len;
+    sb->len = 0;
+    if ((rc = ing_strbuf_reserve(sb, len)) != ING_STAT_OK)
+    {
+        sb->len = old;
+        return rc;
+    }
+    memmove(sb->ptr, s, len);
+    sb->ptr[len] = '\0';
+    sb->len = len;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_strbuf_append(ing_strbuf_t *sb, const char *s, size_t len)
+{
+    ing_stat_t rc;
+
+    if (!sb || (len && !s))
+        return ING_STAT_INVALID_ARGUMENT;
+    if ((rc = ing_strbuf_reserve(sb, len)) != ING_STAT_OK)
+        return rc;
+    memcpy(sb->ptr + sb->len, s, len);
+    sb->len += len;
+    sb->ptr[sb->len] = '\0';
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_strbuf_appendc(ing_strbuf_t *sb, char c)
+{
+    return ing_strbuf_append(sb, &c, 1);
+}
+
+ing_stat_t ing_strbuf_vappendf(ing_strbuf_t *sb, const char *fmt, va_list ap)
+{
+    va_list aq;
+    ing_stat_t rc;
+    size_t room;
+    int n;
+
+    if (!sb || !fmt)
+        return ING_STAT_INVALID_ARGUMENT;
+    if ((rc = ing_strbuf_reserve(sb, 0)) != ING_STAT_OK)
+        return rc;
+
+    room = sb->cap - sb->len;
+    va_copy(aq, ap);
+    n = vsnprintf(sb->ptr + sb->len, room, fmt, aq);
+    va_end(aq);
+    if (n < 0)
+    {
+        sb->ptr[sb->len] = '\0';
+        return ING_STAT_GENERAL_ERROR;
+    }
+    if ((size_t)n >= room)
+    {
+        /* did not fit: grow and format again */
+        sb->ptr[sb->len] = '\0';
+        if ((rc = ing_strbuf_reserve(sb, (size_t)n)) != ING_STAT_OK)
+            return rc;
+        va_copy(aq, ap);
+        vsnprintf(sb->ptr + sb->len, sb->cap - sb->len, fmt, aq);
+        va_end(aq);
+    }
+    sb->len += (size_t)n;
+    return ING_STAT_OK;
+}
+
+ing_stat_t ing_strbuf_appendf(ing_strbuf_t *sb, const char *fmt, ...)
+{
+    ing_stat_t rc;
+    va_list ap;
+
+    va_start(ap, fmt);
+    rc = ing_strbuf_vappendf(sb, fmt, ap);
+    va_end(ap);
+    return rc;
+}
+
+ing_stat_t ing_strbuf_replace(ing_strbuf_t *sb, const char *pattern, const char *replacement,
+    size_t max, size_t *count)
+{
+    size_t plen, rlen, n = 0, i, newlen, tail;
+    size_t *pos, pos1;
+    const char *p, *end;
+    char *dst, *src;
+    ing_stat_t rc;
+
+    if (count)
+        *count = 0;
+    if (!sb || !pattern || !*pattern || !replacement)
+        return ING_STAT_INVALID_ARGUMENT;
+    if (!sb->len)
+        return ING_STAT_OK;
+
+    plen = strlen(pattern);
+    rlen = strlen(replacement);
+    end = sb->ptr + sb->len;
+
+    /* count occurrences first, so a failure leaves the string unchanged */
+    for (p = sb->ptr; (!max || n < max) &&
+         (p = (const char *)memmem(p, end - p, pattern, plen)) != NULL; p += plen)
+        n++;
+    if (!n)
+        return ING_STAT_OK;
+
+    newlen = sb->len - n * plen + n * rlen;
+
+    if (rlen <= plen)
+    {
+        /* shrinking: compact in one forward pass */
+        dst = src = sb->ptr;
+        for (i = 0; i < n; i++)
+        {
+            p = (const char *)memmem(src, end - src, pattern, plen);
+            memmove(dst, src, p - src);
+            dst += p - src;
+            memcpy(dst, replacement, rlen);
+            dst += rlen;
+            src = (char *)p + plen;
+        }
+        memmove(dst, src, end - src);
+    }
+    else
+    {
+        if ((rc = ing_strbuf_reserve(sb, newlen - sb->len)) != ING_STAT_OK)
+            return rc;
+        end = sb->ptr + sb->len;
+
+        /* growing: remember positions and move the pieces from the end */
+        pos = n == 1 ? &pos1 : (size_t *)malloc(n * sizeof(*pos));
+        if (!pos)
+            return ING_STAT_OUTOFMEMORY;
+        for (i = 0, p = sb->ptr; i < n; i++, p += plen)
+        {
+            p = (const char *)memmem(p, end - p, pattern, plen);
+            pos[i] = p - sb->ptr;
+        }
+        tail = sb->len;
+        dst = sb->ptr + newlen;
+        for (i = n; i-- > 0; )
+        {
+            src = sb->ptr + pos[i] + plen;
+            dst -= tail - (pos[i] + plen);
+            memmove(dst, src, tail - (pos[i] + plen));
+            dst -= rlen;
+            memcpy(dst, replacement, rlen);
+            tail = pos[i];
+        }
+        if (pos != &pos1)
+            free(pos);
+    }
+
+    sb->len = newlen;
+    sb->ptr[newlen] = '\0';
+    if (count)
+        *count = n;
+    return ING_STAT_OK;
+}
+
+void ing_strbuf_trim(ing_strbuf_t *sb)
+{
+    size_t lead, len;
+
+    if (!sb || !sb->len)
+        return;
+    lead = ing_str_span_space(sb->ptr, sb->len);
+    len = sb->len - lead;
+    len -= ing_str_rspan_space(sb->ptr + lead, len);
+    if (lead)
+        memmove(sb->ptr, sb->ptr + lead, len);
+    sb->ptr[len] = '\0';
+    sb->len = len;
+}
+
+size_t ing_strbuf_split(const ing_strbuf_t *sb, char sep, ing_strview_t *views, size_t max)
+{
+    const char *p, *end, *q;
+    size_t n = 0;
+
+    if (!sb || (max && !views))
+        return 0;
+
+    p = ing_strbuf_str(sb);
+    end = p + sb->len;
+    for (;;)
+    {
+        q = (const char *)memchr(p, sep, end - p);
+        if (n < max)
+        {
+            views[n].ptr = p;
+            views[n].len = (q ? q : end) - p;
+        }
+        n++;
+        if (!q)
+            break;
+        p = q + 1;
+    }
+    return n;
+}
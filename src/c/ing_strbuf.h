@@ -0,0 +1,151 @@
+/* ing_strbuf.h
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * String buffer
+ *
+ * '\0'-terminated string with its length and capacity, so appends do not
+ * rescan the string. A buffer either owns heap storage that grows as
+ * needed or wraps fixed caller storage; operations that do not fit in a
+ * fixed buffer fail with ING_STAT_FULL and leave the string unchanged.
+ */
+
+#ifndef ING_STRBUF_H_
+#define ING_STRBUF_H_
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "ing_gen_utils.h"
+
+typedef struct ing_strbuf_s {
+    char *ptr;
+    size_t len;
+    size_t cap;         /* storage size, including the terminating '\0' */
+    int fixed;          /* ptr is caller storage */
+} ing_strbuf_t;
+
+#define ING_STRBUF_INIT     { NULL, 0, 0, FALSE }
+
+/* heap buffer with initial capacity cap (may be 0) */
+ing_stat_t ing_strbuf_init(ing_strbuf_t *sb, size_t cap);
+
+/*
+ * Wraps buf of size bytes that already holds a string of len characters
+ * (len < size); the storage is not modified by the call
+ */
+ing_stat_t ing_strbuf_init_fixed(ing_strbuf_t *sb, char *buf, size_t size, size_t len);
+
+/* frees heap storage */
+void ing_strbuf_destroy(ing_strbuf_t *sb);
+
+/* returns heap string (to be freed by the caller) and resets the buffer */
+char *ing_strbuf_detach(ing_strbuf_t *sb);
+
+/* string, never NULL */
+#define ing_strbuf_str(sb)  ((sb)->ptr ? (sb)->ptr : "")
+
+#define ing_strbuf_view(sb) ((ing_strview_t){ ing_strbuf_str(sb), (sb)->len })
+
+void ing_strbuf_clear(ing_strbuf_t *sb);
+
+/* makes room for extra more characters */
+ing_stat_t ing_strbuf_reserve(ing_strbuf_t *sb, size_t extra);
+
+ing_stat_t ing_strbuf_set(ing_strbuf_t *sb, const char *s, size_t len);
+
+ing_stat_t ing_strbuf_append(ing_strbuf_t *sb, const char *s, size_t len);
+
+#define ing_strbuf_append_str(sb, s)    ing_strbuf_append(sb, s, strlen(s))
+
+ing_stat_t ing_strbuf_appendc(ing_strbuf_t *sb, char c);
+
+ing_stat_t ing_strbuf_appendf(ing_strbuf_t *sb, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+ing_stat_t ing_strbuf_vappendf(ing_strbuf_t *sb, const char *fmt, va_list ap);
+
+/*
+ * Replaces up to max (0 - all) non-overlapping occurrences of pattern by
+ * replacement; the number of replacements is returned in *count if count
+ * is not NULL. An empty pattern is ING_STAT_INVALID_ARGUMENT
+ */
+ing_stat_t ing_strbuf_replace(ing_strbuf_t *sb, const char *pattern, const char *replacement,
+    size_t max, size_t *count);
+
+/* strips leading and trailing ' ', '\t', '\n', '\r' */
+void ing_strbuf_trim(ing_strbuf_t *sb);
+
+/*
+ * Splits the string by sep into views of the buffer (valid till it is
+ * modified); empty fields are kept. Stores up to max views and returns
+ * the number of fields
+ */
+size_t ing_strbuf_split(const ing_strbuf_t *sb, char sep, ing_strview_t *views, size_t max);
+
+#endif /* ING_STRBUF_H_ */
@@ -0,0 +1,361 @@
+/* ing_strkern.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * String kernels implementation
+ *
+ * Each kernel has a scalar version and, on x86, SSE2 (always available on
+ * x86-64) and AVX2 versions compiled with target attributes. The first call
+ * picks the best version for the CPU and stores it in the kernel's
+ * function pointer. The AVX2 versions clear the upper ymm halves before
+ * the SSE2 code that handles their tail, as the compiler does not do it
+ * for calls and a dirty upper state slows down legacy SSE instructions.
+ */
+
+#include <stdint.h>
+
+#include "ing_strkern.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__SSE2__)
+#define STRKERN_X86 1
+#include <immintrin.h>
+#else
+#define STRKERN_X86 0
+#endif
+
+#define IS_SPACE(c)     ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r')
+
+typedef size_t (*span_fn)(const char *s, size_t len);
+typedef void (*case_fn)(char *s, size_t len);
+
+/* scalar */
+
+static size_t span_space_scalar(const char *s, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len && IS_SPACE(s[i]); i++)
+        ;
+    return i;
+}
+
+static size_t rspan_space_scalar(const char *s, size_t len)
+{
+    size_t i;
+
+    for (i = len; i > 0 && IS_SPACE(s[i - 1]); i--)
+        ;
+    return len - i;
+}
+
+/* flips bit 0x20 of 'a'..'z' (lo = 'a') or 'A'..'Z' (lo = 'A') */
+static void case_scalar(char *s, size_t len, unsigned char lo)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if ((unsigned char)(s[i] - lo) < 26)
+            s[i] ^= 0x20;
+    }
+}
+
+#if STRKERN_X86
+
+/* SSE2 */
+
+static inline __m128i space_mask128(__m128i v)
+{
+    __m128i m = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+    return _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+}
+
+static size_t span_space_sse2(const char *s, size_t len)
+{
+    unsigned m;
+    size_t i;
+
+    for (i = 0; i + 16 <= len; i += 16)
+    {
+        m = (unsigned)_mm_movemask_epi8(space_mask128(_mm_loadu_si128((const __m128i *)(s + i))));
+        if (m != 0xffff)
+            return i + __builtin_ctz(~m);
+    }
+    return i + span_space_scalar(s + i, len - i);
+}
+
+static size_t rspan_space_sse2(const char *s, size_t len)
+{
+    unsigned m;
+    size_t i;
+
+    for (i = len; i >= 16; i -= 16)
+    {
+        m = (unsigned)_mm_movemask_epi8(space_mask128(_mm_loadu_si128((const __m128i *)(s + i - 16))));
+        if (m != 0xffff)
+            return len - i + __builtin_clz(~m << 16);
+    }
+    return len - i + rspan_space_scalar(s, i);
+}
+
+/*
+ * Letters lo..lo+25 are shifted to -128..-103 so one signed compare
+ * selects them
+ */
+static inline __m128i case128(__m128i v, char lo)
+{
+    __m128i t = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - lo)));
+    __m128i m = _mm_cmplt_epi8(t, _mm_set1_epi8((char)(0x80 - 0x100 + 26)));
+
+    return _mm_xor_si128(v, _mm_and_si128(m, _mm_set1_epi8(0x20)));
+}
+
+static void case_sse2(char *s, size_t len, char lo)
+{
+    size_t i;
+
+    for (i = 0; i + 16 <= len; i += 16)
+        _mm_storeu_si128((__m128i *)(s + i), case128(_mm_loadu_si128((const __m128i *)(s + i)), lo));
+    case_scalar(s + i, len - i, (unsigned char)lo);
+}
+
+static void upper_sse2(char *s, size_t len)
+{
+    case_sse2(s, len, 'a');
+}
+
+static void lower_sse2(char *s, size_t len)
+{
+    case_sse2(s, len, 'A');
+}
+
+/* AVX2 */
+
+__attribute__((target("avx2")))
+static inline __m256i space_mask256(__m256i v)
+{
+    __m256i m = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+    m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+    return _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+}
+
+__attribute__((target("avx2")))
+static size_t span_space_avx2(const char *s, size_t len)
+{
+    uint32_t m;
+    size_t i;
+
+    for (i = 0; i + 32 <= len; i += 32)
+    {
+        m = (uint32_t)_mm256_movemask_epi8(space_mask256(_mm256_loadu_si256((const __m256i *)(s + i))));
+        if (m != 0xffffffffu)
+            return i + __builtin_ctz(~m);
+    }
+    /* the SSE2 tail is not VEX encoded */
+    _mm256_zeroupper();
+    return i + span_space_sse2(s + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size_t rspan_space_avx2(const char *s, size_t len)
+{
+    uint32_t m;
+    size_t i;
+
+    for (i = len; i >= 32; i -= 32)
+    {
+        m = (uint32_t)_mm256_movemask_epi8(space_mask256(_mm256_loadu_si256((const __m256i *)(s + i - 32))));
+        if (m != 0xffffffffu)
+            return len - i + __builtin_clz(~m);
+    }
+    _mm256_zeroupper();
+    return len - i + rspan_space_sse2(s, i);
+}
+
+__attribute__((target("avx2")))
+static void case_avx2(char *s, size_t len, char lo)
+{
+    __m256i v, t, m;
+    size_t i;
+
+    for (i = 0; i + 32 <= len; i += 32)
+    {
+        v = _mm256_loadu_si256((const __m256i *)(s + i));
+        t = _mm256_add_epi8(v, _mm256_set1_epi8((char)(0x80 - lo)));
+        m = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(0x80 - 0x100 + 26)), t);
+        _mm256_storeu_si256((__m256i *)(s + i),
+            _mm256_xor_si256(v, _mm256_and_si256(m, _mm256_set1_epi8(0x20))));
+    }
+    _mm256_zeroupper();
+    case_sse2(s + i, len - i, lo);
+}
+
+__attribute__((target("avx2")))
+static void upper_avx2(char *s, size_t len)
+{
+    case_avx2(s, len, 'a');
+}
+
+__attribute__((target("avx2")))
+static void lower_avx2(char *s, size_t len)
+{
+    case_avx2(s, len, 'A');
+}
+
+static int has_avx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#define PICK(name)  (has_avx2() ? name##_avx2 : name##_sse2)
+
+#else
+
+static void upper_scalar(char *s, size_t len)
+{
+    case_scalar(s, len, 'a');
+}
+
+static void lower_scalar(char *s, size_t len)
+{
+    case_scalar(s, len, 'A');
+}
+
+#define PICK(name)  (name##_scalar)
+
+#endif /* STRKERN_X86 */
+
+/* dispatch: resolved on the first call; concurrent first calls store the same value */
+
+static size_t span_space_init(const char *s, size_t len);
+static size_t rspan_space_init(const char *s, size_t len);
+static void upper_init(char *s, size_t len);
+static void lower_init(char *s, size_t len);
+
+static span_fn span_space_impl = span_space_init;
+static span_fn rspan_space_impl = rspan_space_init;
+static case_fn upper_impl = upper_init;
+static case_fn lower_impl = lower_init;
+
+static size_t span_space_init(const char *s, size_t len)
+{
+    span_fn fn = PICK(span_space);
+
+    __atomic_store_n(&span_space_impl, fn, __ATOMIC_RELAXED);
+    return fn(s, len);
+}
+
+static size_t rspan_space_init(const char *s, size_t len)
+{
+    span_fn fn = PICK(rspan_space);
+
+    __atomic_store_n(&rspan_space_impl, fn, __ATOMIC_RELAXED);
+    return fn(s, len);
+}
+
+static void upper_init(char *s, size_t len)
+{
+    case_fn fn = PICK(upper);
+
+    __atomic_store_n(&upper_impl, fn, __ATOMIC_RELAXED);
+    fn(s, len);
+}
+
+static void lower_init(char *s, size_t len)
+{
+    case_fn fn = PICK(lower);
+
+    __atomic_store_n(&lower_impl, fn, __ATOMIC_RELAXED);
+    fn(s, len);
+}
+
+size_t ing_str_span_space(const char *s, size_t len)
+{
+    return __atomic_load_n(&span_space_impl, __ATOMIC_RELAXED)(s, len);
+}
+
+size_t ing_str_rspan_space(const char *s, size_t len)
+{
+    return __atomic_load_n(&rspan_space_impl, __ATOMIC_RELAXED)(s, len);
+}
+
+void ing_str_ascii_upper(char *s, size_t len)
+{
+    __atomic_load_n(&upper_impl, __ATOMIC_RELAXED)(s, len);
+}
+
+void ing_str_ascii_lower(char *s, size_t len)
+{
+    __atomic_load_n(&lower_impl, __ATOMIC_RELAXED)(s, len);
+}
@@ -0,0 +1,402 @@
+/* ing_template.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * String templates implementation
+ *
+ * The automaton is a trie with sparse edge lists, failure links and
+ * dictionary links (the nearest state on the failure chain that ends a
+ * placeholder). It is only needed while compiling and is freed afterwards.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+
+#include "ing_template.h"
+
+typedef struct ac_edge_s {
+    unsigned char c;
+    int to;
+    int next;
+} ac_edge_t;
+
+typedef struct ac_node_s {
+    int edges;          /* first edge, -1 - none */
+    int fail;
+    int dict;           /* dictionary link, -1 - none */
+    int out;            /* placeholder ending here, -1 - none */
+} ac_node_t;
+
+typedef struct ac_s {
+    ac_node_t *nodes;
+    int nnodes;
+    ac_edge_t *edges;
+    int nedges;
+} ac_t;
+
+typedef struct tpl_match_s {
+    size_t start;
+    size_t len;
+    size_t ph;
+} tpl_match_t;
+
+typedef struct tpl_seg_s {
+    size_t off;         /* literal offset in str */
+    size_t len;         /* literal length */
+    size_t slot;        /* placeholder index, (size_t)-1 - literal */
+} tpl_seg_t;
+
+struct ing_template_s {
+    char *str;
+    tpl_seg_t *segs;
+    size_t nsegs;
+    size_t nslots;
+    size_t nph;
+};
+
+#define SEG_LITERAL     ((size_t)-1)
+
+static int ac_child(const ac_t *ac, int node, unsigned char c)
+{
+    int e;
+
+    for (e = ac->nodes[node].edges; e >= 0; e = ac->edges[e].next)
+    {
+        if (ac->edges[e].c == c)
+            return ac->edges[e].to;
+    }
+    return -1;
+}
+
+static ing_stat_t ac_build(ac_t *ac, const char *const *ph, size_t n)
+{
+    size_t i, total = 1;
+    const unsigned char *p;
+    int node, child, e, f, head, tail, *queue;
+
+    for (i = 0; i < n; i++)
+    {
+        if (!ph[i] || !*ph[i])
+            return ING_STAT_INVALID_ARGUMENT;
+        total += strlen(ph[i]);
+    }
+    if (total > (size_t)1 << 30)
+        return ING_STAT_INVALID_ARGUMENT;
+
+    ac->nodes = (ac_node_t *)malloc(total * sizeof(*ac->nodes));
+    ac->edges = (ac_edge_t *)malloc(total * sizeof(*ac->edges));
+    queue = (int *)malloc(total * sizeof(*queue));
+    if (!ac->nodes || !ac->edges || !queue)
+    {
+        free(queue);
+        return ING_STAT_OUTOFMEMORY;
+    }
+    ac->nnodes = 1;
+    ac->nedges = 0;
+    ac->nodes[0].edges = -1;
+    ac->nodes[0].fail = 0;
+    ac->nodes[0].dict = -1;
+    ac->nodes[0].out = -1;
+
+    /* trie */
+    for (i = 0; i < n; i++)
+    {
+        node = 0;
+        for (p = (const unsigned char *)ph[i]; *p; p++)
+        {
+            if ((child = ac_child(ac, node, *p)) < 0)
+            {
+                child = ac->nnodes++;
+                ac->nodes[child].edges = -1;
+                ac->nodes[child].dict = -1;
+                ac->nodes[child].out = -1;
+                e = ac->nedges++;
+                ac->edges[e].c = *p;
+                ac->edges[e].to = child;
+                ac->edges[e].next = ac->nodes[node].edges;
+                ac->nodes[node].edges = e;
+            }
+            node = child;
+        }
+        /* a repeated placeholder keeps its first index */
+        if (ac->nodes[node].out < 0)
+            ac->nodes[node].out = (int)i;
+    }
+
+    /* failure and dictionary links, breadth first */
+    head = tail = 0;
+    for (e = ac->nodes[0].edges; e >= 0; e = ac->edges[e].next)
+    {
+        ac->nodes[ac->edges[e].to].fail = 0;
+        queue[tail++] = ac->edges[e].to;
+    }
+    while (head < tail)
+    {
+        node = queue[head++];
+        for (e = ac->nodes[node].edges; e >= 0; e = ac->edges[e].next)
+        {
+            child = ac->edges[e].to;
+            for (f = ac->nodes[node].fail; f && ac_child(ac, f, ac->edges[e].c) < 0; f = ac->nodes[f].fail)
+                ;
+            f = ac_child(ac, f, ac->edges[e].c);
+            ac->nodes[child].fail = (f >= 0 && f != child) ? f : 0;
+            f = ac->nodes[child].fail;
+            ac->nodes[child].dict = ac->nodes[f].out >= 0 ? f : ac->nodes[f].dict;
+            queue[tail++] = child;
+        }
+    }
+    free(queue);
+    return ING_STAT_OK;
+}
+
+static void ac_free(ac_t *ac)
+{
+    free(ac->nodes);
+    free(ac->edges);
+}
+
+static int match_cmp(const void *a, const void *b)
+{
+    const tpl_match_t *x = (const tpl_match_t *)a, *y = (const tpl_match_t *)b;
+
+    if (x->start != y->start)
+        return x->start < y->start ? -1 : 1;
+    if (x->len != y->len)
+        return x->len > y->len ? -1 : 1;
+    return 0;
+}
+
+static int match_add(tpl_match_t **m, size_t *n, size_t *cap, size_t end, size_t len, size_t ph)
+{
+    tpl_match_t *p;
+
+    if (*n == *cap)
+    {
+        *cap = *cap ? *cap * 2 : 16;
+        if (!(p = (tpl_match_t *)realloc(*m, *cap * sizeof(**m))))
+            return FALSE;
+        *m = p;
+    }
+    (*m)[*n].start = end + 1 - len;
+    (*m)[*n].len = len;
+    (*m)[*n].ph = ph;
+    (*n)++;
+    return TRUE;
+}
+
+ing_stat_t ing_template_compile(ing_template_t **tpl, const char *str,
+    const char *const *placeholders, size_t n)
+{
+    ing_template_t *t;
+    tpl_match_t *m = NULL;
+    size_t nm = 0, cap = 0, i, len, pos, *phlen = NULL;
+    int node, next, d;
+    ing_stat_t rc;
+    ac_t ac = { NULL, 0, NULL, 0 };
+
+    if (!tpl || !str || (n && !placeholders))
+        return ING_STAT_INVALID_ARGUMENT;
+    if ((rc = ac_build(&ac, placeholders, n)) != ING_STAT_OK)
+    {
+        ac_free(&ac);
+        return rc;
+    }
+
+    t = (ing_template_t *)calloc(1, sizeof(*t));
+    phlen = (size_t *)malloc((n ? n : 1) * sizeof(*phlen));
+    if (!t || !phlen || !(t->str = strdup(str)))
+    {
+        rc = ING_STAT_OUTOFMEMORY;
+        goto out;
+    }
+    for (i = 0; i < n; i++)
+        phlen[i] = strlen(placeholders[i]);
+    t->nph = n;
+
+    /* all occurrences */
+    len = strlen(str);
+    for (pos = 0, node = 0; pos < len; pos++)
+    {
+        while ((next = ac_child(&ac, node, (unsigned char)str[pos])) < 0 && node)
+            node = ac.nodes[node].fail;
+        node = next >= 0 ? next : 0;
+        for (d = ac.nodes[node].out >= 0 ? node : ac.nodes[node].dict; d >= 0; d = ac.nodes[d].dict)
+        {
+            if (!match_add(&m, &nm, &cap, pos, phlen[ac.nodes[d].out], (size_t)ac.nodes[d].out))
+            {
+                rc = ING_STAT_OUTOFMEMORY;
+                goto out;
+            }
+        }
+    }
+
+    /* leftmost-longest non-overlapping occurrences become slots */
+    if (nm)
+        qsort(m, nm, sizeof(*m), match_cmp);
+    t->segs = (tpl_seg_t *)malloc((2 * nm + 1) * sizeof(*t->segs));
+    if (!t->segs)
+    {
+        rc = ING_STAT_OUTOFMEMORY;
+        goto out;
+    }
+    for (i = 0, pos = 0; i < nm; i++)
+    {
+        if (m[i].start < pos)
+            continue;
+        if (m[i].start > pos)
+        {
+            t->segs[t->nsegs].off = pos;
+            t->segs[t->nsegs].len = m[i].start - pos;
+            t->segs[t->nsegs++].slot = SEG_LITERAL;
+        }
+        t->segs[t->nsegs].off = m[i].start;
+        t->segs[t->nsegs].len = 0;
+        t->segs[t->nsegs++].slot = m[i].ph;
+        t->nslots++;
+        pos = m[i].start + m[i].len;
+    }
+    if (pos < len)
+    {
+        t->segs[t->nsegs].off = pos;
+        t->segs[t->nsegs].len = len - pos;
+        t->segs[t->nsegs++].slot = SEG_LITERAL;
+    }
+    rc = ING_STAT_OK;
+
+out:
+    ac_free(&ac);
+    free(m);
+    free(phlen);
+    if (rc != ING_STAT_OK)
+    {
+        ing_template_free(t);
+        t = NULL;
+    }
+    *tpl = t;
+    return rc;
+}
+
+void ing_template_free(ing_template_t *tpl)
+{
+    if (!tpl)
+        return;
+    free(tpl->str);
+    free(tpl->segs);
+    free(tpl);
+}
+
+size_t ing_template_slot_count(const ing_template_t *tpl)
+{
+    return tpl ? tpl->nslots : 0;
+}
+
+ing_stat_t ing_template_render(const ing_template_t *tpl, const char *const *values,
+    ing_strbuf_t *buf)
+{
+    const tpl_seg_t *seg;
+    size_t i, total = 0, len;
+    const char *v;
+    ing_stat_t rc;
+    char *dst;
+
+    if (!tpl || !buf || (tpl->nslots && !values))
+        return ING_STAT_INVALID_ARGUMENT;
+
+    /* size first, so the buffer grows at most once */
+    for (i = 0; i < tpl->nsegs; i++)
+    {
+        seg = &tpl->segs[i];
+        if (seg->slot == SEG_LITERAL)
+            total += seg->len;
+        else if ((v = values[seg->slot]) != NULL)
+            total += strlen(v);
+    }
+    if ((rc = ing_strbuf_reserve(buf, total)) != ING_STAT_OK)
+        return rc;
+
+    dst = buf->ptr + buf->len;
+    for (i = 0; i < tpl->nsegs; i++)
+    {
+        seg = &tpl->segs[i];
+        if (seg->slot == SEG_LITERAL)
+        {
+            memcpy(dst, tpl->str + seg->off, seg->len);
+            dst += seg->len;
+        }
+        else if ((v = values[seg->slot]) != NULL)
+        {
+            len = strlen(v);
+            memcpy(dst, v, len);
+            dst += len;
+        }
+    }
+    buf->len += total;
+    buf->ptr[buf->len] = '\0';
+    return ING_STAT_OK;
+}
@@ -0,0 +1,336 @@
+/* ing_validate.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Validators and parsers implementation
+ */
+
+#include <string.h>
+#include <strings.h>
+
+#include "ing_validate.h"
+
+#define IS_DIGIT(c)     ((unsigned char)((c) - '0') < 10)
+
+static int hex_value(char c)
+{
+    if (IS_DIGIT(c))
+        return c - '0';
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+int ing_parse_ipv4(const char *s, size_t len, uint8_t addr[4])
+{
+    const char *end = s + len;
+    unsigned v, i;
+    uint8_t a[4];
+
+    if (!s)
+        return FALSE;
+
+    for (i = 0; i < 4; i++)
+    {
+        if (i && (s == end || *s++ != '.'))
+            return FALSE;
+        if (s == end || !IS_DIGIT(*s))
+            return FALSE;
+        for (v = 0; s < end && IS_DIGIT(*s); s++)
+        {
+            v = v * 10 + (*s - '0');
+            if (v > 255)
+                return FALSE;
+        }
+        a[i] = (uint8_t)v;
+    }
+    if (s != end)
+        return FALSE;
+    if (addr)
+        memcpy(addr, a, sizeof(a));
+    return TRUE;
+}
+
+/* strict dotted quad (no leading zeros) at the end of an IPv6 address */
+static int parse_ipv4_strict(const char *s, size_t len, uint8_t a[4])
+{
+    const char *end = s + len;
+    unsigned v, i, n;
+
+    for (i = 0; i < 4; i++)
+    {
+        if (i && (s == end || *s++ != '.'))
+            return FALSE;
+        for (v = 0, n = 0; s < end && IS_DIGIT(*s); s++, n++)
+        {
+            if (n == 1 && v == 0)
+                return FALSE;
+            v = v * 10 + (*s - '0');
+            if (v > 255)
+                return FALSE;
+        }
+        if (!n)
+            return FALSE;
+        a[i] = (uint8_t)v;
+    }
+    return s == end;
+}
+
+int ing_parse_ipv6(const char *s, size_t len, uint8_t addr[16])
+{
+    const char *end = s + len, *group;
+    uint8_t a[16];
+    int n = 0, gap = -1, digits, h;
+    unsigned v;
+
+    if (!s || !len)
+        return FALSE;
+
+    memset(a, 0, sizeof(a));
+    if (*s == ':')
+    {
+        if (len < 2 || s[1] != ':')
+            return FALSE;
+        s++;
+    }
+
+    while (s < end)
+    {
+        if (*s == ':')
+        {
+            /* "::" */
+            if (gap >= 0)
+                return FALSE;
+            gap = n;
+            s++;
+            if (s == end)
+                break;
+            continue;
+        }
+
+        group = s;
+        for (v = 0, digits = 0; s < end && (h = hex_value(*s)) >= 0; s++, digits++)
+        {
+            if (digits == 4)
+                return FALSE;
+            v = v << 4 | (unsigned)h;
+        }
+
+        if (s < end && *s == '.')
+        {
+            /* trailing IPv4 part takes two groups */
+            if (n > 12 || !parse_ipv4_strict(group, end - group, a + n))
+                return FALSE;
+            n += 4;
+            s = end;
+            break;
+        }
+        if (!digits || n > 14)
+            return FALSE;
+        a[n++] = (uint8_t)(v >> 8);
+        a[n++] = (uint8_t)v;
+
+        if (s < end)
+        {
+            if (*s++ != ':' || s == end)
+                return FALSE;
+        }
+    }
+
+    if (gap >= 0)
+    {
+        if (n == 16)
+            return FALSE;
+        memmove(a + 16 - (n - gap), a + gap, n - gap);
+        memset(a + gap, 0, 16 - n);
+    }
+    else if (n != 16)
+        return FALSE;
+
+    if (addr)
+        memcpy(addr, a, sizeof(a));
+    return TRUE;
+}
+
+int ing_parse_mac(const char *s, size_t len, uint8_t mac[6])
+{
+    const char *end = s + len;
+    int i, h, n;
+    unsigned v;
+    uint8_t m[6];
+
+    if (!s)
+        return FALSE;
+
+    for (i = 0; i < 6; i++)
+    {
+        if (i && (s == end || (*s != ':' && *s != '-')))
+            return FALSE;
+        if (i)
+            s++;
+        for (v = 0, n = 0; n < 2 && s < end && (h = hex_value(*s)) >= 0; s++, n++)
+            v = v << 4 | (unsigned)h;
+        if (!n)
+            return FALSE;
+        m[i] = (uint8_t)v;
+    }
+    if (s != end)
+        return FALSE;
+    if (mac)
+        memcpy(mac, m, sizeof(m));
+    return TRUE;
+}
+
+/* digits of s into *val, FALSE on overflow of limit or no digits */
+static int parse_digits(const char *s, const char *end, uint64_t limit, uint64_t *val)
+{
+    uint64_t v = 0;
+    unsigned d;
+
+    if (s == end)
+        return FALSE;
+    for (; s < end; s++)
+    {
+        if (!IS_DIGIT(*s))
+            return FALSE;
+        d = *s - '0';
+        /* limit - d must not wrap for a digit above a small limit */
+        if (d > limit || v > (limit - d) / 10)
+            return FALSE;
+        v = v * 10 + d;
+    }
+    *val = v;
+    return TRUE;
+}
+
+int ing_parse_int(const char *s, size_t len, int64_t min, int64_t max, int64_t *val)
+{
+    const char *end = s + len;
+    uint64_t u;
+    int64_t v;
+    int neg = FALSE;
+
+    if (!s || !len || min > max)
+        return FALSE;
+    if (*s == '-' || *s == '+')
+        neg = *s++ == '-';
+
+    if (neg)
+    {
+        if (!parse_digits(s, end, min < 0 ? (uint64_t)-(min + 1) + 1 : 0, &u))
+            return FALSE;
+        v = u ? -(int64_t)(u - 1) - 1 : 0;
+    }
+    else
+    {
+        if (max < 0 || !parse_digits(s, end, (uint64_t)max, &u))
+            return FALSE;
+        v = (int64_t)u;
+    }
+    if (v < min || v > max)
+        return FALSE;
+    if (val)
+        *val = v;
+    return TRUE;
+}
+
+int ing_parse_uint(const char *s, size_t len, uint64_t max, uint64_t *val)
+{
+    const char *end = s + len;
+    uint64_t u;
+
+    if (!s || !len)
+        return FALSE;
+    if (*s == '+')
+        s++;
+    if (!parse_digits(s, end, max, &u))
+        return FALSE;
+    if (val)
+        *val = u;
+    return TRUE;
+}
+
+int ing_parse_bool(const char *s, size_t len, int *val)
+{
+    int v;
+
+    if (!s)
+        return FALSE;
+    if (len == 1 && (*s == '1' || *s == '0'))
+        v = *s == '1';
+    else if (len == 4 && !strncasecmp(s, "true", 4))
+        v = TRUE;
+    else if (len == 5 && !strncasecmp(s, "false", 5))
+        v = FALSE;
+    else
+        return FALSE;
+    if (val)
+        *val = v;
+    return TRUE;
+}
@@ -70,6 +70,10 @@
  * Description: Lua module for in-memory libconfig data decoding/encoding
 /*/
 
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <lua.h>
@@ -83,6 +87,33 @@ typedef enum
     ST_AGGREGATE
 } AddedSettingType;
 //------------------------------------------------------------------------------
+// Type classes of encoded values, the same as config.type_class in libconfig.lua
+typedef enum
+{
+    TC_NONE      = 0,
+    TC_UNKNOWN   = 1,
+    TC_SCALAR    = 2,
+    TC_ARRAY     = 3,
+    TC_LIST      = 4,
+    TC_GROUP     = 5,
+    TC_AGGREGATE = 6
+} TypeClass;
+
+// Key of the type class clue in the tables created by libconfig.empty_*()
+#define ENCODE_CLUE "@"
+
+// Encoder output buffer. It is kept in a userdata to be freed by GC if a Lua
+// error interrupts encoding.
+typedef struct
+{
+    char   *data;
+    size_t  len;
+    size_t  size;
+} EncodeBuffer;
+
+#define ENCODE_BUFFER_META "lualibconfig.EncodeBuffer"
+#define ENCODE_BUFFER_SIZE 1024
+//------------------------------------------------------------------------------
 // Finalization functions.
 // Functions push arguments returned by Lua functions to the stack and return
 // arguments count.
@@ -260,6 +291,592 @@ static int lua_new_table_from_settings(lua_State *lua, config_setting_t *setting
     return 1;
 }
 //------------------------------------------------------------------------------
+// Encoder buffer
+//------------------------------------------------------------------------------
+static int lua_encode_buffer_gc(lua_State *lua)
+{
+    EncodeBuffer *buf = (EncodeBuffer *)lua_touserdata(lua, 1);
+
+    free(buf->data);
+    buf->data = NULL;
+    return 0;
+}
+//------------------------------------------------------------------------------
+static EncodeBuffer *lua_new_encode_buffer(lua_State *lua)
+{
+    EncodeBuffer *buf = (EncodeBuffer *)lua_newuserdata(lua, sizeof(EncodeBuffer));
+
+    memset(buf, 0, sizeof(*buf));
+
+    if (luaL_newmetatable(lua, ENCODE_BUFFER_META))
+    {
+        lua_pushcfunction(lua, lua_encode_buffer_gc);
+        lua_setfield(lua, -2, "__gc");
+    }
+    lua_setmetatable(lua, -2);
+
+    return buf;
+}
+//------------------------------------------------------------------------------
+static char *buffer_reserve(lua_State *lua, EncodeBuffer *buf, size_t len)
+{
+    if (buf->size - buf->len < len)
+    {
+        size_t size = buf->size ? buf->size : ENCODE_BUFFER_SIZE;
+        char  *data;
+
+        while (size - buf->len < len)
+            size *= 2;
+
+        data = (char *)realloc(buf->data, size);
+        if (!data)
+            luaL_error(lua, "not enough memory");
+
+        buf->data = data;
+        buf->size = size;
+    }
+
+    return buf->data + buf->len;
+}
+//------------------------------------------------------------------------------
+static void buffer_add(lua_State *lua, EncodeBuffer *buf, const char *str, size_t len)
+{
+    memcpy(buffer_reserve(lua, buf, len), str, len);
+    buf->len += len;
+}
+//------------------------------------------------------------------------------
+static void buffer_add_char(lua_State *lua, EncodeBuffer *buf, char c)
+{
+    *buffer_reserve(lua, buf, 1) = c;
+    buf->len++;
+}
+//------------------------------------------------------------------------------
+// Adds number as tostring() does
+static void buffer_add_number(lua_State *lua, EncodeBuffer *buf, int index)
+{
+    const char *str;
+    size_t      len;
+
+#if LUA_VERSION_NUM < 503
+    // LUA_NUMBER_FMT ("%.14g") prints integers below 1e14 as is
+    lua_Number num = lua_tonumber(lua, index);
+    if (num == floor(num) && fabs(num) < 1e14 && (num != 0 || !signbit(num)))
+    {
+        buf->len += (size_t)snprintf(buffer_reserve(lua, buf, 32), 32, "%lld", (long long)num);
+        return;
+    }
+#endif
+
+    lua_pushvalue(lua, index);  // tostring a copy so as not to convert a table key in place
+    str = lua_tolstring(lua, -1, &len);
+    buffer_add(lua, buf, str, len);
+    lua_pop(lua, 1);
+}
+//------------------------------------------------------------------------------
+// Adds string quoted as string.format("%q") does. Lua 5.1 escapes only '\r'
+// and '\0' of control characters while Lua 5.2+ and LuaJIT escape all of them
+// as "\ddd"; the style is detected when the module is loaded.
+static int quote_all_controls = LUA_VERSION_NUM >= 502;
+
+static void buffer_add_quoted(lua_State *lua, EncodeBuffer *buf, int index)
+{
+    size_t      len;
+    const char *str = lua_tolstring(lua, index, &len);
+    const char *end = str + len;
+
+    buffer_add_char(lua, buf, '"');
+
+    while (str < end)
+    {
+        const char *run = str;
+
+        // copy characters that need no escaping at once
+        while (str < end && *str != '"' && *str != '\\' && *str != '\n' && *str != '\r' &&
+            *str != '\0' && !(quote_all_controls && iscntrl((unsigned char)*str)))
+            ++str;
+
+        buffer_add(lua, buf, run, (size_t)(str - run));
+        if (str == end)
+            break;
+
+        if (*str == '"' || *str == '\\' || *str == '\n')
+        {
+            buffer_add_char(lua, buf, '\\');
+            buffer_add_char(lua, buf, *str);
+        }
+        else if (!quote_all_controls)
+        {
+            if (*str == '\r')
+                buffer_add(lua, buf, "\\r", 2);
+            else
+                buffer_add(lua, buf, "\\000", 4);
+        }
+        else
+        {
+            char code[8];
+            int  n;
+
+            if (str + 1 < end && isdigit((unsigned char)str[1]))
+                n = snprintf(code, sizeof(code), "\\%03d", (unsigned char)*str);
+            else
+                n = snprintf(code, sizeof(code), "\\%d", (unsigned char)*str);
+            buffer_add(lua, buf, code, (size_t)n);
+        }
+        ++str;
+    }
+
+    buffer_add_char(lua, buf, '"');
+}
+//------------------------------------------------------------------------------
+static void lua_detect_quote_style(lua_State *lua)
+{
+    lua_getglobal(lua, "string");
+    if (lua_istable(lua, -1))
+    {
+        lua_getfield(lua, -1, "format");
+        lua_pushliteral(lua, "%q");
+        lua_pushliteral(lua, "\r");
+        if (0 == lua_pcall(lua, 2, 1, 0) && lua_isstring(lua, -1))
+            quote_all_controls = strcmp(lua_tostring(lua, -1), "\"\\r\"") != 0;
+        lua_pop(lua, 1);
+    }
+    lua_pop(lua, 1);
+}
+//------------------------------------------------------------------------------
+// Adds "name: " prefix of a setting if name_index refers to a name
+static void buffer_add_name(lua_State *lua, EncodeBuffer *buf, int name_index)
+{
+    if (!name_index)
+        return;
+
+    if (LUA_TSTRING == lua_type(lua, name_index))
+    {
+        size_t      len;
+        const char *str = lua_tolstring(lua, name_index, &len);
+        buffer_add(lua, buf, str, len);
+    }
+    else if (LUA_TNUMBER == lua_type(lua, name_index))
+        buffer_add_number(lua, buf, name_index);
+    else
+        luaL_error(lua, "invalid setting name type '%s'", luaL_typename(lua, name_index));
+
+    buffer_add(lua, buf, ": ", 2);
+}
+//------------------------------------------------------------------------------
+// Encoder
+//
+// Tables are encoded in the way libconfig.lua encoder does but the type class
+// of a table is inferred in the same pass that produces its output. Errors are
+// pushed to the stack as messages in the libconfig.lua format.
+//------------------------------------------------------------------------------
+static int lua_encode_setting(lua_State *lua, EncodeBuffer *buf, int index, int name_index);
+//------------------------------------------------------------------------------
+// Prepends ".name" to the error message on top of the stack
+static void lua_error_prepend_name(lua_State *lua, int name_index)
+{
+    lua_pushliteral(lua, ".");
+    lua_pushvalue(lua, name_index);
+    lua_pushvalue(lua, -3);
+    lua_concat(lua, 3);
+    lua_replace(lua, -2);
+}
+//------------------------------------------------------------------------------
+// Prepends "[i]" to the error message on top of the stack
+static void lua_error_prepend_index(lua_State *lua, lua_Integer i)
+{
+    lua_pushliteral(lua, "[");
+    lua_pushinteger(lua, i);
+    lua_pushliteral(lua, "]");
+    lua_pushvalue(lua, -4);
+    lua_concat(lua, 4);
+    lua_replace(lua, -2);
+}
+//------------------------------------------------------------------------------
+static int lua_is_clue(lua_State *lua, int index)
+{
+    size_t      len;
+    const char *str;
+
+    if (LUA_TSTRING != lua_type(lua, index))
+        return 0;
+
+    str = lua_tolstring(lua, index, &len);
+    return len == sizeof(ENCODE_CLUE) - 1 && !memcmp(str, ENCODE_CLUE, len);
+}
+//------------------------------------------------------------------------------
+static TypeClass lua_to_clue_type_class(lua_State *lua, int index)
+{
+    lua_Number num;
+
+    if (LUA_TNUMBER != lua_type(lua, index))
+        return TC_NONE;
+
+    num = lua_tonumber(lua, index);
+    if (num < TC_UNKNOWN || num > TC_AGGREGATE || num != floor(num))
+        return TC_NONE;
+
+    return (TypeClass)num;
+}
+//------------------------------------------------------------------------------
+static void lua_encode_scalar(lua_State *lua, EncodeBuffer *buf, int index)
+{
+    switch (lua_type(lua, index))
+    {
+    case LUA_TSTRING:
+        buffer_add_quoted(lua, buf, index);
+        break;
+
+    case LUA_TNUMBER:
+        buffer_add_number(lua, buf, index);
+        if (lua_tonumber(lua, index) > 2147483647 || lua_tonumber(lua, index) < -2147483648.0)
+            buffer_add_char(lua, buf, 'L');
+        break;
+
+    case LUA_TBOOLEAN:
+        if (lua_toboolean(lua, index))
+            buffer_add(lua, buf, "true", 4);
+        else
+            buffer_add(lua, buf, "false", 5);
+        break;
+
+    default:
+        // aggregates in the arrays created by libconfig.empty_array() are
+        // encoded with tostring() as well
+        lua_getglobal(lua, "tostring");
+        lua_pushvalue(lua, index < 0 ? index - 1 : index);
+        lua_call(lua, 1, 1);
+        if (lua_isstring(lua, -1))
+        {
+            size_t      len;
+            const char *str = lua_tolstring(lua, -1, &len);
+            buffer_add(lua, buf, str, len);
+        }
+        lua_pop(lua, 1);
+        break;
+    }
+}
+//------------------------------------------------------------------------------
+// Adds setting as a ", " separated item of an aggregate; empty settings are skipped
+static int lua_encode_item(lua_State *lua, EncodeBuffer *buf, int index, int name_index, int *count)
+{
+    size_t item_start = buf->len;
+    size_t value_start;
+
+    if (*count)
+        buffer_add(lua, buf, ", ", 2);
+    value_start = buf->len;
+
+    if (!lua_encode_setting(lua, buf, index, name_index))
+    {
+        buf->len = item_start;
+        return 0;
+    }
+
+    if (buf->len == value_start)
+        buf->len = item_start;
+    else
+        ++*count;
+
+    return 1;
+}
+//------------------------------------------------------------------------------
+// Adds ipairs() items of the table starting from i
+static int lua_encode_list_items(lua_State *lua, EncodeBuffer *buf, int index, lua_Integer i, int *count)
+{
+    for (;; ++i)
+    {
+        lua_rawgeti(lua, index, (int)i);
+        if (lua_isnil(lua, -1))
+            break;
+
+        if (!lua_encode_item(lua, buf, lua_gettop(lua), 0, count))
+        {
+            lua_error_prepend_index(lua, i);
+            lua_replace(lua, -2);
+            return 0;
+        }
+        lua_pop(lua, 1);
+    }
+
+    lua_pop(lua, 1);
+    return 1;
+}
+//------------------------------------------------------------------------------
+// Encodes table with the type class given by the clue; no inference and checks
+// are made, the same as libconfig.lua does
+static int lua_encode_clued_table(lua_State *lua, EncodeBuffer *buf, int index, int name_index,
+    TypeClass tc, int top)
+{
+    int count = 0;
+
+    switch (tc)
+    {
+    case TC_AGGREGATE:
+        return 1;
+
+    case TC_ARRAY:
+        buffer_add_name(lua, buf, name_index);
+        buffer_add_char(lua, buf, '[');
+        for (int i = 1;; ++i)
+        {
+            lua_rawgeti(lua, index, i);
+            if (lua_isnil(lua, -1))
+                break;
+
+            if (i > 1)
+                buffer_add(lua, buf, ", ", 2);
+            lua_encode_scalar(lua, buf, -1);
+            lua_pop(lua, 1);
+        }
+        lua_pop(lua, 1);
+        buffer_add_char(lua, buf, ']');
+        return 1;
+
+    case TC_LIST:
+        buffer_add_name(lua, buf, name_index);
+        buffer_add_char(lua, buf, '(');
+        if (!lua_encode_list_items(lua, buf, index, 1, &count))
+            return 0;
+        buffer_add_char(lua, buf, ')');
+        return 1;
+
+    case TC_GROUP:
+        buffer_add_name(lua, buf, name_index);
+        if (!top)
+            buffer_add_char(lua, buf, '{');
+
+        lua_pushnil(lua);
+        while (lua_next(lua, index))
+        {
+            int key = lua_gettop(lua) - 1;
+
+            if (!lua_is_clue(lua, key) && !lua_encode_item(lua, buf, key + 1, key, &count))
+            {
+                lua_error_prepend_name(lua, key);
+                lua_replace(lua, key);
+                lua_pop(lua, 1);
+                return 0;
+            }
+            lua_pop(lua, 1);
+        }
+
+        if (!top)
+            buffer_add_char(lua, buf, '}');
+        return 1;
+
+    default:
+        return luaL_error(lua, "invalid type class clue");
+    }
+}
+//------------------------------------------------------------------------------
+// Encodes table inferring its type class. The class is returned in *tc (it is
+// TC_UNKNOWN if the table itself is malformed). Output of the top level table
+// is not enclosed in braces.
+static int lua_encode_table(lua_State *lua, EncodeBuffer *buf, int index, int name_index, int top,
+    TypeClass *tc)
+{
+    size_t      start           = buf->len;
+    size_t      open            = 0;
+    int         has_aggr_values = 0;
+    int         has_str_keys    = 0;
+    int         has_num_keys    = 0;
+    int         has_same_types  = 1;
+    int         scalar_type     = LUA_TNONE;
+    int         count           = 0;
+    int         in_order        = 1;  // number keys go in ipairs() order so far
+    lua_Integer next_i          = 1;
+    int         error_index;
+
+    luaL_checkstack(lua, 8, "too many nested tables");
+
+    if (!top)
+    {
+        buffer_add_name(lua, buf, name_index);
+        open = buf->len;
+        buffer_add_char(lua, buf, '(');  // replaced when the type class is known
+    }
+
+    lua_pushnil(lua);  // error of a nested setting
+    error_index = lua_gettop(lua);
+
+    lua_pushnil(lua);
+    while (lua_next(lua, index))
+    {
+        int key   = error_index + 1;
+        int value = error_index + 2;
+
+        if (lua_is_clue(lua, key))
+        {
+            TypeClass clue = lua_to_clue_type_class(lua, value);
+
+            lua_settop(lua, error_index - 1);
+            buf->len = start;
+
+            *tc = clue;
+            if (top && TC_GROUP != clue)
+                return 1;  // not a group, let the caller report
+            return lua_encode_clued_table(lua, buf, index, name_index, clue, top);
+        }
+
+        switch (lua_type(lua, key))
+        {
+        case LUA_TNUMBER:
+            has_num_keys = 1;
+            break;
+
+        case LUA_TSTRING:
+            has_str_keys = 1;
+            break;
+
+        default:
+            lua_pushfstring(lua, " - contains invalid key type '%s'", luaL_typename(lua, key));
+            goto malformed;
+        }
+
+        if (has_num_keys == has_str_keys)
+        {
+            lua_pushliteral(lua, " - contains mixed string and number key types");
+            goto malformed;
+        }
+
+        switch (lua_type(lua, value))
+        {
+        case LUA_TNUMBER:
+        case LUA_TSTRING:
+        case LUA_TBOOLEAN:
+            if (LUA_TNONE == scalar_type)
+                scalar_type = lua_type(lua, value);
+            else if (scalar_type != lua_type(lua, value))
+                has_same_types = 0;
+            break;
+
+        case LUA_TTABLE:
+            has_aggr_values = 1;
+            break;
+
+        default:
+            if (has_num_keys)
+            {
+                lua_pushliteral(lua, "[");
+                lua_pushvalue(lua, key);
+                lua_pushliteral(lua, "]");
+            }
+            else
+            {
+                lua_pushliteral(lua, ".");
+                lua_pushvalue(lua, key);
+                lua_pushliteral(lua, "");
+            }
+            lua_pushfstring(lua, " - inappropriate value type '%s'", luaL_typename(lua, value));
+            lua_concat(lua, 4);
+            goto malformed;
+        }
+
+        // output stops at the first error of a nested setting but the rest of
+        // the table is checked as errors of the table itself take precedence
+        if (lua_isnil(lua, error_index))
+        {
+            if (has_str_keys)
+            {
+                if (!lua_encode_item(lua, buf, value, key, &count))
+                {
+                    lua_error_prepend_name(lua, key);
+                    lua_replace(lua, error_index);
+                }
+            }
+            else if (in_order && lua_tonumber(lua, key) == (lua_Number)next_i)
+            {
+                if (!lua_encode_item(lua, buf, value, 0, &count))
+                {
+                    lua_error_prepend_index(lua, next_i);
+                    lua_replace(lua, error_index);
+                }
+                ++next_i;
+            }
+            else
+                in_order = 0;
+        }
+
+        lua_pop(lua, 1);
+    }
+
+    if (!has_str_keys && !has_num_keys)
+    {
+        // pure empty table: type is not deducible and the setting is skipped
+        lua_pop(lua, 1);
+        buf->len = start;
+        *tc = TC_AGGREGATE;
+        return 1;
+    }
+
+    if (has_str_keys)
+        *tc = TC_GROUP;
+    else if (has_aggr_values || !has_same_types)
+        *tc = TC_LIST;
+    else
+        *tc = TC_ARRAY;
+
+    // the rest of ipairs() items that are stored out of order
+    if (has_num_keys && lua_isnil(lua, error_index) && !lua_encode_list_items(lua, buf, index, next_i, &count))
+        lua_replace(lua, error_index);
+
+    if (!lua_isnil(lua, error_index))
+        return 0;  // error message is on top of the stack
+    lua_pop(lua, 1);
+
+    if (!top)
+    {
+        switch (*tc)
+        {
+        case TC_GROUP:
+            buf->data[open] = '{';
+            buffer_add_char(lua, buf, '}');
+            break;
+
+        case TC_ARRAY:
+            buf->data[open] = '[';
+            buffer_add_char(lua, buf, ']');
+            break;
+
+        default:
+            buffer_add_char(lua, buf, ')');
+            break;
+        }
+    }
+
+    return 1;
+
+malformed:
+    lua_replace(lua, error_index);
+    lua_settop(lua, error_index);
+    buf->len = start;
+    *tc = TC_UNKNOWN;
+    return 0;
+}
+//------------------------------------------------------------------------------
+static int lua_encode_setting(lua_State *lua, EncodeBuffer *buf, int index, int name_index)
+{
+    TypeClass tc;
+
+    switch (lua_type(lua, index))
+    {
+    case LUA_TNUMBER:
+    case LUA_TSTRING:
+    case LUA_TBOOLEAN:
+        buffer_add_name(lua, buf, name_index);
+        lua_encode_scalar(lua, buf, index);
+        return 1;
+
+    case LUA_TTABLE:
+        return lua_encode_table(lua, buf, index, name_index, 0, &tc);
+
+    default:
+        // sic: the misspelling is kept to produce libconfig.lua messages
+        lua_pushfstring(lua, " - inappropiate value type '%s'", luaL_typename(lua, index));
+        return 0;
+    }
+}
+//------------------------------------------------------------------------------
 // Exported Lua functions
 //------------------------------------------------------------------------------
 static int lua_config_decode(lua_State *lua)
@@ -300,6 +917,43 @@ static int lua_config_decode(lua_State *lua)
     return set_success_result(lua, -1);  // result table is on top of the stack
 }
 //------------------------------------------------------------------------------
+static int lua_config_encode(lua_State *lua)
+{
+    EncodeBuffer *buf;
+    TypeClass     tc;
+
+    if (LUA_TTABLE != lua_type(lua, 1))
+        return set_failure_result(lua, "Argument is not a table");
+
+    lua_settop(lua, 1);
+
+    lua_pushnil(lua);
+    if (!lua_next(lua, 1))
+    {
+        lua_pushliteral(lua, "");
+        return 1;
+    }
+    lua_settop(lua, 1);
+
+    buf = lua_new_encode_buffer(lua);
+
+    if (!lua_encode_table(lua, buf, 1, 0, 1, &tc) && TC_GROUP == tc)
+    {
+        lua_pushnil(lua);
+        lua_insert(lua, -2);
+        return 2;  // nil and error message of a nested setting
+    }
+
+    if (TC_GROUP != tc)
+        return set_failure_result(lua, "Argument is not formed as a group table");
+
+    lua_pushlstring(lua, buf->len ? buf->data : "", buf->len);
+
+    free(buf->data);
+    buf->data = NULL;
+    return 1;
+}
+//------------------------------------------------------------------------------
 // Entry points for Lua require()
 //------------------------------------------------------------------------------
 int luaopen_lualibconfig(lua_State *lua)
@@ -307,9 +961,12 @@ int luaopen_lualibconfig(lua_State *lua)
     static const struct luaL_Reg funcs[] =
     {
         {"decode", lua_config_decode},
+        {"encode", lua_config_encode},
         {NULL    , NULL}
     };
 
+    lua_detect_quote_style(lua);
+
     // no need for global table - just return unnamed table with functions
     lua_newtable(lua);
     for (const luaL_Reg *fn_reg = funcs; NULL != fn_reg->name; ++fn_reg)
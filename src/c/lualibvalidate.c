@@ -0,0 +1,272 @@
+/* lualibvalidate.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*/-----------------------------------------------------------------------------
+ * Description: Lua module with native validators of ing.utils
+/*/
+
+#include <math.h>
+#include <stdint.h>
+#include <strings.h>
+
+#include <lua.h>
+#include <lauxlib.h>
+
+#include "ing_validate.h"
+
+// 2^53: integers beyond it are not exactly representable as lua_Number
+#define LUA_EXACT_INT_MAX 9007199254740992LL
+//------------------------------------------------------------------------------
+// Lua table helpers
+//------------------------------------------------------------------------------
+static void lua_set_table_function(lua_State *lua, const char *name, lua_CFunction fn)
+{
+    lua_pushstring(lua, name);
+    lua_pushcfunction(lua, fn);
+    lua_settable(lua, -3);
+}
+//------------------------------------------------------------------------------
+// Lua stack helpers
+//------------------------------------------------------------------------------
+// returns the integer value of the argument at index or FALSE if it is not an integer
+static int lua_to_integer(lua_State *lua, int index, lua_Number *num)
+{
+    if (!lua_isnumber(lua, index))
+        return FALSE;
+
+    *num = lua_tonumber(lua, index);
+    return floor(*num) == *num;
+}
+//------------------------------------------------------------------------------
+// Exported Lua functions
+//------------------------------------------------------------------------------
+// is_ip(str) -> boolean
+static int lua_validate_is_ip(lua_State *lua)
+{
+    size_t len;
+    const char *str = luaL_checklstring(lua, 1, &len);
+
+    lua_pushboolean(lua, ing_parse_ipv4(str, len, NULL));
+    return 1;
+}
+//------------------------------------------------------------------------------
+// is_ipv6(str) -> boolean
+static int lua_validate_is_ipv6(lua_State *lua)
+{
+    size_t len;
+    const char *str = luaL_checklstring(lua, 1, &len);
+
+    lua_pushboolean(lua, ing_parse_ipv6(str, len, NULL));
+    return 1;
+}
+//------------------------------------------------------------------------------
+// is_mac(str) -> boolean; nil and false are not valid addresses
+static int lua_validate_is_mac(lua_State *lua)
+{
+    size_t len;
+    const char *str;
+
+    if (!lua_toboolean(lua, 1))
+    {
+        lua_pushboolean(lua, FALSE);
+        return 1;
+    }
+
+    str = luaL_checklstring(lua, 1, &len);
+    lua_pushboolean(lua, ing_parse_mac(str, len, NULL));
+    return 1;
+}
+//------------------------------------------------------------------------------
+// isBoolean(value) -> 0, boolean if value is "true"/"false" in any case or
+// converts to 1/0; nil otherwise
+static int lua_validate_is_boolean(lua_State *lua)
+{
+    int valid = TRUE;
+    int value = FALSE;
+
+    if (lua_type(lua, 1) == LUA_TBOOLEAN)
+    {
+        value = lua_toboolean(lua, 1);
+    }
+    else
+    {
+        size_t len;
+        const char *str = luaL_checklstring(lua, 1, &len);
+
+        if (len == 4 && strncasecmp(str, "true", 4) == 0)
+            value = TRUE;
+        else if (len == 5 && strncasecmp(str, "false", 5) == 0)
+            value = FALSE;
+        else if (lua_isnumber(lua, 1) && lua_tonumber(lua, 1) == 1)
+            value = TRUE;
+        else if (lua_isnumber(lua, 1) && lua_tonumber(lua, 1) == 0)
+            value = FALSE;
+        else
+            valid = FALSE;
+    }
+
+    if (!valid)
+    {
+        lua_pushnil(lua);
+        return 1;
+    }
+
+    lua_pushinteger(lua, 0);
+    lua_pushboolean(lua, value);
+    return 2;
+}
+//------------------------------------------------------------------------------
+// isInteger(value) -> true, number if value converts to an integer; false otherwise
+static int lua_validate_is_integer(lua_State *lua)
+{
+    lua_Number num;
+
+    if (!lua_to_integer(lua, 1, &num))
+    {
+        lua_pushboolean(lua, FALSE);
+        return 1;
+    }
+
+    lua_pushboolean(lua, TRUE);
+    lua_pushnumber(lua, num);
+    return 2;
+}
+//------------------------------------------------------------------------------
+// isUnsignedInteger(value) -> true, number if value converts to a non-negative
+// integer; false otherwise
+static int lua_validate_is_unsigned_integer(lua_State *lua)
+{
+    lua_Number num;
+
+    if (!lua_to_integer(lua, 1, &num) || num < 0)
+    {
+        lua_pushboolean(lua, FALSE);
+        return 1;
+    }
+
+    lua_pushboolean(lua, TRUE);
+    lua_pushnumber(lua, num);
+    return 2;
+}
+//------------------------------------------------------------------------------
+// parse_int(str[, min[, max]]) -> number if str is a decimal integer within
+// [min, max]; nil otherwise
+static int lua_validate_parse_int(lua_State *lua)
+{
+    size_t len;
+    const char *str = luaL_checklstring(lua, 1, &len);
+    lua_Number min = luaL_optnumber(lua, 2, (lua_Number)-LUA_EXACT_INT_MAX);
+    lua_Number max = luaL_optnumber(lua, 3, (lua_Number)LUA_EXACT_INT_MAX);
+    int64_t value;
+
+    // clamp the range so it converts to int64_t without overflow
+    if (min < -LUA_EXACT_INT_MAX)
+        min = -LUA_EXACT_INT_MAX;
+    if (max > LUA_EXACT_INT_MAX)
+        max = LUA_EXACT_INT_MAX;
+
+    if (min > max || !ing_parse_int(str, len, (int64_t)ceil(min), (int64_t)floor(max), &value))
+    {
+        lua_pushnil(lua);
+        return 1;
+    }
+
+    lua_pushnumber(lua, (lua_Number)value);
+    return 1;
+}
+//------------------------------------------------------------------------------
+// Entry points for Lua require()
+//------------------------------------------------------------------------------
+int luaopen_lualibvalidate(lua_State *lua)
+{
+    static const struct luaL_Reg funcs[] =
+    {
+        {"is_ip"            , lua_validate_is_ip},
+        {"is_ipv6"          , lua_validate_is_ipv6},
+        {"is_mac"           , lua_validate_is_mac},
+        {"isBoolean"        , lua_validate_is_boolean},
+        {"isInteger"        , lua_validate_is_integer},
+        {"isUnsignedInteger", lua_validate_is_unsigned_integer},
+        {"parse_int"        , lua_validate_parse_int},
+        {NULL               , NULL}
+    };
+
+    // no need for global table - just return unnamed table with functions
+    lua_newtable(lua);
+    for (const luaL_Reg *fn_reg = funcs; NULL != fn_reg->name; ++fn_reg)
+        lua_set_table_function(lua, fn_reg->name, fn_reg->func);
+
+    return 1;
+}
+//------------------------------------------------------------------------------
+int luaopen_mmx_lualibvalidate(lua_State *lua)
+{
+    // Workaround for loading module from mmx subdirectory of lua home directory
+    // Module should be loaded using require("mmx.lualibvalidate")
+    return luaopen_lualibvalidate(lua);
+}
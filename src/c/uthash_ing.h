@@ -81,13 +81,32 @@ typedef unsigned int uint32_t;
 
 #define HASH_FIND(hh,head,keyptr,keylen,out)                                     \
 do {                                                                             \
-  unsigned _hf_bkt,_hf_hashv;                                                    \
+  unsigned _hf_hashv;                                                            \
   out=NULL;                                                                      \
   if (head) {                                                                    \
-     HASH_FCN(keyptr,keylen, (head)->hh.tbl->num_buckets, _hf_hashv, _hf_bkt);   \
-     if (HASH_BLOOM_TEST((head)->hh.tbl, _hf_hashv)) {                           \
+     HASH_VALUE(keyptr,keylen,_hf_hashv);                                        \
+     HASH_FIND_BYHASHVALUE(hh,head,keyptr,keylen,_hf_hashv,out);                 \
+  }                                                                              \
+} while (0)
+
+/* calculate hash value of the key only; lets the caller hash once and reuse
+ * the value for several lookups or for its own filters */
+#define HASH_VALUE(keyptr,keylen,hashv)                                          \
+do {                                                                             \
+  unsigned _hv_bkt;                                                              \
+  HASH_FCN(keyptr,keylen,1,hashv,_hv_bkt);                                       \
+  (void)_hv_bkt;                                                                 \
+} while (0)
+
+#define HASH_FIND_BYHASHVALUE(hh,head,keyptr,keylen,hashval,out)                 \
+do {                                                                             \
+  unsigned _hf_bkt;                                                              \
+  out=NULL;                                                                      \
+  if (head) {                                                                    \
+     HASH_TO_BKT(hashval, (head)->hh.tbl->num_buckets, _hf_bkt);                 \
+     if (HASH_BLOOM_TEST((head)->hh.tbl, hashval)) {                             \
        HASH_FIND_IN_BKT((head)->hh.tbl, hh, (head)->hh.tbl->buckets[ _hf_bkt ],  \
-                        keyptr,keylen,out);                                      \
+                        keyptr,keylen,hashval,out);                              \
      }                                                                           \
   }                                                                              \
 } while (0)
@@ -194,6 +213,7 @@ do {
     unsigned _hd_bkt;                                                            \
     struct UT_hash_handle *_hd_hh_del;                                           \
     if ( ((delptr)->hh.prev == NULL) && ((delptr)->hh.next == NULL) )  {         \
+        HASH_BKT_TAGS_FREE((head)->hh.tbl->buckets, (head)->hh.tbl->num_buckets);\
         uthash_free((head)->hh.tbl->buckets,                                     \
                     (head)->hh.tbl->num_buckets*sizeof(struct UT_hash_bucket) ); \
         HASH_BLOOM_FREE((head)->hh.tbl);                                         \
@@ -632,19 +652,96 @@ do {
 /* key comparison function; return 0 if keys equal */
 #define HASH_KEYCMP(a,b,len) memcmp(a,b,len) 
 
-/* iterate over items in a known bucket to find desired item */
-#define HASH_FIND_IN_BKT(tbl,hh,head,keyptr,keylen_in,out)                       \
+/* Bucket fingerprints. When compiled with -DHASH_BKT_TAGS every bucket keeps
+ * a compact array of 8-bit tags (top bits of hashv) next to an array of the
+ * chain's hash handles. Lookup scans the tags and touches an element only
+ * when its tag matches, so non-matching chain items cost one byte compare
+ * instead of a cache miss on the element. The arrays are not kept in chain
+ * order: delete moves the last entry into the freed position. */
+#define HASH_TAG(hashv) ((uint8_t)((hashv) >> 24))
+
+#ifdef HASH_BKT_TAGS
+#define HASH_BKT_TAGS_INITIAL 4
+
+#define HASH_BKT_TAG_ADD(bkt,addhh)                                              \
+do {                                                                             \
+ if ((bkt).count > (bkt).tag_cap) {                                              \
+    unsigned _bta_cap = (bkt).tag_cap ? 2 * (bkt).tag_cap : HASH_BKT_TAGS_INITIAL;\
+    struct UT_hash_handle **_bta_hh = (struct UT_hash_handle**)uthash_malloc(    \
+         _bta_cap * (sizeof(struct UT_hash_handle*) + sizeof(uint8_t)));         \
+    if (!_bta_hh) { uthash_fatal( "out of memory"); }                            \
+    if ((bkt).tag_cap) {                                                         \
+        memcpy(_bta_hh, (bkt).tag_hh,                                            \
+               (bkt).tag_cap * sizeof(struct UT_hash_handle*));                  \
+        memcpy(_bta_hh + _bta_cap, (bkt).tags, (bkt).tag_cap);                   \
+        uthash_free((bkt).tag_hh, (bkt).tag_cap *                                \
+               (sizeof(struct UT_hash_handle*) + sizeof(uint8_t)));              \
+    }                                                                            \
+    (bkt).tag_hh = _bta_hh;                                                      \
+    (bkt).tags = (uint8_t*)(_bta_hh + _bta_cap);                                 \
+    (bkt).tag_cap = _bta_cap;                                                    \
+ }                                                                               \
+ (bkt).tag_hh[(bkt).count - 1] = (addhh);                                        \
+ (bkt).tags[(bkt).count - 1] = HASH_TAG((addhh)->hashv);                         \
+} while(0)
+
+/* must be called after (bkt).count was decremented */
+#define HASH_BKT_TAG_DEL(bkt,delhh)                                              \
+do {                                                                             \
+ unsigned _btd_i;                                                                \
+ for (_btd_i = 0; (bkt).tag_hh[_btd_i] != (delhh); _btd_i++) ;                   \
+ (bkt).tag_hh[_btd_i] = (bkt).tag_hh[(bkt).count];                               \
+ (bkt).tags[_btd_i] = (bkt).tags[(bkt).count];                                   \
+} while(0)
+
+#define HASH_BKT_TAGS_FREE(buckets,num_bkts)                                     \
+do {                                                                             \
+ unsigned _btf_i;                                                                \
+ for (_btf_i = 0; _btf_i < (num_bkts); _btf_i++) {                               \
+    if ((buckets)[_btf_i].tag_cap) {                                             \
+        uthash_free((buckets)[_btf_i].tag_hh, (buckets)[_btf_i].tag_cap *        \
+               (sizeof(struct UT_hash_handle*) + sizeof(uint8_t)));              \
+    }                                                                            \
+ }                                                                               \
+} while(0)
+
+/* iterate over tags of a known bucket to find desired item */
+#define HASH_FIND_IN_BKT(tbl,hh,head,keyptr,keylen_in,hashval,out)               \
+do {                                                                             \
+ unsigned _hfb_i;                                                                \
+ uint8_t _hfb_tag = HASH_TAG(hashval);                                           \
+ struct UT_hash_handle *_hfb_hh;                                                 \
+ out = NULL;                                                                     \
+ for (_hfb_i = 0; _hfb_i < (head).count; _hfb_i++) {                             \
+    if ((head).tags[_hfb_i] != _hfb_tag) continue;                               \
+    _hfb_hh = (head).tag_hh[_hfb_i];                                             \
+    if (_hfb_hh->hashv == (hashval) && _hfb_hh->keylen == (keylen_in) &&         \
+        (HASH_KEYCMP(_hfb_hh->key,keyptr,keylen_in)) == 0) {                     \
+        DECLTYPE_ASSIGN(out,ELMT_FROM_HH(tbl,_hfb_hh));                          \
+        break;                                                                   \
+    }                                                                            \
+ }                                                                               \
+} while(0)
+#else
+#define HASH_BKT_TAG_ADD(bkt,addhh)
+#define HASH_BKT_TAG_DEL(bkt,delhh)
+#define HASH_BKT_TAGS_FREE(buckets,num_bkts)
+
+/* iterate over items in a known bucket to find desired item;
+ * the stored hash value is compared first, the key only if it matches */
+#define HASH_FIND_IN_BKT(tbl,hh,head,keyptr,keylen_in,hashval,out)               \
 do {                                                                             \
  if (head.hh_head) DECLTYPE_ASSIGN(out,ELMT_FROM_HH(tbl,head.hh_head));          \
  else out=NULL;                                                                  \
  while (out) {                                                                   \
-    if (out->hh.keylen == keylen_in) {                                           \
+    if (out->hh.hashv == (hashval) && out->hh.keylen == keylen_in) {             \
         if ((HASH_KEYCMP(out->hh.key,keyptr,keylen_in)) == 0) break;             \
     }                                                                            \
     if (out->hh.hh_next) DECLTYPE_ASSIGN(out,ELMT_FROM_HH(tbl,out->hh.hh_next)); \
     else out = NULL;                                                             \
  }                                                                               \
 } while(0)
+#endif
 
 /* add an item to a bucket  */
 #define HASH_ADD_TO_BKT(head,addhh)                                              \
@@ -654,6 +751,7 @@ do {
  (addhh)->hh_prev = NULL;                                                        \
  if (head.hh_head) { (head).hh_head->hh_prev = (addhh); }                        \
  (head).hh_head=addhh;                                                           \
+ HASH_BKT_TAG_ADD(head,addhh);                                                   \
  if (head.count >= ((head.expand_mult+1) * HASH_BKT_CAPACITY_THRESH)             \
      && (addhh)->tbl->noexpand != 1) {                                           \
        HASH_EXPAND_BUCKETS((addhh)->tbl);                                        \
@@ -671,7 +769,8 @@ do {
     }                                                                            \
     if (hh_del->hh_next) {                                                       \
         hh_del->hh_next->hh_prev = hh_del->hh_prev;                              \
-    }                                                                
+    }                                                                            \
+    HASH_BKT_TAG_DEL(head,hh_del);
 
 /* Bucket expansion has the effect of doubling the number of buckets
  * and redistributing the items into the new buckets. Ideally the
@@ -729,6 +828,7 @@ do {
              _he_newbkt->expand_mult = _he_newbkt->count /                       \
                                         tbl->ideal_chain_maxlen;                 \
            }                                                                     \
+           HASH_BKT_TAG_ADD(*_he_newbkt, _he_thh);                               \
            _he_thh->hh_prev = NULL;                                              \
            _he_thh->hh_next = _he_newbkt->hh_head;                               \
            if (_he_newbkt->hh_head) _he_newbkt->hh_head->hh_prev =               \
@@ -737,6 +837,7 @@ do {
            _he_thh = _he_hh_nxt;                                                 \
         }                                                                        \
     }                                                                            \
+    HASH_BKT_TAGS_FREE(tbl->buckets, tbl->num_buckets);                          \
     uthash_free( tbl->buckets, tbl->num_buckets*sizeof(struct UT_hash_bucket) ); \
     tbl->num_buckets *= 2;                                                       \
     tbl->log2_num_buckets++;                                                     \
@@ -880,6 +981,7 @@ do {
 #define HASH_CLEAR(hh,head)                                                      \
 do {                                                                             \
   if (head) {                                                                    \
+    HASH_BKT_TAGS_FREE((head)->hh.tbl->buckets, (head)->hh.tbl->num_buckets);    \
     uthash_free((head)->hh.tbl->buckets,                                         \
                 (head)->hh.tbl->num_buckets*sizeof(struct UT_hash_bucket));      \
     uthash_free((head)->hh.tbl, sizeof(UT_hash_table));                          \
@@ -919,6 +1021,12 @@ typedef struct UT_hash_bucket {
     */
    unsigned expand_mult;
 
+#ifdef HASH_BKT_TAGS
+   struct UT_hash_handle **tag_hh;   /* chain items, see HASH_BKT_TAG_ADD  */
+   uint8_t *tags;                    /* HASH_TAG() of every tag_hh item    */
+   unsigned tag_cap;                 /* allocated entries in both arrays   */
+#endif
+
 } UT_hash_bucket;
 
 /* random signature used only to find hash tables in external analysis */
@@ -950,6 +950,22 @@ function ing.utils.isUnsignedInteger(value)
     return true, integer
 end
 
+--[[-------------------------------------------------------
+      Replaces the validators above with the native
+    implementations if the mmx.lualibvalidate module
+    is installed
+----------------------------------------------------------]]
+do
+    local loaded, native = pcall(require, "mmx.lualibvalidate")
+    if loaded and type(native) == "table" then
+        ing.utils.is_ip = native.is_ip
+        ing.utils.is_mac = native.is_mac
+        ing.utils.isBoolean = native.isBoolean
+        ing.utils.isInteger = native.isInteger
+        ing.utils.isUnsignedInteger = native.isUnsignedInteger
+    end
+end
+
 --[[ -------------------------------------------------------
     (Temporary solution. Should be improved)
     The function writes message to log file.
@@ -146,7 +146,9 @@
 
   Implementation notes:
 
-    Encoding function is a pure Lua standalone implementation.
+    Encoding function is implemented by lualibconfig C module for Lua; the pure
+    Lua implementation below is used if the module does not provide it. Both
+    produce the same output.
     Decoding function requires lualibconfig C module for Lua.
 --]]
 
@@ -409,7 +411,7 @@ local lualibconfig = require("mmx.lualibconfig")
 --]]
 local libconfig = {
     decode      = lualibconfig.decode,  -- decodes libconfig string into a Lua table
-    encode      = libconfig_encode,     -- encodes Lua table into a libconfig string
+    encode      = lualibconfig.encode or libconfig_encode,  -- encodes Lua table into a libconfig string
     empty_array = config.empty_array,   -- returns Lua table, viewed by encoder as an empty array
     empty_list  = config.empty_list,    -- returns Lua table, viewed by encoder as an empty list
     empty_group = config.empty_group    -- returns Lua table, viewed by encoder as an empty group
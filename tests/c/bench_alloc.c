@@ -0,0 +1,204 @@
+/* bench_alloc.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Throughput of the object pool and the arena compared to glibc malloc
+ */
+
+#include <string.h>
+#include <pthread.h>
+
+#include "ing_alloc.h"
+#include "ing_test.h"
+
+#define OBJ_SIZE        64
+#define POOL_CAPACITY   65536
+#define BATCH           256     /* objects held at once by a thread */
+#define ROUNDS          4000
+#define MAX_THREADS     8
+
+typedef struct bench_s
+{
+    ing_pool_t *pool;           /* NULL selects malloc */
+    pthread_barrier_t *start;
+} bench_t;
+
+/* allocates BATCH objects, touches them and frees them, ROUNDS times */
+static void *alloc_loop(void *arg)
+{
+    bench_t *b = (bench_t *)arg;
+    void *objs[BATCH];
+    int r, i;
+
+    if (b->start)
+        pthread_barrier_wait(b->start);
+    for (r = 0; r < ROUNDS; r++)
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            objs[i] = b->pool ? ing_pool_alloc(b->pool) : malloc(OBJ_SIZE);
+            TEST_CHECK(objs[i] != NULL);
+            *(volatile char *)objs[i] = (char)i;
+        }
+        for (i = 0; i < BATCH; i++)
+        {
+            if (b->pool)
+                ing_pool_free(b->pool, objs[i]);
+            else
+                free(objs[i]);
+        }
+    }
+    return NULL;
+}
+
+static void run_threads(const char *name, ing_pool_t *pool, int nthreads)
+{
+    pthread_t threads[MAX_THREADS];
+    pthread_barrier_t start;
+    bench_t b;
+    double t0, t;
+    int i;
+
+    b.pool = pool;
+    b.start = &start;
+    TEST_CHECK(pthread_barrier_init(&start, NULL, (unsigned)nthreads) == 0);
+    t0 = test_now();
+    for (i = 0; i < nthreads; i++)
+        TEST_CHECK(pthread_create(&threads[i], NULL, alloc_loop, &b) == 0);
+    for (i = 0; i < nthreads; i++)
+        pthread_join(threads[i], NULL);
+    t = test_now() - t0;
+    pthread_barrier_destroy(&start);
+
+    printf("  %-8s %d thread(s)  %8.1f M alloc+free/s\n", name, nthreads,
+        (double)nthreads * ROUNDS * BATCH / t / 1e6);
+}
+
+static void bench_pool(void)
+{
+    ing_pool_t pool;
+    int n;
+
+    TEST_OK(ing_pool_init(&pool, OBJ_SIZE, POOL_CAPACITY));
+    for (n = 1; n <= MAX_THREADS; n *= 2)
+    {
+        run_threads("malloc", NULL, n);
+        run_threads("pool", &pool, n);
+    }
+    TEST_OK(ing_pool_destroy(&pool));
+}
+
+/* many small allocations of one request, released all at once */
+static void bench_arena(void)
+{
+    void *objs[BATCH];
+    ing_arena_t arena;
+    double t0, t_malloc, t_arena;
+    int r, i;
+
+    t0 = test_now();
+    for (r = 0; r < ROUNDS; r++)
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            objs[i] = malloc(16 + i % 48);
+            TEST_CHECK(objs[i] != NULL);
+            *(volatile char *)objs[i] = (char)i;
+        }
+        for (i = 0; i < BATCH; i++)
+            free(objs[i]);
+    }
+    t_malloc = test_now() - t0;
+
+    TEST_OK(ing_arena_init(&arena, 0));
+    t0 = test_now();
+    for (r = 0; r < ROUNDS; r++)
+    {
+        for (i = 0; i < BATCH; i++)
+        {
+            objs[i] = ing_arena_alloc(&arena, 16 + i % 48);
+            TEST_CHECK(objs[i] != NULL);
+            *(volatile char *)objs[i] = (char)i;
+        }
+        ing_arena_reset(&arena);
+    }
+    t_arena = test_now() - t0;
+    ing_arena_destroy(&arena);
+
+    printf("  %-8s %8.1f M allocs/s\n", "malloc", (double)ROUNDS * BATCH / t_malloc / 1e6);
+    printf("  %-8s %8.1f M allocs/s\n", "arena", (double)ROUNDS * BATCH / t_arena / 1e6);
+}
+
+int main(void)
+{
+    printf(" pool vs malloc, %d byte objects, %d held per thread\n", OBJ_SIZE, BATCH);
+    bench_pool();
+    printf(" arena vs malloc, 16..63 byte objects\n");
+    bench_arena();
+    return 0;
+}
@@ -0,0 +1,189 @@
+/* bench_io.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Writes per second to regular files: one write() per record compared to
+ * ing_io batches on io_uring and on epoll, to one fd and alternating
+ * between two fds
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "ing_io.h"
+#include "ing_test.h"
+
+#define REC_SIZE    64
+#define NUM_WRITES  100000
+#define MAX_PENDING 256
+
+static const int batch_sizes[] = { 1, 8, 32, 64 };
+
+static char rec[REC_SIZE];
+static int writes_done;
+
+static int tmp_file(void)
+{
+    char name[] = "/tmp/bench_io.XXXXXX";
+    int fd = mkstemp(name);
+
+    TEST_CHECK(fd >= 0);
+    unlink(name);
+    return fd;
+}
+
+static void rewind_files(const int *fds, int nfds)
+{
+    int i;
+
+    for (i = 0; i < nfds; i++)
+    {
+        TEST_CHECK(ftruncate(fds[i], 0) == 0);
+        TEST_CHECK(lseek(fds[i], 0, SEEK_SET) == 0);
+    }
+}
+
+static void report(const char *name, int nfds, int batch, double t)
+{
+    printf("  %-12s %d fd%s batch %2d  %8.3f M writes/s\n", name, nfds, nfds > 1 ? "s" : " ",
+        batch, NUM_WRITES / t / 1e6);
+}
+
+static void bench_syscalls(const int *fds, int nfds, int batch)
+{
+    double t0;
+    int i;
+
+    rewind_files(fds, nfds);
+    t0 = test_now();
+    for (i = 0; i < NUM_WRITES; i++)
+        TEST_CHECK(write(fds[i % nfds], rec, sizeof(rec)) == REC_SIZE);
+    report("write()", nfds, batch, test_now() - t0);
+}
+
+static void on_write(ing_io_t *io, int fd, ssize_t res, void *arg)
+{
+    (void)io;
+    (void)fd;
+    (void)arg;
+    TEST_CHECK(res == REC_SIZE);
+    writes_done++;
+}
+
+static void bench_engine(ing_evloop_t *loop, unsigned flags, const int *fds, int nfds, int batch)
+{
+    ing_io_t *io;
+    double t0;
+    int i, j;
+
+    TEST_OK(ing_io_create(&io, loop, 0, 0, flags));
+    rewind_files(fds, nfds);
+    writes_done = 0;
+
+    t0 = test_now();
+    for (i = 0; i < NUM_WRITES; i += batch)
+    {
+        for (j = i; j < i + batch; j++)
+            TEST_OK(ing_io_write(io, fds[j % nfds], rec, sizeof(rec), -1, on_write, NULL));
+        TEST_OK(ing_io_submit(io));
+        while (i + batch - writes_done > MAX_PENDING)
+            TEST_CHECK(ing_evloop_run_once(loop, 10) >= 0);
+    }
+    while (writes_done < NUM_WRITES)
+        TEST_CHECK(ing_evloop_run_once(loop, 10) >= 0);
+    report(ing_io_uring_enabled(io) ? "ing_io uring" : "ing_io epoll", nfds, batch, test_now() - t0);
+
+    ing_io_destroy(io);
+}
+
+int main(void)
+{
+    ing_evloop_t *loop;
+    int fds[2], nfds;
+    size_t i;
+
+    memset(rec, 'x', sizeof(rec));
+    fds[0] = tmp_file();
+    fds[1] = tmp_file();
+    TEST_OK(ing_evloop_create(&loop));
+    printf(" %d writes of %d bytes to temporary files\n", NUM_WRITES, REC_SIZE);
+    for (nfds = 1; nfds <= 2; nfds++)
+    {
+        for (i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++)
+        {
+            bench_syscalls(fds, nfds, batch_sizes[i]);
+            bench_engine(loop, ING_IO_EPOLL, fds, nfds, batch_sizes[i]);
+            bench_engine(loop, 0, fds, nfds, batch_sizes[i]);
+        }
+    }
+    ing_evloop_destroy(loop);
+    close(fds[0]);
+    close(fds[1]);
+    return 0;
+}
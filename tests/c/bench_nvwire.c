@@ -0,0 +1,155 @@
+/* bench_nvwire.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Throughput of the name/value wire encoding compared to copying
+ * namevaluepair_t arrays, the layout sent before
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ing_nvwire.h"
+#include "ing_test.h"
+
+#define NUM_PAIRS   32
+#define ITERATIONS  200000
+
+static namevaluepair_t nvps[NUM_PAIRS];
+static unsigned char buf[NUM_PAIRS * ING_NVWIRE_PAIR_SIZE(NVP_MAX_NAME_LEN, NVP_MAX_VALUE_LEN)];
+static namevaluepair_t copy[NUM_PAIRS];
+
+static void report(const char *name, double t, size_t bytes)
+{
+    printf("  %-24s %8.2f M msgs/s  %8.1f MB/s  %6zu bytes/msg\n", name,
+        ITERATIONS / t / 1e6, (double)ITERATIONS * bytes / t / 1e6, bytes);
+}
+
+int main(void)
+{
+    ing_nvwire_pair_t pairs[NUM_PAIRS];
+    ing_nvwire_enc_t enc;
+    volatile size_t sink = 0;
+    size_t len = 0;
+    double t0;
+    int i, j, count;
+
+    for (i = 0; i < NUM_PAIRS; i++)
+    {
+        snprintf(nvps[i].name, sizeof(nvps[i].name), "Device.Interface.%d.Stats.BytesSent", i);
+        snprintf(nvps[i].value, sizeof(nvps[i].value), "%d", i * 123457);
+    }
+    printf(" %d pairs per message\n", NUM_PAIRS);
+
+    t0 = test_now();
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        TEST_OK(ing_nvwire_enc_init(&enc, buf, sizeof(buf)));
+        TEST_OK(ing_nvwire_enc_add_nvp(&enc, nvps, NUM_PAIRS));
+        len = ing_nvwire_enc_finish(&enc);
+        sink += buf[len / 2];
+    }
+    report("nvwire encode", test_now() - t0, len);
+
+    t0 = test_now();
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        TEST_OK(ing_nvwire_decode(buf, len, pairs, NUM_PAIRS, &count));
+        sink += pairs[count - 1].value.len;
+    }
+    report("nvwire decode", test_now() - t0, len);
+
+    /* decode into namevaluepair_t, as a receiver of the old layout gets it */
+    t0 = test_now();
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        TEST_OK(ing_nvwire_decode(buf, len, pairs, NUM_PAIRS, &count));
+        for (j = 0; j < count; j++)
+        {
+            memcpy(copy[j].name, pairs[j].name.ptr, pairs[j].name.len);
+            copy[j].name[pairs[j].name.len] = '\0';
+            memcpy(copy[j].value, pairs[j].value.ptr, pairs[j].value.len);
+            copy[j].value[pairs[j].value.len] = '\0';
+        }
+        sink += copy[count - 1].value[0];
+    }
+    report("nvwire decode + copy", test_now() - t0, len);
+    TEST_CHECK(memcmp(copy, nvps, sizeof(copy)) == 0);
+
+    t0 = test_now();
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        memcpy(buf, nvps, sizeof(nvps));
+        memcpy(copy, buf, sizeof(copy));
+        sink += copy[i % NUM_PAIRS].value[0];
+    }
+    report("namevaluepair_t copy", test_now() - t0, sizeof(nvps));
+
+    (void)sink;
+    return 0;
+}
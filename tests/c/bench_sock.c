@@ -0,0 +1,168 @@
+/* bench_sock.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Datagrams per second over UDP loopback: one sendto()/recv() per datagram
+ * compared to ing_sock batches of different sizes
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "ing_sock.h"
+#include "ing_test.h"
+
+#define MSG_SIZE    64
+#define NUM_MSGS    200000
+
+static const int batch_sizes[] = { 1, 8, 32, 64 };
+
+static int udp_socket(struct sockaddr_in *addr)
+{
+    socklen_t len = sizeof(*addr);
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    TEST_CHECK(fd >= 0);
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_CHECK(bind(fd, (struct sockaddr *)addr, sizeof(*addr)) == 0);
+    TEST_CHECK(getsockname(fd, (struct sockaddr *)addr, &len) == 0);
+    return fd;
+}
+
+static void report(const char *name, int batch, double t)
+{
+    printf("  %-10s batch %2d  %8.3f M msgs/s\n", name, batch, NUM_MSGS / t / 1e6);
+}
+
+static void bench_syscalls(int sa, int sb, const struct sockaddr_in *to, int batch)
+{
+    char buf[MSG_SIZE];
+    double t0;
+    int i, j;
+
+    memset(buf, 'x', sizeof(buf));
+    t0 = test_now();
+    for (i = 0; i < NUM_MSGS; i += batch)
+    {
+        for (j = 0; j < batch; j++)
+            TEST_CHECK(sendto(sa, buf, sizeof(buf), 0, (const struct sockaddr *)to, sizeof(*to)) == MSG_SIZE);
+        for (j = 0; j < batch; j++)
+            TEST_CHECK(recv(sb, buf, sizeof(buf), 0) == MSG_SIZE);
+    }
+    report("syscalls", batch, test_now() - t0);
+}
+
+static void bench_batches(int sa, int sb, const struct sockaddr_in *to, int batch)
+{
+    ing_sock_batch_t out, in;
+    char buf[MSG_SIZE];
+    double t0;
+    int i, j, n;
+
+    memset(buf, 'x', sizeof(buf));
+    TEST_OK(ing_sock_batch_init(&out, batch, MSG_SIZE));
+    TEST_OK(ing_sock_batch_init(&in, batch, MSG_SIZE));
+
+    t0 = test_now();
+    for (i = 0; i < NUM_MSGS; i += batch)
+    {
+        for (j = 0; j < batch; j++)
+            TEST_OK(ing_sock_batch_add(&out, buf, sizeof(buf), (const struct sockaddr *)to, sizeof(*to)));
+        TEST_CHECK(ing_sock_send_batch(sa, &out, 0) == batch);
+        for (j = 0; j < batch; j += n)
+            TEST_CHECK((n = ing_sock_recv_batch(sb, &in, 0)) > 0);
+    }
+    report("ing_sock", batch, test_now() - t0);
+
+    ing_sock_batch_destroy(&out);
+    ing_sock_batch_destroy(&in);
+}
+
+int main(void)
+{
+    struct sockaddr_in a, b;
+    int sa, sb;
+    size_t i;
+
+    sa = udp_socket(&a);
+    sb = udp_socket(&b);
+    printf(" %d datagrams of %d bytes over UDP loopback\n", NUM_MSGS, MSG_SIZE);
+    for (i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++)
+    {
+        bench_syscalls(sa, sb, &b, batch_sizes[i]);
+        bench_batches(sa, sb, &b, batch_sizes[i]);
+    }
+    close(sa);
+    close(sb);
+    return 0;
+}
@@ -0,0 +1,252 @@
+/* bench_strkern.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Throughput of the string kernels: scalar, SSE2 and AVX2 versions on
+ * strings of different lengths, and trim()/rstrstr()/str_toupper()
+ * compared to their byte-at-a-time predecessors
+ */
+
+#include <string.h>
+#include <ctype.h>
+
+/* the per-ISA kernels are static, so the source is included */
+#include "ing_strkern.c"
+#include "ing_gen_utils.h"
+#include "ing_test.h"
+
+#define TOTAL_BYTES (64 << 20)     /* processed per measurement */
+
+static const size_t lengths[] = { 16, 64, 256, 4096 };
+
+static char buf[4096 + 1];
+static volatile size_t sink;
+
+static void upper_scalar_bench(char *s, size_t len)
+{
+    case_scalar(s, len, 'a');
+}
+
+static void report(const char *name, size_t len, double t)
+{
+    printf("  %-18s len %4zu  %8.1f MB/s\n", name, len, TOTAL_BYTES / t / 1e6);
+}
+
+static void bench_span(const char *name, span_fn fn, size_t len)
+{
+    size_t i, n = TOTAL_BYTES / len;
+    double t0;
+
+    memset(buf, ' ', len);  /* whole string is scanned */
+    t0 = test_now();
+    for (i = 0; i < n; i++)
+        sink += fn(buf, len);
+    report(name, len, test_now() - t0);
+}
+
+static void bench_case(const char *name, case_fn fn, size_t len)
+{
+    size_t i, n = TOTAL_BYTES / len;
+    double t0;
+
+    for (i = 0; i < len; i++)
+        buf[i] = "aB1 "[i & 3];
+    t0 = test_now();
+    for (i = 0; i < n; i++)
+        fn(buf, len);
+    sink += (unsigned char)buf[0];
+    report(name, len, test_now() - t0);
+}
+
+/* predecessors of the string helpers */
+
+static char *trim_old(char *str)
+{
+    char *p;
+
+    for (p = str; *p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'; p++)
+        ;
+    memmove(str, p, strlen(p) + 1);
+    for (p = p + strlen(p) - 1;
+         p >= str && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' || *p == '\0');
+         p--)
+        *p = '\0';
+    return str;
+}
+
+static char *rstrstr_old(const char *s1, const char *s2)
+{
+    size_t s1len = strlen(s1);
+    size_t s2len = strlen(s2);
+    const char *s;
+
+    if (s2len > s1len)
+        return NULL;
+    for (s = s1 + s1len - s2len; s >= s1; s--)
+    {
+        if (strncmp(s, s2, s2len) == 0)
+            return (char *)s;
+    }
+    return NULL;
+}
+
+static char *toupper_old(char *str)
+{
+    char *p;
+
+    for (p = str; *p; p++)
+        *p = (char)toupper((unsigned char)*p);
+    return str;
+}
+
+typedef char *(*str_fn)(char *str);
+
+/* trimmed string: a quarter of leading and of trailing spaces */
+static void bench_trim(const char *name, str_fn fn, size_t len)
+{
+    size_t i, n = TOTAL_BYTES / len;
+    double t0;
+
+    t0 = test_now();
+    for (i = 0; i < n; i++)
+    {
+        memset(buf, ' ', len);
+        memset(buf + len / 4, 'x', len / 2);
+        buf[len] = '\0';
+        sink += (size_t)fn(buf)[0];
+    }
+    report(name, len, test_now() - t0);
+}
+
+static void bench_str(const char *name, str_fn fn, size_t len)
+{
+    size_t i, n = TOTAL_BYTES / len;
+    double t0;
+
+    for (i = 0; i < len; i++)
+        buf[i] = "aB1 "[i & 3];
+    buf[len] = '\0';
+    t0 = test_now();
+    for (i = 0; i < n; i++)
+        sink += (size_t)fn(buf)[0];
+    report(name, len, test_now() - t0);
+}
+
+/*
+ * Pattern found only at the start, so the whole string is searched. In
+ * random text its first character is rare, in dense text it is everywhere
+ */
+static void bench_rstrstr(const char *name, char *(*fn)(const char *, const char *), size_t len,
+    int dense)
+{
+    unsigned long long seed = 46;
+    size_t i, n = TOTAL_BYTES / len;
+    double t0;
+
+    for (i = 0; i < len; i++)
+        buf[i] = dense ? 'a' : (char)('b' + test_rand(&seed) % 25);
+    memcpy(buf, "abc", 3);
+    buf[len] = '\0';
+    t0 = test_now();
+    for (i = 0; i < n; i++)
+        sink += (size_t)(fn(buf, "abc") - buf);
+    report(name, len, test_now() - t0);
+}
+
+int main(void)
+{
+    size_t i;
+
+    printf(" %d MB per measurement\n", TOTAL_BYTES >> 20);
+    for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        bench_span("span scalar", span_space_scalar, lengths[i]);
+        bench_span("rspan scalar", rspan_space_scalar, lengths[i]);
+        bench_case("upper scalar", upper_scalar_bench, lengths[i]);
+#if STRKERN_X86
+        bench_span("span sse2", span_space_sse2, lengths[i]);
+        bench_span("rspan sse2", rspan_space_sse2, lengths[i]);
+        bench_case("upper sse2", upper_sse2, lengths[i]);
+        if (has_avx2())
+        {
+            bench_span("span avx2", span_space_avx2, lengths[i]);
+            bench_span("rspan avx2", rspan_space_avx2, lengths[i]);
+            bench_case("upper avx2", upper_avx2, lengths[i]);
+        }
+#endif
+        bench_trim("trim old", trim_old, lengths[i]);
+        bench_trim("trim", trim, lengths[i]);
+        bench_str("str_toupper old", toupper_old, lengths[i]);
+        bench_str("str_toupper", str_toupper, lengths[i]);
+        bench_rstrstr("rstrstr old", rstrstr_old, lengths[i], 0);
+        bench_rstrstr("rstrstr", rstrstr, lengths[i], 0);
+        bench_rstrstr("rstrstr dense old", rstrstr_old, lengths[i], 1);
+        bench_rstrstr("rstrstr dense", rstrstr, lengths[i], 1);
+    }
+    return 0;
+}
@@ -0,0 +1,305 @@
+/* test_alloc.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the object pool with its sharded magazines and of the arena
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "ing_alloc.h"
+#include "ing_test.h"
+
+#define POOL_CAPACITY   1000
+#define NUM_THREADS     8
+#define MAX_THREADS     (2 * ING_POOL_MAGAZINES + 1)
+#define THREAD_OPS      200000
+#define THREAD_HELD     64
+
+typedef struct obj_s
+{
+    long owner;
+    long seq;
+    char pad[40];
+} obj_t;
+
+/* allocates the whole pool, checks objects are distinct and owned */
+static void alloc_all(ing_pool_t *pool, obj_t **objs)
+{
+    int i;
+
+    for (i = 0; i < POOL_CAPACITY; i++)
+    {
+        objs[i] = (obj_t *)ing_pool_alloc(pool);
+        TEST_CHECK(objs[i] != NULL);
+        TEST_CHECK(ing_pool_owns(pool, objs[i]));
+        TEST_CHECK(((uintptr_t)objs[i] % sizeof(void *)) == 0);
+        objs[i]->owner = i;
+    }
+    for (i = 0; i < POOL_CAPACITY; i++)
+        TEST_CHECK(objs[i]->owner == i);
+    TEST_CHECK(ing_pool_alloc(pool) == NULL);
+}
+
+static void test_pool(void)
+{
+    static obj_t *objs[POOL_CAPACITY];
+    ing_pool_t pool;
+    obj_t *obj;
+    char c;
+    int i;
+
+    TEST_CHECK(ing_pool_init(&pool, 0, 10) == ING_STAT_INVALID_ARGUMENT);
+    TEST_CHECK(ing_pool_init(&pool, sizeof(obj_t), 0) == ING_STAT_INVALID_ARGUMENT);
+    TEST_OK(ing_pool_init(&pool, sizeof(obj_t), POOL_CAPACITY));
+
+    alloc_all(&pool, objs);
+    TEST_CHECK(!ing_pool_owns(&pool, &c));
+    TEST_CHECK(!ing_pool_owns(&pool, (char *)objs[0] + 1));
+
+    /* everything freed is available again, objects freed last are reused first */
+    for (i = 0; i < POOL_CAPACITY; i++)
+        ing_pool_free(&pool, objs[i]);
+    obj = (obj_t *)ing_pool_alloc(&pool);
+    TEST_CHECK(obj == objs[POOL_CAPACITY - 1]);
+    ing_pool_free(&pool, obj);
+    alloc_all(&pool, objs);
+
+    ing_pool_free(&pool, objs[7]);
+    obj = (obj_t *)ing_pool_calloc(&pool);
+    TEST_CHECK(obj == objs[7] && obj->owner == 0 && obj->seq == 0);
+
+    TEST_OK(ing_pool_destroy(&pool));
+    TEST_CHECK(ing_pool_alloc(&pool) == NULL);
+}
+
+typedef struct worker_s
+{
+    ing_pool_t *pool;
+    pthread_barrier_t *start;
+    long id;
+    int peer_free;          /* frees objects allocated by the previous worker */
+    obj_t **handoff;        /* objects passed to the next worker */
+    long allocs;
+} worker_t;
+
+/* random alloc/free, every object is stamped and the stamp is checked on free */
+static void *pool_worker(void *arg)
+{
+    worker_t *w = (worker_t *)arg;
+    obj_t *held[THREAD_HELD] = { NULL };
+    unsigned long long seed = (unsigned long long)w->id * 7 + 1;
+    int i, n;
+
+    pthread_barrier_wait(w->start);
+    for (i = 0; i < THREAD_OPS; i++)
+    {
+        n = (int)(test_rand(&seed) % THREAD_HELD);
+        if (held[n])
+        {
+            TEST_CHECK(held[n]->owner == w->id && held[n]->seq == n);
+            held[n]->owner = -1;
+            ing_pool_free(w->pool, held[n]);
+            held[n] = NULL;
+        }
+        else if ((held[n] = (obj_t *)ing_pool_alloc(w->pool)) != NULL)
+        {
+            TEST_CHECK(ing_pool_owns(w->pool, held[n]));
+            held[n]->owner = w->id;
+            held[n]->seq = n;
+            w->allocs++;
+        }
+    }
+
+    for (n = 0; n < THREAD_HELD; n++)
+    {
+        if (!held[n])
+            continue;
+        TEST_CHECK(held[n]->owner == w->id && held[n]->seq == n);
+        if (w->handoff)
+            w->handoff[n] = held[n];
+        else
+            ing_pool_free(w->pool, held[n]);
+    }
+    return NULL;
+}
+
+/* threads allocate and free concurrently; more objects than fit into
+ * magazines circulate, so magazines are refilled and flushed all the time
+ */
+static void pool_threads(int nthreads)
+{
+    static obj_t *objs[POOL_CAPACITY];
+    static obj_t *handoff[MAX_THREADS][THREAD_HELD];
+    pthread_t threads[MAX_THREADS];
+    worker_t workers[MAX_THREADS];
+    pthread_barrier_t start;
+    ing_pool_t pool;
+    long total = 0;
+    int i, n;
+
+    TEST_OK(ing_pool_init(&pool, sizeof(obj_t), POOL_CAPACITY));
+    TEST_CHECK(pthread_barrier_init(&start, NULL, nthreads) == 0);
+    memset(handoff, 0, sizeof(handoff));
+    for (i = 0; i < nthreads; i++)
+    {
+        memset(&workers[i], 0, sizeof(workers[i]));
+        workers[i].pool = &pool;
+        workers[i].start = &start;
+        workers[i].id = i;
+        workers[i].handoff = (i % 2) ? handoff[i] : NULL;
+        TEST_CHECK(pthread_create(&threads[i], NULL, pool_worker, &workers[i]) == 0);
+    }
+    for (i = 0; i < nthreads; i++)
+    {
+        TEST_CHECK(pthread_join(threads[i], NULL) == 0);
+        total += workers[i].allocs;
+    }
+    TEST_CHECK(total > 0);
+
+    /* objects kept by exited threads are freed from this thread's magazine */
+    for (i = 0; i < nthreads; i++)
+    {
+        for (n = 0; n < THREAD_HELD; n++)
+        {
+            if (handoff[i][n])
+                ing_pool_free(&pool, handoff[i][n]);
+        }
+    }
+
+    /* nothing was lost or handed out twice: the whole pool is allocatable */
+    alloc_all(&pool, objs);
+
+    pthread_barrier_destroy(&start);
+    TEST_OK(ing_pool_destroy(&pool));
+}
+
+static void test_pool_threads(void)
+{
+    pool_threads(NUM_THREADS);
+}
+
+/* more threads than magazines: some threads share a magazine */
+static void test_pool_shared_magazines(void)
+{
+    pool_threads(MAX_THREADS);
+}
+
+static void test_arena(void)
+{
+    ing_arena_t arena;
+    char *p, *q, *big, *first;
+    size_t i;
+
+    TEST_OK(ing_arena_init(&arena, 256));
+    TEST_CHECK(arena.first == NULL);
+
+    first = p = (char *)ing_arena_alloc(&arena, 1);
+    TEST_CHECK(p && ((uintptr_t)p % ING_ARENA_ALIGN) == 0);
+    for (i = 1; i < 100; i++)
+    {
+        q = (char *)ing_arena_alloc(&arena, i);
+        TEST_CHECK(q && ((uintptr_t)q % ING_ARENA_ALIGN) == 0 && q != p);
+        memset(q, (int)i, i);
+        p = q;
+    }
+
+    /* larger than a chunk gets its own chunk */
+    big = (char *)ing_arena_calloc(&arena, 10000);
+    TEST_CHECK(big);
+    for (i = 0; i < 10000; i++)
+        TEST_CHECK(big[i] == 0);
+
+    p = ing_arena_strdup(&arena, "hello");
+    TEST_CHECK(p && strcmp(p, "hello") == 0);
+    p = ing_arena_strndup(&arena, "hello world", 5);
+    TEST_CHECK(p && strcmp(p, "hello") == 0);
+    TEST_CHECK(ing_arena_strdup(&arena, NULL) == NULL);
+    TEST_CHECK(arena.allocated > 10000);
+
+    /* reset keeps the chunks: the same memory is handed out again */
+    ing_arena_reset(&arena);
+    TEST_CHECK(arena.allocated == 0);
+    TEST_CHECK(ing_arena_alloc(&arena, 1) == first);
+    TEST_CHECK(ing_arena_alloc(&arena, 10000) == big);
+
+    ing_arena_destroy(&arena);
+    TEST_CHECK(arena.first == NULL);
+    TEST_CHECK(ing_arena_init(NULL, 0) == ING_STAT_INVALID_ARGUMENT);
+}
+
+int main(void)
+{
+    TEST_RUN(test_pool);
+    TEST_RUN(test_pool_threads);
+    TEST_RUN(test_pool_shared_magazines);
+    TEST_RUN(test_arena);
+    return 0;
+}
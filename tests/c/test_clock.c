@@ -0,0 +1,198 @@
+/* test_clock.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the fast clocks against clock_gettime() and of the cached time
+ * strings against strftime()
+ */
+
+#include <string.h>
+#include <sys/sysinfo.h>
+
+#include "ing_clock.h"
+#include "ing_gen_utils.h"
+#include "ing_test.h"
+
+#define READS   1000000
+
+static uint64_t precise_ms(clockid_t id)
+{
+    struct timespec ts;
+
+    TEST_CHECK(clock_gettime(id, &ts) == 0);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* resolution of the coarse clock in ms, rounded up */
+static uint64_t coarse_res_ms(clockid_t id)
+{
+    struct timespec ts;
+
+    TEST_CHECK(clock_getres(id, &ts) == 0);
+    return (uint64_t)ts.tv_sec * 1000 + (ts.tv_nsec + 999999) / 1000000;
+}
+
+/*
+ * Coarse reading lies between precise readings, less the resolution; a
+ * tickless kernel updates it on the first tick after a wakeup, so it may
+ * lag by up to two ticks
+ */
+static void check_coarse(uint64_t (*coarse)(void), clockid_t precise, clockid_t coarse_id)
+{
+    uint64_t res = coarse_res_ms(coarse_id), before, now, after, prev = 0;
+    int i;
+
+    TEST_CHECK(res >= 1 && res <= 100);
+    for (i = 0; i < READS; i++)
+    {
+        before = precise_ms(precise);
+        now = coarse();
+        after = precise_ms(precise);
+        TEST_CHECK(now >= prev || precise == CLOCK_REALTIME);
+        TEST_CHECK(now <= after && now + 2 * res + 1 >= before);
+        prev = now;
+    }
+}
+
+static void test_clock_mono(void)
+{
+    check_coarse(ing_clock_mono_ms, CLOCK_MONOTONIC, CLOCK_MONOTONIC_COARSE);
+}
+
+static void test_clock_real(void)
+{
+    struct timespec ts;
+    uint64_t before, now, after;
+    int i;
+
+    check_coarse(ing_clock_real_ms, CLOCK_REALTIME, CLOCK_REALTIME_COARSE);
+    for (i = 0; i < READS; i++)
+    {
+        TEST_CHECK(clock_gettime(CLOCK_REALTIME, &ts) == 0);
+        before = (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+        now = ing_clock_real_ns();
+        TEST_CHECK(clock_gettime(CLOCK_REALTIME, &ts) == 0);
+        after = (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+        TEST_CHECK(now >= before && now <= after);
+    }
+}
+
+/* uptime is CLOCK_BOOTTIME rounded up to a second, like sysinfo() */
+static void test_clock_uptime(void)
+{
+    struct timespec b1, b2;
+    struct sysinfo si;
+    long up, prev = 0;
+    int i;
+
+    for (i = 0; i < 10000; i++)
+    {
+        TEST_CHECK(clock_gettime(CLOCK_BOOTTIME, &b1) == 0);
+        up = ing_clock_uptime();
+        TEST_CHECK(clock_gettime(CLOCK_BOOTTIME, &b2) == 0);
+        TEST_CHECK(up >= b1.tv_sec + (b1.tv_nsec ? 1 : 0));
+        TEST_CHECK(up <= b2.tv_sec + (b2.tv_nsec ? 1 : 0));
+        TEST_CHECK(up >= prev);
+        prev = up;
+    }
+
+    TEST_CHECK(sysinfo(&si) == 0);
+    up = get_uptime();
+    TEST_CHECK(up >= si.uptime && up <= si.uptime + 1);
+}
+
+static void test_clock_timestr(void)
+{
+    char buf[ING_CLOCK_TIMESTR_SIZE], expect[64];
+    time_t t, base = time(NULL);
+    struct tm tm;
+    int i;
+
+    /* the cached string must follow changes of the second in both directions */
+    for (i = 0; i < 1000; i++)
+    {
+        t = base + (i % 3 ? i * 37 : -i * 3601);
+        localtime_r(&t, &tm);
+        strftime(expect, sizeof(expect), "%d.%m %H:%M:%S", &tm);
+        TEST_CHECK(ing_clock_timestr(buf, t) == 14 && strcmp(buf, expect) == 0);
+        TEST_CHECK(ing_clock_timestr(buf, t) == 14 && strcmp(buf, expect) == 0);
+
+        snprintf(expect + 14, sizeof(expect) - 14, ".%03d", i);
+        TEST_CHECK(ing_clock_timestr_ms(buf, (uint64_t)t * 1000 + i) == 18);
+        TEST_CHECK(strcmp(buf, expect) == 0);
+    }
+}
+
+int main(void)
+{
+    TEST_RUN(test_clock_mono);
+    TEST_RUN(test_clock_real);
+    TEST_RUN(test_clock_uptime);
+    TEST_RUN(test_clock_timestr);
+    return 0;
+}
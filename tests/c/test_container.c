@@ -0,0 +1,249 @@
+/* test_container.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the IC container macros with and without the bloom filter
+ */
+
+#include <string.h>
+
+#include "ing_container.h"
+#include "ing_test.h"
+
+#define NUM_RECORDS 4096
+
+typedef struct rec_s
+{
+    int key;
+    int value;
+    UT_hash_handle hh;
+} rec_t;
+
+GENERATE_DB_TYPE(rec_t)
+GENERATE_DB_DECLARATIONS(rec_t, key)
+GENERATE_DB_FUNCTIONS(rec_t, key)
+
+static int key_of(int i)
+{
+    return i * 7919 + 13;
+}
+
+/* adds all records, deletes every third one and checks lookups of both */
+static void check_add_del_get(IC_DB_TYPE(rec_t) *db)
+{
+    rec_t rec;
+    rec_t *found;
+    int i, key;
+
+    memset(&rec, 0, sizeof(rec));
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        rec.key = key_of(i);
+        rec.value = i;
+        TEST_OK(IC_ADD(rec_t, db, &rec));
+    }
+    TEST_CHECK(IC_SIZE(rec_t, db) == NUM_RECORDS);
+
+    rec.key = key_of(0);
+    TEST_CHECK(IC_ADD(rec_t, db, &rec) == ING_STAT_ALREADY_EXISTS);
+    rec.key = -1;
+    TEST_CHECK(IC_ADD(rec_t, db, &rec) == ING_STAT_FULL);
+
+    for (i = 0; i < NUM_RECORDS; i += 3)
+    {
+        key = key_of(i);
+        TEST_OK(IC_DEL(rec_t, db, &key));
+        TEST_CHECK(IC_DEL(rec_t, db, &key) == ING_STAT_NOT_FOUND);
+    }
+
+    /* no false negatives after deletes: all remaining keys are found */
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        key = key_of(i);
+        if (i % 3 == 0)
+        {
+            TEST_CHECK(IC_GET(rec_t, db, &key, &found) == ING_STAT_NOT_FOUND);
+            TEST_CHECK(found == NULL);
+        }
+        else
+        {
+            TEST_OK(IC_GET(rec_t, db, &key, &found));
+            TEST_CHECK(found && found->key == key && found->value == i);
+        }
+    }
+
+    /* deleted slots are reused */
+    for (i = 0; i < NUM_RECORDS; i += 3)
+    {
+        rec.key = key_of(i);
+        rec.value = -i;
+        TEST_OK(IC_ADD(rec_t, db, &rec));
+    }
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        key = key_of(i);
+        TEST_OK(IC_GET(rec_t, db, &key, &found));
+        TEST_CHECK(found->value == (i % 3 == 0 ? -i : i));
+    }
+}
+
+static void test_container_plain(void)
+{
+    IC_DB_TYPE(rec_t) db;
+    ing_container_stats_t stats;
+
+    TEST_OK(IC_INIT(rec_t, &db, NUM_RECORDS));
+    check_add_del_get(&db);
+
+    TEST_OK(IC_STATS(rec_t, &db, &stats));
+    TEST_CHECK(stats.max_rec_num == NUM_RECORDS);
+    TEST_CHECK(stats.rec_num == NUM_RECORDS);
+    TEST_CHECK(stats.num_buckets >= NUM_RECORDS / 10);
+    TEST_CHECK(stats.bloom_size == 0);
+    TEST_CHECK(stats.bloom_lookups == 0);
+
+    TEST_OK(IC_DESTROY(rec_t, &db));
+}
+
+static void test_container_bloom(void)
+{
+    IC_DB_TYPE(rec_t) db;
+    ing_container_stats_t stats;
+    rec_t *found;
+    int i, key, misses = 0;
+
+    TEST_OK(IC_INIT_BLOOM(rec_t, &db, NUM_RECORDS, 0.01));
+    check_add_del_get(&db);
+
+    /* lookups of absent keys are mostly answered by the filter */
+    TEST_OK(IC_STATS(rec_t, &db, &stats));
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        key = -key_of(i) - 1;
+        if (IC_GET(rec_t, &db, &key, &found) == ING_STAT_NOT_FOUND)
+            misses++;
+    }
+    TEST_CHECK(misses == NUM_RECORDS);
+
+    {
+        ing_container_stats_t after;
+
+        TEST_OK(IC_STATS(rec_t, &db, &after));
+        TEST_CHECK(after.rec_num == NUM_RECORDS);
+        TEST_CHECK(after.bloom_size > 0);
+        TEST_CHECK(after.bloom_lookups == stats.bloom_lookups + NUM_RECORDS);
+        TEST_CHECK(after.bloom_negatives + after.bloom_false_positives ==
+            stats.bloom_negatives + stats.bloom_false_positives + NUM_RECORDS);
+        TEST_CHECK(after.bloom_false_positives - stats.bloom_false_positives < NUM_RECORDS / 20);
+        TEST_CHECK(after.bloom_fp_rate >= 0.0 && after.bloom_fp_rate < 0.05);
+    }
+
+    /* the filter follows deletes of all keys */
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        key = key_of(i);
+        TEST_OK(IC_DEL(rec_t, &db, &key));
+    }
+    TEST_CHECK(IC_SIZE(rec_t, &db) == 0);
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        key = key_of(i);
+        TEST_CHECK(IC_GET(rec_t, &db, &key, &found) == ING_STAT_NOT_FOUND);
+    }
+
+    TEST_OK(IC_DESTROY(rec_t, &db));
+
+    TEST_CHECK(IC_INIT_BLOOM(rec_t, &db, NUM_RECORDS, 1.5) == ING_STAT_INVALID_ARGUMENT);
+}
+
+/* counters saturate, but a key is never reported absent while present */
+static void test_bloom_saturation(void)
+{
+    ing_bloom_t bf;
+    unsigned i;
+
+    TEST_CHECK(ing_bloom_init(&bf, 16, 0.1) == 0);
+    for (i = 0; i < 4096; i++)
+        ing_bloom_add(&bf, i);
+    for (i = 0; i < 4096; i += 2)
+        ing_bloom_del(&bf, i);
+    for (i = 1; i < 4096; i += 2)
+        TEST_CHECK(ing_bloom_test(&bf, i));
+
+    ing_bloom_clear(&bf);
+    TEST_CHECK(!ing_bloom_test(&bf, 1));
+    ing_bloom_destroy(&bf);
+}
+
+int main(void)
+{
+    TEST_RUN(test_container_plain);
+    TEST_RUN(test_container_bloom);
+    TEST_RUN(test_bloom_saturation);
+    return 0;
+}
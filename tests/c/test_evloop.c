@@ -0,0 +1,264 @@
+/* test_evloop.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the event loop: fd callbacks, timers, posts and the CPU
+ * placement of sharded UDP receivers
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "ing_evloop.h"
+#include "ing_test.h"
+
+#define GROUP_MAX   8
+
+static int reads, timer_fires, posts;
+
+static void on_read(ing_evloop_t *loop, int fd, unsigned events, void *arg)
+{
+    char c;
+
+    (void)loop;
+    (void)arg;
+    TEST_CHECK(events & ING_EV_READ);
+    TEST_CHECK(read(fd, &c, 1) == 1);
+    reads++;
+}
+
+static void on_timer(ing_evloop_t *loop, int timer, void *arg)
+{
+    (void)timer;
+    (void)arg;
+    if (++timer_fires == 3)
+        ing_evloop_stop(loop);
+}
+
+static void on_post(ing_evloop_t *loop, void *arg)
+{
+    (void)loop;
+    posts += *(int *)arg;
+}
+
+static void test_evloop_basic(void)
+{
+    ing_evloop_t *loop;
+    int p[2], timer, one = 1;
+
+    TEST_CHECK(pipe(p) == 0);
+    TEST_OK(ing_evloop_create(&loop));
+    TEST_OK(ing_evloop_add(loop, p[0], ING_EV_READ, on_read, NULL));
+    TEST_CHECK((timer = ing_evloop_timer_add(loop, 1, 1, on_timer, NULL)) >= 0);
+    TEST_OK(ing_evloop_post(loop, on_post, &one));
+    TEST_CHECK(write(p[1], "ab", 2) == 2);
+
+    TEST_OK(ing_evloop_run(loop));
+    TEST_CHECK(timer_fires == 3 && reads == 2 && posts == 1);
+
+    TEST_OK(ing_evloop_timer_del(loop, timer));
+    TEST_OK(ing_evloop_del(loop, p[0]));
+    TEST_CHECK(write(p[1], "c", 1) == 1);
+    TEST_CHECK(ing_evloop_run_once(loop, 0) >= 0 && reads == 2);
+
+    ing_evloop_destroy(loop);
+    close(p[0]);
+    close(p[1]);
+}
+
+typedef struct placement_s
+{
+    cpu_set_t cpus;
+    int done;
+    int received;
+} placement_t;
+
+static placement_t placement[GROUP_MAX];
+
+static void get_affinity(ing_evloop_t *loop, void *arg)
+{
+    placement_t *pl = (placement_t *)arg;
+
+    (void)loop;
+    TEST_CHECK(pthread_getaffinity_np(pthread_self(), sizeof(pl->cpus), &pl->cpus) == 0);
+    __atomic_store_n(&pl->done, 1, __ATOMIC_RELEASE);
+}
+
+static void on_datagram(ing_evloop_t *loop, int fd, unsigned events, void *arg)
+{
+    char buf[64];
+
+    (void)loop;
+    (void)events;
+    (void)arg;
+    while (recv(fd, buf, sizeof(buf), 0) > 0)
+        __atomic_fetch_add(&placement[0].received, 1, __ATOMIC_RELAXED);
+}
+
+static in_port_t free_port(void)
+{
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_CHECK(fd >= 0 && bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    TEST_CHECK(getsockname(fd, (struct sockaddr *)&addr, &len) == 0);
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+/* thread i runs on the cpus whose datagrams the steering program sends to
+ * socket i (cpu % n == i), or anywhere allowed if there are none
+ */
+static void check_group(int n)
+{
+    ing_evloop_t *loops[GROUP_MAX];
+    int socks[GROUP_MAX];
+    udp_group_opts_t opts = { 0, 0, 0, 1 };
+    struct sockaddr_in to;
+    cpu_set_t allowed, expect;
+    in_port_t port = free_port();
+    int i, cpu, fd, spin;
+
+    TEST_CHECK(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    memset(placement, 0, sizeof(placement));
+    TEST_OK(ing_evloop_udp_group_start(loops, socks, n, INADDR_LOOPBACK, port, &opts, on_datagram, NULL));
+
+    for (i = 0; i < n; i++)
+    {
+        TEST_OK(ing_evloop_post(loops[i], get_affinity, &placement[i]));
+        for (spin = 0; !__atomic_load_n(&placement[i].done, __ATOMIC_ACQUIRE); spin++)
+        {
+            TEST_CHECK(spin < 10000);
+            usleep(100);
+        }
+
+        CPU_ZERO(&expect);
+        for (cpu = i; cpu < CPU_SETSIZE; cpu += n)
+        {
+            if (CPU_ISSET(cpu, &allowed))
+                CPU_SET(cpu, &expect);
+        }
+        if (CPU_COUNT(&expect))
+            TEST_CHECK(CPU_EQUAL(&expect, &placement[i].cpus));
+        else
+        {
+            TEST_CHECK(CPU_COUNT(&placement[i].cpus) == 1);
+            CPU_AND(&expect, &placement[i].cpus, &allowed);
+            TEST_CHECK(CPU_COUNT(&expect) == 1);
+        }
+    }
+
+    /* datagrams reach the group */
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    to.sin_port = htons(port);
+    for (i = 0; i < 10; i++)
+        TEST_CHECK(sendto(fd, "x", 1, 0, (struct sockaddr *)&to, sizeof(to)) == 1);
+    for (spin = 0; __atomic_load_n(&placement[0].received, __ATOMIC_RELAXED) < 10; spin++)
+    {
+        TEST_CHECK(spin < 10000);
+        usleep(100);
+    }
+    close(fd);
+
+    ing_evloop_udp_group_stop(loops, socks, n);
+    for (i = 0; i < n; i++)
+        TEST_CHECK(loops[i] == NULL && socks[i] == -1);
+}
+
+static void test_evloop_udp_group(void)
+{
+    cpu_set_t allowed;
+    int ncpu;
+
+    TEST_CHECK(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    ncpu = CPU_COUNT(&allowed);
+
+    check_group(1);
+    check_group(ncpu < GROUP_MAX ? ncpu : GROUP_MAX);
+    check_group(2);
+    check_group(GROUP_MAX);
+}
+
+int main(void)
+{
+    TEST_RUN(test_evloop_basic);
+    TEST_RUN(test_evloop_udp_group);
+    return 0;
+}
@@ -0,0 +1,195 @@
+/* test_hash_tags.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the uthash bucket fingerprint tags; built with -DHASH_BKT_TAGS
+ */
+
+#include <string.h>
+
+#include "uthash_ing.h"
+#include "ing_test.h"
+
+#ifndef HASH_BKT_TAGS
+#error "test_hash_tags must be built with -DHASH_BKT_TAGS"
+#endif
+
+#define NUM_ITEMS 20000
+
+typedef struct item_s
+{
+    int key;
+    UT_hash_handle hh;
+} item_t;
+
+/* every chain item has exactly one tag entry with its fingerprint */
+static void check_tags(item_t *head)
+{
+    UT_hash_table *tbl;
+    unsigned b, i, total = 0;
+
+    if (!head)
+        return;
+
+    tbl = head->hh.tbl;
+    for (b = 0; b < tbl->num_buckets; b++)
+    {
+        UT_hash_bucket *bkt = &tbl->buckets[b];
+        UT_hash_handle *hh;
+        unsigned chain = 0;
+
+        TEST_CHECK(bkt->count <= bkt->tag_cap || bkt->count == 0);
+        for (hh = bkt->hh_head; hh; hh = hh->hh_next)
+        {
+            for (i = 0; i < bkt->count && bkt->tag_hh[i] != hh; i++)
+                ;
+            TEST_CHECK(i < bkt->count);
+            TEST_CHECK(bkt->tags[i] == HASH_TAG(hh->hashv));
+            chain++;
+        }
+        TEST_CHECK(chain == bkt->count);
+        total += chain;
+    }
+    TEST_CHECK(total == tbl->num_items);
+}
+
+static void test_hash_tags(void)
+{
+    static item_t items[NUM_ITEMS];
+    item_t *head = NULL, *found, *item;
+    unsigned buckets;
+    int i, key;
+
+    for (i = 0; i < NUM_ITEMS; i++)
+    {
+        items[i].key = i * 31 + 7;
+        item = &items[i];
+        HASH_ADD_INT(head, key, item);
+    }
+    buckets = head->hh.tbl->num_buckets;
+    TEST_CHECK(buckets > HASH_INITIAL_NUM_BUCKETS);  /* went through expansions */
+    check_tags(head);
+
+    for (i = 0; i < NUM_ITEMS; i++)
+    {
+        key = i * 31 + 7;
+        HASH_FIND_INT(head, &key, found);
+        TEST_CHECK(found == &items[i]);
+        key = i * 31 + 8;
+        HASH_FIND_INT(head, &key, found);
+        TEST_CHECK(found == NULL);
+    }
+
+    /* delete odd items, the tags follow the chains */
+    for (i = 1; i < NUM_ITEMS; i += 2)
+    {
+        item = &items[i];
+        HASH_DEL(head, item);
+    }
+    check_tags(head);
+    TEST_CHECK(HASH_COUNT(head) == NUM_ITEMS / 2);
+
+    for (i = 0; i < NUM_ITEMS; i++)
+    {
+        key = i * 31 + 7;
+        HASH_FIND_INT(head, &key, found);
+        TEST_CHECK(found == (i % 2 ? NULL : &items[i]));
+    }
+
+    /* re-add them, more expansions are not needed */
+    for (i = 1; i < NUM_ITEMS; i += 2)
+    {
+        item = &items[i];
+        HASH_ADD_INT(head, key, item);
+    }
+    TEST_CHECK(head->hh.tbl->num_buckets == buckets);
+    check_tags(head);
+
+    HASH_CLEAR(hh, head);
+    TEST_CHECK(head == NULL);
+
+    /* the table is usable again after clear */
+    for (i = 0; i < 100; i++)
+    {
+        item = &items[i];
+        HASH_ADD_INT(head, key, item);
+    }
+    check_tags(head);
+    for (i = 0; i < 100; i++)
+    {
+        item = &items[i];
+        HASH_DEL(head, item);
+    }
+    TEST_CHECK(head == NULL);
+}
+
+int main(void)
+{
+    TEST_RUN(test_hash_tags);
+    return 0;
+}
@@ -0,0 +1,324 @@
+/* test_io.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the I/O engine, on io_uring and on its epoll fallback
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include "ing_io.h"
+#include "ing_test.h"
+
+#define NFILES      3
+#define NWRITES     1000
+#define NDGRAMS     20
+
+typedef struct rec_s
+{
+    int file;
+    int seq;
+} rec_t;
+
+static rec_t recs[NWRITES];
+static int next_done[NFILES];
+static int writes_done;
+
+static void run_until(ing_evloop_t *loop, int *count, int target)
+{
+    int spin;
+
+    for (spin = 0; *count < target; spin++)
+    {
+        TEST_CHECK(spin < 1000);
+        TEST_CHECK(ing_evloop_run_once(loop, 10) >= 0);
+    }
+}
+
+static int tmp_file(void)
+{
+    char name[] = "/tmp/test_io.XXXXXX";
+    int fd = mkstemp(name);
+
+    TEST_CHECK(fd >= 0);
+    unlink(name);
+    return fd;
+}
+
+static void on_write(ing_io_t *io, int fd, ssize_t res, void *arg)
+{
+    rec_t *rec = (rec_t *)arg;
+
+    (void)io;
+    (void)fd;
+    TEST_CHECK(res == sizeof(*rec));
+    TEST_CHECK(rec->seq == next_done[rec->file]++);
+    writes_done++;
+}
+
+/* writes to several fds queued in random order, with and without a submit
+ * in between and more than fit in the ring, land in order per fd
+ */
+static void check_write_order(unsigned flags)
+{
+    ing_evloop_t *loop;
+    ing_io_t *io;
+    unsigned long long seed = 45;
+    int fds[NFILES], seqs[NFILES], i, f;
+    rec_t rec;
+
+    TEST_OK(ing_evloop_create(&loop));
+    TEST_OK(ing_io_create(&io, loop, 0, 0, flags));
+    if (flags & ING_IO_EPOLL)
+        TEST_CHECK(!ing_io_uring_enabled(io));
+    for (f = 0; f < NFILES; f++)
+    {
+        fds[f] = tmp_file();
+        seqs[f] = next_done[f] = 0;
+    }
+    writes_done = 0;
+
+    for (i = 0; i < NWRITES; i++)
+    {
+        f = (int)(test_rand(&seed) % NFILES);
+        recs[i].file = f;
+        recs[i].seq = seqs[f]++;
+        TEST_OK(ing_io_write(io, fds[f], &recs[i], sizeof(recs[i]), -1, on_write, &recs[i]));
+        if (test_rand(&seed) % 50 == 0)
+            TEST_OK(ing_io_submit(io));
+    }
+    TEST_OK(ing_io_submit(io));
+    run_until(loop, &writes_done, NWRITES);
+
+    for (f = 0; f < NFILES; f++)
+    {
+        TEST_CHECK(next_done[f] == seqs[f]);
+        TEST_CHECK(lseek(fds[f], 0, SEEK_SET) == 0);
+        for (i = 0; i < seqs[f]; i++)
+        {
+            TEST_CHECK(read(fds[f], &rec, sizeof(rec)) == sizeof(rec));
+            TEST_CHECK(rec.file == f && rec.seq == i);
+        }
+        TEST_CHECK(read(fds[f], &rec, sizeof(rec)) == 0);
+        close(fds[f]);
+    }
+    ing_io_destroy(io);
+    ing_evloop_destroy(loop);
+}
+
+static ssize_t results[8];
+static int results_done;
+
+static void on_result(ing_io_t *io, int fd, ssize_t res, void *arg)
+{
+    (void)io;
+    (void)fd;
+    results[(ssize_t *)arg - results] = res;
+    results_done++;
+}
+
+/* a failed write cancels the following writes to its fd of the batch only */
+static void check_write_cancel(unsigned flags)
+{
+    ing_evloop_t *loop;
+    ing_io_t *io;
+    int bad, good;
+
+    TEST_OK(ing_evloop_create(&loop));
+    TEST_OK(ing_io_create(&io, loop, 0, 0, flags));
+    TEST_CHECK((bad = open("/dev/null", O_RDONLY)) >= 0);
+    good = tmp_file();
+    results_done = 0;
+
+    /* not linked: another fd between the writes */
+    TEST_OK(ing_io_write(io, bad, "a", 1, -1, on_result, &results[0]));
+    TEST_OK(ing_io_write(io, good, "b", 1, -1, on_result, &results[1]));
+    TEST_OK(ing_io_write(io, bad, "c", 1, -1, on_result, &results[2]));
+    TEST_OK(ing_io_write(io, good, "d", 1, -1, on_result, &results[3]));
+    TEST_OK(ing_io_submit(io));
+    run_until(loop, &results_done, 4);
+    TEST_CHECK(results[0] == -EBADF && results[1] == 1);
+    TEST_CHECK(results[2] == -ECANCELED && results[3] == 1);
+
+    /* linked, and the next batch is not cancelled */
+    TEST_OK(ing_io_write(io, bad, "e", 1, -1, on_result, &results[4]));
+    TEST_OK(ing_io_write(io, bad, "f", 1, -1, on_result, &results[5]));
+    TEST_OK(ing_io_submit(io));
+    TEST_OK(ing_io_write(io, bad, "g", 1, -1, on_result, &results[6]));
+    TEST_OK(ing_io_write(io, good, "h", 1, -1, on_result, &results[7]));
+    TEST_OK(ing_io_submit(io));
+    run_until(loop, &results_done, 8);
+    TEST_CHECK(results[4] == -EBADF && results[5] == -ECANCELED);
+    TEST_CHECK(results[6] == -EBADF && results[7] == 1);
+
+    TEST_CHECK(ing_io_write(io, -1, "x", 1, -1, on_result, NULL) == ING_STAT_INVALID_ARGUMENT);
+    ing_io_destroy(io);
+    ing_evloop_destroy(loop);
+    close(bad);
+    close(good);
+}
+
+static int dgrams;
+
+static void on_recv(ing_io_t *io, int fd, const void *data, size_t len,
+    const struct sockaddr *addr, socklen_t addrlen, void *arg)
+{
+    char expect[16];
+
+    (void)io;
+    (void)fd;
+    (void)addr;
+    (void)addrlen;
+    (void)arg;
+    snprintf(expect, sizeof(expect), "msg%d", dgrams++);
+    TEST_CHECK(len == strlen(expect) && memcmp(data, expect, len) == 0);
+}
+
+static void check_recv(unsigned flags)
+{
+    ing_evloop_t *loop;
+    ing_io_t *io;
+    char buf[16];
+    int sv[2], i, n;
+
+    TEST_OK(ing_evloop_create(&loop));
+    TEST_OK(ing_io_create(&io, loop, 4, 64, flags));
+    TEST_CHECK(socketpair(AF_UNIX, SOCK_DGRAM, 0, sv) == 0);
+    dgrams = 0;
+
+    TEST_OK(ing_io_recv_start(io, sv[0], on_recv, NULL));
+    TEST_CHECK(ing_io_recv_start(io, sv[0], on_recv, NULL) == ING_STAT_ALREADY_EXISTS);
+    /* more datagrams than receive buffers */
+    for (i = 0; i < NDGRAMS; i += 5)
+    {
+        for (n = i; n < i + 5; n++)
+        {
+            snprintf(buf, sizeof(buf), "msg%d", n);
+            TEST_CHECK(send(sv[1], buf, strlen(buf), 0) == (ssize_t)strlen(buf));
+        }
+        run_until(loop, &dgrams, i + 5);
+    }
+    TEST_OK(ing_io_recv_stop(io, sv[0]));
+    TEST_CHECK(ing_io_recv_stop(io, sv[0]) == ING_STAT_NOT_FOUND);
+
+    /* nothing is received after stop */
+    TEST_CHECK(send(sv[1], "late", 4, 0) == 4);
+    TEST_CHECK(ing_evloop_run_once(loop, 10) >= 0);
+    TEST_CHECK(dgrams == NDGRAMS);
+
+    ing_io_destroy(io);
+    ing_evloop_destroy(loop);
+    close(sv[0]);
+    close(sv[1]);
+}
+
+static void test_io_write_order_uring(void)
+{
+    check_write_order(0);
+}
+
+static void test_io_write_order_epoll(void)
+{
+    check_write_order(ING_IO_EPOLL);
+}
+
+static void test_io_write_cancel_uring(void)
+{
+    check_write_cancel(0);
+}
+
+static void test_io_write_cancel_epoll(void)
+{
+    check_write_cancel(ING_IO_EPOLL);
+}
+
+static void test_io_recv_uring(void)
+{
+    check_recv(0);
+}
+
+static void test_io_recv_epoll(void)
+{
+    check_recv(ING_IO_EPOLL);
+}
+
+int main(void)
+{
+    TEST_RUN(test_io_write_order_uring);
+    TEST_RUN(test_io_write_order_epoll);
+    TEST_RUN(test_io_write_cancel_uring);
+    TEST_RUN(test_io_write_cancel_epoll);
+    TEST_RUN(test_io_recv_uring);
+    TEST_RUN(test_io_recv_epoll);
+    return 0;
+}
@@ -0,0 +1,693 @@
+/* test_log.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the logging extensions. Log output goes to stdout, which is
+ * redirected to a temporary file while messages are captured.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#include <limits.h>
+
+#include "ing_log.h"
+#include "ing_test.h"
+
+#define LOGB_RECORDS    5000
+#define ASYNC_THREADS   4
+#define ASYNC_MSGS      2000
+
+ING_LOG_MODULE(mod_a, "test_a")
+ING_LOG_MODULE(mod_b, "test_b")
+
+static int saved_stdout = -1;
+static FILE *capture_file;
+
+/* redirects stdout to a temporary file */
+static void capture_begin(void)
+{
+    fflush(stdout);
+    TEST_CHECK((capture_file = tmpfile()) != NULL);
+    TEST_CHECK((saved_stdout = dup(STDOUT_FILENO)) >= 0);
+    TEST_CHECK(dup2(fileno(capture_file), STDOUT_FILENO) == STDOUT_FILENO);
+}
+
+/* restores stdout; returns the captured output, to be freed */
+static char *capture_end(size_t *len)
+{
+    char *buf;
+    long size;
+
+    fflush(stdout);
+    TEST_CHECK(dup2(saved_stdout, STDOUT_FILENO) == STDOUT_FILENO);
+    close(saved_stdout);
+    TEST_CHECK(fseek(capture_file, 0, SEEK_END) == 0 && (size = ftell(capture_file)) >= 0);
+    rewind(capture_file);
+    TEST_CHECK((buf = (char *)malloc(size + 1)) != NULL);
+    TEST_CHECK(fread(buf, 1, size, capture_file) == (size_t)size);
+    buf[size] = '\0';
+    fclose(capture_file);
+    if (len)
+        *len = size;
+    return buf;
+}
+
+/* returns the message of the log line at *pos and advances *pos to the next
+ * line; the line prefix "dd.MM hh:mm:ss |PRIO | " is checked and skipped
+ */
+static char *next_msg(char **pos, const char *prio)
+{
+    char *line = *pos, *end, *msg;
+
+    TEST_CHECK((end = strchr(line, '\n')) != NULL);
+    *end = '\0';
+    *pos = end + 1;
+    TEST_CHECK((msg = strstr(line, " |")) != NULL && msg - line == 14);
+    msg += 2;
+    TEST_CHECK(strncmp(msg, prio, 5) == 0 && strncmp(msg + 5, "| ", 2) == 0);
+    return msg + 7;
+}
+
+/*
+ * ING_LOGB() calls with every argument class; the expected messages are
+ * formatted by snprintf() from the same arguments. Messages end with '\n',
+ * which next_msg() strips.
+ */
+static int logb_calls(char expect[][256], int i)
+{
+    static const char *strs[] = { "", "a", "string argument", NULL };
+    int ival = -12345 * i;
+    long long llval = -9876543210123LL * (i + 1);
+    double dval = 3.25 * i - 0.001;
+    long double ldval = 1.5L * i;
+    const char *s = strs[i % 4];
+    void *p = (void *)((uintptr_t)0x1234 * (i + 1));
+    int n = 0;
+
+#define LOGB_CHECK(...)                                                     \
+    do {                                                                    \
+        ING_LOGB(LOG_INFO, __VA_ARGS__);                                    \
+        snprintf(expect[n], sizeof(expect[n]), __VA_ARGS__);                \
+        expect[n][strlen(expect[n]) - 1] = '\0';                            \
+        n++;                                                                \
+    } while (0)
+
+    LOGB_CHECK("int %d ll %lld double %f str %s ptr %p\n", ival, llval, dval, s, p);
+    LOGB_CHECK("%5d|%-6lld|%x|%o|%u|%c|%%\n", i, llval, (unsigned)ival, (unsigned)i, (unsigned)i, 'a' + i % 26);
+    LOGB_CHECK("%.3f %e %g %10.4f %Lf\n", dval, dval, dval, -dval, ldval);
+    LOGB_CHECK("%ld %lu %zu %zd %hd %hhu\n", (long)llval, (unsigned long)i, (size_t)i * 1000,
+               (ssize_t)-i, (short)ival, (unsigned char)i);
+    LOGB_CHECK("[%s] [%.4s] [%10s] [%-10s]\n", s, "truncated", s ? s : "x", "left");
+    LOGB_CHECK("no arguments %d\n", 0);
+#undef LOGB_CHECK
+    return n;
+}
+
+static void logb_check_output(char *out, int ncalls, int nrecords)
+{
+    char expect[8][256];
+    char *pos = out, *msg;
+    int i, j, n;
+
+    for (i = 0; i < ncalls; i++)
+    {
+        /* same arguments as when logged */
+        capture_begin();
+        n = logb_calls(expect, i);
+        free(capture_end(NULL));
+        TEST_CHECK(n * ncalls == nrecords);
+        for (j = 0; j < n; j++)
+        {
+            msg = next_msg(&pos, "INFO ");
+            if (strcmp(msg, expect[j]) != 0)
+                fprintf(stderr, "got '%s'\nexpected '%s'\n", msg, expect[j]);
+            TEST_CHECK(strcmp(msg, expect[j]) == 0);
+        }
+    }
+    TEST_CHECK(*pos == '\0');
+}
+
+static void test_logb_decode(void)
+{
+    char path[] = "/tmp/test_logb_XXXXXX";
+    char expect[8][256];
+    FILE *in, *out;
+    char *text;
+    int fd, i, n = 0;
+
+    TEST_CHECK((fd = mkstemp(path)) >= 0);
+    close(fd);
+    TEST_OK(ing_logb_start(path));
+    TEST_CHECK(ing_logb_start(path) == ING_STAT_ALREADY_EXISTS);
+    capture_begin();
+    for (i = 0; i < LOGB_RECORDS; i++)
+    {
+        n += logb_calls(expect, i);
+        /* the thread buffer wraps many times but never overflows */
+        if (i % 100 == 99)
+            ing_logb_flush();
+    }
+    ing_logb_stop();
+    text = capture_end(NULL);
+    TEST_CHECK(text[0] == '\0');
+    free(text);
+    TEST_CHECK(ing_logb_dropped() == 0);
+
+    TEST_CHECK((in = fopen(path, "r")) != NULL);
+    capture_begin();
+    TEST_OK(ing_logb_decode(in, stdout));
+    text = capture_end(NULL);
+    fclose(in);
+    logb_check_output(text, LOGB_RECORDS, n);
+    free(text);
+
+    /* not a binary log */
+    TEST_CHECK((in = fopen(path, "w+")) != NULL);
+    fputs("garbage", in);
+    rewind(in);
+    TEST_CHECK((out = tmpfile()) != NULL);
+    TEST_CHECK(ing_logb_decode(in, out) == ING_STAT_INVALID_ARGUMENT);
+    fclose(out);
+    fclose(in);
+    unlink(path);
+}
+
+/* text mode formats the same records in the background thread */
+static void test_logb_text(void)
+{
+    char expect[8][256];
+    char *text;
+    int i, n = 0;
+
+    capture_begin();
+    TEST_OK(ing_logb_start(NULL));
+    for (i = 0; i < 200; i++)
+    {
+        n += logb_calls(expect, i);
+        if (i % 100 == 99)
+            ing_logb_flush();
+    }
+    ing_logb_stop();
+    text = capture_end(NULL);
+    logb_check_output(text, 200, n);
+    free(text);
+
+    /* not started: logged synchronously by ing_log_msg() */
+    capture_begin();
+    n = logb_calls(expect, 0);
+    text = capture_end(NULL);
+    logb_check_output(text, 1, n);
+    free(text);
+}
+
+static int async_msgs;
+
+static void *async_producer(void *arg)
+{
+    int t = (int)(intptr_t)arg, i;
+
+    for (i = 0; i < async_msgs; i++)
+        ing_log_msg(LOG_INFO, "thread %d msg %d\n", t, i);
+    return NULL;
+}
+
+static void async_run_producers(void)
+{
+    pthread_t threads[ASYNC_THREADS];
+    int t;
+
+    for (t = 0; t < ASYNC_THREADS; t++)
+        TEST_CHECK(pthread_create(&threads[t], NULL, async_producer, (void *)(intptr_t)t) == 0);
+    for (t = 0; t < ASYNC_THREADS; t++)
+        TEST_CHECK(pthread_join(threads[t], NULL) == 0);
+}
+
+/*
+ * Parses "thread t msg i" lines; every thread's messages must be 0, 1, ...
+ * without gaps. Returns their number, the count per thread in cnt and the
+ * sum of "dropped" reports (written after any batch) in dropped
+ */
+static int async_check_output(char *out, int *cnt, unsigned long *dropped)
+{
+    char *pos = out;
+    unsigned long d;
+    int t, i, n = 0;
+
+    memset(cnt, 0, ASYNC_THREADS * sizeof(*cnt));
+    *dropped = 0;
+    while (*pos)
+    {
+        if (strncmp(strchr(pos, '|'), "|ERROR|", 7) == 0)
+        {
+            TEST_CHECK(sscanf(next_msg(&pos, "ERROR"), "%lu log messages dropped", &d) == 1);
+            *dropped += d;
+            continue;
+        }
+        TEST_CHECK(sscanf(next_msg(&pos, "INFO "), "thread %d msg %d", &t, &i) == 2);
+        TEST_CHECK(t >= 0 && t < ASYNC_THREADS && i == cnt[t]);
+        cnt[t]++;
+        n++;
+    }
+    return n;
+}
+
+/* all messages of all producers arrive once and in order per thread */
+static void test_async_producers(void)
+{
+    int cnt[ASYNC_THREADS], t;
+    unsigned long dropped;
+    size_t len;
+    char *text;
+
+    async_msgs = ASYNC_MSGS;
+    capture_begin();
+    TEST_OK(ing_log_async_start(ASYNC_THREADS * ASYNC_MSGS));
+    TEST_CHECK(ing_log_async_start(0) == ING_STAT_ALREADY_EXISTS);
+    async_run_producers();
+
+    /* everything logged before ing_log_flush() is written when it returns */
+    ing_log_flush();
+    TEST_CHECK(fseek(capture_file, 0, SEEK_END) == 0);
+    len = ftell(capture_file);
+    ing_log_async_stop();
+    text = capture_end(NULL);
+    TEST_CHECK(strlen(text) == len);
+
+    TEST_CHECK(async_check_output(text, cnt, &dropped) == ASYNC_THREADS * ASYNC_MSGS && !dropped);
+    for (t = 0; t < ASYNC_THREADS; t++)
+        TEST_CHECK(cnt[t] == ASYNC_MSGS);
+    TEST_CHECK(ing_log_dropped() == 0);
+    free(text);
+}
+
+typedef struct pipe_reader_s {
+    int fd;
+    size_t len;
+    char buf[1 << 20];
+} pipe_reader_t;
+
+static void *pipe_read(void *arg)
+{
+    pipe_reader_t *r = (pipe_reader_t *)arg;
+    ssize_t n;
+
+    while ((n = read(r->fd, r->buf + r->len, sizeof(r->buf) - 1 - r->len)) > 0)
+        r->len += n;
+    r->buf[r->len] = '\0';
+    return NULL;
+}
+
+/*
+ * The writer thread is blocked on a full pipe, so the ring keeps exactly
+ * its capacity of messages and every further message is dropped and counted
+ */
+static void test_async_overflow(void)
+{
+    static pipe_reader_t reader;
+    enum { SLOTS = 64, PER_THREAD = 50 };
+    char junk[4096];
+    int p[2], cnt[ASYNC_THREADS], fl;
+    size_t filled = 0;
+    ssize_t w;
+    pthread_t thread;
+    unsigned long dropped, reported;
+
+    TEST_CHECK(pipe(p) == 0);
+    memset(junk, '#', sizeof(junk));
+    fl = fcntl(p[1], F_GETFL);
+    TEST_CHECK(fcntl(p[1], F_SETFL, fl | O_NONBLOCK) == 0);
+    while ((w = write(p[1], junk, sizeof(junk))) > 0)
+        filled += w;
+    TEST_CHECK(errno == EAGAIN && filled > 0);
+    TEST_CHECK(fcntl(p[1], F_SETFL, fl) == 0);
+
+    fflush(stdout);
+    TEST_CHECK((saved_stdout = dup(STDOUT_FILENO)) >= 0);
+    TEST_CHECK(dup2(p[1], STDOUT_FILENO) == STDOUT_FILENO);
+    close(p[1]);
+
+    TEST_OK(ing_log_async_start(SLOTS));
+    async_msgs = PER_THREAD;
+    async_run_producers();
+    dropped = ing_log_dropped();
+    TEST_CHECK(dropped == ASYNC_THREADS * PER_THREAD - SLOTS);
+
+    /* unblock the writer; stop flushes the ring and reports the drops */
+    reader.fd = p[0];
+    TEST_CHECK(pthread_create(&thread, NULL, pipe_read, &reader) == 0);
+    ing_log_async_stop();
+    TEST_CHECK(dup2(saved_stdout, STDOUT_FILENO) == STDOUT_FILENO);
+    close(saved_stdout);
+    TEST_CHECK(pthread_join(thread, NULL) == 0);
+    close(p[0]);
+
+    TEST_CHECK(reader.len > filled && reader.buf[filled - 1] == '#' && reader.buf[filled] != '#');
+    /* the ring never drained, so each thread kept a prefix of its messages */
+    TEST_CHECK(async_check_output(reader.buf + filled, cnt, &reported) == SLOTS);
+    TEST_CHECK(reported == dropped);
+}
+
+static int evaluated;
+
+static int side_effect(void)
+{
+    return ++evaluated;
+}
+
+static int count_lines(const char *text)
+{
+    int n = 0;
+
+    for (; *text; text++)
+        n += *text == '\n';
+    return n;
+}
+
+/* logs the same message at each priority through every macro */
+static int log_all_macros(void)
+{
+    static const int prios[] = { LOG_CRIT, LOG_ERR, LOG_INFO, LOG_DEBUG };
+    char *text;
+    int i, n;
+
+    capture_begin();
+    for (i = 0; i < 4; i++)
+    {
+        ING_LOG(prios[i], "global %d\n", side_effect());
+        ING_LOGM(mod_a, prios[i], "a %d\n", side_effect());
+        ING_LOGM(mod_b, prios[i], "b %d\n", side_effect());
+        ING_LOG_RATELIMITED(prios[i], 0, 0, "limited %d\n", side_effect());
+        ING_LOGB(prios[i], "binary %d\n", side_effect());
+    }
+    text = capture_end(NULL);
+    n = count_lines(text);
+    free(text);
+    return n;
+}
+
+static void test_log_levels(void)
+{
+    TEST_CHECK(mod_a.level == ING_LOG_LEVEL_INHERIT && mod_b.level == ING_LOG_LEVEL_INHERIT);
+    TEST_CHECK(ing_log_set_module_level("no_such_module", LOG_ERR) == ING_STAT_NOT_FOUND);
+    TEST_CHECK(ing_log_set_module_level(NULL, LOG_ERR) == ING_STAT_INVALID_ARGUMENT);
+
+    /* arguments are evaluated only for the messages that are logged */
+    ing_log_set_level(LOG_ERR);
+    evaluated = 0;
+    TEST_CHECK(log_all_macros() == 2 * 5 && evaluated == 2 * 5);
+
+    /* module levels override the global level both ways */
+    TEST_OK(ing_log_set_module_level("test_a", LOG_DEBUG));
+    TEST_OK(ing_log_set_module_level("test_b", LOG_CRIT));
+    TEST_CHECK(ing_log_module_level(mod_a) == LOG_DEBUG && ing_log_module_level(mod_b) == LOG_CRIT);
+    evaluated = 0;
+    TEST_CHECK(log_all_macros() == 2 * 3 + 4 + 1 && evaluated == 11);
+
+    /* inherit follows later changes of the global level */
+    TEST_OK(ing_log_set_module_level("test_a", ING_LOG_LEVEL_INHERIT));
+    ing_log_set_level(LOG_INFO);
+    evaluated = 0;
+    TEST_CHECK(log_all_macros() == 3 * 4 + 1 && evaluated == 13);
+    TEST_OK(ing_log_set_module_level("test_b", ING_LOG_LEVEL_INHERIT));
+    ing_log_set_level(LOG_CRIT);
+    evaluated = 0;
+    TEST_CHECK(log_all_macros() == 5 && evaluated == 5);
+    ing_log_set_level(LOG_DEBUG);
+}
+
+static void test_log_ratelimit(void)
+{
+    ing_log_ratelimit_t rl;
+    unsigned long suppressed;
+    int i, allowed;
+
+    /* burst at once, then nothing until tokens are refilled */
+    memset(&rl, 0, sizeof(rl));
+    for (i = 0, allowed = 0; i < 20; i++)
+    {
+        allowed += ing_log_ratelimit(&rl, 10, 5, &suppressed);
+        TEST_CHECK(suppressed == 0);
+    }
+    TEST_CHECK(allowed == 5);
+
+    /* 10 per second: 2 tokens after 250 ms, the rest is kept for later */
+    usleep(250000);
+    TEST_CHECK(ing_log_ratelimit(&rl, 10, 5, &suppressed) && suppressed == 15);
+    TEST_CHECK(ing_log_ratelimit(&rl, 10, 5, &suppressed) && suppressed == 0);
+    TEST_CHECK(!ing_log_ratelimit(&rl, 10, 5, &suppressed) && suppressed == 0);
+    usleep(60000);
+    TEST_CHECK(ing_log_ratelimit(&rl, 10, 5, &suppressed) && suppressed == 1);
+
+    /* refill is capped by burst */
+    memset(&rl, 0, sizeof(rl));
+    for (i = 0; i < 3; i++)
+        TEST_CHECK(ing_log_ratelimit(&rl, 100, 3, &suppressed));
+    usleep(100000);
+    for (i = 0, allowed = 0; i < 10; i++)
+        allowed += ing_log_ratelimit(&rl, 100, 3, &suppressed);
+    TEST_CHECK(allowed == 3);
+
+    /* no limit */
+    memset(&rl, 0, sizeof(rl));
+    for (i = 0; i < 100; i++)
+        TEST_CHECK(ing_log_ratelimit(&rl, 0, 0, &suppressed) && suppressed == 0);
+}
+
+/* suppressed messages are summarized before the next logged one */
+static void test_log_ratelimited_macro(void)
+{
+    char *text, *pos, func[64];
+    unsigned long suppressed;
+    int i, n;
+
+    capture_begin();
+    /* one call site, one bucket */
+    for (i = 0; i <= 10; i++)
+    {
+        if (i == 10)
+            usleep(60000);
+        ING_LOG_RATELIMITED(LOG_ERR, 20, 2, "message %d\n", i);
+    }
+    text = capture_end(NULL);
+
+    pos = text;
+    TEST_CHECK(strcmp(next_msg(&pos, "ERROR"), "message 0") == 0);
+    TEST_CHECK(strcmp(next_msg(&pos, "ERROR"), "message 1") == 0);
+    TEST_CHECK(sscanf(next_msg(&pos, "ERROR"), " %63s (%d): suppressed %lu messages",
+                      func, &n, &suppressed) == 3);
+    TEST_CHECK(strcmp(func, __func__) == 0 && suppressed == 8);
+    TEST_CHECK(strcmp(next_msg(&pos, "ERROR"), "message 10") == 0);
+    TEST_CHECK(*pos == '\0');
+    free(text);
+}
+
+/* critical messages are also written to stderr; returns saved stderr */
+static int stderr_silence(void)
+{
+    int fd, saved;
+
+    fflush(stderr);
+    TEST_CHECK((saved = dup(STDERR_FILENO)) >= 0);
+    TEST_CHECK((fd = open("/dev/null", O_WRONLY)) >= 0);
+    TEST_CHECK(dup2(fd, STDERR_FILENO) == STDERR_FILENO);
+    close(fd);
+    return saved;
+}
+
+static void stderr_restore(int saved)
+{
+    TEST_CHECK(dup2(saved, STDERR_FILENO) == STDERR_FILENO);
+    close(saved);
+}
+
+/* logs critical messages first..last-1 */
+static void crit_log(int first, int last)
+{
+    char msg[32];
+    int saved = stderr_silence(), i;
+
+    for (i = first; i < last; i++)
+    {
+        if (i % 2)
+            ing_log_critical("critical %d\n", i);
+        else
+        {
+            snprintf(msg, sizeof(msg), "critical %d\n", i);
+            ing_log_critical_str(msg);
+        }
+    }
+    stderr_restore(saved);
+}
+
+/* dumps the critical log; returns the text, to be freed */
+static char *crit_dump(const char *path)
+{
+    char *text;
+
+    capture_begin();
+    TEST_OK(ing_log_critical_dump(path, stdout));
+    text = capture_end(NULL);
+    return text;
+}
+
+/* returns the message of the dumped line at *pos, advancing *pos */
+static char *crit_next(char **pos)
+{
+    char *line = *pos, *end, *msg;
+
+    TEST_CHECK((end = strchr(line, '\n')) != NULL);
+    *end = '\0';
+    *pos = end + 1;
+    TEST_CHECK((msg = strstr(line, " |CRIT | ")) != NULL);
+    return msg + 9;
+}
+
+/* the dump holds the last messages in order: first..last-1 */
+static void crit_check(const char *path, int first, int last)
+{
+    char *text, *pos, expect[32];
+    int i;
+
+    pos = text = crit_dump(path);
+    for (i = first; i < last; i++)
+    {
+        snprintf(expect, sizeof(expect), "critical %d", i);
+        TEST_CHECK(strcmp(crit_next(&pos), expect) == 0);
+    }
+    TEST_CHECK(*pos == '\0');
+    free(text);
+}
+
+static void test_log_critical(void)
+{
+    char dir[] = "/tmp/test_crit_XXXXXX", path[PATH_MAX], *text, *pos;
+    char msg[ING_LOG_CRIT_MSG_SIZE * 2];
+    int i, saved;
+
+    TEST_CHECK(mkdtemp(dir) != NULL);
+    TEST_CHECK(setenv("INANGOLOGPATH", dir, 1) == 0);
+    snprintf(path, sizeof(path), "%s/cg_critical_err.ring", dir);
+    TEST_CHECK(ing_log_critical_dump(path, stdout) == ING_STAT_NOT_FOUND);
+    ing_openlog();
+
+    /* fewer messages than slots */
+    crit_log(0, 10);
+    crit_check(path, 0, 10);
+
+    /* wrapped: only the last ING_LOG_CRIT_SLOTS remain, oldest first */
+    crit_log(10, ING_LOG_CRIT_SLOTS * 3 + 7);
+    crit_check(path, ING_LOG_CRIT_SLOTS * 2 + 7, ING_LOG_CRIT_SLOTS * 3 + 7);
+    crit_check(NULL, ING_LOG_CRIT_SLOTS * 2 + 7, ING_LOG_CRIT_SLOTS * 3 + 7);
+
+    /* the file survives a restart and numbering continues */
+    ing_closelog();
+    ing_openlog();
+    crit_log(ING_LOG_CRIT_SLOTS * 3 + 7, ING_LOG_CRIT_SLOTS * 3 + 17);
+    crit_check(path, ING_LOG_CRIT_SLOTS * 2 + 17, ING_LOG_CRIT_SLOTS * 3 + 17);
+
+    /* long messages are truncated to ING_LOG_CRIT_MSG_MAX characters */
+    for (i = 0; i < (int)sizeof(msg) - 1; i++)
+        msg[i] = 'a' + i % 26;
+    msg[sizeof(msg) - 1] = '\0';
+    saved = stderr_silence();
+    ing_log_critical("%s", msg);
+    ing_log_critical_str(msg);
+    msg[ING_LOG_CRIT_MSG_MAX] = '\0';
+    ing_log_critical_str(msg);
+    stderr_restore(saved);
+
+    pos = text = crit_dump(path);
+    for (i = 0; i < ING_LOG_CRIT_SLOTS - 3; i++)
+        crit_next(&pos);
+    for (i = 0; i < 3; i++)
+        TEST_CHECK(strcmp(crit_next(&pos), msg) == 0);
+    TEST_CHECK(*pos == '\0');
+    free(text);
+
+    ing_closelog();
+    unlink(path);
+    rmdir(dir);
+    unsetenv("INANGOLOGPATH");
+}
+
+int main(void)
+{
+    TEST_RUN(test_log_levels);
+    TEST_RUN(test_log_ratelimit);
+    TEST_RUN(test_log_ratelimited_macro);
+    TEST_RUN(test_log_critical);
+    TEST_RUN(test_logb_decode);
+    TEST_RUN(test_logb_text);
+    TEST_RUN(test_async_producers);
+    TEST_RUN(test_async_overflow);
+    return 0;
+}
@@ -0,0 +1,301 @@
+/* test_nvset.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of interned names and name/value sets
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ing_log.h"
+#include "ing_nvset.h"
+#include "ing_test.h"
+
+#define NUM_NAMES   400
+#define NUM_OPS     200000
+
+/* the library's calloc()/realloc() are wrapped (see Makefile) to fail on request */
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+
+static int fail_calloc, fail_realloc;
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    if (fail_calloc)
+        return NULL;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *p, size_t size)
+{
+    if (fail_realloc)
+        return NULL;
+    return __real_realloc(p, size);
+}
+
+static void test_sym(void)
+{
+    ing_sym_t a = ing_sym_intern("alpha");
+    char buf[] = "alpha";
+
+    TEST_CHECK(a && strcmp(ing_sym_name(a), "alpha") == 0 && ing_sym_len(a) == 5);
+    TEST_CHECK(ing_sym_intern(buf) == a);
+    TEST_CHECK(ing_sym_internn("alphabet", 5) == a);
+    TEST_CHECK(ing_sym_lookup("alpha") == a);
+    TEST_CHECK(ing_sym_lookup("never interned name") == NULL);
+    TEST_CHECK(ing_sym_intern(NULL) == NULL);
+}
+
+/* every pair of the set is reachable through the index and matches the reference */
+static void check_set(const ing_nvset_t *set, char values[][16], char names[][16])
+{
+    const char *val;
+    size_t len;
+    int i, count = 0;
+
+    for (i = 0; i < NUM_NAMES; i++)
+    {
+        val = ing_nvset_get(set, names[i], &len);
+        if (values[i][0])
+        {
+            TEST_CHECK(val && strcmp(val, values[i]) == 0 && len == strlen(values[i]));
+            count++;
+        }
+        else
+            TEST_CHECK(val == NULL);
+    }
+    TEST_CHECK(ing_nvset_count(set) == count);
+    for (i = 0; i < ing_nvset_count(set); i++)
+        TEST_CHECK(ing_nvset_get_sym(set, ing_nvset_at(set, i)->name, NULL) ==
+            ing_nvset_at(set, i)->value->data);
+}
+
+/* random set/del/get against a plain array */
+static void test_nvset_random(void)
+{
+    static char names[NUM_NAMES][16];
+    static char values[NUM_NAMES][16];
+    unsigned long long seed = 42;
+    ing_nvset_t set;
+    int i, n, op;
+
+    for (i = 0; i < NUM_NAMES; i++)
+        snprintf(names[i], sizeof(names[i]), "name.%d", i);
+    memset(values, 0, sizeof(values));
+
+    TEST_OK(ing_nvset_init(&set, 0));
+    for (i = 0; i < NUM_OPS; i++)
+    {
+        n = (int)(test_rand(&seed) % NUM_NAMES);
+        op = (int)(test_rand(&seed) % 3);
+        if (op == 0)
+        {
+            if (values[n][0])
+            {
+                TEST_OK(ing_nvset_del(&set, names[n]));
+                values[n][0] = '\0';
+            }
+            TEST_CHECK(ing_nvset_del(&set, names[n]) == ING_STAT_NOT_FOUND);
+        }
+        else
+        {
+            snprintf(values[n], sizeof(values[n]), "v%d", i);
+            TEST_OK(ing_nvset_set(&set, names[n], values[n]));
+        }
+        if (i % 1000 == 0)
+            check_set(&set, values, names);
+    }
+    check_set(&set, values, names);
+
+    /* delete everything left, in slot order and from the end */
+    for (i = 0; i < NUM_NAMES; i += 2)
+    {
+        if (values[i][0])
+            TEST_OK(ing_nvset_del(&set, names[i]));
+        values[i][0] = '\0';
+    }
+    check_set(&set, values, names);
+    while (ing_nvset_count(&set))
+    {
+        ing_sym_t name = ing_nvset_at(&set, ing_nvset_count(&set) - 1)->name;
+
+        TEST_OK(ing_nvset_del(&set, ing_sym_name(name)));
+    }
+    memset(values, 0, sizeof(values));
+    check_set(&set, values, names);
+
+    ing_nvset_destroy(&set);
+}
+
+static void test_nvset_nvp(void)
+{
+    namevaluepair_t in[3], out[3];
+    ing_nvset_t set;
+    int count;
+
+    memset(in, 0, sizeof(in));
+    strcpy(in[0].name, "a");
+    strcpy(in[0].value, "1");
+    strcpy(in[1].name, "b");
+    strcpy(in[1].value, "");
+    strcpy(in[2].name, "a");
+    strcpy(in[2].value, "3");
+
+    TEST_OK(ing_nvset_init(&set, 4));
+    TEST_OK(ing_nvset_from_nvp(&set, in, 3));
+    TEST_CHECK(ing_nvset_count(&set) == 2);
+    TEST_CHECK(strcmp(ing_nvset_get(&set, "a", NULL), "3") == 0);
+    TEST_CHECK(strcmp(ing_nvset_get(&set, "b", NULL), "") == 0);
+
+    TEST_CHECK(ing_nvset_to_nvp(&set, out, 1, &count) == ING_STAT_FULL && count == 1);
+    TEST_OK(ing_nvset_to_nvp(&set, out, 3, &count));
+    TEST_CHECK(count == 2);
+    TEST_CHECK(strcmp(out[0].name, "a") == 0 && strcmp(out[0].value, "3") == 0);
+    TEST_CHECK(strcmp(out[1].name, "b") == 0 && strcmp(out[1].value, "") == 0);
+
+    ing_nvset_clear(&set);
+    TEST_CHECK(ing_nvset_count(&set) == 0 && ing_nvset_get(&set, "a", NULL) == NULL);
+    TEST_CHECK(ing_nvset_del(&set, "a") == ING_STAT_NOT_FOUND);
+    TEST_OK(ing_nvset_set(&set, "a", "4"));
+    TEST_CHECK(strcmp(ing_nvset_get(&set, "a", NULL), "4") == 0);
+    ing_nvset_destroy(&set);
+}
+
+/* a failed grow leaves the set as it was */
+static void test_nvset_grow_fail(void)
+{
+    char name[16];
+    ing_nvset_t set;
+    int i, round;
+
+    TEST_OK(ing_nvset_init(&set, 0));
+    for (i = 0; i < 200; i++)
+    {
+        snprintf(name, sizeof(name), "grow.%d", i);
+        TEST_CHECK(ing_sym_intern(name) != NULL);
+        if (set.count == set.capacity)
+        {
+            /* first grow has no index yet; others fail on the index or the pairs */
+            for (round = 0; round < 2; round++)
+            {
+                fail_calloc = round == 0;
+                fail_realloc = round == 1;
+                TEST_CHECK(ing_nvset_set(&set, name, "v") == ING_STAT_OUTOFMEMORY);
+                TEST_CHECK(set.count == i && set.count == set.capacity);
+                TEST_CHECK(set.index_size >= set.capacity * 2);
+            }
+            fail_calloc = fail_realloc = 0;
+        }
+        TEST_OK(ing_nvset_set(&set, name, "v"));
+        TEST_CHECK(strcmp(ing_nvset_get(&set, "grow.0", NULL), "v") == 0);
+        TEST_CHECK(strcmp(ing_nvset_get(&set, name, NULL), "v") == 0);
+    }
+    ing_nvset_destroy(&set);
+}
+
+/* new names are refused when the table is full, known names still work */
+static void test_sym_limit(void)
+{
+    size_t count = ing_sym_count();
+    ing_nvset_t set;
+
+    ing_sym_set_limit(count + 2);
+    TEST_CHECK(ing_sym_intern("limit.1") && ing_sym_intern("limit.2"));
+    TEST_CHECK(ing_sym_count() == count + 2);
+    TEST_CHECK(ing_sym_intern("limit.3") == NULL);
+    TEST_CHECK(ing_sym_intern("limit.1") != NULL && ing_sym_intern("alpha") != NULL);
+
+    TEST_OK(ing_nvset_init(&set, 0));
+    TEST_OK(ing_nvset_set(&set, "limit.2", "x"));
+    TEST_CHECK(ing_nvset_set(&set, "limit.3", "x") == ING_STAT_FULL);
+    TEST_CHECK(ing_nvset_count(&set) == 1);
+    ing_nvset_destroy(&set);
+
+    ing_sym_set_limit(0);
+    TEST_CHECK(ing_sym_intern("limit.3") != NULL);
+    ing_sym_set_limit(ING_SYM_MAX);
+
+    /* the table can be released and used again */
+    ing_sym_cleanup();
+    TEST_CHECK(ing_sym_count() == 0 && ing_sym_lookup("alpha") == NULL);
+    TEST_CHECK(ing_sym_intern("alpha") != NULL && ing_sym_count() == 1);
+}
+
+int main(void)
+{
+    TEST_RUN(test_sym);
+    TEST_RUN(test_nvset_random);
+    TEST_RUN(test_nvset_nvp);
+    TEST_RUN(test_nvset_grow_fail);
+    ing_log_set_level(LOG_CRIT);
+    TEST_RUN(test_sym_limit);
+    ing_sym_cleanup();
+    return 0;
+}
@@ -0,0 +1,264 @@
+/* test_nvwire.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the name/value wire encoding: round trips and malformed datagrams
+ */
+
+#include <string.h>
+
+#include "ing_log.h"
+#include "ing_nvwire.h"
+#include "ing_test.h"
+
+#define NUM_PAIRS   50
+
+static unsigned char msg[16384];
+static size_t msg_len;
+
+static char names[NUM_PAIRS][200];
+static char values[NUM_PAIRS][300];
+static size_t value_lens[NUM_PAIRS];
+
+/* pairs of different lengths, including empty and longer than one varint byte */
+static void build_message(void)
+{
+    ing_nvwire_enc_t enc;
+    int i;
+
+    TEST_OK(ing_nvwire_enc_init(&enc, msg, sizeof(msg)));
+    for (i = 0; i < NUM_PAIRS; i++)
+    {
+        memset(names[i], 'a' + i % 26, sizeof(names[i]));
+        names[i][(i * 37) % 190] = '\0';
+        value_lens[i] = (size_t)(i * 61) % 300;
+        memset(values[i], i, value_lens[i]);     /* binary, with '\0' bytes */
+        TEST_OK(ing_nvwire_enc_add(&enc, names[i], strlen(names[i]), values[i], value_lens[i]));
+    }
+    msg_len = ing_nvwire_enc_finish(&enc);
+    TEST_CHECK(msg_len == enc.len && msg_len > ING_NVWIRE_HDR_SIZE);
+}
+
+static void check_pair(const ing_nvwire_pair_t *pair, int i)
+{
+    TEST_CHECK(pair->name.len == strlen(names[i]));
+    TEST_CHECK(memcmp(pair->name.ptr, names[i], pair->name.len) == 0);
+    TEST_CHECK(pair->value.len == value_lens[i]);
+    TEST_CHECK(!value_lens[i] || memcmp(pair->value.ptr, values[i], value_lens[i]) == 0);
+}
+
+static void test_nvwire_roundtrip(void)
+{
+    ing_nvwire_pair_t pairs[NUM_PAIRS];
+    ing_nvwire_dec_t dec;
+    ing_nvwire_pair_t pair;
+    int i, count;
+
+    build_message();
+
+    TEST_OK(ing_nvwire_decode(msg, msg_len, pairs, NUM_PAIRS, &count));
+    TEST_CHECK(count == NUM_PAIRS);
+    for (i = 0; i < count; i++)
+        check_pair(&pairs[i], i);
+
+    TEST_CHECK(ing_nvwire_decode(msg, msg_len, pairs, NUM_PAIRS - 1, &count) == ING_STAT_FULL);
+    TEST_CHECK(count == NUM_PAIRS - 1);
+
+    TEST_OK(ing_nvwire_dec_init(&dec, msg, msg_len));
+    TEST_CHECK(dec.count == NUM_PAIRS);
+    for (i = 0; i < NUM_PAIRS; i++)
+    {
+        TEST_OK(ing_nvwire_dec_next(&dec, &pair));
+        check_pair(&pair, i);
+    }
+    TEST_CHECK(ing_nvwire_dec_next(&dec, &pair) == ING_STAT_NOT_FOUND);
+    TEST_CHECK(dec.pos == msg_len);
+}
+
+static void test_nvwire_nvp(void)
+{
+    namevaluepair_t nvp[2];
+    nvpair_t nvpair[2];
+    ing_nvwire_pair_t pairs[4];
+    unsigned char buf[64];
+    ing_nvwire_enc_t enc;
+    int count;
+
+    memset(nvp, 0, sizeof(nvp));
+    memset(nvpair, 0, sizeof(nvpair));
+    strcpy(nvp[0].name, "a");
+    strcpy(nvp[0].value, "1");
+    strcpy(nvp[1].name, "b");
+    strcpy(nvpair[0].name, "c");
+    nvpair[0].pValue = "33";
+    strcpy(nvpair[1].name, "d");
+
+    TEST_OK(ing_nvwire_enc_init(&enc, buf, sizeof(buf)));
+    TEST_OK(ing_nvwire_enc_add_nvp(&enc, nvp, 2));
+    TEST_OK(ing_nvwire_enc_add_nvpair(&enc, nvpair, 2));
+    TEST_OK(ing_nvwire_decode(buf, ing_nvwire_enc_finish(&enc), pairs, 4, &count));
+    TEST_CHECK(count == 4);
+    TEST_CHECK(pairs[1].name.len == 1 && pairs[1].value.len == 0);
+    TEST_CHECK(pairs[2].value.len == 2 && memcmp(pairs[2].value.ptr, "33", 2) == 0);
+    TEST_CHECK(pairs[3].value.len == 0);
+}
+
+/* a pair that does not fit leaves the encoder unchanged */
+static void test_nvwire_full(void)
+{
+    unsigned char buf[ING_NVWIRE_HDR_SIZE + 7];
+    ing_nvwire_pair_t pair;
+    ing_nvwire_enc_t enc;
+    int count;
+
+    TEST_CHECK(ing_nvwire_enc_init(&enc, buf, ING_NVWIRE_HDR_SIZE - 1) == ING_STAT_FULL);
+    TEST_OK(ing_nvwire_enc_init(&enc, buf, sizeof(buf)));
+    TEST_OK(ing_nvwire_enc_add_str(&enc, "ab", "c"));
+    TEST_CHECK(ing_nvwire_enc_add_str(&enc, "x", "") == ING_STAT_FULL);
+    TEST_CHECK(enc.len == ING_NVWIRE_HDR_SIZE + 5 && enc.count == 1);
+    TEST_OK(ing_nvwire_enc_add_str(&enc, "", ""));
+    TEST_CHECK(ing_nvwire_enc_add_str(&enc, "", "") == ING_STAT_FULL);
+    TEST_CHECK(ing_nvwire_decode(buf, ing_nvwire_enc_finish(&enc), &pair, 1, &count) == ING_STAT_FULL);
+    TEST_CHECK(count == 1 && pair.name.len == 2 && pair.value.len == 1);
+}
+
+/* every truncated prefix of a valid message is rejected */
+static void test_nvwire_truncated(void)
+{
+    ing_nvwire_pair_t pairs[NUM_PAIRS];
+    size_t len;
+    int count;
+
+    build_message();
+    for (len = 0; len < msg_len; len++)
+    {
+        TEST_CHECK(ing_nvwire_decode(msg, len, pairs, NUM_PAIRS, &count) == ING_STAT_INVALID_ARGUMENT);
+        TEST_CHECK(count < NUM_PAIRS);
+    }
+}
+
+/* builds a one-pair message whose name length is the given varint bytes */
+static size_t varint_message(unsigned char *buf, const unsigned char *varint, size_t n)
+{
+    memcpy(buf, "NV\1\0\1\0\0\0", ING_NVWIRE_HDR_SIZE);
+    memcpy(buf + ING_NVWIRE_HDR_SIZE, varint, n);
+    memset(buf + ING_NVWIRE_HDR_SIZE + n, 0, 8);
+    return ING_NVWIRE_HDR_SIZE + n + 8;
+}
+
+static void test_nvwire_varints(void)
+{
+    static const unsigned char over_long[11] =
+        { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 };
+    static const unsigned char overflow[10] =
+        { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02 };
+    static const unsigned char huge[10] =
+        { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01 };
+    static const unsigned char padded[2] = { 0x83, 0x00 };     /* 3 in two bytes */
+    unsigned char buf[64];
+    ing_nvwire_pair_t pair;
+    size_t len;
+    int count;
+
+    len = varint_message(buf, over_long, sizeof(over_long));
+    TEST_CHECK(ing_nvwire_decode(buf, len, &pair, 1, &count) == ING_STAT_INVALID_ARGUMENT);
+    len = varint_message(buf, overflow, sizeof(overflow));
+    TEST_CHECK(ing_nvwire_decode(buf, len, &pair, 1, &count) == ING_STAT_INVALID_ARGUMENT);
+    len = varint_message(buf, huge, sizeof(huge));
+    TEST_CHECK(ing_nvwire_decode(buf, len, &pair, 1, &count) == ING_STAT_INVALID_ARGUMENT);
+
+    /* non-minimal encodings are accepted: 3 byte name, then empty value */
+    len = varint_message(buf, padded, sizeof(padded));
+    TEST_OK(ing_nvwire_decode(buf, len, &pair, 1, &count));
+    TEST_CHECK(count == 1 && pair.name.len == 3 && pair.value.len == 0);
+
+    /* count larger than the pairs present */
+    buf[4] = 2;
+    TEST_CHECK(ing_nvwire_decode(buf, len, &pair, 1, &count) == ING_STAT_FULL);
+    TEST_CHECK(ing_nvwire_decode(buf, 14, NULL, 0, &count) == ING_STAT_FULL);
+
+    /* bad header */
+    buf[2] = ING_NVWIRE_VERSION + 1;
+    TEST_CHECK(ing_nvwire_decode(buf, len, &pair, 1, &count) == ING_STAT_INVALID_ARGUMENT);
+    buf[2] = ING_NVWIRE_VERSION;
+    buf[0] = 'n';
+    TEST_CHECK(ing_nvwire_decode(buf, len, &pair, 1, &count) == ING_STAT_INVALID_ARGUMENT);
+}
+
+int main(void)
+{
+    TEST_RUN(test_nvwire_roundtrip);
+    TEST_RUN(test_nvwire_nvp);
+    TEST_RUN(test_nvwire_full);
+
+    /* malformed messages are expected below, do not log them */
+    ing_log_set_level(LOG_CRIT);
+    TEST_RUN(test_nvwire_truncated);
+    TEST_RUN(test_nvwire_varints);
+    return 0;
+}
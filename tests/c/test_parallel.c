@@ -0,0 +1,309 @@
+/* test_parallel.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of parallel foreach, select and reduce over IC containers
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ing_container.h"
+#include "ing_test.h"
+
+#define NUM_RECORDS (ING_PARALLEL_SCAN_MIN * 4)
+
+typedef struct rec_s
+{
+    int key;
+    int visits;
+    UT_hash_handle hh;
+} rec_t;
+
+GENERATE_DB_TYPE(rec_t)
+GENERATE_DB_DECLARATIONS(rec_t, key)
+GENERATE_DB_FUNCTIONS(rec_t, key)
+
+/* accumulator deliberately smaller than a cache line */
+typedef struct acc_s
+{
+    long long sum;
+    int count;
+} acc_t;
+
+static const int nthreads[] = { 1, 4, 0 };
+
+#define NUM_NTHREADS    (int)(sizeof(nthreads) / sizeof(nthreads[0]))
+
+/* fills the container and frees every seventh slot, so scans skip holes */
+static void fill_db(IC_DB_TYPE(rec_t) *db)
+{
+    rec_t rec;
+    int i, key;
+
+    memset(&rec, 0, sizeof(rec));
+    TEST_OK(IC_INIT(rec_t, db, NUM_RECORDS));
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        rec.key = i;
+        TEST_OK(IC_ADD(rec_t, db, &rec));
+    }
+    for (i = 0; i < NUM_RECORDS; i += 7)
+    {
+        key = i;
+        TEST_OK(IC_DEL(rec_t, db, &key));
+    }
+}
+
+static void visit(void *rec, void *arg)
+{
+    (void)arg;
+    ((rec_t *)rec)->visits++;
+}
+
+static int is_selected(const void *rec, void *arg)
+{
+    return ((const rec_t *)rec)->key % *(int *)arg == 0;
+}
+
+static void sum_map(void *acc, const void *rec, void *arg)
+{
+    acc_t *a = (acc_t *)acc;
+
+    (void)arg;
+    TEST_CHECK((uintptr_t)acc % ING_PARALLEL_CACHE_LINE == 0);
+    a->sum += ((const rec_t *)rec)->key;
+    a->count++;
+}
+
+static void sum_merge(void *acc, const void *part_acc, void *arg)
+{
+    acc_t *a = (acc_t *)acc;
+    const acc_t *p = (const acc_t *)part_acc;
+
+    (void)arg;
+    a->sum += p->sum;
+    a->count += p->count;
+}
+
+/* every occupied slot is visited exactly once */
+static void test_parallel_foreach(void)
+{
+    IC_DB_TYPE(rec_t) db;
+    rec_t *found;
+    int i, t;
+
+    fill_db(&db);
+    for (t = 0; t < NUM_NTHREADS; t++)
+        TEST_OK(IC_PARALLEL_FOREACH(rec_t, &db, visit, NULL, nthreads[t]));
+
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        if (i % 7 == 0)
+            continue;
+        TEST_OK(IC_GET(rec_t, &db, &i, &found));
+        TEST_CHECK(found->visits == NUM_NTHREADS);
+    }
+    TEST_OK(IC_DESTROY(rec_t, &db));
+}
+
+/* selected records match a serial scan and come in slot order */
+static void test_parallel_select(void)
+{
+    IC_DB_TYPE(rec_t) db;
+    ing_view_t view;
+    int i, t, expected, divisor = 5;
+
+    fill_db(&db);
+    for (i = 0, expected = 0; i < NUM_RECORDS; i++)
+        expected += (i % 7 != 0 && i % divisor == 0);
+
+    for (t = 0; t < NUM_NTHREADS; t++)
+    {
+        TEST_OK(IC_SELECT_INTO_ARRAY(rec_t, &db, is_selected, &divisor, &view, nthreads[t]));
+        TEST_CHECK(view.count == expected);
+        for (i = 0; i < view.count; i++)
+        {
+            rec_t *rec = IC_VIEW_AT(rec_t, &view, i);
+
+            TEST_CHECK(rec->key % divisor == 0 && rec->key % 7 != 0);
+            if (i > 0)
+                TEST_CHECK(IC_VIEW_AT(rec_t, &view, i - 1) < rec);
+        }
+        IC_VIEW_FREE(&view);
+    }
+
+    /* nothing selected */
+    divisor = NUM_RECORDS * 2;
+    TEST_OK(IC_DEL(rec_t, &db, &(int){ 1 }));
+    for (t = 0; t < NUM_NTHREADS; t++)
+    {
+        TEST_OK(IC_SELECT_INTO_ARRAY(rec_t, &db, is_selected, &divisor, &view, nthreads[t]));
+        TEST_CHECK(view.count == 0);
+        IC_VIEW_FREE(&view);
+    }
+    TEST_OK(IC_DESTROY(rec_t, &db));
+}
+
+/* reduce equals the serial sum, per-thread accumulators are cache-line aligned */
+static void test_parallel_reduce(void)
+{
+    IC_DB_TYPE(rec_t) db;
+    acc_t acc;
+    long long sum = 0;
+    int i, t, count = 0;
+
+    fill_db(&db);
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        if (i % 7 == 0)
+            continue;
+        sum += i;
+        count++;
+    }
+
+    for (t = 0; t < NUM_NTHREADS; t++)
+    {
+        memset(&acc, 0, sizeof(acc));
+        TEST_OK(IC_REDUCE(rec_t, &db, sum_map, sum_merge, &acc, NULL, nthreads[t]));
+        TEST_CHECK(acc.sum == sum && acc.count == count);
+    }
+    TEST_OK(IC_DESTROY(rec_t, &db));
+}
+
+/* looks up the record's key and an absent one from the scanning thread */
+static void lookup(void *rec, void *arg)
+{
+    IC_DB_TYPE(rec_t) *db = (IC_DB_TYPE(rec_t) *)arg;
+    rec_t *found;
+    int key = ((rec_t *)rec)->key;
+
+    TEST_OK(IC_GET(rec_t, db, &key, &found));
+    TEST_CHECK(found == rec);
+    key = -key - 1;
+    TEST_CHECK(IC_GET(rec_t, db, &key, &found) == ING_STAT_NOT_FOUND);
+}
+
+/* bloom filter statistics stay exact with concurrent readers */
+static void test_parallel_bloom_stats(void)
+{
+    IC_DB_TYPE(rec_t) db;
+    ing_container_stats_t before, after;
+    rec_t rec;
+    int i, t;
+
+    memset(&rec, 0, sizeof(rec));
+    TEST_OK(IC_INIT_BLOOM(rec_t, &db, NUM_RECORDS, 0.01));
+    for (i = 0; i < NUM_RECORDS; i++)
+    {
+        rec.key = i;
+        TEST_OK(IC_ADD(rec_t, &db, &rec));
+    }
+
+    TEST_OK(IC_STATS(rec_t, &db, &before));
+    for (t = 0; t < NUM_NTHREADS; t++)
+        TEST_OK(IC_PARALLEL_FOREACH(rec_t, &db, lookup, &db, nthreads[t]));
+    TEST_OK(IC_STATS(rec_t, &db, &after));
+    TEST_CHECK(after.bloom_lookups - before.bloom_lookups == 2ULL * NUM_RECORDS * NUM_NTHREADS);
+    TEST_CHECK(after.bloom_negatives + after.bloom_false_positives -
+               before.bloom_negatives - before.bloom_false_positives ==
+               (unsigned long long)NUM_RECORDS * NUM_NTHREADS);
+    TEST_OK(IC_DESTROY(rec_t, &db));
+}
+
+/* containers below ING_PARALLEL_SCAN_MIN are scanned serially */
+static void test_parallel_small(void)
+{
+    IC_DB_TYPE(rec_t) db;
+    rec_t rec;
+    acc_t acc;
+    int i;
+
+    memset(&rec, 0, sizeof(rec));
+    TEST_OK(IC_INIT(rec_t, &db, 100));
+    for (i = 0; i < 100; i++)
+    {
+        rec.key = i;
+        TEST_OK(IC_ADD(rec_t, &db, &rec));
+    }
+    memset(&acc, 0, sizeof(acc));
+    TEST_OK(IC_REDUCE(rec_t, &db, sum_map, sum_merge, &acc, NULL, 0));
+    TEST_CHECK(acc.sum == 99 * 100 / 2 && acc.count == 100);
+    TEST_OK(IC_DESTROY(rec_t, &db));
+}
+
+int main(void)
+{
+    TEST_RUN(test_parallel_foreach);
+    TEST_RUN(test_parallel_select);
+    TEST_RUN(test_parallel_reduce);
+    TEST_RUN(test_parallel_bloom_stats);
+    TEST_RUN(test_parallel_small);
+    ing_parallel_shutdown();
+    return 0;
+}
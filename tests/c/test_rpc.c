@@ -0,0 +1,517 @@
+/* test_rpc.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the RPC layer on a socketpair driven by ing_evloop_run_once():
+ * pipelined calls answered out of order, retries and stale responses,
+ * cancellation, memfd-sized payloads and queueing on a full socket
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/socket.h>
+
+#include "ing_log.h"
+#include "ing_rpc.h"
+#include "ing_sock.h"
+#include "ing_test.h"
+
+#define NCALLS      100
+#define HELD_MAX    256
+#define BIG_LEN     (4 * ING_SOCK_INLINE_MAX + 123)
+
+typedef struct result_s {
+    int done;
+    int order;                  /* completion number */
+    ing_stat_t status;
+    size_t len;
+    char data[64];
+} result_t;
+
+typedef struct held_s {
+    ing_rpc_req_t req;
+    double t;                   /* when it was received */
+    size_t len;
+    char *data;
+} held_t;
+
+enum { SRV_ECHO, SRV_HOLD, SRV_DROP_FIRST, SRV_IGNORE };
+
+static ing_evloop_t *loop;
+static ing_rpc_t *cli, *srv;
+static int sv[2];
+static int srv_mode;
+static double srv_delay;        /* SRV_HOLD: reply after this long, <0 - never */
+static held_t held[HELD_MAX];
+static int nheld, nrecv, ncompleted;
+static uint32_t first_id;
+static int big_ok;
+
+static void on_request(ing_rpc_t *rpc, const ing_rpc_req_t *req, const void *data, size_t len,
+    void *arg)
+{
+    (void)arg;
+    nrecv++;
+    switch (srv_mode)
+    {
+    case SRV_ECHO:
+        TEST_OK(ing_rpc_reply(rpc, req, data, len));
+        break;
+    case SRV_DROP_FIRST:
+        if (req->id != first_id)
+        {
+            first_id = req->id;
+            break;
+        }
+        TEST_OK(ing_rpc_reply(rpc, req, data, len));
+        break;
+    case SRV_HOLD:
+        TEST_CHECK(nheld < HELD_MAX);
+        held[nheld].req = *req;
+        held[nheld].t = test_now();
+        held[nheld].len = len;
+        TEST_CHECK((held[nheld].data = (char *)malloc(len + 1)) != NULL);
+        memcpy(held[nheld].data, data, len);
+        nheld++;
+        break;
+    }
+}
+
+static void on_response(ing_rpc_t *rpc, ing_stat_t status, const void *data, size_t len, void *arg)
+{
+    result_t *res = (result_t *)arg;
+
+    (void)rpc;
+    res->done++;
+    res->order = ncompleted++;
+    res->status = status;
+    res->len = len;
+    if (status == ING_STAT_OK)
+        memcpy(res->data, data, len < sizeof(res->data) ? len : sizeof(res->data));
+}
+
+static void on_big(ing_rpc_t *rpc, ing_stat_t status, const void *data, size_t len, void *arg)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    size_t i;
+
+    (void)rpc;
+    (void)arg;
+    TEST_CHECK(status == ING_STAT_OK && len == BIG_LEN);
+    for (i = 0; i < len; i++)
+        TEST_CHECK(p[i] == (unsigned char)(i * 7));
+    big_ok++;
+}
+
+static void reply_held(int i)
+{
+    TEST_OK(ing_rpc_reply(srv, &held[i].req, held[i].data, held[i].len));
+}
+
+static void clear_held(void)
+{
+    int i;
+
+    for (i = 0; i < nheld; i++)
+        free(held[i].data);
+    nheld = 0;
+}
+
+/* replies to requests held for srv_delay, in the order received */
+static void srv_pump(void)
+{
+    static int next;
+    double now = test_now();
+
+    if (!nheld)
+        next = 0;
+    if (srv_mode != SRV_HOLD || srv_delay < 0)
+        return;
+    while (next < nheld && now - held[next].t >= srv_delay)
+        reply_held(next++);
+}
+
+/* runs the loop until *counter reaches n; fails after max_ms */
+static void run_until(const int *counter, int n, int max_ms)
+{
+    double end = test_now() + max_ms / 1000.0;
+
+    while (*counter < n)
+    {
+        TEST_CHECK(test_now() < end);
+        TEST_CHECK(ing_evloop_run_once(loop, 1) >= 0);
+        srv_pump();
+    }
+}
+
+static void run_for(int ms)
+{
+    double end = test_now() + ms / 1000.0;
+
+    while (test_now() < end)
+    {
+        TEST_CHECK(ing_evloop_run_once(loop, 1) >= 0);
+        srv_pump();
+    }
+}
+
+static void setup(int max_pending, int with_server)
+{
+    TEST_CHECK(socketpair(AF_UNIX, SOCK_DGRAM, 0, sv) == 0);
+    TEST_OK(ing_evloop_create(&loop));
+    TEST_OK(ing_rpc_create(&cli, loop, sv[0], max_pending));
+    srv = NULL;
+    if (with_server)
+    {
+        TEST_OK(ing_rpc_create(&srv, loop, sv[1], 16));
+        ing_rpc_set_handler(srv, on_request, NULL);
+    }
+    srv_mode = SRV_ECHO;
+    srv_delay = -1;
+    nrecv = 0;
+    ncompleted = 0;
+    first_id = 0;
+}
+
+static void teardown(void)
+{
+    ing_rpc_destroy(cli);
+    ing_rpc_destroy(srv);
+    ing_evloop_destroy(loop);
+    close(sv[0]);
+    close(sv[1]);
+    clear_held();
+}
+
+static ing_stat_t call(const char *text, const ing_rpc_opts_t *opts, result_t *res, uint32_t *id)
+{
+    memset(res, 0, sizeof(*res));
+    return ing_rpc_call(cli, NULL, 0, text, strlen(text) + 1, opts, on_response, res, id);
+}
+
+static void test_rpc_out_of_order(void)
+{
+    static result_t res[NCALLS];
+    char text[32];
+    int i;
+
+    setup(NCALLS, TRUE);
+    srv_mode = SRV_HOLD;
+    for (i = 0; i < NCALLS; i++)
+    {
+        snprintf(text, sizeof(text), "call %d", i);
+        TEST_OK(call(text, NULL, &res[i], NULL));
+    }
+    TEST_CHECK(ing_rpc_pending(cli) == NCALLS);
+    run_until(&nheld, NCALLS, 2000);
+
+    /* requests arrive in call order and are answered in reverse */
+    for (i = 0; i < NCALLS; i++)
+    {
+        snprintf(text, sizeof(text), "call %d", i);
+        TEST_CHECK(strcmp(held[i].data, text) == 0);
+    }
+    for (i = NCALLS - 1; i >= 0; i--)
+        reply_held(i);
+    run_until(&ncompleted, NCALLS, 2000);
+
+    for (i = 0; i < NCALLS; i++)
+    {
+        snprintf(text, sizeof(text), "call %d", i);
+        TEST_CHECK(res[i].done == 1 && res[i].status == ING_STAT_OK);
+        TEST_CHECK(strcmp(res[i].data, text) == 0);
+        TEST_CHECK(res[i].order == NCALLS - 1 - i);
+    }
+    TEST_CHECK(ing_rpc_pending(cli) == 0);
+    teardown();
+}
+
+static void test_rpc_timeout_retry(void)
+{
+    ing_rpc_opts_t opts = { 30, 2 };
+    result_t res, res2;
+    uint32_t id, id2;
+    double t;
+
+    setup(4, TRUE);
+
+    /* no response: completes with ING_STAT_TIMEOUT after one attempt */
+    srv_mode = SRV_IGNORE;
+    opts.retries = 0;
+    t = test_now();
+    TEST_OK(call("lost", &opts, &res, NULL));
+    run_until(&res.done, 1, 2000);
+    TEST_CHECK(res.status == ING_STAT_TIMEOUT && nrecv == 1);
+    TEST_CHECK(test_now() - t >= 0.029);
+    TEST_CHECK(ing_rpc_pending(cli) == 0);
+
+    /* first attempt is lost, the retry is answered */
+    srv_mode = SRV_DROP_FIRST;
+    nrecv = 0;
+    opts.retries = 2;
+    TEST_OK(call("retried", &opts, &res, &id));
+    run_until(&res.done, 1, 2000);
+    TEST_CHECK(res.status == ING_STAT_OK && strcmp(res.data, "retried") == 0);
+    TEST_CHECK(nrecv == 2 && first_id == id);
+
+    /* both attempts are answered late: the second response is dropped */
+    srv_mode = SRV_HOLD;
+    nrecv = 0;
+    TEST_OK(call("late", &opts, &res, &id));
+    run_until(&nheld, 2, 2000);
+    TEST_CHECK(held[0].req.id == id && held[1].req.id == id);
+    reply_held(0);
+    reply_held(1);
+    run_for(20);
+    TEST_CHECK(res.done == 1 && res.status == ING_STAT_OK && strcmp(res.data, "late") == 0);
+
+    /* a stale response does not complete the next call in the same slot */
+    TEST_OK(call("next", &opts, &res2, &id2));
+    TEST_CHECK((id2 & 0xffff) == (id & 0xffff) && id2 != id);
+    run_until(&nheld, 3, 2000);
+    reply_held(0);
+    run_for(20);
+    TEST_CHECK(res2.done == 0 && res.done == 1);
+    reply_held(2);
+    run_until(&res2.done, 1, 2000);
+    TEST_CHECK(res2.status == ING_STAT_OK && strcmp(res2.data, "next") == 0);
+    TEST_CHECK(ing_rpc_pending(cli) == 0);
+    teardown();
+}
+
+/* calls time out in deadline order, whatever order they were made in */
+static void test_rpc_deadlines(void)
+{
+    static const unsigned timeouts[] = { 90, 20, 70, 40, 100, 30, 60, 50, 80, 110 };
+    result_t res[10];
+    ing_rpc_opts_t opts = { 0, 0 };
+    uint32_t ids[10];
+    int i, j, before;
+
+    setup(16, TRUE);
+    srv_mode = SRV_IGNORE;
+    for (i = 0; i < 10; i++)
+    {
+        opts.timeout_ms = timeouts[i];
+        TEST_OK(call("slow", &opts, &res[i], &ids[i]));
+    }
+    TEST_OK(ing_rpc_cancel(cli, ids[6]));
+    TEST_OK(ing_rpc_cancel(cli, ids[1]));
+    run_until(&ncompleted, 8, 2000);
+
+    for (i = 0; i < 10; i++)
+    {
+        if (i == 1 || i == 6)
+        {
+            TEST_CHECK(res[i].done == 0);
+            continue;
+        }
+        TEST_CHECK(res[i].done == 1 && res[i].status == ING_STAT_TIMEOUT);
+        for (before = 0, j = 0; j < 10; j++)
+        {
+            if (j != 1 && j != 6 && timeouts[j] < timeouts[i])
+                before++;
+        }
+        TEST_CHECK(res[i].order == before);
+    }
+    teardown();
+}
+
+static void test_rpc_cancel(void)
+{
+    result_t res, res2;
+    uint32_t id, id2;
+
+    setup(4, TRUE);
+    srv_mode = SRV_HOLD;
+    TEST_OK(call("cancelled", NULL, &res, &id));
+    TEST_OK(call("kept", NULL, &res2, &id2));
+    run_until(&nheld, 2, 2000);
+
+    TEST_OK(ing_rpc_cancel(cli, id));
+    TEST_CHECK(ing_rpc_cancel(cli, id) == ING_STAT_NOT_FOUND);
+    TEST_CHECK(ing_rpc_cancel(cli, 0) == ING_STAT_NOT_FOUND);
+    TEST_CHECK(ing_rpc_pending(cli) == 1);
+
+    reply_held(0);
+    reply_held(1);
+    run_until(&res2.done, 1, 2000);
+    run_for(20);
+    TEST_CHECK(res.done == 0 && res2.status == ING_STAT_OK);
+    TEST_CHECK(ing_rpc_pending(cli) == 0);
+    teardown();
+}
+
+static void test_rpc_big(void)
+{
+    unsigned char *data;
+    size_t i;
+
+    TEST_CHECK((data = (unsigned char *)malloc(BIG_LEN)) != NULL);
+    for (i = 0; i < BIG_LEN; i++)
+        data[i] = (unsigned char)(i * 7);
+
+    setup(4, TRUE);
+    big_ok = 0;
+    for (i = 0; i < 3; i++)
+        TEST_OK(ing_rpc_call(cli, NULL, 0, data, BIG_LEN, NULL, on_big, NULL, NULL));
+    run_until(&big_ok, 3, 5000);
+    TEST_CHECK(nrecv == 3 && ing_rpc_pending(cli) == 0);
+    teardown();
+    free(data);
+}
+
+/* fills the client socket buffer with datagrams the server drops */
+static void fill_socket(void)
+{
+    char junk[512];
+    int n = 0;
+
+    memset(junk, 0, sizeof(junk));
+    while (send(sv[0], junk, sizeof(junk), MSG_DONTWAIT) > 0)
+        n++;
+    TEST_CHECK(n > 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+}
+
+static void test_rpc_full(void)
+{
+    static result_t res[NCALLS];
+    ing_rpc_opts_t opts = { 100, 0 };
+    char text[32];
+    int i, sndbuf = 4096;
+    double t;
+
+    /* max_pending outstanding calls */
+    setup(4, TRUE);
+    srv_mode = SRV_HOLD;
+    for (i = 0; i < 4; i++)
+        TEST_OK(call("pending", NULL, &res[i], NULL));
+    TEST_CHECK(call("over", NULL, &res[4], NULL) == ING_STAT_FULL);
+    run_until(&nheld, 4, 2000);
+    reply_held(2);
+    run_until(&ncompleted, 1, 2000);
+    TEST_OK(call("again", NULL, &res[4], NULL));
+    TEST_CHECK(ing_rpc_pending(cli) == 4);
+    teardown();
+
+    /*
+     * Full socket buffer: calls are queued without a server reading the
+     * socket for most of their timeout; their attempt deadline starts when
+     * they are sent, so the delayed responses still arrive in time
+     */
+    setup(NCALLS, FALSE);
+    TEST_CHECK(setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) == 0);
+    fill_socket();
+    for (i = 0; i < 20; i++)
+    {
+        snprintf(text, sizeof(text), "queued %d", i);
+        TEST_OK(call(text, &opts, &res[i], NULL));
+    }
+    run_for(70);
+    TEST_CHECK(ncompleted == 0 && ing_rpc_pending(cli) == 20);
+
+    TEST_OK(ing_rpc_create(&srv, loop, sv[1], 16));
+    ing_rpc_set_handler(srv, on_request, NULL);
+    srv_mode = SRV_HOLD;
+    srv_delay = 0.06;
+    run_until(&ncompleted, 20, 2000);
+    for (i = 0; i < 20; i++)
+    {
+        snprintf(text, sizeof(text), "queued %d", i);
+        TEST_CHECK(res[i].done == 1 && res[i].status == ING_STAT_OK);
+        TEST_CHECK(strcmp(res[i].data, text) == 0 && strcmp(held[i].data, text) == 0);
+    }
+    TEST_CHECK(nrecv == 20);
+
+    /* a call that can never be sent times out after all its attempts */
+    ing_rpc_destroy(srv);
+    srv = NULL;
+    fill_socket();
+    opts.timeout_ms = 30;
+    opts.retries = 1;
+    t = test_now();
+    TEST_OK(call("stuck", &opts, &res[0], NULL));
+    run_until(&res[0].done, 1, 2000);
+    TEST_CHECK(res[0].status == ING_STAT_TIMEOUT && test_now() - t >= 0.059);
+    TEST_CHECK(ing_rpc_pending(cli) == 0);
+    teardown();
+}
+
+int main(void)
+{
+    ing_log_set_level(LOG_CRIT);
+    TEST_RUN(test_rpc_out_of_order);
+    TEST_RUN(test_rpc_timeout_retry);
+    TEST_RUN(test_rpc_deadlines);
+    TEST_RUN(test_rpc_cancel);
+    TEST_RUN(test_rpc_big);
+    TEST_RUN(test_rpc_full);
+    return 0;
+}
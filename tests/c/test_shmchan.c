@@ -0,0 +1,189 @@
+/* test_shmchan.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the shared-memory channel within one process: message order
+ * across ring wraps and rejection of corrupted records
+ */
+
+#include <string.h>
+
+#include "ing_log.h"
+#include "ing_shmchan.h"
+#include "ing_test.h"
+
+#define CAPACITY    4096
+
+static void send_seq(ing_shmchan_t *ch, size_t len, int seq)
+{
+    char buf[CAPACITY];
+
+    memset(buf, seq & 0xff, len);
+    TEST_OK(ing_shmchan_send(ch, buf, len, 0));
+}
+
+static void recv_seq(ing_shmchan_t *ch, size_t len, int seq)
+{
+    char buf[CAPACITY];
+    size_t n, i;
+
+    TEST_OK(ing_shmchan_recv(ch, buf, sizeof(buf), &n, 0));
+    TEST_CHECK(n == len);
+    for (i = 0; i < n; i++)
+        TEST_CHECK(buf[i] == (char)(seq & 0xff));
+}
+
+/* messages of varying sizes go through many wraps of the ring */
+static void test_shmchan_order(void)
+{
+    ing_shmchan_t ch;
+    const void *ptr;
+    size_t len;
+    int i;
+
+    TEST_OK(ing_shmchan_create(&ch, "test", CAPACITY));
+    TEST_CHECK(ch.capacity == CAPACITY);
+    TEST_CHECK(ing_shmchan_peek(&ch, &ptr, &len, 0) == ING_STAT_NOT_FOUND);
+    TEST_CHECK(ing_shmchan_send(&ch, "x", ing_shmchan_max_msg(&ch) + 1, 0) != ING_STAT_OK);
+
+    for (i = 0; i < 3000; i++)
+    {
+        send_seq(&ch, (size_t)(i * 97) % 1000, i);
+        if (i % 3 == 2)
+        {
+            recv_seq(&ch, (size_t)((i - 2) * 97) % 1000, i - 2);
+            recv_seq(&ch, (size_t)((i - 1) * 97) % 1000, i - 1);
+            recv_seq(&ch, (size_t)(i * 97) % 1000, i);
+        }
+    }
+    send_seq(&ch, ing_shmchan_max_msg(&ch), 1);
+    TEST_CHECK(ing_shmchan_send(&ch, "x", ing_shmchan_max_msg(&ch), 0) == ING_STAT_FULL);
+    recv_seq(&ch, ing_shmchan_max_msg(&ch), 1);
+    TEST_CHECK(ing_shmchan_peek(&ch, &ptr, &len, 0) == ING_STAT_NOT_FOUND);
+
+    ing_shmchan_close(&ch);
+}
+
+/* lengths written by a broken peer must not point past the ring or head */
+static void test_shmchan_corrupted(void)
+{
+    ing_shmchan_t ch;
+    const void *ptr;
+    size_t len;
+    uint32_t *rec;
+    int i;
+
+    TEST_OK(ing_shmchan_create(&ch, "test", CAPACITY));
+
+    /* move the ring positions to CAPACITY - 64 with 1008 byte records */
+    for (i = 0; i < 4; i++)
+    {
+        send_seq(&ch, 1000, 1);
+        recv_seq(&ch, 1000, 1);
+    }
+
+    /* a record at CAPACITY - 64, a wrap header and a record at 0 */
+    send_seq(&ch, 8, 2);
+    send_seq(&ch, 100, 3);
+    rec = (uint32_t *)(ch.data + CAPACITY - 64);
+    TEST_CHECK(*rec == 8);
+
+    /* within head, but crosses the end of the ring */
+    *rec = 160;
+    TEST_CHECK(ing_shmchan_peek(&ch, &ptr, &len, 0) == ING_STAT_GENERAL_ERROR);
+
+    /* beyond head */
+    *rec = 1000;
+    TEST_CHECK(ing_shmchan_peek(&ch, &ptr, &len, 0) == ING_STAT_GENERAL_ERROR);
+
+    /* larger than any message */
+    *rec = 0x7fffffff;
+    TEST_CHECK(ing_shmchan_peek(&ch, &ptr, &len, 0) == ING_STAT_GENERAL_ERROR);
+
+    /* a wrap header at the tail of a ring that was not wrapped */
+    *rec = 8;
+    recv_seq(&ch, 8, 2);
+    recv_seq(&ch, 100, 3);
+    send_seq(&ch, 8, 4);
+    rec = (uint32_t *)(ch.data + 112);
+    TEST_CHECK(*rec == 8);
+    *rec = 0xffffffffu;
+    TEST_CHECK(ing_shmchan_peek(&ch, &ptr, &len, 0) == ING_STAT_GENERAL_ERROR);
+
+    ing_shmchan_close(&ch);
+}
+
+int main(void)
+{
+    TEST_RUN(test_shmchan_order);
+
+    /* corrupted channels are logged as errors */
+    ing_log_set_level(LOG_CRIT);
+    TEST_RUN(test_shmchan_corrupted);
+    return 0;
+}
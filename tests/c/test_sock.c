@@ -0,0 +1,357 @@
+/* test_sock.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of batched datagram I/O
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "ing_log.h"
+#include "ing_sock.h"
+#include "ing_test.h"
+
+#define BATCH_MAX   64
+#define MSG_SIZE    32
+
+static int udp_socket(struct sockaddr_in *addr)
+{
+    socklen_t len = sizeof(*addr);
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    TEST_CHECK(fd >= 0);
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_CHECK(bind(fd, (struct sockaddr *)addr, sizeof(*addr)) == 0);
+    TEST_CHECK(getsockname(fd, (struct sockaddr *)addr, &len) == 0);
+    return fd;
+}
+
+static void fill_msg(char *buf, int seq)
+{
+    memset(buf, 'a' + seq % 26, MSG_SIZE);
+    memcpy(buf, &seq, sizeof(seq));
+}
+
+static int msg_seq(const char *buf)
+{
+    int seq;
+
+    memcpy(&seq, buf, sizeof(seq));
+    return seq;
+}
+
+/* datagrams to an address, source addresses and truncation on receive */
+static void test_sock_udp(void)
+{
+    struct sockaddr_in a, b;
+    ing_sock_batch_t out, in;
+    char buf[MSG_SIZE * 2];
+    int sa, sb, i;
+
+    sa = udp_socket(&a);
+    sb = udp_socket(&b);
+    TEST_CHECK(ing_sock_batch_init(&out, 0, MSG_SIZE) == ING_STAT_INVALID_ARGUMENT);
+    TEST_OK(ing_sock_batch_init(&out, BATCH_MAX, MSG_SIZE * 2));
+    TEST_OK(ing_sock_batch_init(&in, BATCH_MAX, MSG_SIZE));
+
+    TEST_CHECK(ing_sock_recv_batch(sb, &in, 0) == 0);
+
+    for (i = 0; i < BATCH_MAX; i++)
+    {
+        fill_msg(buf, i);
+        TEST_OK(ing_sock_batch_add(&out, buf, i == 5 ? MSG_SIZE * 2 : MSG_SIZE,
+            (struct sockaddr *)&b, sizeof(b)));
+    }
+    TEST_CHECK(ing_sock_batch_add(&out, buf, 1, NULL, 0) == ING_STAT_FULL);
+    TEST_CHECK(ing_sock_batch_add(&out, buf, MSG_SIZE * 2 + 1, NULL, 0) == ING_STAT_INVALID_ARGUMENT);
+    TEST_CHECK(ing_sock_send_batch(sa, &out, 0) == BATCH_MAX);
+    TEST_CHECK(out.count == 0 && out.sent == 0);
+
+    TEST_CHECK(ing_sock_recv_batch(sb, &in, 0) == BATCH_MAX);
+    for (i = 0; i < BATCH_MAX; i++)
+    {
+        struct sockaddr_in *from = (struct sockaddr_in *)ing_sock_batch_addr(&in, i);
+
+        TEST_CHECK(msg_seq(ing_sock_batch_data(&in, i)) == i);
+        TEST_CHECK(ing_sock_batch_len(&in, i) == MSG_SIZE);
+        TEST_CHECK(ing_sock_batch_truncated(&in, i) == (i == 5));
+        TEST_CHECK(ing_sock_batch_addrlen(&in, i) == sizeof(a));
+        TEST_CHECK(from->sin_port == a.sin_port && from->sin_addr.s_addr == a.sin_addr.s_addr);
+    }
+    TEST_CHECK(ing_sock_recv_batch(sb, &in, 0) == 0);
+
+    ing_sock_batch_destroy(&out);
+    ing_sock_batch_destroy(&in);
+    close(sa);
+    close(sb);
+}
+
+/* the receiver queue takes only part of the batch: the rest stays queued,
+ * in order, and datagrams added meanwhile go after it
+ */
+static void test_sock_partial(void)
+{
+    ing_sock_batch_t out, in;
+    char buf[MSG_SIZE];
+    int sv[2], i, n, sent = 0, received = 0, seq = 0, sndbuf = 1;
+
+    /* the smallest send buffer holds a few datagrams only */
+    TEST_CHECK(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) == 0);
+    TEST_CHECK(setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) == 0);
+    TEST_OK(ing_sock_batch_init(&out, BATCH_MAX, MSG_SIZE));
+    TEST_OK(ing_sock_batch_init(&in, BATCH_MAX, MSG_SIZE));
+
+    for (i = 0; i < BATCH_MAX / 2; i++)
+    {
+        fill_msg(buf, seq++);
+        TEST_OK(ing_sock_batch_add(&out, buf, MSG_SIZE, NULL, 0));
+    }
+
+    n = ing_sock_send_batch(sv[0], &out, 0);
+    TEST_CHECK(n > 0 && n < BATCH_MAX / 2);
+    TEST_CHECK(out.sent == n && out.count == BATCH_MAX / 2);
+    sent += n;
+
+    /* the queue is full: nothing more is sent, nothing is lost */
+    TEST_CHECK(ing_sock_send_batch(sv[0], &out, 0) == 0);
+    TEST_CHECK(out.sent == n);
+
+    /* requeue more while the rest is pending */
+    while (out.count < BATCH_MAX)
+    {
+        fill_msg(buf, seq++);
+        TEST_OK(ing_sock_batch_add(&out, buf, MSG_SIZE, NULL, 0));
+    }
+
+    while (received < seq)
+    {
+        n = ing_sock_recv_batch(sv[1], &in, 0);
+        TEST_CHECK(n >= 0);
+        for (i = 0; i < n; i++)
+            TEST_CHECK(msg_seq(ing_sock_batch_data(&in, i)) == received++);
+        if (sent < seq)
+        {
+            n = ing_sock_send_batch(sv[0], &out, 0);
+            TEST_CHECK(n >= 0);
+            sent += n;
+        }
+    }
+    TEST_CHECK(sent == seq && out.count == 0 && out.sent == 0);
+
+    ing_sock_batch_destroy(&out);
+    ing_sock_batch_destroy(&in);
+    close(sv[0]);
+    close(sv[1]);
+}
+
+/* number of open descriptors of the process */
+static int count_fds(void)
+{
+    int fd, n = 0;
+
+    for (fd = 0; fd < 1024; fd++)
+        n += fcntl(fd, F_GETFD) >= 0;
+    return n;
+}
+
+/* sends a datagram with nfds copies of fd, bypassing the ING_SOCK_MAX_FDS limit */
+static void send_raw_fds(int sock, const void *data, size_t len, int fd, int nfds)
+{
+    union {
+        char buf[CMSG_SPACE(64 * sizeof(int))];
+        struct cmsghdr align;
+    } ctrl;
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    int i;
+
+    iov.iov_base = (void *)data;
+    iov.iov_len = len;
+    memset(&msg, 0, sizeof(msg));
+    memset(&ctrl, 0, sizeof(ctrl));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = CMSG_SPACE(nfds * sizeof(int));
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(nfds * sizeof(int));
+    for (i = 0; i < nfds; i++)
+        memcpy(CMSG_DATA(cmsg) + i * sizeof(int), &fd, sizeof(int));
+    TEST_CHECK(sendmsg(sock, &msg, 0) == (ssize_t)len);
+}
+
+/* truncated data or descriptors are errors and leak no descriptors */
+static void test_sock_fds(void)
+{
+    char buf[MSG_SIZE];
+    int sv[2], fds[ING_SOCK_MAX_FDS], nfds, open_fds;
+    size_t len;
+
+    TEST_CHECK(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) == 0);
+    open_fds = count_fds();
+
+    TEST_OK(ing_sock_send_fds(sv[0], NULL, 0, "hello", 5, &sv[0], 1));
+    len = sizeof(buf);
+    nfds = ING_SOCK_MAX_FDS;
+    TEST_OK(ing_sock_recv_fds(sv[1], buf, &len, fds, &nfds, NULL, NULL, 0));
+    TEST_CHECK(len == 5 && memcmp(buf, "hello", 5) == 0 && nfds == 1);
+    TEST_CHECK(fcntl(fds[0], F_GETFD) == FD_CLOEXEC);
+    close(fds[0]);
+
+    /* descriptors only */
+    TEST_OK(ing_sock_send_fds(sv[0], NULL, 0, NULL, 0, &sv[0], 2));
+    len = 0;
+    nfds = ING_SOCK_MAX_FDS;
+    TEST_OK(ing_sock_recv_fds(sv[1], NULL, &len, fds, &nfds, NULL, NULL, 0));
+    TEST_CHECK(len == 0 && nfds == 2);
+    close(fds[0]);
+    close(fds[1]);
+
+    /* more descriptors than asked for are closed */
+    TEST_OK(ing_sock_send_fds(sv[0], NULL, 0, "x", 1, &sv[0], 3));
+    len = sizeof(buf);
+    nfds = 1;
+    TEST_OK(ing_sock_recv_fds(sv[1], buf, &len, fds, &nfds, NULL, NULL, 0));
+    TEST_CHECK(nfds == 1);
+    close(fds[0]);
+    TEST_CHECK(count_fds() == open_fds);
+
+    /* data longer than the buffer */
+    TEST_OK(ing_sock_send_fds(sv[0], NULL, 0, "hello", 5, &sv[0], 2));
+    len = 4;
+    nfds = ING_SOCK_MAX_FDS;
+    TEST_CHECK(ing_sock_recv_fds(sv[1], buf, &len, fds, &nfds, NULL, NULL, 0) == ING_STAT_GENERAL_ERROR);
+    TEST_CHECK(nfds == 0 && count_fds() == open_fds);
+
+    /* more descriptors than the control buffer takes */
+    send_raw_fds(sv[0], "x", 1, sv[0], ING_SOCK_MAX_FDS + 4);
+    len = sizeof(buf);
+    nfds = ING_SOCK_MAX_FDS;
+    TEST_CHECK(ing_sock_recv_fds(sv[1], buf, &len, fds, &nfds, NULL, NULL, 0) == ING_STAT_GENERAL_ERROR);
+    TEST_CHECK(nfds == 0 && count_fds() == open_fds);
+
+    len = sizeof(buf);
+    nfds = ING_SOCK_MAX_FDS;
+    TEST_CHECK(ing_sock_recv_fds(sv[1], buf, &len, fds, &nfds, NULL, NULL, 0) == ING_STAT_NOT_FOUND);
+    close(sv[0]);
+    close(sv[1]);
+}
+
+/* inline and memfd messages; an inline message longer than the buffer is an error */
+static void test_sock_msg(void)
+{
+    static char big[ING_SOCK_INLINE_MAX * 4], buf[ING_SOCK_INLINE_MAX];
+    ing_sock_msg_t msg;
+    int sv[2], sndbuf = sizeof(big);
+    size_t i;
+
+    TEST_CHECK(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) == 0);
+    TEST_CHECK(setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) == 0);
+    for (i = 0; i < sizeof(big); i++)
+        big[i] = (char)(i * 31);
+
+    TEST_OK(ing_sock_send_msg(sv[0], NULL, 0, big, ING_SOCK_INLINE_MAX));
+    TEST_OK(ing_sock_recv_msg(sv[1], buf, sizeof(buf), &msg, NULL, NULL, 0));
+    TEST_CHECK(msg.map == NULL && msg.len == ING_SOCK_INLINE_MAX && memcmp(msg.data, big, msg.len) == 0);
+    ing_sock_msg_release(&msg);
+
+    TEST_OK(ing_sock_send_msg(sv[0], NULL, 0, big, sizeof(big)));
+    TEST_OK(ing_sock_recv_msg(sv[1], buf, 16, &msg, NULL, NULL, 0));
+    TEST_CHECK(msg.map != NULL && msg.len == sizeof(big) && memcmp(msg.data, big, msg.len) == 0);
+    ing_sock_msg_release(&msg);
+
+    TEST_OK(ing_sock_send_msg(sv[0], NULL, 0, big, 100));
+    TEST_CHECK(ing_sock_recv_msg(sv[1], buf, 64, &msg, NULL, NULL, 0) == ING_STAT_GENERAL_ERROR);
+    TEST_CHECK(ing_sock_recv_msg(sv[1], buf, 8, &msg, NULL, NULL, 0) == ING_STAT_INVALID_ARGUMENT);
+    TEST_CHECK(ing_sock_recv_msg(sv[1], buf, sizeof(buf), &msg, NULL, NULL, 0) == ING_STAT_NOT_FOUND);
+
+    close(sv[0]);
+    close(sv[1]);
+}
+
+int main(void)
+{
+    TEST_RUN(test_sock_udp);
+    TEST_RUN(test_sock_partial);
+
+    /* truncated messages are logged as errors */
+    ing_log_set_level(LOG_CRIT);
+    TEST_RUN(test_sock_fds);
+    TEST_RUN(test_sock_msg);
+    return 0;
+}
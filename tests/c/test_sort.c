@@ -0,0 +1,307 @@
+/* test_sort.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of radix and merge sort of record pointers and of sorted container views
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ing_container.h"
+#include "ing_test.h"
+
+#define NUM_SMALL   1000
+#define NUM_LARGE   (ING_SORT_PARALLEL_MIN * 3)
+
+typedef struct rec_s
+{
+    uint8_t u8;
+    int8_t i8;
+    uint16_t u16;
+    int16_t i16;
+    uint32_t u32;
+    int32_t i32;
+    uint64_t u64;
+    int64_t i64;
+    unsigned char bytes[5];
+    int seq;                /* original position, checks stability */
+    UT_hash_handle hh;
+} rec_t;
+
+GENERATE_DB_TYPE(rec_t)
+GENERATE_DB_DECLARATIONS(rec_t, seq)
+GENERATE_DB_FUNCTIONS(rec_t, seq)
+
+/* reference comparison by a key and then by the original position */
+static size_t ref_off, ref_size;
+static ing_sort_key_t ref_type;
+
+static int ref_cmp_key(const rec_t *a, const rec_t *b)
+{
+    const void *ka = (const char *)a + ref_off;
+    const void *kb = (const char *)b + ref_off;
+
+    if (ref_type == ING_SORT_KEY_BYTES)
+        return memcmp(ka, kb, ref_size);
+
+#define REF_CMP(type) \
+    do { \
+        type x, y; \
+        memcpy(&x, ka, sizeof(x)); \
+        memcpy(&y, kb, sizeof(y)); \
+        return (x > y) - (x < y); \
+    } while (0)
+
+    switch (ref_size)
+    {
+    case 1: if (ref_type == ING_SORT_KEY_INT) REF_CMP(int8_t); else REF_CMP(uint8_t);
+    case 2: if (ref_type == ING_SORT_KEY_INT) REF_CMP(int16_t); else REF_CMP(uint16_t);
+    case 4: if (ref_type == ING_SORT_KEY_INT) REF_CMP(int32_t); else REF_CMP(uint32_t);
+    default: if (ref_type == ING_SORT_KEY_INT) REF_CMP(int64_t); else REF_CMP(uint64_t);
+    }
+#undef REF_CMP
+}
+
+static int ref_cmp_stable(const void *pa, const void *pb)
+{
+    const rec_t *a = *(rec_t * const *)pa;
+    const rec_t *b = *(rec_t * const *)pb;
+    int res = ref_cmp_key(a, b);
+
+    return res ? res : (a->seq > b->seq) - (a->seq < b->seq);
+}
+
+/* record comparison for ing_sort_ptrs(), deliberately ignores seq */
+static int cmp_i32(const void *a, const void *b)
+{
+    int32_t x = ((const rec_t *)a)->i32, y = ((const rec_t *)b)->i32;
+
+    return (x > y) - (x < y);
+}
+
+/* fills records with random keys from a narrow range, so there are many duplicates */
+static void fill_records(rec_t *recs, size_t n, unsigned long long seed)
+{
+    size_t i;
+
+    memset(recs, 0, n * sizeof(*recs));
+    for (i = 0; i < n; i++)
+    {
+        unsigned long long r = test_rand(&seed);
+        int64_t v = (int64_t)(r % 64) - 32;
+
+        recs[i].u8 = (uint8_t)(r >> 8);
+        recs[i].i8 = (int8_t)v;
+        recs[i].u16 = (uint16_t)(r >> 16) & 0x81FF;
+        recs[i].i16 = (int16_t)(v * 1000);
+        recs[i].u32 = (uint32_t)(r >> 24) & 0x800000FF;
+        recs[i].i32 = (int32_t)(v * 100000000);
+        recs[i].u64 = (r % 3) << 62 | (r % 50);
+        recs[i].i64 = v * 1000000000000LL;
+        recs[i].bytes[0] = (unsigned char)(r % 3);
+        recs[i].bytes[4] = (unsigned char)(r >> 40);
+        recs[i].seq = (int)i;
+    }
+}
+
+static void check_sorted(rec_t *recs, size_t n, size_t off, size_t size, ing_sort_key_t type,
+    int nthreads)
+{
+    void **ptrs = malloc(n * sizeof(void *));
+    void **ref = malloc(n * sizeof(void *));
+    size_t i;
+
+    TEST_CHECK(ptrs && ref);
+    for (i = 0; i < n; i++)
+        ptrs[i] = ref[i] = &recs[i];
+
+    ref_off = off;
+    ref_size = size;
+    ref_type = type;
+    qsort(ref, n, sizeof(void *), ref_cmp_stable);
+
+    TEST_OK(ing_sort_ptrs_by_key(ptrs, n, off, size, type, nthreads));
+    TEST_CHECK(memcmp(ptrs, ref, n * sizeof(void *)) == 0);
+
+    free(ptrs);
+    free(ref);
+}
+
+#define CHECK_KEY(recs, n, field, type, nthreads) \
+    check_sorted(recs, n, offsetof(rec_t, field), FIELD_SIZE(rec_t, field), type, nthreads)
+
+static void check_all_keys(rec_t *recs, size_t n, int nthreads)
+{
+    CHECK_KEY(recs, n, u8, ING_SORT_KEY_UINT, nthreads);
+    CHECK_KEY(recs, n, i8, ING_SORT_KEY_INT, nthreads);
+    CHECK_KEY(recs, n, u16, ING_SORT_KEY_UINT, nthreads);
+    CHECK_KEY(recs, n, i16, ING_SORT_KEY_INT, nthreads);
+    CHECK_KEY(recs, n, u32, ING_SORT_KEY_UINT, nthreads);
+    CHECK_KEY(recs, n, i32, ING_SORT_KEY_INT, nthreads);
+    CHECK_KEY(recs, n, u64, ING_SORT_KEY_UINT, nthreads);
+    CHECK_KEY(recs, n, i64, ING_SORT_KEY_INT, nthreads);
+    CHECK_KEY(recs, n, bytes, ING_SORT_KEY_BYTES, nthreads);
+    CHECK_KEY(recs, n, u32, ING_SORT_KEY_BYTES, nthreads);
+}
+
+static void test_sort_by_key(void)
+{
+    static rec_t recs[NUM_SMALL];
+    size_t n;
+
+    for (n = 0; n <= 3; n++)
+    {
+        fill_records(recs, n, 1);
+        check_all_keys(recs, n, 1);
+    }
+
+    fill_records(recs, NUM_SMALL, 2);
+    check_all_keys(recs, NUM_SMALL, 1);
+}
+
+/* merge sort with a comparison function, single and multi-threaded */
+static void test_sort_cmp_stable(void)
+{
+    rec_t *recs = malloc(NUM_LARGE * sizeof(rec_t));
+    void **ptrs = malloc(NUM_LARGE * sizeof(void *));
+    void **ref = malloc(NUM_LARGE * sizeof(void *));
+    int nthreads[] = { 1, 4, 0 };
+    size_t i, t;
+
+    TEST_CHECK(recs && ptrs && ref);
+    fill_records(recs, NUM_LARGE, 3);
+    for (i = 0; i < NUM_LARGE; i++)
+        ref[i] = &recs[i];
+    ref_off = offsetof(rec_t, i32);
+    ref_size = sizeof(int32_t);
+    ref_type = ING_SORT_KEY_INT;
+    qsort(ref, NUM_LARGE, sizeof(void *), ref_cmp_stable);
+
+    for (t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); t++)
+    {
+        for (i = 0; i < NUM_LARGE; i++)
+            ptrs[i] = &recs[i];
+        TEST_OK(ing_sort_ptrs(ptrs, NUM_LARGE, cmp_i32, nthreads[t]));
+        TEST_CHECK(memcmp(ptrs, ref, NUM_LARGE * sizeof(void *)) == 0);
+    }
+
+    /* radix sort of a large array */
+    CHECK_KEY(recs, NUM_LARGE, i64, ING_SORT_KEY_INT, 0);
+    CHECK_KEY(recs, NUM_LARGE, bytes, ING_SORT_KEY_BYTES, 4);
+
+    free(recs);
+    free(ptrs);
+    free(ref);
+}
+
+/* sorted views of a container, records stay in place */
+static void test_sorted_views(void)
+{
+    static rec_t recs[NUM_SMALL];
+    IC_DB_TYPE(rec_t) db;
+    ing_view_t view;
+    int i;
+
+    fill_records(recs, NUM_SMALL, 4);
+    TEST_OK(IC_INIT(rec_t, &db, NUM_SMALL));
+    for (i = NUM_SMALL - 1; i >= 0; i--)
+        TEST_OK(IC_ADD(rec_t, &db, &recs[i]));
+
+    TEST_OK(IC_SORTED_VIEW_BY_KEY(rec_t, &db, &view, ING_SORT_KEY_INT));
+    TEST_CHECK(view.count == NUM_SMALL);
+    for (i = 0; i < view.count; i++)
+        TEST_CHECK(IC_VIEW_AT(rec_t, &view, i)->seq == i);
+    IC_VIEW_FREE(&view);
+
+    TEST_OK(IC_SORTED_VIEW_BY_FIELD(rec_t, &db, &view, i16, ING_SORT_KEY_INT));
+    for (i = 1; i < view.count; i++)
+    {
+        rec_t *a = IC_VIEW_AT(rec_t, &view, i - 1), *b = IC_VIEW_AT(rec_t, &view, i);
+        TEST_CHECK(a->i16 <= b->i16);
+    }
+    IC_VIEW_FREE(&view);
+
+    TEST_OK(IC_SORTED_VIEW(rec_t, &db, &view, cmp_i32, 1));
+    for (i = 1; i < view.count; i++)
+    {
+        rec_t *a = IC_VIEW_AT(rec_t, &view, i - 1), *b = IC_VIEW_AT(rec_t, &view, i);
+        TEST_CHECK(a->i32 <= b->i32);
+    }
+    IC_VIEW_FREE(&view);
+
+    TEST_OK(IC_DESTROY(rec_t, &db));
+}
+
+int main(void)
+{
+    TEST_RUN(test_sort_by_key);
+    TEST_RUN(test_sort_cmp_stable);
+    TEST_RUN(test_sorted_views);
+    return 0;
+}
@@ -0,0 +1,282 @@
+/* test_strbuf.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the string buffer: heap and fixed storage, replace against a
+ * naive implementation, formatting, split and the legacy wrappers
+ */
+
+#include <string.h>
+#include <stdarg.h>
+
+#include "ing_strbuf.h"
+#include "ing_test.h"
+
+/* replaces up to max (0 - all) occurrences, scanning left to right */
+static char *naive_replace(const char *s, const char *pat, const char *rep, size_t max, size_t *count)
+{
+    size_t plen = strlen(pat), rlen = strlen(rep), n = 0;
+    char *out = (char *)malloc(strlen(s) * (rlen + 1) + 1), *o = out;
+
+    while (*s)
+    {
+        if ((!max || n < max) && !strncmp(s, pat, plen))
+        {
+            memcpy(o, rep, rlen);
+            o += rlen;
+            s += plen;
+            n++;
+        }
+        else
+            *o++ = *s++;
+    }
+    *o = '\0';
+    *count = n;
+    return out;
+}
+
+static void check_replace(const char *s, const char *pat, const char *rep, size_t max)
+{
+    ing_strbuf_t sb = ING_STRBUF_INIT;
+    size_t count, expect_count;
+    char *expect = naive_replace(s, pat, rep, max, &expect_count);
+
+    TEST_OK(ing_strbuf_set(&sb, s, strlen(s)));
+    TEST_OK(ing_strbuf_replace(&sb, pat, rep, max, &count));
+    TEST_CHECK(count == expect_count && sb.len == strlen(expect));
+    TEST_CHECK(strcmp(ing_strbuf_str(&sb), expect) == 0);
+    ing_strbuf_destroy(&sb);
+    free(expect);
+}
+
+static void test_strbuf_replace(void)
+{
+    static const char *reps[] = { "", "x", "yy", "zzz", "0123456789" };
+    unsigned long long seed = 1;
+    char s[200], pat[4];
+    size_t len, plen, max;
+    int i, j;
+
+    /* growing and shrinking, all or the first max */
+    check_replace("aXbXcX", "X", "long", 0);
+    check_replace("aXbXcX", "X", "long", 2);
+    check_replace("aLONGbLONGc", "LONG", "s", 0);
+    check_replace("aLONGbLONGc", "LONG", "s", 1);
+    check_replace("aaaa", "aa", "b", 0);
+    check_replace("aaa", "aa", "aaa", 0);
+    check_replace("XXXX", "X", "", 3);
+    check_replace("none here", "X", "long", 0);
+
+    /* random strings over a small alphabet, so patterns repeat and overlap */
+    for (i = 0; i < 20000; i++)
+    {
+        len = test_rand(&seed) % sizeof(s);
+        for (j = 0; j < (int)len; j++)
+            s[j] = 'a' + test_rand(&seed) % 3;
+        s[len] = '\0';
+        plen = 1 + test_rand(&seed) % 3;
+        for (j = 0; j < (int)plen; j++)
+            pat[j] = 'a' + test_rand(&seed) % 3;
+        pat[plen] = '\0';
+        max = test_rand(&seed) % 4;
+        check_replace(s, pat, reps[test_rand(&seed) % 5], max);
+    }
+}
+
+static void test_strbuf_fixed(void)
+{
+    char buf[16];
+    ing_strbuf_t sb;
+    size_t count = 99;
+
+    strcpy(buf, "abcabc");
+    TEST_OK(ing_strbuf_init_fixed(&sb, buf, sizeof(buf), 6));
+    TEST_CHECK(ing_strbuf_init_fixed(&sb, buf, 6, 6) == ING_STAT_INVALID_ARGUMENT);
+    TEST_OK(ing_strbuf_init_fixed(&sb, buf, sizeof(buf), 6));
+
+    /* does not fit: ING_STAT_FULL, string unchanged */
+    TEST_CHECK(ing_strbuf_replace(&sb, "b", "0123456", 0, &count) == ING_STAT_FULL && count == 0);
+    TEST_CHECK(sb.len == 6 && strcmp(buf, "abcabc") == 0);
+    TEST_CHECK(ing_strbuf_append_str(&sb, "0123456789") == ING_STAT_FULL);
+    TEST_CHECK(ing_strbuf_appendf(&sb, "%d", 1234567890) == ING_STAT_FULL);
+    TEST_CHECK(ing_strbuf_set(&sb, "0123456789abcdefg", 17) == ING_STAT_FULL);
+    TEST_CHECK(sb.len == 6 && strcmp(buf, "abcabc") == 0);
+
+    /* exactly fits */
+    TEST_OK(ing_strbuf_replace(&sb, "b", "01234", 0, &count));
+    TEST_CHECK(count == 2 && sb.len == 14 && strcmp(buf, "a01234ca01234c") == 0);
+    TEST_OK(ing_strbuf_appendc(&sb, '!'));
+    TEST_CHECK(ing_strbuf_appendc(&sb, '?') == ING_STAT_FULL && strcmp(buf, "a01234ca01234c!") == 0);
+    TEST_OK(ing_strbuf_replace(&sb, "01234", "", 0, &count));
+    TEST_CHECK(count == 2 && strcmp(buf, "acac!") == 0 && sb.len == 5);
+    TEST_CHECK(ing_strbuf_replace(&sb, "", "x", 0, &count) == ING_STAT_INVALID_ARGUMENT);
+}
+
+static ing_stat_t appendf(ing_strbuf_t *sb, const char *fmt, ...)
+{
+    ing_stat_t rc;
+    va_list ap;
+
+    va_start(ap, fmt);
+    rc = ing_strbuf_vappendf(sb, fmt, ap);
+    va_end(ap);
+    return rc;
+}
+
+static void test_strbuf_format(void)
+{
+    ing_strbuf_t sb;
+    char expect[4096], *s;
+    int i, n = 0;
+
+    /* each append outgrows the capacity, so the va_list is used twice */
+    TEST_OK(ing_strbuf_init(&sb, 1));
+    for (i = 0; i < 40; i++)
+    {
+        TEST_OK(appendf(&sb, "%d:%s:%0*d;", i, "text", i, i));
+        n += snprintf(expect + n, sizeof(expect) - n, "%d:%s:%0*d;", i, "text", i, i);
+        TEST_CHECK(sb.len == (size_t)n && strcmp(sb.ptr, expect) == 0 && sb.cap > sb.len);
+    }
+    ing_strbuf_trim(&sb);
+    TEST_CHECK(strcmp(sb.ptr, expect) == 0);
+    s = ing_strbuf_detach(&sb);
+    TEST_CHECK(strcmp(s, expect) == 0 && sb.ptr == NULL && sb.len == 0);
+    free(s);
+
+    TEST_OK(ing_strbuf_set(&sb, " \t trimmed \r\n", 13));
+    ing_strbuf_trim(&sb);
+    TEST_CHECK(strcmp(sb.ptr, "trimmed") == 0 && sb.len == 7);
+    ing_strbuf_clear(&sb);
+    TEST_CHECK(sb.len == 0 && strcmp(ing_strbuf_str(&sb), "") == 0);
+    ing_strbuf_destroy(&sb);
+}
+
+static void test_strbuf_split(void)
+{
+    ing_strbuf_t sb = ING_STRBUF_INIT;
+    ing_strview_t v[3];
+
+    TEST_CHECK(ing_strbuf_split(&sb, ',', v, 3) == 1 && v[0].len == 0);
+    TEST_OK(ing_strbuf_set(&sb, "a,,bc,d,", 8));
+    TEST_CHECK(ing_strbuf_split(&sb, ',', NULL, 0) == 5);
+
+    /* more fields than views: the first max are stored, all are counted */
+    TEST_CHECK(ing_strbuf_split(&sb, ',', v, 3) == 5);
+    TEST_CHECK(v[0].len == 1 && v[0].ptr == sb.ptr);
+    TEST_CHECK(v[1].len == 0 && v[1].ptr == sb.ptr + 2);
+    TEST_CHECK(v[2].len == 2 && !strncmp(v[2].ptr, "bc", 2));
+    TEST_CHECK(ing_strbuf_split(&sb, ';', v, 3) == 1 && v[0].len == 8);
+    ing_strbuf_destroy(&sb);
+}
+
+/* legacy wrappers keep their return values */
+static void test_strbuf_wrappers(void)
+{
+    char buf[8];
+
+    strcpy(buf, "ab");
+    TEST_CHECK(strcat_safe(buf, "cdefg", sizeof(buf)) == buf && strcmp(buf, "abcdefg") == 0);
+    TEST_CHECK(strcat_safe(buf, "h", sizeof(buf)) == NULL && strcmp(buf, "abcdefg") == 0);
+    TEST_CHECK(strcat_safe(NULL, "h", sizeof(buf)) == NULL);
+    TEST_CHECK(strcat_safe(buf, NULL, sizeof(buf)) == NULL);
+    TEST_CHECK(strcat_safe(buf, "", 4) == NULL);    /* to is longer than to_len */
+
+    TEST_CHECK(strcpy_safe(buf, "1234567", sizeof(buf)) == buf && strcmp(buf, "1234567") == 0);
+    TEST_CHECK(strcpy_safe(buf, "12345678", sizeof(buf)) == NULL && strcmp(buf, "1234567") == 0);
+    TEST_CHECK(strcpy_safe(NULL, "1", sizeof(buf)) == NULL);
+    TEST_CHECK(strcpy_safe(buf, NULL, sizeof(buf)) == NULL);
+    TEST_CHECK(strcpy_safe(buf, "", 0) == NULL);
+
+    strcpy(buf, "a$Xb");
+    TEST_CHECK(str_replace(buf, sizeof(buf), "$X", "123") == 0 && strcmp(buf, "a123b") == 0);
+    TEST_CHECK(str_replace(buf, sizeof(buf), "2", "") == 0 && strcmp(buf, "a13b") == 0);
+    TEST_CHECK(str_replace(buf, sizeof(buf), "$X", "1") == 2 && strcmp(buf, "a13b") == 0);
+    TEST_CHECK(str_replace(buf, sizeof(buf), "1", "xyzwv") == 3 && strcmp(buf, "a13b") == 0);
+    TEST_CHECK(str_replace(buf, sizeof(buf), "1", "xyz") == 0 && strcmp(buf, "axyz3b") == 0);
+    TEST_CHECK(str_replace(NULL, sizeof(buf), "1", "x") == 1);
+    TEST_CHECK(str_replace(buf, sizeof(buf), NULL, "x") == 1);
+    TEST_CHECK(str_replace(buf, sizeof(buf), "1", NULL) == 1);
+    TEST_CHECK(str_replace(buf, 3, "x", "y") == 3);    /* str is longer than str_size */
+
+    /* an empty placeholder matches at the start, as before */
+    strcpy(buf, "abc");
+    TEST_CHECK(str_replace(buf, sizeof(buf), "", "12") == 0 && strcmp(buf, "12abc") == 0);
+    TEST_CHECK(str_replace(buf, sizeof(buf), "", "34") == 0 && strcmp(buf, "3412abc") == 0);
+    TEST_CHECK(str_replace(buf, sizeof(buf), "", "5") == 3 && strcmp(buf, "3412abc") == 0);
+    TEST_CHECK(str_replace(buf, sizeof(buf), "", "") == 0 && strcmp(buf, "3412abc") == 0);
+}
+
+int main(void)
+{
+    TEST_RUN(test_strbuf_replace);
+    TEST_RUN(test_strbuf_fixed);
+    TEST_RUN(test_strbuf_format);
+    TEST_RUN(test_strbuf_split);
+    TEST_RUN(test_strbuf_wrappers);
+    return 0;
+}
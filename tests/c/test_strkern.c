@@ -0,0 +1,334 @@
+/* test_strkern.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the string kernels: every SSE2/AVX2 version and the string
+ * helpers built on them against scalar references, at all lengths and
+ * alignments around the 16 and 32 byte blocks
+ */
+
+#include <string.h>
+#include <ctype.h>
+
+/* the per-ISA kernels are static, so the source is included */
+#include "ing_strkern.c"
+#include "ing_gen_utils.h"
+#include "ing_test.h"
+
+#define MAX_LEN     100     /* past 3 AVX2 blocks */
+#define MAX_ALIGN   32
+
+typedef struct kernels_s
+{
+    const char *name;
+    span_fn span;
+    span_fn rspan;
+    case_fn upper;
+    case_fn lower;
+} kernels_t;
+
+static void upper_ref(char *s, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+        s[i] = (char)toupper((unsigned char)s[i]);
+}
+
+static void lower_ref(char *s, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+        s[i] = (char)tolower((unsigned char)s[i]);
+}
+
+static void upper_scalar_test(char *s, size_t len)
+{
+    case_scalar(s, len, 'a');
+}
+
+static void lower_scalar_test(char *s, size_t len)
+{
+    case_scalar(s, len, 'A');
+}
+
+static const kernels_t kernels[] = {
+    { "scalar", span_space_scalar, rspan_space_scalar, upper_scalar_test, lower_scalar_test },
+#if STRKERN_X86
+    { "sse2", span_space_sse2, rspan_space_sse2, upper_sse2, lower_sse2 },
+    { "avx2", span_space_avx2, rspan_space_avx2, upper_avx2, lower_avx2 },
+#endif
+};
+
+static int kernel_supported(const kernels_t *k)
+{
+#if STRKERN_X86
+    if (k->span == span_space_avx2)
+        return has_avx2();
+#endif
+    (void)k;
+    return 1;
+}
+
+static const char spaces[] = " \t\n\r";
+/* bytes next to the spaces and letters, and some that sign-extend */
+static const char others[] = "x\v\f\x1f!@AZaz[`{\x80\xc1\xe0\xff";
+
+static char random_space(unsigned long long *seed)
+{
+    return spaces[test_rand(seed) % (sizeof(spaces) - 1)];
+}
+
+static char random_other(unsigned long long *seed)
+{
+    return others[test_rand(seed) % (sizeof(others) - 1)];
+}
+
+/* leading and trailing runs of every length, the rest random */
+static void test_strkern_span(void)
+{
+    static char buf[MAX_ALIGN + MAX_LEN + 1];
+    unsigned long long seed = 46;
+    size_t len, run, align, i, k;
+    char *s;
+
+    for (k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+    {
+        if (!kernel_supported(&kernels[k]))
+            continue;
+        for (align = 0; align < MAX_ALIGN; align++)
+        {
+            s = buf + align;
+            for (len = 0; len <= MAX_LEN; len++)
+            {
+                for (run = 0; run <= len; run++)
+                {
+                    for (i = 0; i < len; i++)
+                        s[i] = test_rand(&seed) & 1 ? random_space(&seed) : random_other(&seed);
+
+                    for (i = 0; i < run; i++)
+                        s[i] = random_space(&seed);
+                    if (run < len)
+                        s[run] = random_other(&seed);
+                    TEST_CHECK(kernels[k].span(s, len) == run);
+                    TEST_CHECK(span_space_scalar(s, len) == run);
+
+                    for (i = 0; i < run; i++)
+                        s[len - 1 - i] = random_space(&seed);
+                    if (run < len)
+                        s[len - 1 - run] = random_other(&seed);
+                    TEST_CHECK(kernels[k].rspan(s, len) == run);
+                    TEST_CHECK(rspan_space_scalar(s, len) == run);
+                }
+            }
+        }
+    }
+}
+
+/* all byte values; bytes around the string are not touched */
+static void test_strkern_case(void)
+{
+    static char buf[256], ref[256];    /* aligned strings, or all non-zero bytes */
+    unsigned long long seed = 46;
+    size_t len, align, i, k;
+    int upper;
+
+    for (k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+    {
+        if (!kernel_supported(&kernels[k]))
+            continue;
+        for (align = 0; align < MAX_ALIGN; align++)
+        {
+            for (len = 0; len <= MAX_LEN; len++)
+            {
+                for (upper = 0; upper <= 1; upper++)
+                {
+                    for (i = 0; i < sizeof(buf); i++)
+                        buf[i] = ref[i] = (char)test_rand(&seed);
+                    if (upper)
+                    {
+                        upper_ref(ref + align, len);
+                        kernels[k].upper(buf + align, len);
+                    }
+                    else
+                    {
+                        lower_ref(ref + align, len);
+                        kernels[k].lower(buf + align, len);
+                    }
+                    TEST_CHECK(memcmp(buf, ref, sizeof(buf)) == 0);
+                }
+            }
+        }
+    }
+
+    /* str_toupper()/str_tolower() on all non-zero bytes */
+    for (i = 0; i < 255; i++)
+        buf[i] = ref[i] = (char)(i + 1);
+    buf[255] = ref[255] = '\0';
+    upper_ref(ref, 255);
+    TEST_CHECK(str_toupper(buf) == buf && memcmp(buf, ref, 256) == 0);
+    lower_ref(ref, 255);
+    TEST_CHECK(str_tolower(buf) == buf && memcmp(buf, ref, 256) == 0);
+}
+
+/* trim() as it was before the kernels, with the trailing scan fixed */
+static char *trim_ref(char *str)
+{
+    char *p;
+
+    for (p = str; *p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'; p++)
+        ;
+    memmove(str, p, strlen(p) + 1);
+    for (p = str + strlen(str) - 1;
+         p >= str && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r');
+         p--)
+        *p = '\0';
+    return str;
+}
+
+static void test_strkern_trim(void)
+{
+    static char buf[MAX_ALIGN + 2 * MAX_LEN + 1], ref[2 * MAX_LEN + 1];
+    unsigned long long seed = 46;
+    size_t lead, body, tail, align, i;
+    char *s;
+
+    TEST_CHECK(trim(NULL) == NULL);
+    for (lead = 0; lead <= 70; lead++)
+    {
+        for (tail = 0; tail <= 70; tail++)
+        {
+            body = test_rand(&seed) % 40;
+            align = test_rand(&seed) % MAX_ALIGN;
+            s = buf + align;
+            for (i = 0; i < lead + body + tail; i++)
+                s[i] = random_space(&seed);
+            for (i = 0; i < body; i++)
+                s[lead + i] = test_rand(&seed) & 1 ? random_space(&seed) : random_other(&seed);
+            if (body)
+                s[lead] = s[lead + body - 1] = 'x';
+            s[lead + body + tail] = '\0';
+            strcpy(ref, s);
+
+            TEST_CHECK(trim(s) == s);
+            TEST_CHECK(strcmp(s, trim_ref(ref)) == 0);
+            TEST_CHECK(strlen(s) == body);
+        }
+    }
+}
+
+/* rstrstr() as it was: strncmp() at every position, last first */
+static char *rstrstr_ref(const char *s1, const char *s2)
+{
+    size_t s1len = strlen(s1);
+    size_t s2len = strlen(s2);
+    const char *s;
+
+    if (s2len > s1len)
+        return NULL;
+    for (s = s1 + s1len - s2len; s >= s1; s--)
+    {
+        if (strncmp(s, s2, s2len) == 0)
+            return (char *)s;
+    }
+    return NULL;
+}
+
+static void test_strkern_rstrstr(void)
+{
+    char s1[MAX_LEN + 1], s2[8];
+    unsigned long long seed = 46;
+    size_t len, plen, i;
+    int iter;
+
+    for (len = 0; len <= MAX_LEN; len++)
+    {
+        for (iter = 0; iter < 200; iter++)
+        {
+            /* a small alphabet makes partial matches common */
+            for (i = 0; i < len; i++)
+                s1[i] = "ab"[test_rand(&seed) & 1];
+            s1[len] = '\0';
+            plen = test_rand(&seed) % sizeof(s2);
+            for (i = 0; i < plen; i++)
+                s2[i] = "ab"[test_rand(&seed) & 1];
+            s2[plen] = '\0';
+            TEST_CHECK(rstrstr(s1, s2) == rstrstr_ref(s1, s2));
+        }
+    }
+}
+
+int main(void)
+{
+    TEST_RUN(test_strkern_span);
+    TEST_RUN(test_strkern_case);
+    TEST_RUN(test_strkern_trim);
+    TEST_RUN(test_strkern_rstrstr);
+    return 0;
+}
@@ -0,0 +1,303 @@
+/* test_syslog.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the syslog sink against a local datagram socket: message
+ * format, reconnect after the server restarts and fd swaps under load
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "ing_log.h"
+#include "ing_test.h"
+
+#define NUM_THREADS     4
+#define NUM_RESTARTS    200
+
+static char sock_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+
+/* binds the "syslogd" socket at sock_path */
+static int server_open(void)
+{
+    struct sockaddr_un addr;
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    TEST_CHECK(fd >= 0);
+    unlink(sock_path);
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, sock_path);
+    TEST_CHECK(bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    return fd;
+}
+
+/* "restarts syslogd": a new socket takes the path and the fd number of srv */
+static void server_restart(int srv)
+{
+    int fd = server_open();
+
+    TEST_CHECK(dup3(fd, srv, O_CLOEXEC) == srv);
+    close(fd);
+}
+
+/* receives one datagram or returns 0 if nothing arrives */
+static int server_recv(int fd, char *buf, size_t size, int wait)
+{
+    ssize_t n = recv(fd, buf, size - 1, wait ? 0 : MSG_DONTWAIT);
+
+    if (n < 0)
+        return 0;
+    buf[n] = '\0';
+    return (int)n;
+}
+
+static void send_one(int priority, const char *msg)
+{
+    ing_strview_t sv;
+
+    sv.ptr = msg;
+    sv.len = strlen(msg);
+    TEST_OK(ing_syslog_sendv(&priority, &sv, 1));
+}
+
+#define NUM_BATCH   100
+
+/* more messages than one sendmmsg() batch; the socket queue is shorter,
+ * so they are sent from another thread while this one receives
+ */
+static void *send_batch(void *arg)
+{
+    ing_strview_t msgs[NUM_BATCH];
+    int prio[NUM_BATCH], i;
+
+    (void)arg;
+    for (i = 0; i < NUM_BATCH; i++)
+    {
+        prio[i] = LOG_USER | LOG_INFO;     /* the facility of a priority wins */
+        msgs[i].ptr = "m";
+        msgs[i].len = 1;
+    }
+    TEST_OK(ing_syslog_sendv(prio, msgs, NUM_BATCH));
+    return NULL;
+}
+
+static void test_syslog_format(void)
+{
+    pthread_t thread;
+    int i, srv, prio = LOG_INFO;
+    char buf[512], expect[64];
+
+    srv = server_open();
+    TEST_OK(ing_syslog_open(sock_path, "tst", LOG_LOCAL0, ING_SYSLOG_RFC3164));
+
+    send_one(LOG_ERR, "hello\n");
+    TEST_CHECK(server_recv(srv, buf, sizeof(buf), TRUE));
+    snprintf(expect, sizeof(expect), " tst[%d]: hello", (int)getpid());
+    TEST_CHECK(strncmp(buf, "<131>", 5) == 0);
+    TEST_CHECK(strlen(buf) > strlen(expect) && strcmp(buf + strlen(buf) - strlen(expect), expect) == 0);
+
+    TEST_CHECK(pthread_create(&thread, NULL, send_batch, NULL) == 0);
+    for (i = 0; i < NUM_BATCH; i++)
+    {
+        TEST_CHECK(server_recv(srv, buf, sizeof(buf), TRUE));
+        TEST_CHECK(strncmp(buf, "<14>", 4) == 0 && buf[strlen(buf) - 1] == 'm');
+    }
+    pthread_join(thread, NULL);
+
+    ing_syslog_close();
+    TEST_OK(ing_syslog_open(sock_path, "tst", LOG_LOCAL0, ING_SYSLOG_RFC5424));
+    send_one(LOG_INFO, "five");
+    TEST_CHECK(server_recv(srv, buf, sizeof(buf), TRUE));
+    TEST_CHECK(strncmp(buf, "<134>1 ", 7) == 0 && strstr(buf, " tst ") && strstr(buf, " - - five"));
+
+    ing_syslog_close();
+    TEST_CHECK(ing_syslog_sendv(&prio, (ing_strview_t[]){ { "x", 1 } }, 1) == ING_STAT_GENERAL_ERROR);
+    close(srv);
+}
+
+/* the server goes away and comes back at the same path */
+static void test_syslog_reconnect(void)
+{
+    char buf[512];
+    int srv, prio = LOG_INFO;
+
+    srv = server_open();
+    TEST_OK(ing_syslog_open(sock_path, "tst", LOG_USER, ING_SYSLOG_RFC3164));
+    send_one(LOG_INFO, "before");
+    TEST_CHECK(server_recv(srv, buf, sizeof(buf), TRUE) && strstr(buf, "before"));
+
+    close(srv);
+    srv = server_open();
+    send_one(LOG_INFO, "after");
+    TEST_CHECK(server_recv(srv, buf, sizeof(buf), TRUE) && strstr(buf, "after"));
+
+    close(srv);
+    unlink(sock_path);
+    TEST_CHECK(ing_syslog_sendv(&prio, (ing_strview_t[]){ { "x", 1 } }, 1) == ING_STAT_SYSTEM_ERROR);
+
+    ing_syslog_close();
+}
+
+static int stop;
+static int server_fd;
+static long received;
+
+static void *sender(void *arg)
+{
+    ing_strview_t sv = { "load", 4 };
+    int prio = LOG_INFO;
+
+    (void)arg;
+    while (!__atomic_load_n(&stop, __ATOMIC_ACQUIRE))
+        ing_syslog_sendv(&prio, &sv, 1);
+    return NULL;
+}
+
+/* keeps the server queue short, so senders do not block for long */
+static void *drainer(void *arg)
+{
+    char buf[512];
+
+    (void)arg;
+    while (!__atomic_load_n(&stop, __ATOMIC_ACQUIRE))
+    {
+        if (server_recv(server_fd, buf, sizeof(buf), FALSE))
+            received++;
+        else
+            usleep(10);
+    }
+    return NULL;
+}
+
+/* senders keep sending while the server restarts and the sink is closed
+ * and reopened: an fd the sink gave up must never receive their messages
+ */
+static void test_syslog_swap(void)
+{
+    pthread_t threads[NUM_THREADS], drain;
+    char buf[512];
+    int i, t, probe[2];
+
+    server_fd = server_open();
+    TEST_OK(ing_syslog_open(sock_path, "tst", LOG_USER, ING_SYSLOG_RFC3164));
+    TEST_CHECK(pthread_create(&drain, NULL, drainer, NULL) == 0);
+    for (t = 0; t < NUM_THREADS; t++)
+        TEST_CHECK(pthread_create(&threads[t], NULL, sender, NULL) == 0);
+
+    for (i = 0; i < NUM_RESTARTS; i++)
+    {
+        if (i % 2)
+            server_restart(server_fd);
+        else
+        {
+            ing_syslog_close();
+
+            /* likely takes the number of the closed sink fd */
+            TEST_CHECK(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, probe) == 0);
+            usleep(200);
+            TEST_CHECK(!server_recv(probe[1], buf, sizeof(buf), FALSE));
+            TEST_CHECK(!server_recv(probe[0], buf, sizeof(buf), FALSE));
+            close(probe[0]);
+            close(probe[1]);
+            TEST_OK(ing_syslog_open(sock_path, "tst", LOG_USER, ING_SYSLOG_RFC3164));
+        }
+        usleep(200);
+    }
+
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    pthread_join(drain, NULL);
+    while (server_recv(server_fd, buf, sizeof(buf), FALSE))
+        ;
+    for (t = 0; t < NUM_THREADS; t++)
+        pthread_join(threads[t], NULL);
+    TEST_CHECK(received > 0);
+
+    /* the sink still works after all the swaps */
+    while (server_recv(server_fd, buf, sizeof(buf), FALSE))
+        ;
+    send_one(LOG_INFO, "last");
+    TEST_CHECK(server_recv(server_fd, buf, sizeof(buf), TRUE) && strstr(buf, "last"));
+
+    ing_syslog_close();
+    close(server_fd);
+}
+
+int main(void)
+{
+    snprintf(sock_path, sizeof(sock_path), "/tmp/ing_test_syslog.%d", (int)getpid());
+    TEST_RUN(test_syslog_format);
+    TEST_RUN(test_syslog_reconnect);
+    TEST_RUN(test_syslog_swap);
+    unlink(sock_path);
+    return 0;
+}
@@ -0,0 +1,256 @@
+/* test_template.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of string templates: overlapping and repeated placeholders,
+ * adjacent slots, fixed buffers and a comparison with a naive replacer
+ */
+
+#include <string.h>
+
+#include "ing_template.h"
+#include "ing_test.h"
+
+#define MAX_PH  6
+
+/*
+ * Leftmost-longest replacement scanning the string once; a repeated
+ * placeholder takes the value of its first occurrence in the list.
+ * Returns the number of replaced occurrences
+ */
+static size_t naive_render(const char *s, const char *const *ph, size_t n,
+    const char *const *values, ing_strbuf_t *out)
+{
+    size_t i, best, best_len, len, count = 0;
+
+    while (*s)
+    {
+        best = n;
+        best_len = 0;
+        for (i = 0; i < n; i++)
+        {
+            len = strlen(ph[i]);
+            if (len > best_len && !strncmp(s, ph[i], len))
+            {
+                best = i;
+                best_len = len;
+            }
+        }
+        if (best < n)
+        {
+            if (values[best])
+                TEST_OK(ing_strbuf_append_str(out, values[best]));
+            s += best_len;
+            count++;
+        }
+        else
+            TEST_OK(ing_strbuf_appendc(out, *s++));
+    }
+    return count;
+}
+
+/* renders str after "pre:" and compares with the naive replacer */
+static void check_render(const char *str, const char *const *ph, size_t n, const char *const *values)
+{
+    ing_strbuf_t got = ING_STRBUF_INIT, expect = ING_STRBUF_INIT;
+    ing_template_t *tpl;
+    size_t count;
+
+    TEST_OK(ing_strbuf_append_str(&got, "pre:"));
+    TEST_OK(ing_strbuf_append_str(&expect, "pre:"));
+    TEST_OK(ing_template_compile(&tpl, str, ph, n));
+    TEST_OK(ing_template_render(tpl, values, &got));
+    count = naive_render(str, ph, n, values, &expect);
+    if (strcmp(ing_strbuf_str(&got), ing_strbuf_str(&expect)) != 0)
+        fprintf(stderr, "template '%s': got '%s', expected '%s'\n", str, got.ptr, expect.ptr);
+    TEST_CHECK(got.len == expect.len && strcmp(ing_strbuf_str(&got), ing_strbuf_str(&expect)) == 0);
+    TEST_CHECK(ing_template_slot_count(tpl) == count);
+    ing_template_free(tpl);
+    ing_strbuf_destroy(&got);
+    ing_strbuf_destroy(&expect);
+}
+
+static void expect_render(const char *str, const char *const *ph, size_t n,
+    const char *const *values, const char *expect)
+{
+    ing_strbuf_t buf = ING_STRBUF_INIT;
+    ing_template_t *tpl;
+
+    TEST_OK(ing_template_compile(&tpl, str, ph, n));
+    TEST_OK(ing_template_render(tpl, values, &buf));
+    TEST_CHECK(strcmp(ing_strbuf_str(&buf), expect) == 0);
+    ing_template_free(tpl);
+    ing_strbuf_destroy(&buf);
+    check_render(str, ph, n, values);
+}
+
+static void test_template_overlap(void)
+{
+    static const char *const ph[] = { "$A", "$AB", "B" };
+    static const char *const values[] = { "1", "22", "333" };
+    static const char *const ph2[] = { "AB", "BCD" };
+    static const char *const values2[] = { "x", "y" };
+
+    /* the longest placeholder at a position wins */
+    expect_render("x$ABy$Az B", ph, 3, values, "x22y1z 333");
+    /* the leftmost occurrence wins over a longer one starting later */
+    expect_render("ABCD", ph2, 2, values2, "xCD");
+    expect_render("$$AB$A$$", ph, 3, values, "$221$$");
+    /* adjacent slots */
+    expect_render("$A$AB$ABB$A", ph, 3, values, "122223331");
+    expect_render("BBB", ph, 3, values, "333333333");
+    /* no placeholders */
+    expect_render("plain $ text", ph, 0, NULL, "plain $ text");
+    expect_render("", ph, 3, values, "");
+}
+
+static void test_template_values(void)
+{
+    static const char *const ph[] = { "$X", "$Y", "$X", "%X%" };
+    static const char *const values[] = { "first", "y", "second", NULL };
+    static const char *const empty[] = { "" };
+    ing_template_t *tpl;
+
+    /* a repeated placeholder takes the first value; NULL is an empty string */
+    expect_render("$X-$Y-%X%-$X", ph, 4, values, "first-y--first");
+
+    TEST_CHECK(ing_template_compile(&tpl, "$X", empty, 1) == ING_STAT_INVALID_ARGUMENT && !tpl);
+    TEST_CHECK(ing_template_compile(&tpl, NULL, ph, 1) == ING_STAT_INVALID_ARGUMENT);
+    TEST_CHECK(ing_template_compile(&tpl, "$X", NULL, 1) == ING_STAT_INVALID_ARGUMENT);
+    TEST_OK(ing_template_compile(&tpl, "$X", ph, 1));
+    TEST_CHECK(ing_template_render(tpl, NULL, NULL) == ING_STAT_INVALID_ARGUMENT);
+    ing_template_free(tpl);
+}
+
+static void test_template_fixed(void)
+{
+    static const char *const ph[] = { "$IF", "$ADDR" };
+    static const char *const values[] = { "eth0", "192.168.100.200" };
+    ing_template_t *tpl;
+    ing_strbuf_t sb;
+    char buf[32];
+
+    TEST_OK(ing_template_compile(&tpl, "ip addr add $ADDR dev $IF", ph, 2));
+    TEST_CHECK(ing_template_slot_count(tpl) == 2);
+
+    /* "ip addr add 192.168.100.200 dev eth0" needs 37 bytes */
+    strcpy(buf, "old");
+    TEST_OK(ing_strbuf_init_fixed(&sb, buf, sizeof(buf), 3));
+    TEST_CHECK(ing_template_render(tpl, values, &sb) == ING_STAT_FULL);
+    TEST_CHECK(sb.len == 3 && strcmp(buf, "old") == 0);
+
+    /* exactly fits */
+    buf[0] = '\0';
+    TEST_OK(ing_strbuf_init_fixed(&sb, buf, 37, 0));
+    TEST_OK(ing_template_render(tpl, values, &sb));
+    TEST_CHECK(sb.len == 36 && strcmp(buf, "ip addr add 192.168.100.200 dev eth0") == 0);
+    ing_template_free(tpl);
+}
+
+static void test_template_random(void)
+{
+    static const char alphabet[] = "$ABC";
+    const char *ph[MAX_PH], *values[MAX_PH];
+    char phbuf[MAX_PH][4], valbuf[MAX_PH][8], str[64];
+    unsigned long long seed = 7;
+    size_t n, i, j, len;
+    int iter;
+
+    for (iter = 0; iter < 50000; iter++)
+    {
+        n = test_rand(&seed) % (MAX_PH + 1);
+        for (i = 0; i < n; i++)
+        {
+            len = 1 + test_rand(&seed) % 3;
+            for (j = 0; j < len; j++)
+                phbuf[i][j] = alphabet[test_rand(&seed) % 4];
+            phbuf[i][len] = '\0';
+            ph[i] = phbuf[i];
+
+            len = test_rand(&seed) % 5;
+            for (j = 0; j < len; j++)
+                valbuf[i][j] = 'a' + test_rand(&seed) % 26;
+            valbuf[i][len] = '\0';
+            values[i] = test_rand(&seed) % 5 ? valbuf[i] : NULL;
+        }
+        len = test_rand(&seed) % sizeof(str);
+        for (j = 0; j < len; j++)
+            str[j] = alphabet[test_rand(&seed) % 4];
+        str[len] = '\0';
+        check_render(str, ph, n, values);
+    }
+}
+
+int main(void)
+{
+    TEST_RUN(test_template_overlap);
+    TEST_RUN(test_template_values);
+    TEST_RUN(test_template_fixed);
+    TEST_RUN(test_template_random);
+    return 0;
+}
@@ -0,0 +1,229 @@
+/* test_validate.c
+ *
+ * Copyright (c) 2013-2021 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+
+/*
+ * Tests of the validators: integer ranges against the values they encode,
+ * IPv6 against inet_pton(), IPv4, MAC and boolean forms
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <arpa/inet.h>
+
+#include "ing_validate.h"
+#include "ing_test.h"
+
+static int parse_uint(const char *s, uint64_t max, uint64_t *val)
+{
+    return ing_parse_uint(s, strlen(s), max, val);
+}
+
+static int parse_int(const char *s, int64_t min, int64_t max, int64_t *val)
+{
+    return ing_parse_int(s, strlen(s), min, max, val);
+}
+
+/* every value and form against every small limit, digits above the limit included */
+static void test_validate_uint(void)
+{
+    static const char *forms[] = { "%d", "0%d", "+%d", "00%d" };
+    char s[32];
+    uint64_t max, v;
+    size_t f;
+    int n;
+
+    TEST_CHECK(!parse_uint("5", 3, &v));
+    TEST_CHECK(!parse_uint("09", 5, &v));
+    TEST_CHECK(parse_uint("3", 3, &v) && v == 3);
+    TEST_CHECK(!parse_uint("1", 0, &v));
+    TEST_CHECK(parse_uint("0", 0, &v) && v == 0);
+
+    for (max = 0; max <= 120; max++)
+    {
+        for (n = 0; n <= 1200; n++)
+        {
+            for (f = 0; f < sizeof(forms) / sizeof(forms[0]); f++)
+            {
+                snprintf(s, sizeof(s), forms[f], n);
+                v = 12345;
+                TEST_CHECK(parse_uint(s, max, &v) == ((uint64_t)n <= max));
+                TEST_CHECK(v == ((uint64_t)n <= max ? (uint64_t)n : 12345));
+            }
+        }
+    }
+
+    TEST_CHECK(parse_uint("18446744073709551615", UINT64_MAX, &v) && v == UINT64_MAX);
+    TEST_CHECK(!parse_uint("18446744073709551616", UINT64_MAX, &v));
+    TEST_CHECK(!parse_uint("18446744073709551620", UINT64_MAX, &v));
+    TEST_CHECK(!parse_uint("99999999999999999999", UINT64_MAX, &v));
+    TEST_CHECK(parse_uint("18446744073709551614", UINT64_MAX - 1, &v));
+    TEST_CHECK(!parse_uint("18446744073709551615", UINT64_MAX - 1, &v));
+
+    TEST_CHECK(!parse_uint("", 10, &v));
+    TEST_CHECK(!parse_uint("+", 10, &v));
+    TEST_CHECK(!parse_uint("-1", 10, &v));
+    TEST_CHECK(!parse_uint("1 ", 10, &v));
+    TEST_CHECK(!parse_uint("1a", 10, &v));
+    TEST_CHECK(ing_parse_uint("12", 1, 10, &v) && v == 1);
+}
+
+static void test_validate_int(void)
+{
+    char s[32];
+    int64_t min, max, v;
+    int n;
+
+    TEST_CHECK(!parse_int("-5", -3, 3, &v));
+    TEST_CHECK(!parse_int("-09", -5, 5, &v));
+    TEST_CHECK(parse_int("-3", -3, 3, &v) && v == -3);
+
+    for (min = -30; min <= 30; min++)
+    {
+        for (max = min; max <= 30; max++)
+        {
+            for (n = -300; n <= 300; n++)
+            {
+                snprintf(s, sizeof(s), "%d", n);
+                TEST_CHECK(parse_int(s, min, max, &v) == (n >= min && n <= max));
+                snprintf(s, sizeof(s), n < 0 ? "-0%d" : "+0%d", n < 0 ? -n : n);
+                TEST_CHECK(parse_int(s, min, max, &v) == (n >= min && n <= max));
+            }
+        }
+    }
+
+    TEST_CHECK(parse_int("9223372036854775807", INT64_MIN, INT64_MAX, &v) && v == INT64_MAX);
+    TEST_CHECK(parse_int("-9223372036854775808", INT64_MIN, INT64_MAX, &v) && v == INT64_MIN);
+    TEST_CHECK(!parse_int("9223372036854775808", INT64_MIN, INT64_MAX, &v));
+    TEST_CHECK(!parse_int("-9223372036854775809", INT64_MIN, INT64_MAX, &v));
+    TEST_CHECK(parse_int("-0", 0, 10, &v) && v == 0);
+    TEST_CHECK(!parse_int("-1", 0, 10, &v));
+    TEST_CHECK(!parse_int("1", 2, 1, &v));
+}
+
+static void test_validate_ip(void)
+{
+    static const char *v4_ok[] = { "0.0.0.0", "255.255.255.255", "1.2.3.4", "01.002.0003.0000004" };
+    static const char *v4_bad[] = { "", "1.2.3", "1.2.3.4.", "1.2.3.256", ".1.2.3", "1..2.3",
+        "1.2.3.4 ", "a.b.c.d", "1.2.3.-4" };
+    static const char alphabet[] = "0123456789abcdefABCDEF:.g";
+    unsigned long long seed = 49;
+    uint8_t a[16], b[16];
+    char s[48];
+    size_t i, len;
+
+    for (i = 0; i < sizeof(v4_ok) / sizeof(v4_ok[0]); i++)
+        TEST_CHECK(ing_parse_ipv4(v4_ok[i], strlen(v4_ok[i]), a));
+    TEST_CHECK(a[0] == 1 && a[1] == 2 && a[2] == 3 && a[3] == 4);
+    for (i = 0; i < sizeof(v4_bad) / sizeof(v4_bad[0]); i++)
+        TEST_CHECK(!ing_parse_ipv4(v4_bad[i], strlen(v4_bad[i]), a));
+
+    /* random strings, biased to valid addresses by the alphabet */
+    for (i = 0; i < 2000000; i++)
+    {
+        len = test_rand(&seed) % 24;
+        s[len] = '\0';
+        while (len--)
+            s[len] = alphabet[test_rand(&seed) % (sizeof(alphabet) - 1)];
+        TEST_CHECK(ing_parse_ipv6(s, strlen(s), a) == (inet_pton(AF_INET6, s, b) == 1));
+        if (inet_pton(AF_INET6, s, b) == 1)
+            TEST_CHECK(memcmp(a, b, 16) == 0);
+    }
+    TEST_CHECK(ing_parse_ipv6("::ffff:1.2.3.4", 14, a) && a[10] == 0xff && a[15] == 4);
+    TEST_CHECK(!ing_parse_ipv6("::ffff:1.2.3.04", 15, a));
+}
+
+static void test_validate_mac_bool(void)
+{
+    uint8_t m[6];
+    int v;
+
+    TEST_CHECK(ing_parse_mac("00:1a:2B:3c:4D:5e", 17, m) && m[1] == 0x1a && m[5] == 0x5e);
+    TEST_CHECK(ing_parse_mac("0-1:2-3:4-f", 11, m) && m[0] == 0 && m[5] == 0xf);
+    TEST_CHECK(!ing_parse_mac("00:11:22:33:44", 14, m));
+    TEST_CHECK(!ing_parse_mac("00:11:22:33:44:55:", 18, m));
+    TEST_CHECK(!ing_parse_mac("000:11:22:33:44:55", 18, m));
+    TEST_CHECK(!ing_parse_mac("00.11.22.33.44.55", 17, m));
+    TEST_CHECK(!ing_parse_mac("0g:11:22:33:44:55", 17, m));
+
+    TEST_CHECK(ing_parse_bool("TrUe", 4, &v) && v);
+    TEST_CHECK(ing_parse_bool("FALSE", 5, &v) && !v);
+    TEST_CHECK(ing_parse_bool("1", 1, &v) && v);
+    TEST_CHECK(ing_parse_bool("0", 1, &v) && !v);
+    TEST_CHECK(!ing_parse_bool("2", 1, &v));
+    TEST_CHECK(!ing_parse_bool("yes", 3, &v));
+    TEST_CHECK(!ing_parse_bool("true", 3, &v));
+}
+
+int main(void)
+{
+    TEST_RUN(test_validate_uint);
+    TEST_RUN(test_validate_int);
+    TEST_RUN(test_validate_ip);
+    TEST_RUN(test_validate_mac_bool);
+    return 0;
+}
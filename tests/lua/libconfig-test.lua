@@ -322,6 +322,16 @@ test_decode_should_fail('a = 20; 20 = "a"')
 
 test_encode({a = {42, {}}, b = {}}, "a: (42)")
 
+test_encode({a = "\"\\"}, 'a: "\\"\\\\"')
+
+test_encode({a = {2147483647, 2147483648, -2147483649}}, "a: [2147483647, 2147483648L, -2147483649L]")
+
+test_encode({a = {1.5, {b = true}, config.empty_group()}}, "a: (1.5, {b: true}, {})")
+
+test_encode({a = {[1] = 1, [2] = 2, [4] = 4}}, "a: [1, 2]")
+
+test_encode_should_fail({a = {b = {1, 2}, [1] = 1}})
+
 --------------------------------------------------------------------------------
 -- Some poorely formalized tests
 --------------------------------------------------------------------------------
@@ -0,0 +1,295 @@
+--[[
+################################################################################
+#
+# validate-test.lua
+#
+# Copyright (c) 2013-2021 Inango Systems LTD.
+#
+# Author: Inango Systems LTD. <support@inango-systems.com>
+# Creation Date: Oct 2026
+#
+# The author may be reached at support@inango-systems.com
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# Subject to the terms and conditions of this license, each copyright holder
+# and contributor hereby grants to those receiving rights under this license
+# a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+# (except for failure to satisfy the conditions of this license) patent license
+# to make, have made, use, offer to sell, sell, import, and otherwise transfer
+# this software, where such license applies only to those patent claims, already
+# acquired or hereafter acquired, licensable by such copyright holder or contributor
+# that are necessarily infringed by:
+#
+# (a) their Contribution(s) (the licensed copyrights of copyright holders and
+# non-copyrightable additions of contributors, in source or binary form) alone;
+# or
+#
+# (b) combination of their Contribution(s) with the work of authorship to which
+# such Contribution(s) was added by such copyright holder or contributor, if,
+# at the time the Contribution is added, such addition causes such combination
+# to be necessarily infringed. The patent license shall not apply to any other
+# combinations which include the Contribution.
+#
+# Except as expressly stated above, no rights or licenses from any copyright
+# holder or contributor is granted under this license, whether expressly, by
+# implication, estoppel or otherwise.
+#
+# DISCLAIMER
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+# OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+# USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# NOTE
+#
+# This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+#
+# This version of MMX provides web and command-line management interfaces.
+#
+# Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+# - other management packages, such as SNMP, TR-069 or Netconf
+# - how we can extend the data model to support all parts of your system
+# - professional sub-contract and customization services
+#
+################################################################################
+--]]
+
+--[[
+--  Description: Tests for the native validators of the mmx.lualibvalidate
+--  module against the Lua implementations in ing_utils.lua they replace
+--]]
+
+local native = require("mmx.lualibvalidate")
+
+-- ing_utils.lua keeps its Lua validators if the native module fails to load
+package.loaded["mmx.lualibvalidate"] = nil
+package.preload["mmx.lualibvalidate"] = function() error("native validators disabled") end
+require("mmx/ing_utils")
+package.preload["mmx.lualibvalidate"] = nil
+package.loaded["mmx.lualibvalidate"] = native
+
+local fallback = {
+    is_ip = ing.utils.is_ip,
+    is_mac = ing.utils.is_mac,
+    isBoolean = ing.utils.isBoolean,
+    isInteger = ing.utils.isInteger,
+    isUnsignedInteger = ing.utils.isUnsignedInteger,
+}
+
+assert(fallback.is_ip ~= native.is_ip, "ing_utils.lua loaded the native validators")
+
+--------------------------------------------------------------------------------
+-- Test helpers
+--------------------------------------------------------------------------------
+local failures = 0
+
+-- results of pcall(fn, ...) with the count, so trailing nils are compared too
+local function call(fn, ...)
+    local res = {n = 0}
+    local function pack(...)
+        res.n = select('#', ...)
+        for i = 1, res.n do
+            res[i] = select(i, ...)
+        end
+    end
+    pack(pcall(fn, ...))
+    return res
+end
+
+local function describe(res)
+    if not res[1] then
+        return "error"
+    end
+    local out = {}
+    for i = 2, res.n do
+        out[#out + 1] = type(res[i]) == "string" and ("%q"):format(res[i]) or tostring(res[i])
+    end
+    return "(" .. table.concat(out, ", ") .. ")"
+end
+
+-- both error, or both return the same values
+local function same(a, b)
+    if a[1] ~= b[1] then
+        return false
+    end
+    if not a[1] then
+        return true
+    end
+    if a.n ~= b.n then
+        return false
+    end
+    for i = 2, a.n do
+        if a[i] ~= b[i] then
+            return false
+        end
+    end
+    return true
+end
+
+local function value_str(v)
+    return type(v) == "string" and ("%q"):format(v) or tostring(v)
+end
+
+local function test_same(name, values)
+    print("\n- test native " .. name .. " == Lua " .. name)
+
+    local success = true
+    for i = 1, values.n or #values do
+        local n = call(native[name], values[i])
+        local f = call(fallback[name], values[i])
+        if not same(n, f) then
+            success = false
+            print(("  %s(%s): native %s, Lua %s"):format(name, value_str(values[i]), describe(n), describe(f)))
+        end
+    end
+
+    if success then
+        print("= ok")
+    else
+        failures = failures + 1
+        print("= fail")
+    end
+end
+
+local function test_values(name, cases)
+    print("\n- test native " .. name)
+
+    local success = true
+    for _, case in ipairs(cases) do
+        local res = call(native[name], unpack(case.args))
+        local expect = call(function() return unpack(case.expect, 1, case.expect.n) end)
+        if not same(res, expect) then
+            success = false
+            local args = {}
+            for i = 1, #case.args do
+                args[i] = value_str(case.args[i])
+            end
+            print(("  %s(%s): %s, expected %s"):format(name, table.concat(args, ", "),
+                describe(res), describe(expect)))
+        end
+    end
+
+    if success then
+        print("= ok")
+    else
+        failures = failures + 1
+        print("= fail")
+    end
+end
+
+-- random strings of characters from alphabet
+local function random_strings(alphabet, count, max_len)
+    local values = {}
+    for i = 1, count do
+        local s = {}
+        for j = 1, math.random(0, max_len) do
+            local k = math.random(1, #alphabet)
+            s[j] = alphabet:sub(k, k)
+        end
+        values[i] = table.concat(s)
+    end
+    return values
+end
+--------------------------------------------------------------------------------
+-- Test cases
+--------------------------------------------------------------------------------
+print("\n- [begin]")
+
+math.randomseed(49)
+
+test_same("is_ip", {
+    "1.2.3.4", "0.0.0.0", "255.255.255.255", "256.1.1.1", "1.2.3.300", "01.02.03.04",
+    "0000000000001.1.1.1", "1.2.3", "1.2.3.4.5", "1.2.3.", ".1.2.3", "1..2.3", "",
+    "a.b.c.d", " 1.2.3.4", "1.2.3.4 ", "1.2.3.4\n", "1.2.3.4\0", "-1.2.3.4", "+1.2.3.4",
+    "1.2.3.4/24", "::1", 1234, 1.5,
+})
+
+test_same("is_mac", {
+    "00:11:22:33:44:55", "AA:BB:CC:DD:EE:FF", "aA:bB:cC:dD:eE:fF", "0-1-2-3-4-5",
+    "00:11-22:33-44:55", "0:1:2:3:4:5", "000:11:22:33:44:55", "00:11:22:33:44",
+    "00:11:22:33:44:55:66", "00:11:22:33:44:", "gg:11:22:33:44:55", "00.11.22.33.44.55",
+    "00:11:22:33:44:55\0", " 00:11:22:33:44:55", "", 123456, false,
+    n = 17,
+})
+
+test_same("isBoolean", {
+    "true", "TRUE", "True", "false", "FALSE", "fAlSe", "1", "0", "1.0", "0.0", "0x1", "0x0",
+    " 1", "1 ", "1e0", "-0", "2", "-1", "yes", "no", "", "truex", "t", 1, 0, 2, 0.5, nil,
+    n = 28,
+})
+
+test_same("isInteger", {
+    "10", "-10", "+10", "0", "-0", "10.0", "10.5", "1e3", "1e-3", "0x10", "0X1f", " 7 ",
+    "7\n", "abc", "", "1 2", "inf", "-inf", "nan", "9007199254740992", "9007199254740993",
+    "1e308", "1e309", 5, 5.5, -3, true, nil,
+    n = 28,
+})
+
+test_same("isUnsignedInteger", {
+    "0", "-0", "1", "-1", "1.5", "-1.5", "0x10", "1e3", "-1e3", " 3", "x", "", 7, -7, nil,
+    n = 15,
+})
+
+-- strings made of the characters the validators look at
+local values = random_strings("0123456789abcdefABCDEFxX.:- +eEtTrRuUlLsS", 20000, 20)
+test_same("is_ip", values)
+test_same("is_mac", values)
+test_same("isBoolean", values)
+test_same("isInteger", values)
+test_same("isUnsignedInteger", values)
+
+-- native only: isBoolean of booleans and the range checked parse_int
+test_values("isBoolean", {
+    {args = {true}, expect = {0, true, n = 2}},
+    {args = {false}, expect = {0, false, n = 2}},
+})
+
+test_values("parse_int", {
+    {args = {"3", 1, 3}, expect = {3, n = 1}},
+    {args = {"5", 1, 3}, expect = {nil, n = 1}},
+    {args = {"09", 0, 5}, expect = {nil, n = 1}},
+    {args = {"05", 0, 5}, expect = {5, n = 1}},
+    {args = {"-4", -5, 5}, expect = {-4, n = 1}},
+    {args = {"-6", -5, 5}, expect = {nil, n = 1}},
+    {args = {"-09", -5, 5}, expect = {nil, n = 1}},
+    {args = {"0", 1, 3}, expect = {nil, n = 1}},
+    {args = {"+2", 1, 3}, expect = {2, n = 1}},
+    {args = {"2", 3, 1}, expect = {nil, n = 1}},
+    {args = {"1.5"}, expect = {nil, n = 1}},
+    {args = {"0x10"}, expect = {nil, n = 1}},
+    {args = {" 1"}, expect = {nil, n = 1}},
+    {args = {""}, expect = {nil, n = 1}},
+    {args = {"9007199254740992"}, expect = {9007199254740992, n = 1}},
+    {args = {"9007199254740993"}, expect = {nil, n = 1}},
+    {args = {"-9007199254740992"}, expect = {-9007199254740992, n = 1}},
+})
+
+-- every value against every small range, digits above the bounds included
+local ranges = {}
+for max = 0, 12 do
+    for n = -15, 15 do
+        local expect = (n >= -max and n <= max) and n or nil
+        ranges[#ranges + 1] = {args = {tostring(n), -max, max}, expect = {expect, n = 1}}
+    end
+end
+test_values("parse_int", ranges)
+
+print("\n- [ end ]")
+
+assert(failures == 0, failures .. " test(s) failed")